@@ -17,6 +17,7 @@ out vec4 outFragColor;
 // Uniforms
 uniform int uHasTexture = 0;
 uniform sampler2D uTexture;
+uniform vec3 uTint = vec3(1.0);
 
 // Main
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -32,7 +33,7 @@ void main()
 	if (uHasTexture != 0) {
 		baseColor = texture(uTexture, uv).rgb;
 	}
-	outFragColor = vec4((ambient + diffuseFactor) * baseColor, 1.0);
+	outFragColor = vec4((ambient + diffuseFactor) * baseColor * uTint, 1.0);
 
 	//outFragLinearDepth = vec4(-pos.z / uFarPlaneDist, 0.0, 0.0, 1.0);
 	//outFragNormal = vec4(normal, 1.0);
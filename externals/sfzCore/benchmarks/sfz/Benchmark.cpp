@@ -0,0 +1,96 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/Benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// BenchmarkSuite: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+BenchmarkSuite::BenchmarkSuite(uint32_t warmupReps, uint32_t reps, const char* filter) noexcept
+:
+	mWarmupReps(warmupReps),
+	mReps(reps),
+	mFilter(filter)
+{
+	sfz_assert_debug(reps > 0);
+}
+
+// BenchmarkSuite: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void BenchmarkSuite::run(const char* name, size_t opsPerRep, const std::function<void()>& func) noexcept
+{
+	sfz_assert_debug(opsPerRep > 0);
+	if (mFilter != nullptr && std::strstr(name, mFilter) == nullptr) return;
+
+	using clock = std::chrono::high_resolution_clock;
+
+	for (uint32_t i = 0; i < mWarmupReps; ++i) {
+		func();
+	}
+
+	std::vector<double> nsPerOp;
+	nsPerOp.reserve(mReps);
+	for (uint32_t i = 0; i < mReps; ++i) {
+		auto before = clock::now();
+		func();
+		auto after = clock::now();
+		double ns = std::chrono::duration<double, std::nano>(after - before).count();
+		nsPerOp.push_back(ns / double(opsPerRep));
+	}
+	std::sort(nsPerOp.begin(), nsPerOp.end());
+
+	BenchmarkResult result;
+	result.name = name;
+	result.opsPerRep = opsPerRep;
+	result.reps = mReps;
+	result.minNs = nsPerOp.front();
+	result.medianNs = nsPerOp[nsPerOp.size() / 2];
+	result.p95Ns = nsPerOp[std::min(nsPerOp.size() - 1, (nsPerOp.size() * 95) / 100)];
+	mResults.push_back(result);
+}
+
+void BenchmarkSuite::printTable(FILE* out) const noexcept
+{
+	std::fprintf(out, "%-40s %10s %6s %12s %12s %12s\n",
+	             "benchmark", "ops/rep", "reps", "min ns/op", "median ns/op", "p95 ns/op");
+	for (const BenchmarkResult& r : mResults) {
+		std::fprintf(out, "%-40s %10zu %6u %12.3f %12.3f %12.3f\n",
+		             r.name, r.opsPerRep, r.reps, r.minNs, r.medianNs, r.p95Ns);
+	}
+}
+
+void BenchmarkSuite::printCsv(FILE* out) const noexcept
+{
+	std::fprintf(out, "benchmark,ops_per_rep,reps,min_ns_per_op,median_ns_per_op,p95_ns_per_op\n");
+	for (const BenchmarkResult& r : mResults) {
+		std::fprintf(out, "%s,%zu,%u,%.4f,%.4f,%.4f\n",
+		             r.name, r.opsPerRep, r.reps, r.minNs, r.medianNs, r.p95Ns);
+	}
+}
+
+} // namespace sfz
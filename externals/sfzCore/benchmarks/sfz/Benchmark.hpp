@@ -0,0 +1,114 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace sfz {
+
+// Benchmark result
+// ------------------------------------------------------------------------------------------------
+
+/// Timing statistics for a single benchmark. All times are in nanoseconds per operation, where an
+/// operation is whatever the benchmark function performs opsPerRep times per repetition.
+struct BenchmarkResult final {
+	const char* name = nullptr;
+	size_t opsPerRep = 0;
+	uint32_t reps = 0;
+	double minNs = 0.0;
+	double medianNs = 0.0;
+	double p95Ns = 0.0;
+};
+
+// Benchmark suite
+// ------------------------------------------------------------------------------------------------
+
+/// A minimal microbenchmark harness. Each benchmark is run a number of warmup repetitions that
+/// are discarded, followed by the measured repetitions. Statistics are computed over the
+/// per-repetition times so that a single preempted repetition does not skew the median.
+class BenchmarkSuite final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	BenchmarkSuite(const BenchmarkSuite&) = delete;
+	BenchmarkSuite& operator= (const BenchmarkSuite&) = delete;
+
+	/// filter: only benchmarks whose name contains this substring are run, nullptr runs all.
+	BenchmarkSuite(uint32_t warmupReps = 3, uint32_t reps = 31, const char* filter = nullptr) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Runs func (warmup + measured repetitions) and stores the result. func is expected to
+	/// perform opsPerRep operations per call.
+	void run(const char* name, size_t opsPerRep, const std::function<void()>& func) noexcept;
+
+	void printTable(FILE* out) const noexcept;
+	void printCsv(FILE* out) const noexcept;
+
+	inline const std::vector<BenchmarkResult>& results() const noexcept { return mResults; }
+
+private:
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	uint32_t mWarmupReps, mReps;
+	const char* mFilter;
+	std::vector<BenchmarkResult> mResults;
+};
+
+// Optimization barriers
+// ------------------------------------------------------------------------------------------------
+
+/// Forces the compiler to assume value is read, so that the computation producing it can not be
+/// eliminated as dead code.
+template<typename T>
+inline void doNotOptimize(const T& value) noexcept
+{
+#if defined(_MSC_VER)
+	const volatile char* volatile sink = reinterpret_cast<const volatile char*>(&value);
+	(void)sink;
+#else
+	asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/// Forces the compiler to assume all memory may have been modified.
+inline void clobberMemory() noexcept
+{
+#if defined(_MSC_VER)
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : : "memory");
+#endif
+}
+
+// Benchmark registration
+// ------------------------------------------------------------------------------------------------
+
+void runMathBenchmarks(BenchmarkSuite& suite) noexcept;
+void runGeometryBenchmarks(BenchmarkSuite& suite) noexcept;
+
+} // namespace sfz
@@ -0,0 +1,58 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "sfz/Benchmark.hpp"
+
+// Usage: sfzCoreBenchmarks [--csv] [--warmup N] [--reps N] [filter]
+int main(int argc, char* argv[])
+{
+	bool csv = false;
+	uint32_t warmupReps = 3;
+	uint32_t reps = 31;
+	const char* filter = nullptr;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--csv") == 0) {
+			csv = true;
+		} else if (std::strcmp(argv[i], "--warmup") == 0 && (i + 1) < argc) {
+			warmupReps = uint32_t(std::atoi(argv[++i]));
+		} else if (std::strcmp(argv[i], "--reps") == 0 && (i + 1) < argc) {
+			reps = uint32_t(std::max(1, std::atoi(argv[++i])));
+		} else if (argv[i][0] != '-') {
+			filter = argv[i];
+		} else {
+			std::fprintf(stderr, "Usage: %s [--csv] [--warmup N] [--reps N] [filter]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	sfz::BenchmarkSuite suite(warmupReps, reps, filter);
+	sfz::runMathBenchmarks(suite);
+	sfz::runGeometryBenchmarks(suite);
+
+	if (csv) suite.printCsv(stdout);
+	else suite.printTable(stdout);
+
+	return EXIT_SUCCESS;
+}
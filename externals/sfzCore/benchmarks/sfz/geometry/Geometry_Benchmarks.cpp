@@ -0,0 +1,582 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/Benchmark.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/BVH.hpp"
+#include "sfz/geometry/BatchIntersection.hpp"
+#include "sfz/geometry/BoundingVolumes.hpp"
+#include "sfz/geometry/Broadphase.hpp"
+#include "sfz/geometry/ConvexHull.hpp"
+#include "sfz/geometry/GJK.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/LooseOctree.hpp"
+#include "sfz/geometry/MeshOptimization.hpp"
+#include "sfz/geometry/MeshSimplification.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/OcclusionBuffer.hpp"
+#include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/Sweep.hpp"
+#include "sfz/geometry/TriangleBVH.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const size_t NUM_PRIMITIVES = 4096;
+static const uint32_t NUM_BVH_PRIMITIVES = 65536;
+static const uint32_t MESH_GRID_SIZE = 317; // 2 * 316^2 = 199712 triangles
+static const uint32_t NUM_MESH_RAYS = 1024;
+static const uint32_t NUM_BROADPHASE_OBJECTS = 4096;
+static const uint32_t NUM_OCTREE_OBJECTS = 100000;
+static const uint32_t OCCLUDER_GRID_SIZE = 8; // 64 buildings
+static const uint32_t NUM_OCCLUSION_OBJECTS = 10000;
+static const uint32_t NUM_GJK_PAIRS = 1024;
+static const uint32_t NUM_GJK_FRAMES = 8;
+static const uint32_t NUM_HULL_POINTS = 5000;
+static const uint32_t NUM_SWEEPS = 64;
+
+// Geometry benchmarks
+// ------------------------------------------------------------------------------------------------
+
+void runGeometryBenchmarks(BenchmarkSuite& suite) noexcept
+{
+	std::mt19937 gen(1337);
+	std::uniform_real_distribution<float> posDistr(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> sizeDistr(0.5f, 10.0f);
+	std::uniform_real_distribution<float> angleDistr(0.0f, 6.28f);
+
+	std::vector<AABB> aabbs;
+	std::vector<OBB> obbs;
+	std::vector<Sphere> spheres;
+	aabbs.reserve(NUM_PRIMITIVES);
+	obbs.reserve(NUM_PRIMITIVES);
+	spheres.reserve(NUM_PRIMITIVES);
+	for (size_t i = 0; i < NUM_PRIMITIVES; ++i) {
+		vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+		vec3 ext(sizeDistr(gen), sizeDistr(gen), sizeDistr(gen));
+		aabbs.emplace_back(pos, ext[0], ext[1], ext[2]);
+		mat4 rot = rotationMatrix4(normalize(vec3(1.0f, 2.0f, 3.0f)), angleDistr(gen));
+		obbs.push_back(OBB(aabbs.back()).transformOBB(rot));
+		spheres.emplace_back(pos, ext[0]);
+	}
+	const Plane plane(normalize(vec3(1.0f, 1.0f, 0.0f)), vec3(0.0f));
+	const ViewFrustum frustum(vec3(0.0f, 0.0f, -60.0f), vec3(0.0f, 0.0f, 1.0f),
+	                          vec3(0.0f, 1.0f, 0.0f), 90.0f, 1.0f, 0.1f, 100.0f);
+	std::vector<uint8_t> hits(NUM_PRIMITIVES);
+
+	// SoA copies of the spheres and AABBs for the batch culling functions
+	std::vector<float> xs, ys, zs, radii, minX, minY, minZ, maxX, maxY, maxZ;
+	for (size_t i = 0; i < NUM_PRIMITIVES; ++i) {
+		xs.push_back(spheres[i].position()[0]);
+		ys.push_back(spheres[i].position()[1]);
+		zs.push_back(spheres[i].position()[2]);
+		radii.push_back(spheres[i].radius());
+		minX.push_back(aabbs[i].min()[0]);
+		minY.push_back(aabbs[i].min()[1]);
+		minZ.push_back(aabbs[i].min()[2]);
+		maxX.push_back(aabbs[i].max()[0]);
+		maxY.push_back(aabbs[i].max()[1]);
+		maxZ.push_back(aabbs[i].max()[2]);
+	}
+	std::vector<uint32_t> visibleMask((NUM_PRIMITIVES + 31) / 32);
+	OBBBatch obbBatch;
+	for (const OBB& obb : obbs) obbBatch.add(obb);
+
+	suite.run("intersects AABB-AABB", NUM_PRIMITIVES - 1, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES - 1; ++i) hits[i] = intersects(aabbs[i], aabbs[i + 1]);
+		clobberMemory();
+	});
+	suite.run("intersects OBB-OBB", NUM_PRIMITIVES - 1, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES - 1; ++i) hits[i] = intersects(obbs[i], obbs[i + 1]);
+		clobberMemory();
+	});
+	suite.run("intersects Sphere-Sphere", NUM_PRIMITIVES - 1, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES - 1; ++i) {
+			hits[i] = intersects(spheres[i], spheres[i + 1]);
+		}
+		clobberMemory();
+	});
+	suite.run("intersects OBB vs 4k OBBs", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = intersects(obbs[0], obbs[i]);
+		clobberMemory();
+	});
+	suite.run("intersects OBB vs 4k OBBs (batched)", NUM_PRIMITIVES, [&]() {
+		intersects(obbs[0], obbBatch, visibleMask.data());
+		clobberMemory();
+	});
+	suite.run("intersects Sphere vs 4k Spheres", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = intersects(spheres[0], spheres[i]);
+		clobberMemory();
+	});
+	suite.run("intersects Sphere vs 4k Spheres (batched)", NUM_PRIMITIVES, [&]() {
+		intersects(spheres[0], xs.data(), ys.data(), zs.data(), radii.data(), NUM_PRIMITIVES,
+		           visibleMask.data());
+		clobberMemory();
+	});
+	suite.run("intersects Plane-AABB", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = intersects(plane, aabbs[i]);
+		clobberMemory();
+	});
+	suite.run("intersects Plane-OBB", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = intersects(plane, obbs[i]);
+		clobberMemory();
+	});
+	suite.run("pointInside OBB", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) {
+			hits[i] = pointInside(obbs[i], spheres[i].position());
+		}
+		clobberMemory();
+	});
+	suite.run("ViewFrustum isVisible AABB", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = frustum.isVisible(aabbs[i]);
+		clobberMemory();
+	});
+	suite.run("ViewFrustum isVisible OBB", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = frustum.isVisible(obbs[i]);
+		clobberMemory();
+	});
+	suite.run("ViewFrustum isVisible Sphere", NUM_PRIMITIVES, [&]() {
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) hits[i] = frustum.isVisible(spheres[i]);
+		clobberMemory();
+	});
+	suite.run("ViewFrustum cullAABBs", NUM_PRIMITIVES, [&]() {
+		frustum.cullAABBs(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(),
+		                  NUM_PRIMITIVES, visibleMask.data());
+		clobberMemory();
+	});
+	suite.run("ViewFrustum cullSpheres", NUM_PRIMITIVES, [&]() {
+		frustum.cullSpheres(xs.data(), ys.data(), zs.data(), radii.data(), NUM_PRIMITIVES,
+		                    visibleMask.data());
+		clobberMemory();
+	});
+
+	// BVH
+	std::vector<AABB> bvhAABBs;
+	bvhAABBs.reserve(NUM_BVH_PRIMITIVES);
+	std::uniform_real_distribution<float> scenePosDistr(-200.0f, 200.0f);
+	for (uint32_t i = 0; i < NUM_BVH_PRIMITIVES; ++i) {
+		vec3 pos(scenePosDistr(gen), scenePosDistr(gen), scenePosDistr(gen));
+		bvhAABBs.emplace_back(pos, sizeDistr(gen), sizeDistr(gen), sizeDistr(gen));
+	}
+	BVH bvh;
+	DynArray<uint32_t> bvhResult;
+	suite.run("BVH build 64k", NUM_BVH_PRIMITIVES, [&]() {
+		bvh.build(bvhAABBs.data(), NUM_BVH_PRIMITIVES);
+		doNotOptimize(bvh.nodes().data());
+	});
+	suite.run("BVH build 64k (4 threads)", NUM_BVH_PRIMITIVES, [&]() {
+		bvh.build(bvhAABBs.data(), NUM_BVH_PRIMITIVES, 4);
+		doNotOptimize(bvh.nodes().data());
+	});
+	suite.run("BVH refit 64k", NUM_BVH_PRIMITIVES, [&]() {
+		bvh.refit(bvhAABBs.data());
+		doNotOptimize(bvh.nodes().data());
+	});
+	suite.run("BVH queryFrustum 64k", NUM_BVH_PRIMITIVES, [&]() {
+		bvhResult.clear();
+		bvh.queryFrustum(frustum, bvhResult);
+		doNotOptimize(bvhResult.data());
+	});
+	suite.run("Brute force isVisible 64k", NUM_BVH_PRIMITIVES, [&]() {
+		bvhResult.clear();
+		for (uint32_t i = 0; i < NUM_BVH_PRIMITIVES; ++i) {
+			if (frustum.isVisible(bvhAABBs[i])) bvhResult.add(i);
+		}
+		doNotOptimize(bvhResult.data());
+	});
+
+	// Rays
+	std::vector<Ray> rays;
+	rays.reserve(NUM_PRIMITIVES);
+	for (size_t i = 0; i < NUM_PRIMITIVES; ++i) {
+		vec3 origin(posDistr(gen), posDistr(gen), posDistr(gen));
+		vec3 target(posDistr(gen), posDistr(gen), posDistr(gen));
+		rays.emplace_back(origin, normalize(target - origin + vec3(0.01f)), 100.0f);
+	}
+	suite.run("raycast(Ray, AABB)", NUM_PRIMITIVES, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) sum += raycast(rays[i], aabbs[i]);
+		doNotOptimize(sum);
+	});
+	suite.run("raycast(RayPacket8, AABB)", NUM_PRIMITIVES, [&]() {
+		floatx8 sum(0.0f);
+		for (size_t i = 0; i < NUM_PRIMITIVES; i += 8) sum = sum + raycast(RayPacket8(&rays[i]), aabbs[i]);
+		doNotOptimize(sum);
+	});
+	suite.run("raycast(Ray, OBB)", NUM_PRIMITIVES, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) sum += raycast(rays[i], obbs[i]);
+		doNotOptimize(sum);
+	});
+	suite.run("raycast(Ray, Sphere)", NUM_PRIMITIVES, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) sum += raycast(rays[i], spheres[i]);
+		doNotOptimize(sum);
+	});
+	suite.run("raycast(Ray, triangle)", NUM_PRIMITIVES, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < NUM_PRIMITIVES; ++i) {
+			sum += raycast(rays[i], aabbs[i].min(), aabbs[i].max(), spheres[i].position());
+		}
+		doNotOptimize(sum);
+	});
+
+	// Triangle mesh (height field) raycasts
+	std::vector<vec3> meshPositions;
+	std::vector<uint32_t> meshIndices;
+	std::uniform_real_distribution<float> heightDistr(-1.0f, 1.0f);
+	for (uint32_t y = 0; y < MESH_GRID_SIZE; ++y) {
+		for (uint32_t x = 0; x < MESH_GRID_SIZE; ++x) {
+			meshPositions.emplace_back(float(x) - 158.0f, heightDistr(gen), float(y) - 158.0f);
+		}
+	}
+	for (uint32_t y = 0; y < MESH_GRID_SIZE - 1; ++y) {
+		for (uint32_t x = 0; x < MESH_GRID_SIZE - 1; ++x) {
+			uint32_t i0 = y * MESH_GRID_SIZE + x;
+			uint32_t i1 = i0 + MESH_GRID_SIZE;
+			meshIndices.insert(meshIndices.end(), { i0, i1, i0 + 1, i0 + 1, i1, i1 + 1 });
+		}
+	}
+	const uint32_t numMeshIndices = uint32_t(meshIndices.size());
+	const uint32_t numMeshTriangles = numMeshIndices / 3;
+	std::vector<Ray> meshRays;
+	std::uniform_real_distribution<float> meshPosDistr(-150.0f, 150.0f);
+	for (uint32_t i = 0; i < NUM_MESH_RAYS; ++i) {
+		vec3 origin(meshPosDistr(gen), 10.0f, meshPosDistr(gen));
+		vec3 target(meshPosDistr(gen), 0.0f, meshPosDistr(gen));
+		meshRays.emplace_back(origin, normalize(target - origin));
+	}
+
+	const uint32_t numMeshVertices = uint32_t(meshPositions.size());
+	suite.run("computeAABB 100k vertices", numMeshVertices, [&]() {
+		doNotOptimize(computeAABB(meshPositions.data(), numMeshVertices));
+	});
+	suite.run("computeBoundingSphere 100k vertices", numMeshVertices, [&]() {
+		doNotOptimize(computeBoundingSphere(meshPositions.data(), numMeshVertices));
+	});
+	suite.run("computePCAOBB 100k vertices", numMeshVertices, [&]() {
+		doNotOptimize(computePCAOBB(meshPositions.data(), numMeshVertices));
+	});
+
+	TriangleBVH triBVH(meshPositions.data(), meshIndices.data(), numMeshIndices);
+	suite.run("TriangleBVH build 200k", numMeshTriangles, [&]() {
+		TriangleBVH tmp(meshPositions.data(), meshIndices.data(), numMeshIndices);
+		doNotOptimize(tmp.bvh().nodes().data());
+	});
+	suite.run("TriangleBVH raycast 200k", NUM_MESH_RAYS, [&]() {
+		float sum = 0.0f;
+		for (const Ray& ray : meshRays) sum += triBVH.raycast(ray).dist;
+		doNotOptimize(sum);
+	});
+	suite.run("Brute force raycast 200k", 1, [&]() {
+		float closest = RAY_MISS;
+		for (uint32_t i = 0; i < numMeshIndices; i += 3) {
+			closest = std::min(closest, raycast(meshRays[0], meshPositions[meshIndices[i]],
+			    meshPositions[meshIndices[i + 1]], meshPositions[meshIndices[i + 2]]));
+		}
+		doNotOptimize(closest);
+	});
+
+	// Mesh optimization, triangles shuffled to mimic an unordered OBJ file
+	std::vector<uint32_t> shuffledTriangles(numMeshTriangles);
+	for (uint32_t i = 0; i < numMeshTriangles; ++i) shuffledTriangles[i] = i;
+	std::shuffle(shuffledTriangles.begin(), shuffledTriangles.end(), gen);
+	std::vector<uint32_t> shuffledIndices;
+	for (uint32_t t : shuffledTriangles) {
+		shuffledIndices.insert(shuffledIndices.end(), meshIndices.begin() + t * 3, meshIndices.begin() + t * 3 + 3);
+	}
+	std::vector<uint32_t> optimizedIndices(numMeshIndices);
+	std::vector<uint32_t> overdrawIndices(numMeshIndices);
+	std::vector<uint32_t> vertexRemap(numMeshVertices);
+	suite.run("analyzeVertexCache 200k", numMeshTriangles, [&]() {
+		doNotOptimize(analyzeVertexCache(shuffledIndices.data(), numMeshIndices, numMeshVertices));
+	});
+	suite.run("optimizeVertexCache 200k", numMeshTriangles, [&]() {
+		optimizeVertexCache(optimizedIndices.data(), shuffledIndices.data(), numMeshIndices, numMeshVertices);
+		doNotOptimize(optimizedIndices.data());
+	});
+	suite.run("optimizeOverdraw 200k", numMeshTriangles, [&]() {
+		optimizeOverdraw(overdrawIndices.data(), optimizedIndices.data(), numMeshIndices,
+		    meshPositions.data(), numMeshVertices);
+		doNotOptimize(overdrawIndices.data());
+	});
+	suite.run("optimizeVertexFetch 200k", numMeshTriangles, [&]() {
+		std::vector<uint32_t> tmp = overdrawIndices;
+		doNotOptimize(optimizeVertexFetch(vertexRemap.data(), tmp.data(), numMeshIndices, numMeshVertices));
+	});
+	std::vector<uint32_t> simplifiedIndices(numMeshIndices);
+	suite.run("simplifyMesh 200k to 50%", numMeshTriangles, [&]() {
+		doNotOptimize(simplifyMesh(simplifiedIndices.data(), meshIndices.data(), numMeshIndices,
+		    meshPositions.data(), numMeshVertices, sizeof(vec3), numMeshIndices / 6 * 3));
+	});
+	suite.run("simplifyMesh 200k to 10%", numMeshTriangles, [&]() {
+		doNotOptimize(simplifyMesh(simplifiedIndices.data(), meshIndices.data(), numMeshIndices,
+		    meshPositions.data(), numMeshVertices, sizeof(vec3), numMeshIndices / 30 * 3));
+	});
+
+	// Broadphase, objects moving slightly each frame
+	std::vector<AABB> bpAABBs;
+	std::vector<vec3> bpVelocities;
+	std::uniform_real_distribution<float> bpPosDistr(-40.0f, 40.0f);
+	std::uniform_real_distribution<float> bpSizeDistr(0.2f, 2.0f);
+	std::uniform_real_distribution<float> bpVelDistr(-0.05f, 0.05f);
+	for (uint32_t i = 0; i < NUM_BROADPHASE_OBJECTS; ++i) {
+		vec3 pos(bpPosDistr(gen), bpPosDistr(gen), bpPosDistr(gen));
+		bpAABBs.emplace_back(pos, bpSizeDistr(gen), bpSizeDistr(gen), bpSizeDistr(gen));
+		bpVelocities.emplace_back(bpVelDistr(gen), bpVelDistr(gen), bpVelDistr(gen));
+	}
+	auto moveObjects = [&]() {
+		for (uint32_t i = 0; i < NUM_BROADPHASE_OBJECTS; ++i) {
+			bpAABBs[i] = AABB(bpAABBs[i].min() + bpVelocities[i], bpAABBs[i].max() + bpVelocities[i]);
+		}
+	};
+	DynArray<BroadphasePair> bpPairs;
+
+	SweepAndPrune sap;
+	for (const AABB& aabb : bpAABBs) sap.add(aabb);
+	suite.run("SweepAndPrune update + findPairs 4k", NUM_BROADPHASE_OBJECTS, [&]() {
+		moveObjects();
+		for (uint32_t i = 0; i < NUM_BROADPHASE_OBJECTS; ++i) sap.update(i, bpAABBs[i]);
+		bpPairs.clear();
+		sap.findPairs(bpPairs);
+		doNotOptimize(bpPairs.data());
+	});
+
+	HashGrid grid(2.0f);
+	for (const AABB& aabb : bpAABBs) grid.add(aabb);
+	suite.run("HashGrid update + findPairs 4k", NUM_BROADPHASE_OBJECTS, [&]() {
+		moveObjects();
+		for (uint32_t i = 0; i < NUM_BROADPHASE_OBJECTS; ++i) grid.update(i, bpAABBs[i]);
+		bpPairs.clear();
+		grid.findPairs(bpPairs);
+		doNotOptimize(bpPairs.data());
+	});
+
+	suite.run("Brute force pairs 4k", NUM_BROADPHASE_OBJECTS, [&]() {
+		moveObjects();
+		bpPairs.clear();
+		for (uint32_t i = 0; i < NUM_BROADPHASE_OBJECTS; ++i) {
+			for (uint32_t j = i + 1; j < NUM_BROADPHASE_OBJECTS; ++j) {
+				if (intersects(bpAABBs[i], bpAABBs[j])) bpPairs.add(BroadphasePair{i, j});
+			}
+		}
+		doNotOptimize(bpPairs.data());
+	});
+
+	// Loose octree, 100k objects moving every frame
+	std::vector<AABB> octAABBs;
+	std::vector<vec3> octVelocities;
+	std::uniform_real_distribution<float> octVelDistr(-0.2f, 0.2f);
+	for (uint32_t i = 0; i < NUM_OCTREE_OBJECTS; ++i) {
+		vec3 pos(scenePosDistr(gen), scenePosDistr(gen), scenePosDistr(gen));
+		octAABBs.emplace_back(pos, sizeDistr(gen), sizeDistr(gen), sizeDistr(gen));
+		octVelocities.emplace_back(octVelDistr(gen), octVelDistr(gen), octVelDistr(gen));
+	}
+	const ViewFrustum octFrustum(vec3(0.0f, 0.0f, -250.0f), vec3(0.0f, 0.0f, 1.0f),
+	                             vec3(0.0f, 1.0f, 0.0f), 60.0f, 1.0f, 0.1f, 300.0f);
+	LooseOctree octree(AABB(vec3(-200.0f), vec3(200.0f)), 5); // 12.5 units smallest cells
+	std::vector<uint32_t> octHandles;
+	for (const AABB& aabb : octAABBs) octHandles.push_back(octree.insert(aabb));
+	BVH octBVH(octAABBs.data(), NUM_OCTREE_OBJECTS);
+	DynArray<uint32_t> octResult;
+
+	suite.run("LooseOctree move 100k", NUM_OCTREE_OBJECTS, [&]() {
+		for (uint32_t i = 0; i < NUM_OCTREE_OBJECTS; ++i) {
+			octAABBs[i] = AABB(octAABBs[i].min() + octVelocities[i], octAABBs[i].max() + octVelocities[i]);
+			octree.move(octHandles[i], octAABBs[i]);
+		}
+		doNotOptimize(octAABBs.data());
+	});
+	suite.run("LooseOctree queryFrustum 100k", NUM_OCTREE_OBJECTS, [&]() {
+		octResult.clear();
+		octree.queryFrustum(octFrustum, octResult);
+		doNotOptimize(octResult.data());
+	});
+	suite.run("BVH refit + queryFrustum 100k", NUM_OCTREE_OBJECTS, [&]() {
+		octBVH.refit(octAABBs.data());
+		octResult.clear();
+		octBVH.queryFrustum(octFrustum, octResult);
+		doNotOptimize(octResult.data());
+	});
+	suite.run("Brute force isVisible 100k", NUM_OCTREE_OBJECTS, [&]() {
+		octResult.clear();
+		for (uint32_t i = 0; i < NUM_OCTREE_OBJECTS; ++i) {
+			if (octFrustum.isVisible(octAABBs[i])) octResult.add(i);
+		}
+		doNotOptimize(octResult.data());
+	});
+
+	// Software occlusion culling, a grid of buildings seen from street level
+	std::vector<vec3> occPositions;
+	std::vector<uint32_t> occIndices;
+	const uint32_t boxIndices[36] = { 0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+	                                  2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3 };
+	std::uniform_real_distribution<float> buildingHeightDistr(10.0f, 40.0f);
+	for (uint32_t x = 0; x < OCCLUDER_GRID_SIZE; ++x) {
+		for (uint32_t z = 0; z < OCCLUDER_GRID_SIZE; ++z) {
+			const vec3 min(float(x) * 20.0f - 80.0f, 0.0f, -float(z) * 20.0f - 10.0f);
+			const vec3 max = min + vec3(14.0f, buildingHeightDistr(gen), -14.0f);
+			const uint32_t base = uint32_t(occPositions.size());
+			for (uint32_t i = 0; i < 8; ++i) {
+				occPositions.emplace_back((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+			}
+			for (uint32_t index : boxIndices) occIndices.push_back(base + index);
+		}
+	}
+	std::vector<AABB> occObjects;
+	std::uniform_real_distribution<float> occXDistr(-80.0f, 80.0f);
+	std::uniform_real_distribution<float> occZDistr(-170.0f, -5.0f);
+	std::uniform_real_distribution<float> occSizeDistr(0.5f, 2.0f);
+	for (uint32_t i = 0; i < NUM_OCCLUSION_OBJECTS; ++i) {
+		const vec3 min(occXDistr(gen), 0.0f, occZDistr(gen));
+		occObjects.emplace_back(min, min + vec3(occSizeDistr(gen)));
+	}
+	const mat4 occViewProj = perspectiveProjectionMatrix(90.0f, 2.0f, 0.5f, 500.0f)
+	                       * lookAt(vec3(-3.0f, 1.8f, 0.0f), vec3(-3.0f, 1.8f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+	const uint32_t numOccTriangles = uint32_t(occIndices.size() / 3);
+	OcclusionBuffer occBuffer(256, 128);
+	const uint32_t numOccMaskWords = (NUM_OCCLUSION_OBJECTS + 31) / 32;
+	DynArray<uint32_t> occMask(numOccMaskWords, 0u, numOccMaskWords);
+
+	suite.run("OcclusionBuffer rasterize 768 tris 256x128", numOccTriangles, [&]() {
+		occBuffer.clear();
+		occBuffer.addOccluder(occViewProj, occPositions.data(), occIndices.data(), uint32_t(occIndices.size()));
+		occBuffer.rasterize();
+		doNotOptimize(occBuffer.depth(0, 0));
+	});
+	occBuffer.clear();
+	occBuffer.addOccluder(occViewProj, occPositions.data(), occIndices.data(), uint32_t(occIndices.size()));
+	occBuffer.rasterize();
+	suite.run("OcclusionBuffer testAABBs 10k", NUM_OCCLUSION_OBJECTS, [&]() {
+		occBuffer.testAABBs(occViewProj, occObjects.data(), NUM_OCCLUSION_OBJECTS, occMask.data());
+		doNotOptimize(occMask.data());
+	});
+
+	// GJK & EPA, pairs of OBBs moving slightly between frames
+	std::vector<OBB> gjkBoxesA, gjkBoxesB;
+	std::uniform_real_distribution<float> gjkOffsetDistr(-4.0f, 4.0f);
+	for (uint32_t i = 0; i < NUM_GJK_PAIRS; ++i) {
+		const mat3 rotA = rotationMatrix3(normalize(vec3(posDistr(gen), posDistr(gen), posDistr(gen))), angleDistr(gen));
+		const mat3 rotB = rotationMatrix3(normalize(vec3(posDistr(gen), posDistr(gen), posDistr(gen))), angleDistr(gen));
+		const vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+		gjkBoxesA.emplace_back(pos, rotA.columnAt(0), rotA.columnAt(1), rotA.columnAt(2), vec3(sizeDistr(gen)));
+		gjkBoxesB.emplace_back(pos + vec3(gjkOffsetDistr(gen), gjkOffsetDistr(gen), gjkOffsetDistr(gen)),
+		                       rotB.columnAt(0), rotB.columnAt(1), rotB.columnAt(2), vec3(sizeDistr(gen)));
+	}
+	std::vector<GJKSimplex> gjkSimplices(NUM_GJK_PAIRS);
+	auto runGJKFrames = [&](bool warmStart) {
+		float sum = 0.0f;
+		for (uint32_t frame = 0; frame < NUM_GJK_FRAMES; ++frame) {
+			const vec3 offset = vec3(0.01f, -0.02f, 0.01f) * float(frame);
+			for (uint32_t i = 0; i < NUM_GJK_PAIRS; ++i) {
+				OBB movedB = gjkBoxesB[i];
+				movedB.position(movedB.position() + offset);
+				if (!warmStart) gjkSimplices[i].size = 0;
+				sum += gjkDistance(OBBShape(gjkBoxesA[i]), OBBShape(movedB), gjkSimplices[i]).distance;
+			}
+		}
+		doNotOptimize(sum);
+	};
+	suite.run("GJK distance OBB-OBB 1k cold", NUM_GJK_PAIRS * NUM_GJK_FRAMES, [&]() { runGJKFrames(false); });
+	suite.run("GJK distance OBB-OBB 1k warm", NUM_GJK_PAIRS * NUM_GJK_FRAMES, [&]() { runGJKFrames(true); });
+	suite.run("SAT intersects OBB-OBB 1k", NUM_GJK_PAIRS, [&]() {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < NUM_GJK_PAIRS; ++i) count += intersects(gjkBoxesA[i], gjkBoxesB[i]) ? 1 : 0;
+		doNotOptimize(count);
+	});
+	suite.run("GJK + EPA OBB-OBB 1k", NUM_GJK_PAIRS, [&]() {
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < NUM_GJK_PAIRS; ++i) {
+			const OBBShape shapeA(gjkBoxesA[i]), shapeB(gjkBoxesB[i]);
+			GJKSimplex simplex;
+			if (gjkIntersects(shapeA, shapeB, simplex)) sum += epaPenetration(shapeA, shapeB, simplex).depth;
+		}
+		doNotOptimize(sum);
+	});
+
+	// Convex hulls of a controller sized blob of 5k points, and GJK against the point cloud
+	// versus a 32 vertex hull
+	std::vector<vec3> hullPoints;
+	std::normal_distribution<float> hullDistr(0.0f, 1.0f);
+	for (uint32_t i = 0; i < NUM_HULL_POINTS; ++i) {
+		const vec3 dir = normalize(vec3(hullDistr(gen), hullDistr(gen), hullDistr(gen)));
+		hullPoints.push_back(dir * vec3(0.05f, 0.03f, 0.12f) * (0.8f + 0.2f * std::abs(hullDistr(gen))));
+	}
+	ConvexHull fullHull, reducedHull;
+	suite.run("computeConvexHull 5k points", 1, [&]() {
+		fullHull = computeConvexHull(hullPoints.data(), NUM_HULL_POINTS);
+		doNotOptimize(fullHull.vertices.data());
+	});
+	suite.run("computeConvexHull 5k points max 32", 1, [&]() {
+		reducedHull = computeConvexHull(hullPoints.data(), NUM_HULL_POINTS, sizeof(vec3), 32);
+		doNotOptimize(reducedHull.vertices.data());
+	});
+	reducedHull = computeConvexHull(hullPoints.data(), NUM_HULL_POINTS, sizeof(vec3), 32);
+	const Sphere hullProbe(vec3(0.1f, 0.05f, 0.0f), 0.04f);
+	suite.run("GJK distance 5k point cloud", 1, [&]() {
+		GJKSimplex simplex;
+		doNotOptimize(gjkDistance(ConvexHullShape(hullPoints.data(), NUM_HULL_POINTS), SphereShape(hullProbe), simplex));
+	});
+	suite.run("GJK distance 32 vertex hull", 1, [&]() {
+		GJKSimplex simplex;
+		doNotOptimize(gjkDistance(ConvexHullShape(reducedHull.vertices.data(), reducedHull.vertices.size()),
+		                          SphereShape(hullProbe), simplex));
+	});
+
+	// Controller hull swung 30 cm with a 20 degree turn per frame, down into the height field mesh
+	// and against a static hull
+	const ConvexHullShape controllerShape(reducedHull.vertices.data(), reducedHull.vertices.size());
+	std::vector<mat4> sweepFrom, sweepTo;
+	std::uniform_real_distribution<float> sweepPosDistr(-100.0f, 100.0f);
+	for (uint32_t i = 0; i < NUM_SWEEPS; ++i) {
+		const vec3 start(sweepPosDistr(gen), 1.2f, sweepPosDistr(gen));
+		const mat4 rot = rotationMatrix4(normalize(vec3(1.0f, 1.0f, 0.0f)), angleDistr(gen));
+		sweepFrom.push_back(translationMatrix(start) * rot);
+		sweepTo.push_back(translationMatrix(start + vec3(0.1f, -0.28f, 0.05f))
+		                  * rotationMatrix4(vec3(0.0f, 1.0f, 0.0f), 0.35f) * rot);
+	}
+	suite.run("TriangleBVH sweep 32 vertex hull", NUM_SWEEPS, [&]() {
+		uint32_t numHits = 0;
+		for (uint32_t i = 0; i < NUM_SWEEPS; ++i) {
+			if (triBVH.sweep(SweptShape(controllerShape, sweepFrom[i], sweepTo[i])).isHit()) numHits++;
+		}
+		doNotOptimize(numHits);
+	});
+	const OBBShape sweepTarget(OBB(AABB(vec3(-0.2f, 0.8f, -0.2f), vec3(0.2f, 1.0f, 0.2f))));
+	suite.run("sweep 32 vertex hull vs OBB", NUM_SWEEPS, [&]() {
+		uint32_t numHits = 0;
+		for (uint32_t i = 0; i < NUM_SWEEPS; ++i) {
+			const mat4 offset = translationMatrix(-translation(sweepFrom[i]));
+			if (sweep(controllerShape, offset * sweepFrom[i], offset * sweepTo[i], sweepTarget).isHit()) numHits++;
+		}
+		doNotOptimize(numHits);
+	});
+}
+
+} // namespace sfz
@@ -0,0 +1,223 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/Benchmark.hpp"
+
+#include <cmath>
+#include <random>
+
+#include "sfz/math/FastMath.hpp"
+#include "sfz/math/Matrix.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+#include "sfz/math/Vector.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const size_t NUM_ELEMENTS = 4096;
+
+static std::vector<vec3> randomVec3s(std::mt19937& gen, size_t count) noexcept
+{
+	std::uniform_real_distribution<float> distr(-100.0f, 100.0f);
+	std::vector<vec3> vecs(count);
+	for (vec3& v : vecs) v = vec3(distr(gen), distr(gen), distr(gen));
+	return vecs;
+}
+
+static std::vector<mat4> randomTransforms(std::mt19937& gen, size_t count) noexcept
+{
+	std::uniform_real_distribution<float> distr(-10.0f, 10.0f);
+	std::vector<mat4> mats(count);
+	for (mat4& m : mats) {
+		vec3 axis = normalize(vec3(distr(gen), distr(gen), distr(gen)) + vec3(0.0f, 0.0f, 20.0f));
+		m = translationMatrix(vec3(distr(gen), distr(gen), distr(gen)))
+		  * rotationMatrix4(axis, distr(gen))
+		  * scalingMatrix4(1.0f + std::abs(distr(gen)));
+	}
+	return mats;
+}
+
+// Math benchmarks
+// ------------------------------------------------------------------------------------------------
+
+void runMathBenchmarks(BenchmarkSuite& suite) noexcept
+{
+	std::mt19937 gen(42);
+	const std::vector<vec3> as = randomVec3s(gen, NUM_ELEMENTS);
+	const std::vector<vec3> bs = randomVec3s(gen, NUM_ELEMENTS);
+	const std::vector<mat4> mats = randomTransforms(gen, NUM_ELEMENTS);
+	std::vector<float> floatsOut(NUM_ELEMENTS);
+	std::vector<vec3> vecsOut(NUM_ELEMENTS);
+	std::vector<mat4> matsOut(NUM_ELEMENTS);
+
+	// Vector ops
+	suite.run("vec3 add", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) vecsOut[i] = as[i] + bs[i];
+		clobberMemory();
+	});
+	suite.run("vec3 dot", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = dot(as[i], bs[i]);
+		clobberMemory();
+	});
+	suite.run("vec3 cross", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) vecsOut[i] = cross(as[i], bs[i]);
+		clobberMemory();
+	});
+	suite.run("vec3 length", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = length(as[i]);
+		clobberMemory();
+	});
+	suite.run("vec3 normalize", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) vecsOut[i] = normalize(as[i]);
+		clobberMemory();
+	});
+	suite.run("vec3 fastNormalize", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) vecsOut[i] = fastNormalize(as[i]);
+		clobberMemory();
+	});
+
+	// Scalar functions
+	std::vector<float> positives(NUM_ELEMENTS), angles(NUM_ELEMENTS), exponents(NUM_ELEMENTS);
+	for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+		positives[i] = std::abs(as[i][0]) + 0.001f;
+		angles[i] = as[i][0];
+		exponents[i] = 0.5f * as[i][0];
+	}
+	suite.run("1 / std::sqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = 1.0f / std::sqrt(positives[i]);
+		clobberMemory();
+	});
+	suite.run("fastRsqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastRsqrt(positives[i]);
+		clobberMemory();
+	});
+	suite.run("std::sqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = std::sqrt(positives[i]);
+		clobberMemory();
+	});
+	suite.run("fastSqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastSqrt(positives[i]);
+		clobberMemory();
+	});
+	suite.run("std::sin", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = std::sin(angles[i]);
+		clobberMemory();
+	});
+	suite.run("fastSin", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastSin(angles[i]);
+		clobberMemory();
+	});
+	suite.run("std::cos", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = std::cos(angles[i]);
+		clobberMemory();
+	});
+	suite.run("fastCos", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastCos(angles[i]);
+		clobberMemory();
+	});
+	suite.run("std::atan2", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = std::atan2(as[i][1], as[i][0]);
+		clobberMemory();
+	});
+	suite.run("fastAtan2", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastAtan2(as[i][1], as[i][0]);
+		clobberMemory();
+	});
+	suite.run("std::exp", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = std::exp(exponents[i]);
+		clobberMemory();
+	});
+	suite.run("fastExp", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) floatsOut[i] = fastExp(exponents[i]);
+		clobberMemory();
+	});
+
+	// Packet functions, 8 elements per iteration
+	std::vector<floatx8> packetsOut(NUM_ELEMENTS / 8);
+	std::vector<vec3x8> vecPacketsOut(NUM_ELEMENTS / 8);
+	suite.run("floatx8 fastRsqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) packetsOut[i / 8] = fastRsqrt(floatx8(&positives[i]));
+		clobberMemory();
+	});
+	suite.run("floatx8 fastSqrt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) packetsOut[i / 8] = fastSqrt(floatx8(&positives[i]));
+		clobberMemory();
+	});
+	suite.run("floatx8 fastSin", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) packetsOut[i / 8] = fastSin(floatx8(&angles[i]));
+		clobberMemory();
+	});
+	suite.run("floatx8 fastCos", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) packetsOut[i / 8] = fastCos(floatx8(&angles[i]));
+		clobberMemory();
+	});
+	suite.run("floatx8 fastAtan2", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) {
+			packetsOut[i / 8] = fastAtan2(floatx8(&exponents[i]), floatx8(&angles[i]));
+		}
+		clobberMemory();
+	});
+	suite.run("floatx8 fastExp", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) packetsOut[i / 8] = fastExp(floatx8(&exponents[i]));
+		clobberMemory();
+	});
+	suite.run("vec3x8 normalize", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) {
+			vec3x8 v = loadAoS<8>(&as[i]);
+			vecPacketsOut[i / 8] = v * (floatx8(1.0f) / length(v));
+		}
+		clobberMemory();
+	});
+	suite.run("vec3x8 fastNormalize", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; i += 8) vecPacketsOut[i / 8] = fastNormalize(loadAoS<8>(&as[i]));
+		clobberMemory();
+	});
+
+	// Matrix ops
+	suite.run("mat4 multiply", NUM_ELEMENTS - 1, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS - 1; ++i) matsOut[i] = mats[i] * mats[i + 1];
+		clobberMemory();
+	});
+	suite.run("mat4 inverse", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) matsOut[i] = inverse(mats[i]);
+		clobberMemory();
+	});
+	suite.run("transformPoint", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) vecsOut[i] = transformPoint(mats[i], as[i]);
+		clobberMemory();
+	});
+	suite.run("lookAt", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+			matsOut[i] = lookAt(as[i], bs[i], vec3(0.0f, 1.0f, 0.0f));
+		}
+		clobberMemory();
+	});
+	suite.run("perspectiveProjectionMatrix", NUM_ELEMENTS, [&]() {
+		for (size_t i = 0; i < NUM_ELEMENTS; ++i) {
+			float fov = 45.0f + std::abs(as[i][0]) * 0.5f;
+			matsOut[i] = perspectiveProjectionMatrix(fov, 16.0f / 9.0f, 0.1f, 100.0f);
+		}
+		clobberMemory();
+	});
+}
+
+} // namespace sfz
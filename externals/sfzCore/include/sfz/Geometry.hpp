@@ -20,9 +20,21 @@
 
 #include "sfz/geometry/AABB.hpp"
 #include "sfz/geometry/AABB2D.hpp"
+#include "sfz/geometry/BVH.hpp"
+#include "sfz/geometry/BatchIntersection.hpp"
+#include "sfz/geometry/BoundingVolumes.hpp"
+#include "sfz/geometry/Broadphase.hpp"
 #include "sfz/geometry/Circle.hpp"
+#include "sfz/geometry/ConvexHull.hpp"
+#include "sfz/geometry/ConvexShape.hpp"
+#include "sfz/geometry/GJK.hpp"
 #include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/LooseOctree.hpp"
 #include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/OcclusionBuffer.hpp"
 #include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Ray.hpp"
 #include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/Sweep.hpp"
+#include "sfz/geometry/TriangleBVH.hpp"
 #include "sfz/geometry/ViewFrustum.hpp"
@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include "sfz/math/FastMath.hpp"
 #include "sfz/math/MathConstants.hpp"
 #include "sfz/math/MathHelpers.hpp"
 #include "sfz/math/Matrix.hpp"
 #include "sfz/math/MatrixSupport.hpp"
+#include "sfz/math/PackedVector.hpp"
 #include "sfz/math/Vector.hpp"
+#include "sfz/math/VectorPacket.hpp"
@@ -238,7 +238,7 @@ void DynArray<T, Allocator>::remove(uint32_t position, uint32_t numElements) noe
 
 	// Move elements back
 	uint32_t numElementsToMove = mSize - position - numElementsToRemove;
-	std::memmove(mDataPtr + position, mDataPtr + position + numElementsToRemove, numElementsToMove);
+	std::memmove(mDataPtr + position, mDataPtr + position + numElementsToRemove, numElementsToMove * sizeof(T));
 
 	mSize -= numElementsToRemove;
 }
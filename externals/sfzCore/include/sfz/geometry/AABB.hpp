@@ -19,9 +19,11 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 #include <functional> // std::hash
 
 #include "sfz/Assert.hpp"
+#include "sfz/math/Matrix.hpp"
 #include "sfz/math/Vector.hpp"
 
 namespace sfz {
@@ -46,6 +48,10 @@ public:
 	inline void corners(vec3* arrayOut) const noexcept;
 	inline vec3 closestPoint(const vec3& point) const noexcept;
 
+	/// Returns the AABB enclosing this AABB transformed by the (affine) matrix. Uses the
+	/// absolute values of the matrix (Arvo), so no corners need to be transformed.
+	inline AABB transformAABB(const mat4& transform) const noexcept;
+
 	inline size_t hash() const noexcept;
 
 	// Public getters
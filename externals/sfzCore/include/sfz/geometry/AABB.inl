@@ -75,6 +75,19 @@ inline void AABB::corners(vec3* arrayOut) const noexcept
 	arrayOut[7] = mMax; // Front-top-right
 }
 
+inline AABB AABB::transformAABB(const mat4& transform) const noexcept
+{
+	const vec3 center = transformPoint(transform, position());
+	const vec3 halfExt = halfExtents();
+	vec3 newHalfExt;
+	for (size_t i = 0; i < 3; i++) {
+		newHalfExt[i] = std::abs(transform.at(i, 0)) * halfExt[0]
+		              + std::abs(transform.at(i, 1)) * halfExt[1]
+		              + std::abs(transform.at(i, 2)) * halfExt[2];
+	}
+	return AABB{center - newHalfExt, center + newHalfExt};
+}
+
 inline vec3 AABB::closestPoint(const vec3& point) const noexcept
 {
 	vec3 res = point;
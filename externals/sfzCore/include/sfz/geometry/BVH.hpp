@@ -0,0 +1,164 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+class Sphere;
+class ViewFrustum;
+
+// BVHNode
+// ------------------------------------------------------------------------------------------------
+
+/// A four-wide BVH node. The bounds of the four children are stored as SoA arrays so that all
+/// four can be tested at once. A child slot is either an inner node (count == 0, child is the
+/// index of the node), a leaf (count > 0, child is the index of the first primitive in the leaf)
+/// or empty (count == 0 and child == BVH_INVALID_INDEX). Empty slots have inverted bounds.
+struct BVHNode final {
+	float minX[4], minY[4], minZ[4];
+	float maxX[4], maxY[4], maxZ[4];
+	uint32_t children[4];
+	uint32_t counts[4];
+
+	inline bool isEmpty(uint32_t slot) const noexcept { return counts[slot] == 0 && children[slot] == ~0u; }
+	inline bool isLeaf(uint32_t slot) const noexcept { return counts[slot] != 0; }
+	inline bool isInner(uint32_t slot) const noexcept { return counts[slot] == 0 && children[slot] != ~0u; }
+};
+
+static_assert(sizeof(BVHNode) == 128, "BVHNode is padded");
+
+constexpr uint32_t BVH_INVALID_INDEX = ~0u;
+
+// BVH
+// ------------------------------------------------------------------------------------------------
+
+/// A bounding volume hierarchy over an array of AABBs, built using a binned SAH.
+///
+/// Primitives are referred to by their index in the array the BVH was built from. The nodes are
+/// stored in depth-first order with the root at index 0, every child node having a higher index
+/// than its parent. This allows refit() to be a single reverse pass over the nodes. The BVH keeps
+/// its own copy of the primitive bounds (in leaf order), so queries are exact and do not need
+/// access to the original array.
+class BVH final {
+public:
+	// Constants
+	// --------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t MAX_LEAF_SIZE = 4;
+	static constexpr uint32_t NUM_BINS = 16;
+
+	/// Size of the traversal stacks used by the queries. The build bounds the depth of the tree
+	/// (SAH levels followed by median split levels) so that this is never exceeded.
+	static constexpr uint32_t TRAVERSAL_STACK_SIZE = 256;
+
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	BVH() noexcept = default;
+	BVH(const BVH&) noexcept = default;
+	BVH& operator= (const BVH&) noexcept = default;
+	BVH(BVH&&) noexcept = default;
+	BVH& operator= (BVH&&) noexcept = default;
+
+	BVH(const AABB* aabbs, uint32_t numAABBs, uint32_t numThreads = 1) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Builds the BVH from the specified AABBs. If numThreads > 1 the (up to 4) subtrees of the
+	/// root are built in parallel, larger numbers of threads than 4 will not be used.
+	void build(const AABB* aabbs, uint32_t numAABBs, uint32_t numThreads = 1) noexcept;
+
+	/// Updates the bounds of all nodes after primitives have moved, keeping the tree topology.
+	/// aabbs must contain the same number of primitives (with the same indices) as when built.
+	/// Quality degrades if objects move far from where they were at build time, rebuild then.
+	void refit(const AABB* aabbs) noexcept;
+
+	/// Restores a BVH from the nodes() and primitiveIndices() of a BVH previously built from the
+	/// same AABBs (e.g. stored in a file), which is much faster than building it. The node bounds
+	/// are recomputed from the AABBs. Returns false and leaves the BVH empty if the nodes are not a
+	/// valid tree (as produced by build()) over all numAABBs primitives.
+	bool restore(const AABB* aabbs, uint32_t numAABBs, const BVHNode* nodes, uint32_t numNodes,
+	             const uint32_t* primitiveIndices) noexcept;
+
+	/// Appends the indices of all primitives visible in the frustum (as defined by
+	/// ViewFrustum::isVisible()) to resultOut. Planes a node is completely inside of are not
+	/// tested again for its children.
+	void queryFrustum(const ViewFrustum& frustum, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the indices of all primitives intersecting the AABB to resultOut
+	void queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the indices of all primitives intersecting the sphere to resultOut
+	void queryOverlap(const Sphere& sphere, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the indices of all primitives whose AABB is hit by the ray to resultOut. The order
+	/// of the indices is unspecified.
+	void queryRay(const Ray& ray, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Finds the closest hit along the ray, visiting nodes front to back and skipping nodes further
+	/// away than the closest hit found so far. leafRaycast is called for each leaf hit by the ray
+	/// as leafRaycast(uint32_t first, uint32_t count, float maxDist) -> float, where [first,
+	/// first + count) is a range in primitiveIndices() (leaf order). It should return the distance
+	/// to the closest primitive hit within maxDist in the range, or RAY_MISS. Returns the distance
+	/// to the closest hit or RAY_MISS.
+	template<typename LeafRaycastFunc>
+	float raycastClosest(const Ray& ray, LeafRaycastFunc&& leafRaycast) const noexcept;
+
+	/// Calls leafFunc(uint32_t first, uint32_t count) for each leaf whose bounds intersect the AABB,
+	/// where [first, first + count) is a range in primitiveIndices() (leaf order). Used by queries
+	/// that store primitive data in leaf order, see TriangleBVH.
+	template<typename LeafFunc>
+	void forEachLeafOverlapping(const AABB& aabb, LeafFunc&& leafFunc) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline uint32_t numPrimitives() const noexcept { return mPrimIndices.size(); }
+	inline const DynArray<BVHNode>& nodes() const noexcept { return mNodes; }
+
+	/// The primitive indices in leaf order, leaves refer to ranges in this array
+	inline const DynArray<uint32_t>& primitiveIndices() const noexcept { return mPrimIndices; }
+
+	/// The primitive bounds in leaf order, i.e. primitiveBounds()[i] is the bounds of primitive
+	/// primitiveIndices()[i]
+	inline const DynArray<AABB>& primitiveBounds() const noexcept { return mPrimBounds; }
+
+private:
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	DynArray<BVHNode> mNodes;
+	DynArray<uint32_t> mPrimIndices;
+	DynArray<AABB> mPrimBounds;
+};
+
+} // namespace sfz
+
+#include "sfz/geometry/BVH.inl"
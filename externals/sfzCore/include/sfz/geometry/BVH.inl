@@ -0,0 +1,142 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+namespace sfz {
+
+namespace detail {
+
+/// Slab test of one ray (broadcast to all lanes) against the four child bounds of a node,
+/// returns the entry distance for each slot or RAY_MISS. Empty slots always miss.
+inline floatx4 raycastNodeSlots(const RayPacket<4>& rays, const BVHNode& node) noexcept
+{
+	const vec3x4 nodeMin = loadSoA<4>(node.minX, node.minY, node.minZ);
+	const vec3x4 nodeMax = loadSoA<4>(node.maxX, node.maxY, node.maxZ);
+	const vec3x4 t1 = (nodeMin - rays.origin) * rays.invDir;
+	const vec3x4 t2 = (nodeMax - rays.origin) * rays.invDir;
+	const vec3x4 tMins = min(t1, t2);
+	const vec3x4 tMaxs = max(t1, t2);
+	const floatx4 tMin = max(max(tMins.x, tMins.y), max(tMins.z, floatx4(0.0f)));
+	const floatx4 tMax = min(min(tMaxs.x, tMaxs.y), min(tMaxs.z, rays.maxDist));
+	LaneMask hits = lessThanEqual(tMin, tMax);
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		if (node.isEmpty(slot)) hits &= ~(1u << slot);
+	}
+	return select(hits, tMin, floatx4(RAY_MISS));
+}
+
+} // namespace detail
+
+// BVH: Public methods
+// ------------------------------------------------------------------------------------------------
+
+template<typename LeafRaycastFunc>
+float BVH::raycastClosest(const Ray& ray, LeafRaycastFunc&& leafRaycast) const noexcept
+{
+	if (mNodes.size() == 0) return RAY_MISS;
+
+	struct StackEntry final {
+		uint32_t nodeIndex;
+		float dist;
+	};
+	StackEntry stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = StackEntry{0, 0.0f};
+
+	RayPacket<4> rays(ray);
+	float closest = ray.maxDist();
+	bool found = false;
+
+	while (stackSize > 0) {
+		const StackEntry entry = stack[--stackSize];
+		if (entry.dist > closest) continue;
+		const BVHNode& node = mNodes[entry.nodeIndex];
+
+		rays.maxDist = floatx4(closest);
+		const floatx4 dists = detail::raycastNodeSlots(rays, node);
+
+		// Sort the hit slots by entry distance, closest first
+		uint32_t order[4];
+		uint32_t numHits = 0;
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if (dists[slot] == RAY_MISS) continue;
+			uint32_t i = numHits++;
+			while (i > 0 && dists[order[i - 1]] > dists[slot]) {
+				order[i] = order[i - 1];
+				i--;
+			}
+			order[i] = slot;
+		}
+
+		// Leaves are tested directly (closest first), inner nodes are pushed furthest first so that
+		// the closest is popped next
+		for (uint32_t i = 0; i < numHits; i++) {
+			const uint32_t slot = order[i];
+			if (!node.isLeaf(slot) || dists[slot] > closest) continue;
+			float dist = leafRaycast(node.children[slot], node.counts[slot], closest);
+			if (dist != RAY_MISS && dist <= closest) {
+				closest = dist;
+				found = true;
+			}
+		}
+		for (uint32_t i = numHits; i > 0; i--) {
+			const uint32_t slot = order[i - 1];
+			if (!node.isInner(slot) || dists[slot] > closest) continue;
+			sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+			stack[stackSize++] = StackEntry{node.children[slot], dists[slot]};
+		}
+	}
+
+	return found ? closest : RAY_MISS;
+}
+
+template<typename LeafFunc>
+void BVH::forEachLeafOverlapping(const AABB& aabb, LeafFunc&& leafFunc) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const vec3x4 queryMin(aabb.min());
+	const vec3x4 queryMax(aabb.max());
+
+	uint32_t stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const BVHNode& node = mNodes[stack[--stackSize]];
+
+		const vec3x4 nodeMin = loadSoA<4>(node.minX, node.minY, node.minZ);
+		const vec3x4 nodeMax = loadSoA<4>(node.maxX, node.maxY, node.maxZ);
+		const LaneMask hits = lessThanEqual(nodeMin.x, queryMax.x) & greaterThanEqual(nodeMax.x, queryMin.x)
+		                    & lessThanEqual(nodeMin.y, queryMax.y) & greaterThanEqual(nodeMax.y, queryMin.y)
+		                    & lessThanEqual(nodeMin.z, queryMax.z) & greaterThanEqual(nodeMax.z, queryMin.z);
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if ((hits & (1u << slot)) == 0) continue;
+			if (node.isLeaf(slot)) {
+				leafFunc(node.children[slot], node.counts[slot]);
+			}
+			else if (node.isInner(slot)) {
+				sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+				stack[stackSize++] = node.children[slot];
+			}
+		}
+	}
+}
+
+} // namespace sfz
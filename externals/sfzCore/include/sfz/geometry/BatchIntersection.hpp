@@ -0,0 +1,92 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+
+// Batched intersection tests
+// ------------------------------------------------------------------------------------------------
+
+// Tests one primitive against many primitives of the same type stored as SoA arrays, 8 at a time
+// in FloatPackets. The result is written as a bitmask with the same layout as
+// ViewFrustum::cullAABBs(), i.e. bit (i % 32) of word (i / 32) is set if primitive i intersects.
+// intersectMaskOut must have room for (count + 31) / 32 words. Intended as the inner loop between
+// a broadphase (which gathers candidates) and an exact narrowphase.
+
+/// Width of the packets used by the batched tests
+constexpr uint32_t BATCH_PACKET_WIDTH = 8;
+
+/// OBBs stored as SoA arrays, one array per float component. The arrays are padded with zeroes to
+/// a multiple of BATCH_PACKET_WIDTH so that the batched test can always load whole packets.
+class OBBBatch final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	OBBBatch() noexcept = default;
+	OBBBatch(const OBBBatch&) noexcept = default;
+	OBBBatch& operator= (const OBBBatch&) noexcept = default;
+	OBBBatch(OBBBatch&&) noexcept = default;
+	OBBBatch& operator= (OBBBatch&&) noexcept = default;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	void add(const OBB& obb) noexcept;
+	void set(uint32_t index, const OBB& obb) noexcept;
+	OBB get(uint32_t index) const noexcept;
+
+	/// Removes all OBBs, keeps the allocated memory
+	void clear() noexcept;
+
+	uint32_t size() const noexcept { return mSize; }
+
+	/// Returns the SoA array for component i (0-2 center xyz, 3-11 axes 0-2 xyz, 12-14 half
+	/// extents xyz)
+	const float* component(uint32_t i) const noexcept { return mComponents[i].data(); }
+
+	static constexpr uint32_t NUM_COMPONENTS = 15;
+
+private:
+	uint32_t mSize = 0;
+	DynArray<float> mComponents[NUM_COMPONENTS];
+};
+
+/// OBB vs OBB separating axis test (same as intersects(const OBB&, const OBB&)) against all OBBs
+/// in boxes. Packets stop testing axes as soon as all their lanes have found a separating axis.
+void intersects(const OBB& box, const OBBBatch& boxes, uint32_t* intersectMaskOut) noexcept;
+
+/// Sphere vs sphere test against count spheres stored as SoA arrays (center x, y, z and radius).
+/// Touching spheres intersect.
+void intersects(const Sphere& sphere, const float* centerX, const float* centerY,
+                const float* centerZ, const float* radius, size_t count,
+                uint32_t* intersectMaskOut) noexcept;
+
+} // namespace sfz
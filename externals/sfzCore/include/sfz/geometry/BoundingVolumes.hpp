@@ -0,0 +1,54 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// Bounding volume computation
+// ------------------------------------------------------------------------------------------------
+
+// Functions computing bounding volumes of point sets, e.g. the vertices of a model at load time.
+// The points are read from a strided array so that positions can be read directly from an
+// interleaved vertex array, stride is the distance in bytes between consecutive points. All
+// functions require numPoints > 0. Extents and radii are padded to be strictly positive so that
+// the result is valid even for flat or single point inputs.
+
+/// Computes the smallest AABB containing all points
+AABB computeAABB(const vec3* points, uint32_t numPoints, uint32_t stride = sizeof(vec3)) noexcept;
+
+/// Computes a bounding sphere using Ritter's algorithm refined by a few iterations of shrinking
+/// and regrowing (Ericson, Real-Time Collision Detection, chapter 4.3.4). Usually within a few
+/// percent of the minimal bounding sphere.
+Sphere computeBoundingSphere(const vec3* points, uint32_t numPoints,
+                             uint32_t stride = sizeof(vec3)) noexcept;
+
+/// Computes an OBB aligned with the principal axes (eigenvectors of the covariance matrix) of
+/// the points. Tighter than the AABB for elongated models not aligned with the coordinate axes.
+OBB computePCAOBB(const vec3* points, uint32_t numPoints, uint32_t stride = sizeof(vec3)) noexcept;
+
+} // namespace sfz
@@ -0,0 +1,198 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::int32_t;
+using std::uint32_t;
+
+// Broadphase collision detection
+// ------------------------------------------------------------------------------------------------
+
+// The broadphases find candidate pairs of objects with overlapping AABBs, the pairs can then be
+// fed into the exact (narrowphase) intersection tests in Intersection.hpp. Objects are referred to
+// by handles returned when added, handles of removed objects are reused by later additions. Both
+// broadphases are designed to be kept alive between frames with the bounds of moving objects
+// updated each frame, rather than being rebuilt from scratch.
+
+/// A pair of handles to objects with overlapping AABBs, first < second
+struct BroadphasePair final {
+	uint32_t first, second;
+};
+
+inline bool operator== (const BroadphasePair& lhs, const BroadphasePair& rhs) noexcept
+{
+	return lhs.first == rhs.first && lhs.second == rhs.second;
+}
+
+inline bool operator< (const BroadphasePair& lhs, const BroadphasePair& rhs) noexcept
+{
+	return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+}
+
+// SweepAndPrune
+// ------------------------------------------------------------------------------------------------
+
+/// Sweep-and-prune (sort and sweep) on a single axis.
+///
+/// The objects are kept sorted by the minimum of their AABBs along the axis. Since objects move
+/// little between frames the order is restored with an insertion sort, which is close to linear
+/// for nearly sorted input. Works best when the objects are spread out along the chosen axis,
+/// e.g. the horizontal axes in a room-scale scene.
+class SweepAndPrune final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	SweepAndPrune(const SweepAndPrune&) noexcept = default;
+	SweepAndPrune& operator= (const SweepAndPrune&) noexcept = default;
+	SweepAndPrune(SweepAndPrune&&) noexcept = default;
+	SweepAndPrune& operator= (SweepAndPrune&&) noexcept = default;
+
+	/// Creates an empty SweepAndPrune sorting along the specified axis (0 = x, 1 = y, 2 = z)
+	explicit SweepAndPrune(uint32_t axis = 0) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Adds an object, returns its handle
+	uint32_t add(const AABB& bounds) noexcept;
+
+	/// Removes an object, its handle may be reused by later additions
+	void remove(uint32_t handle) noexcept;
+
+	/// Updates the bounds of an object, takes effect on the next call to findPairs()
+	void update(uint32_t handle, const AABB& bounds) noexcept;
+
+	/// Removes all objects
+	void clear() noexcept;
+
+	/// Appends all pairs of objects with overlapping bounds to pairsOut, in unspecified order
+	void findPairs(DynArray<BroadphasePair>& pairsOut) noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline uint32_t axis() const noexcept { return mAxis; }
+	inline uint32_t numObjects() const noexcept { return mEntries.size(); }
+	inline const AABB& bounds(uint32_t handle) const noexcept { return mBounds[handle]; }
+
+private:
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	struct Entry final {
+		AABB bounds;
+		uint32_t handle;
+	};
+
+	uint32_t mAxis;
+	DynArray<Entry> mEntries; // Sorted by bounds.min()[mAxis] after findPairs()
+	DynArray<AABB> mBounds; // Indexed by handle
+	DynArray<uint32_t> mFreeHandles;
+};
+
+// HashGrid
+// ------------------------------------------------------------------------------------------------
+
+/// A uniform grid of cubic cells stored in a fixed size hash table, so the grid is unbounded and
+/// its memory usage is independent of the size of the world.
+///
+/// Each object is inserted into all cells its AABB overlaps. Updating an object whose AABB still
+/// overlaps the same cells only stores the new bounds, so slowly moving objects are cheap. The
+/// cell size should be about the size of the typical object, objects much larger than a cell are
+/// inserted into many cells.
+class HashGrid final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	HashGrid(const HashGrid&) noexcept = default;
+	HashGrid& operator= (const HashGrid&) noexcept = default;
+	HashGrid(HashGrid&&) noexcept = default;
+	HashGrid& operator= (HashGrid&&) noexcept = default;
+
+	/// Creates an empty HashGrid. numBuckets is rounded up to a power of two.
+	explicit HashGrid(float cellSize = 1.0f, uint32_t numBuckets = 4096) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Adds an object, returns its handle
+	uint32_t add(const AABB& bounds) noexcept;
+
+	/// Removes an object, its handle may be reused by later additions
+	void remove(uint32_t handle) noexcept;
+
+	/// Updates the bounds of an object
+	void update(uint32_t handle, const AABB& bounds) noexcept;
+
+	/// Removes all objects
+	void clear() noexcept;
+
+	/// Appends all pairs of objects with overlapping bounds to pairsOut, in unspecified order
+	void findPairs(DynArray<BroadphasePair>& pairsOut) const noexcept;
+
+	/// Appends the handles of all objects overlapping the AABB to resultOut
+	void queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline float cellSize() const noexcept { return mCellSize; }
+	inline uint32_t numObjects() const noexcept { return mObjects.size() - mFreeHandles.size(); }
+	inline const AABB& bounds(uint32_t handle) const noexcept { return mObjects[handle].bounds; }
+
+private:
+	// Private methods
+	// --------------------------------------------------------------------------------------------
+
+	vec3i cellOf(const vec3& point) const noexcept;
+	uint32_t bucketOf(const vec3i& cell) const noexcept;
+	void insertIntoCells(uint32_t handle) noexcept;
+	void removeFromCells(uint32_t handle) noexcept;
+
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	struct Object final {
+		AABB bounds;
+		vec3i cellMin, cellMax;
+		bool alive;
+	};
+
+	struct CellEntry final {
+		vec3i cell;
+		uint32_t handle;
+	};
+
+	float mCellSize, mInvCellSize;
+	DynArray<DynArray<CellEntry>> mBuckets;
+	DynArray<Object> mObjects; // Indexed by handle
+	DynArray<uint32_t> mFreeHandles;
+};
+
+} // namespace sfz
@@ -0,0 +1,57 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// ConvexHull
+// ------------------------------------------------------------------------------------------------
+
+/// A convex hull as a closed triangle mesh, triangles are wound counter-clockwise when seen from
+/// the outside. Only contains the vertices referenced by the triangles.
+struct ConvexHull final {
+	DynArray<vec3> vertices;
+	DynArray<uint32_t> indices;
+
+	inline uint32_t numTriangles() const noexcept { return indices.size() / 3; }
+};
+
+/// Computes the convex hull of a set of points using quickhull (Barber et al, "The Quickhull
+/// Algorithm for Convex Hulls"). Each step adds the point furthest outside of the current hull.
+///
+/// If maxVertices is non-zero the hull stops growing when it has that many vertices. Since the
+/// furthest points are added first the result is a good (inner) approximation of the full hull,
+/// which makes it suitable as a collision proxy for meshes with many vertices.
+///
+/// Flat point sets (fewer than 4 points not in the same plane) have no volume, the resulting hull
+/// then only contains the extreme points found and no triangles.
+/// \param stride the number of bytes between consecutive points
+/// sfz_assert_debug maxVertices == 0 || maxVertices >= 4
+ConvexHull computeConvexHull(const vec3* points, uint32_t numPoints,
+                             uint32_t stride = sizeof(vec3), uint32_t maxVertices = 0) noexcept;
+
+} // namespace sfz
@@ -0,0 +1,118 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/math/Matrix.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// ConvexShape interface
+// ------------------------------------------------------------------------------------------------
+
+/// Interface for convex shapes described by their support function, used by GJK and EPA.
+class ConvexShape {
+public:
+	virtual ~ConvexShape() noexcept = default;
+
+	/// Returns the point of the shape furthest along the specified direction. dir is not
+	/// necessarily normalized but is never zero.
+	virtual vec3 support(const vec3& dir) const noexcept = 0;
+};
+
+// Shapes
+// ------------------------------------------------------------------------------------------------
+
+/// Support function adapter for a Sphere
+class SphereShape final : public ConvexShape {
+public:
+	explicit SphereShape(const Sphere& sphere) noexcept : mSphere(sphere) { }
+	virtual vec3 support(const vec3& dir) const noexcept override final;
+
+private:
+	Sphere mSphere;
+};
+
+/// Support function adapter for an AABB
+class AABBShape final : public ConvexShape {
+public:
+	explicit AABBShape(const AABB& aabb) noexcept : mAABB(aabb) { }
+	virtual vec3 support(const vec3& dir) const noexcept override final;
+
+private:
+	AABB mAABB;
+};
+
+/// Support function adapter for an OBB
+class OBBShape final : public ConvexShape {
+public:
+	explicit OBBShape(const OBB& obb) noexcept : mOBB(obb) { }
+	virtual vec3 support(const vec3& dir) const noexcept override final;
+
+private:
+	OBB mOBB;
+};
+
+/// The convex hull of a set of points, optionally transformed by an affine transform. The points
+/// are referenced and not copied. The support function is a linear scan, so for larger meshes the
+/// points should be reduced to the vertices of their convex hull first.
+class ConvexHullShape final : public ConvexShape {
+public:
+	/// \param stride the number of bytes between consecutive points, allows using the position
+	///               member of a vertex struct directly
+	/// sfz_assert_debug numPoints > 0
+	ConvexHullShape(const vec3* points, uint32_t numPoints, uint32_t stride = sizeof(vec3)) noexcept;
+	ConvexHullShape(const vec3* points, uint32_t numPoints, uint32_t stride,
+	                const mat4& transform) noexcept;
+
+	virtual vec3 support(const vec3& dir) const noexcept override final;
+
+private:
+	const vec3* mPoints;
+	uint32_t mNumPoints, mStride;
+	bool mHasTransform;
+	mat4 mTransform;
+};
+
+/// A shape given in its own local space placed with an affine transform. The local shape is
+/// referenced and not copied, so it must outlive this object.
+class TransformedShape final : public ConvexShape {
+public:
+	TransformedShape(const ConvexShape& localShape, const mat4& transform) noexcept
+	:
+		mLocalShape(&localShape),
+		mTransform(transform)
+	{ }
+
+	virtual vec3 support(const vec3& dir) const noexcept override final;
+
+private:
+	const ConvexShape* mLocalShape;
+	mat4 mTransform;
+};
+
+} // namespace sfz
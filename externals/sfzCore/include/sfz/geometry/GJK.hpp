@@ -0,0 +1,90 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/geometry/ConvexShape.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// GJK & EPA
+// ------------------------------------------------------------------------------------------------
+
+// The Gilbert-Johnson-Keerthi algorithm finds the point of the Minkowski difference A - B closest
+// to the origin using only the support functions of the shapes. If the difference contains the
+// origin the shapes intersect, and the Expanding Polytope Algorithm grows the final GJK simplex
+// towards the boundary of the difference to find the penetration depth. See van den Bergen,
+// "Collision Detection in Interactive 3D Environments" and Ericson, "Real-Time Collision
+// Detection" (chapter 9.5).
+
+/// The simplex GJK terminated with. Keep one per pair of shapes and pass it to the next query of
+/// the same pair to warm start GJK, the support points are recomputed from the stored search
+/// directions so the shapes may have moved in between. An empty simplex starts from scratch.
+struct GJKSimplex final {
+	vec3 dirs[4];
+	vec3 pointsA[4];
+	vec3 pointsB[4];
+	uint32_t size = 0;
+};
+
+struct GJKResult final {
+	bool intersecting = false;
+
+	/// The distance between the shapes, 0 if intersecting
+	float distance = 0.0f;
+
+	/// The closest points on A and B, only valid if not intersecting
+	vec3 pointA = vec3(0.0f);
+	vec3 pointB = vec3(0.0f);
+
+	uint32_t iterations = 0;
+};
+
+struct Penetration final {
+	/// False if EPA could not expand a degenerate simplex, e.g. for touching flat shapes
+	bool valid = false;
+
+	/// Points from A towards B, translating B by normal * depth separates the shapes
+	vec3 normal = vec3(0.0f);
+	float depth = 0.0f;
+
+	/// The deepest points of A inside B and of B inside A, pointA - pointB = normal * depth
+	vec3 pointA = vec3(0.0f);
+	vec3 pointB = vec3(0.0f);
+};
+
+/// Computes the distance and closest points between two convex shapes
+GJKResult gjkDistance(const ConvexShape& a, const ConvexShape& b, GJKSimplex& simplex) noexcept;
+
+/// Tests two convex shapes for intersection. Cheaper than gjkDistance() for separated shapes as
+/// it stops as soon as a separating axis is found.
+bool gjkIntersects(const ConvexShape& a, const ConvexShape& b, GJKSimplex& simplex) noexcept;
+
+/// Computes the penetration of two intersecting convex shapes
+/// \param simplex the simplex of a gjkDistance() or gjkIntersects() call which found the shapes
+///                intersecting
+Penetration epaPenetration(const ConvexShape& a, const ConvexShape& b,
+                           const GJKSimplex& simplex) noexcept;
+
+} // namespace sfz
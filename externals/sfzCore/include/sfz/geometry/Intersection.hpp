@@ -27,6 +27,7 @@ namespace sfz {
 	struct Circle;
 	class OBB;
 	class Plane;
+	class Ray;
 	class Sphere;
 }
 
@@ -58,6 +59,12 @@ bool overlaps(const AABB2D& lhs, const AABB2D& rhs) noexcept;
 bool overlaps(const Circle& circle, const AABB2D& rect) noexcept;
 bool overlaps(const AABB2D& rect, const Circle& circle) noexcept;
 
+// AABB & Sphere tests
+// ------------------------------------------------------------------------------------------------
+
+bool intersects(const AABB& aabb, const Sphere& sphere) noexcept;
+bool intersects(const Sphere& sphere, const AABB& aabb) noexcept;
+
 // Plane & AABB tests
 // ------------------------------------------------------------------------------------------------
 
@@ -88,4 +95,24 @@ bool abovePlane(const Plane& plane, const Sphere& sphere) noexcept;
 /// Checks whether Sphere intersects with or is in negative half-space of plane.
 bool belowPlane(const Plane& plane, const Sphere& sphere) noexcept;
 
+// Ray tests
+// ------------------------------------------------------------------------------------------------
+
+// Returns the distance along the ray to the closest intersection within [0, ray.maxDist()], or
+// RAY_MISS (see Ray.hpp) if there is none. Rays starting inside a volume hit it at distance 0.
+// Packet versions are available in Ray.hpp.
+
+/// Slab test
+float raycast(const Ray& ray, const AABB& aabb) noexcept;
+/// Slab test in the local space of the OBB
+float raycast(const Ray& ray, const OBB& obb) noexcept;
+float raycast(const Ray& ray, const Sphere& sphere) noexcept;
+/// Hits the plane from either side, rays parallel to the plane never hit.
+float raycast(const Ray& ray, const Plane& plane) noexcept;
+/// Double sided ray vs triangle test (Mller-Trumbore).
+float raycast(const Ray& ray, const vec3& v0, const vec3& v1, const vec3& v2) noexcept;
+/// Same as above, also returns the barycentric coordinates (u, v) of the hit, where the hit point
+/// is (1 - u - v) * v0 + u * v1 + v * v2. uvOut is not modified on a miss.
+float raycast(const Ray& ray, const vec3& v0, const vec3& v1, const vec3& v2, vec2& uvOut) noexcept;
+
 } // namespace sfz
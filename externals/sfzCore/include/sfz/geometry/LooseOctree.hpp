@@ -0,0 +1,161 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+class Ray;
+class Sphere;
+class ViewFrustum;
+
+constexpr uint32_t OCTREE_INVALID_INDEX = ~0u;
+
+// LooseOctree
+// ------------------------------------------------------------------------------------------------
+
+/// A loose octree over AABBs for dynamic objects that move every frame.
+///
+/// Each node has loose bounds which are larger than its cell (by the looseness factor), an object
+/// is stored in the node at the depth matching its size whose cell contains the center of the
+/// object. Finding this node does not depend on the number of objects, so insert, move and remove
+/// are O(1) (bounded by the max depth). Moving an object within its cell only updates its bounds.
+///
+/// Nodes and objects are pooled in arrays with free lists, nodes are created on demand and
+/// returned to the pool when their subtree becomes empty. Each node stores the bounds of its
+/// objects contiguously so queries do not chase pointers per object. Objects outside the world
+/// bounds are stored in the root node, which is always visited by queries.
+class LooseOctree final {
+public:
+	// Constants
+	// --------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t MAX_DEPTH_LIMIT = 16;
+
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	LooseOctree() noexcept = default;
+	LooseOctree(const LooseOctree&) noexcept = default;
+	LooseOctree& operator= (const LooseOctree&) noexcept = default;
+	LooseOctree(LooseOctree&&) noexcept = default;
+	LooseOctree& operator= (LooseOctree&&) noexcept = default;
+
+	/// Creates an empty octree whose root cell is the smallest cube containing worldBounds.
+	/// maxDepth should be chosen so that the smallest cells are about the size of the typical
+	/// object, deeper levels only add sparsely populated nodes.
+	/// sfz_assert_debug maxDepth <= MAX_DEPTH_LIMIT and 1 < looseness <= 2
+	LooseOctree(const AABB& worldBounds, uint32_t maxDepth = 8, float looseness = 2.0f) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Inserts an object, returns its handle
+	uint32_t insert(const AABB& bounds) noexcept;
+
+	/// Updates the bounds of an object, moving it to another node if necessary
+	void move(uint32_t handle, const AABB& bounds) noexcept;
+
+	/// Removes an object, its handle may be reused by later insertions
+	void remove(uint32_t handle) noexcept;
+
+	/// Removes all objects
+	void clear() noexcept;
+
+	/// Appends the handles of all objects visible in the frustum (as defined by
+	/// ViewFrustum::isVisible()) to resultOut
+	void queryFrustum(const ViewFrustum& frustum, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the handles of all objects intersecting the AABB to resultOut
+	void queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the handles of all objects intersecting the sphere to resultOut
+	void queryOverlap(const Sphere& sphere, DynArray<uint32_t>& resultOut) const noexcept;
+
+	/// Appends the handles of all objects whose AABB is hit by the ray to resultOut
+	void queryRay(const Ray& ray, DynArray<uint32_t>& resultOut) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline uint32_t numObjects() const noexcept { return mObjects.size() - mFreeObjects.size(); }
+	inline uint32_t numNodes() const noexcept { return mNodes.size() - mFreeNodes.size(); }
+	inline const AABB& bounds(uint32_t handle) const noexcept
+	{
+		return mNodes[mObjects[handle].node].objectBounds[mObjects[handle].index];
+	}
+
+private:
+	// Private structs
+	// --------------------------------------------------------------------------------------------
+
+	struct Node final {
+		vec3 center;
+		float halfSize; // Half the size of the cell, the loose bounds are halfSize * looseness
+		vec3i cell; // Coordinate of the cell at its depth
+		uint32_t depth;
+		uint32_t parent;
+		uint32_t children[8];
+		uint32_t numObjectsInSubtree;
+		DynArray<AABB> objectBounds;
+		DynArray<uint32_t> objectHandles;
+	};
+
+	struct Object final {
+		vec3i cell; // Cached from the node, so move() within a cell does not need to read it
+		uint32_t depth;
+		uint32_t node; // OCTREE_INVALID_INDEX if removed
+		uint32_t index; // Index in the node's object arrays
+	};
+
+	// Private methods
+	// --------------------------------------------------------------------------------------------
+
+	void targetCell(const AABB& bounds, uint32_t& depthOut, vec3i& cellOut) const noexcept;
+	uint32_t allocateNode(uint32_t parent, uint32_t depth, const vec3i& cell) noexcept;
+	void link(uint32_t handle, const AABB& bounds, uint32_t depth, const vec3i& cell) noexcept;
+	void unlink(uint32_t handle) noexcept;
+	AABB looseBounds(const Node& node) const noexcept;
+
+	/// Visits all nodes whose loose bounds pass nodeTest(const AABB&) and appends the objects in
+	/// them passing objectTest(const AABB&) to resultOut
+	template<typename NodeTest, typename ObjectTest>
+	void query(NodeTest&& nodeTest, ObjectTest&& objectTest, DynArray<uint32_t>& resultOut) const noexcept;
+
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	vec3 mWorldMin = vec3(0.0f);
+	float mWorldSize = 1.0f;
+	uint32_t mMaxDepth = 0;
+	float mLooseness = 2.0f;
+	DynArray<Node> mNodes; // Root is at index 0
+	DynArray<uint32_t> mFreeNodes;
+	DynArray<Object> mObjects; // Indexed by handle
+	DynArray<uint32_t> mFreeObjects;
+};
+
+} // namespace sfz
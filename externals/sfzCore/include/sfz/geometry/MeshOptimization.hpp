@@ -0,0 +1,82 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// Vertex cache statistics
+// ------------------------------------------------------------------------------------------------
+
+/// Statistics of a simulated FIFO post-transform vertex cache, see analyzeVertexCache()
+struct VertexCacheStats final {
+	/// Number of vertices transformed, i.e. cache misses
+	uint32_t numTransformed = 0;
+
+	/// Average cache miss ratio, transformed vertices per triangle. Between 3 (no reuse) and
+	/// about 0.5 (ideal for large regular meshes).
+	float acmr = 0.0f;
+
+	/// Average transformed vertex ratio, transformed vertices per referenced vertex. 1 is ideal,
+	/// each vertex is then only transformed once.
+	float atvr = 0.0f;
+};
+
+/// Simulates a FIFO post-transform vertex cache with cacheSize entries on an indexed triangle list
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, uint32_t numIndices,
+                                    uint32_t numVertices, uint32_t cacheSize = 16) noexcept;
+
+// Mesh optimization functions
+// ------------------------------------------------------------------------------------------------
+
+// The functions below reorder indexed triangle lists for the GPU, the intended order is
+// optimizeVertexCache(), optimizeOverdraw() and finally optimizeVertexFetch(). None of them
+// change the triangles themselves (or the winding of the triangles), only their order.
+
+/// Reorders triangles for the post-transform vertex cache using Tom Forsyth's "Linear-Speed Vertex
+/// Cache Optimisation". Each step emits the triangle with the highest score, where vertices score
+/// higher the more recently used they are and the fewer remaining triangles use them. The result
+/// is good on any cache size and replacement policy. indicesOut may be the same as indices.
+void optimizeVertexCache(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                         uint32_t numVertices) noexcept;
+
+/// Reorders clusters of triangles in a vertex cache optimized order to reduce overdraw, based on
+/// Sander et al, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw". The order is
+/// split into clusters whose ACMR is at most threshold times that of the surrounding order (so
+/// 1.05 allows the ACMR to grow by about 5%), which are sorted so that clusters facing away from
+/// the center of the mesh (likely occluders from most directions) are drawn first.
+/// indicesOut may not be the same as indices.
+/// \param stride the number of bytes between consecutive positions
+void optimizeOverdraw(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                      const vec3* positions, uint32_t numVertices, uint32_t stride = sizeof(vec3),
+                      float threshold = 1.05f) noexcept;
+
+/// Computes a new vertex order where vertices are stored in the order they are first used by the
+/// indices, which is the order the GPU fetches them in. The indices are rewritten in place and
+/// remapOut[oldIndex] is set to the new index of each vertex, or ~0u for vertices not referenced
+/// by any triangle (which should be removed). Returns the number of referenced vertices.
+uint32_t optimizeVertexFetch(uint32_t* remapOut, uint32_t* indices, uint32_t numIndices,
+                             uint32_t numVertices) noexcept;
+
+} // namespace sfz
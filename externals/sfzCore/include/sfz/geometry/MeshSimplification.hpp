@@ -0,0 +1,58 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// Mesh simplification
+// ------------------------------------------------------------------------------------------------
+
+/// Simplifies an indexed triangle mesh using the quadric error metric (Garland & Heckbert,
+/// "Surface Simplification Using Quadric Error Metrics"), collapsing the edges with the smallest
+/// error until the mesh has at most targetNumIndices indices or no collapse with an error below
+/// maxError remains.
+///
+/// Edges are collapsed onto one of their existing vertices (half-edge collapses), so the result
+/// uses a subset of the input vertices and can share the vertex buffer of the input. Vertices
+/// are never modified, normals and uv coordinates are thus kept exactly as they were.
+///
+/// Vertices with the same position but different attributes (uv seams and hard normal edges) are
+/// detected from the positions of the vertices used by the indices. Such seams and open borders
+/// are only collapsed along themselves (both sides of a seam at the same time), so they stay
+/// closed and keep their shape. Vertices where this isn't possible, and vertices with
+/// lockedVertices[vertex] == true (if lockedVertices is not nullptr), are never removed. The
+/// latter is needed for vertices shared with geometry that isn't simplified at the same time.
+///
+/// \param indicesOut must have room for numIndices indices, may be the same as indices
+/// \param stride the number of bytes between consecutive positions
+/// \param maxError the max allowed error, as a distance in the units of the positions
+/// \param errorOut if not nullptr, set to the largest error of the performed collapses
+/// \return the number of indices written to indicesOut
+uint32_t simplifyMesh(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                      const vec3* positions, uint32_t numVertices, uint32_t stride,
+                      uint32_t targetNumIndices, float maxError = 1e30f, float* errorOut = nullptr,
+                      const bool* lockedVertices = nullptr) noexcept;
+
+} // namespace sfz
@@ -0,0 +1,140 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/math/Matrix.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::int32_t;
+using std::size_t;
+using std::uint32_t;
+
+// OcclusionBuffer
+// ------------------------------------------------------------------------------------------------
+
+/// A low resolution CPU depth buffer used for software occlusion culling.
+///
+/// A small set of large occluder meshes is first added, which transforms their triangles to
+/// screen space and bins them into tiles. rasterize() then renders the tiles (optionally on
+/// several threads, each tile is owned by a single thread) with edge functions evaluated 8 pixels
+/// at a time. Object bounds can afterwards be tested against the buffer, an AABB is occluded if
+/// the nearest depth of its projected corners is behind the occluders in every pixel its screen
+/// rectangle covers.
+///
+/// Depth is clip space z / w, i.e. whatever range the view projection matrix produces, smaller is
+/// closer. Occluder triangles which cross the near plane are skipped and objects which cross it
+/// are always visible, so the buffer only errs on the side of visibility there. Coverage is
+/// sampled at pixel centers, so the buffer should not be much lower resolution than the size of
+/// the smallest gaps between occluders that matter.
+class OcclusionBuffer final {
+public:
+	// Constants
+	// --------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t TILE_WIDTH = 32;
+	static constexpr uint32_t TILE_HEIGHT = 8;
+	static constexpr uint32_t MAX_THREADS = 8;
+
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	OcclusionBuffer() noexcept = default;
+	OcclusionBuffer(const OcclusionBuffer&) noexcept = default;
+	OcclusionBuffer& operator= (const OcclusionBuffer&) noexcept = default;
+	OcclusionBuffer(OcclusionBuffer&&) noexcept = default;
+	OcclusionBuffer& operator= (OcclusionBuffer&&) noexcept = default;
+
+	/// Creates a cleared buffer, the resolution is rounded up to a multiple of the tile size
+	/// sfz_assert_debug width > 0 and height > 0
+	OcclusionBuffer(uint32_t width, uint32_t height) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Clears the depth buffer to the largest float and removes all binned occluders
+	void clear() noexcept;
+
+	/// Transforms the triangles of an occluder mesh to screen space and bins them into tiles,
+	/// they are not rendered until rasterize() is called.
+	/// \param modelViewProj the matrix transforming positions to clip space
+	void addOccluder(const mat4& modelViewProj, const vec3* positions, const uint32_t* indices,
+	                 uint32_t numIndices) noexcept;
+
+	/// Rasterizes all binned occluders into the depth buffer and removes them from the bins.
+	/// numThreads is clamped to [1, MAX_THREADS].
+	void rasterize(uint32_t numThreads = 1) noexcept;
+
+	/// Returns whether the specified world space AABB might be visible past the occluders
+	/// \param viewProj the view projection matrix used when the occluders were added
+	bool testAABB(const mat4& viewProj, const AABB& aabb) const noexcept;
+
+	/// Tests count AABBs, writing the result to a bitmask with the same layout as
+	/// ViewFrustum::cullAABBs(), i.e. bit (i % 32) of word (i / 32) is set if AABB i might be
+	/// visible. visibleMaskOut must have room for (count + 31) / 32 words.
+	void testAABBs(const mat4& viewProj, const AABB* aabbs, size_t count,
+	               uint32_t* visibleMaskOut) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline uint32_t width() const noexcept { return mWidth; }
+	inline uint32_t height() const noexcept { return mHeight; }
+	inline uint32_t numBinnedTriangles() const noexcept { return mTriangles.size(); }
+
+	/// Returns the depth of the pixel at (x, y), (0, 0) is the lower left corner
+	inline float depth(uint32_t x, uint32_t y) const noexcept { return mDepth[y * mWidth + x]; }
+
+private:
+	// Private types
+	// --------------------------------------------------------------------------------------------
+
+	/// A screen space triangle set up for rasterization. The three edge functions are
+	/// edgeA * x + edgeB * y + edgeC and are positive inside the triangle, depth is interpolated
+	/// with the plane depthA * x + depthB * y + depthC.
+	struct ScreenTriangle final {
+		float edgeA[3], edgeB[3], edgeC[3];
+		float depthA, depthB, depthC;
+		int32_t minX, minY, maxX, maxY;
+	};
+
+	// Private methods
+	// --------------------------------------------------------------------------------------------
+
+	void rasterizeTile(uint32_t tileIndex) noexcept;
+
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	uint32_t mWidth = 0, mHeight = 0;
+	uint32_t mNumTilesX = 0, mNumTilesY = 0;
+	DynArray<float> mDepth;
+	DynArray<float> mTileMaxDepth;
+	DynArray<ScreenTriangle> mTriangles;
+	DynArray<DynArray<uint32_t>> mTileBins;
+};
+
+} // namespace sfz
@@ -0,0 +1,131 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "sfz/math/Vector.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+using std::size_t;
+
+class AABB;
+class Sphere;
+
+/// Distance returned by raycast functions when the ray misses. Being the largest float it can be
+/// compared directly against other distances when searching for the closest hit.
+constexpr float RAY_MISS = std::numeric_limits<float>::max();
+
+// Ray
+// ------------------------------------------------------------------------------------------------
+
+/// Class representing a ray segment, starting at origin and extending maxDist along dir. The
+/// direction does not need to be normalized, but distances returned by the raycast functions are
+/// in multiples of its length.
+class Ray final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	Ray() noexcept = default;
+	Ray(const Ray&) noexcept = default;
+	Ray& operator= (const Ray&) noexcept = default;
+
+	/// sfz_assert_debug dir != 0 and maxDist >= 0
+	inline Ray(const vec3& origin, const vec3& dir, float maxDist = RAY_MISS) noexcept;
+
+	// Public member functions
+	// --------------------------------------------------------------------------------------------
+
+	/// Returns the point at the specified distance along the ray
+	inline vec3 point(float dist) const noexcept { return mOrigin + mDir * dist; }
+
+	// Public getters/setters
+	// --------------------------------------------------------------------------------------------
+
+	inline vec3 origin() const noexcept { return mOrigin; }
+	inline vec3 dir() const noexcept { return mDir; }
+	/// Element-wise 1 / dir, zero components are replaced by a large finite value
+	inline vec3 invDir() const noexcept { return mInvDir; }
+	inline float maxDist() const noexcept { return mMaxDist; }
+
+	inline void maxDist(float newMaxDist) noexcept;
+
+private:
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	vec3 mOrigin, mDir, mInvDir;
+	float mMaxDist;
+};
+
+// RayPacket
+// ------------------------------------------------------------------------------------------------
+
+/// W rays stored as SoA packets, for testing several rays against the same primitive at once
+template<size_t W>
+struct RayPacket final {
+	Vec3Packet<W> origin, dir, invDir;
+	FloatPacket<W> maxDist;
+
+	RayPacket() noexcept = default;
+	RayPacket(const RayPacket<W>&) noexcept = default;
+	RayPacket<W>& operator= (const RayPacket<W>&) noexcept = default;
+
+	/// Loads W consecutive rays from arrayPtr
+	explicit RayPacket(const Ray* arrayPtr) noexcept;
+
+	/// Broadcasts the ray to all lanes, for testing one ray against W primitives
+	explicit RayPacket(const Ray& ray) noexcept;
+};
+
+using RayPacket4 = RayPacket<4>;
+using RayPacket8 = RayPacket<8>;
+
+// Packet ray tests
+// ------------------------------------------------------------------------------------------------
+
+// Packet versions of the raycast() functions in Intersection.hpp. Each lane of the result holds
+// the distance to the closest hit within [0, maxDist] or RAY_MISS, with the same semantics as the
+// scalar versions.
+
+/// W rays against one AABB (slab test)
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const AABB& aabb) noexcept;
+
+/// W rays against one sphere
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const Sphere& sphere) noexcept;
+
+/// W rays against one (double sided) triangle (Möller-Trumbore)
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const vec3& v0, const vec3& v1, const vec3& v2) noexcept;
+
+/// One ray against W (double sided) triangles (Möller-Trumbore)
+template<size_t W>
+FloatPacket<W> raycast(const Ray& ray, const Vec3Packet<W>& v0, const Vec3Packet<W>& v1,
+                       const Vec3Packet<W>& v2) noexcept;
+
+} // namespace sfz
+
+#include "sfz/geometry/Ray.inl"
@@ -0,0 +1,159 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+
+namespace sfz {
+
+// Ray: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+inline Ray::Ray(const vec3& origin, const vec3& dir, float maxDist) noexcept
+:
+	mOrigin(origin),
+	mDir(dir),
+	mMaxDist(maxDist)
+{
+	sfz_assert_debug(dir != vec3(0.0f));
+	sfz_assert_debug(maxDist >= 0.0f);
+
+	// Avoids infinities (and 0 * inf = NaN) in the slab tests, also with -ffast-math
+	for (size_t i = 0; i < 3; i++) {
+		float d = (std::abs(dir[i]) < 1e-20f) ? 1e-20f : dir[i];
+		mInvDir[i] = 1.0f / d;
+	}
+}
+
+// Ray: Public getters/setters
+// ------------------------------------------------------------------------------------------------
+
+inline void Ray::maxDist(float newMaxDist) noexcept
+{
+	sfz_assert_debug(newMaxDist >= 0.0f);
+	mMaxDist = newMaxDist;
+}
+
+// RayPacket
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+RayPacket<W>::RayPacket(const Ray* arrayPtr) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		origin.setLane(i, arrayPtr[i].origin());
+		dir.setLane(i, arrayPtr[i].dir());
+		invDir.setLane(i, arrayPtr[i].invDir());
+		maxDist[i] = arrayPtr[i].maxDist();
+	}
+}
+
+template<size_t W>
+RayPacket<W>::RayPacket(const Ray& ray) noexcept
+:
+	origin(ray.origin()),
+	dir(ray.dir()),
+	invDir(ray.invDir()),
+	maxDist(ray.maxDist())
+{ }
+
+// Packet ray tests
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const AABB& aabb) noexcept
+{
+	const Vec3Packet<W> t1 = (Vec3Packet<W>(aabb.min()) - rays.origin) * rays.invDir;
+	const Vec3Packet<W> t2 = (Vec3Packet<W>(aabb.max()) - rays.origin) * rays.invDir;
+	const Vec3Packet<W> tMins = min(t1, t2);
+	const Vec3Packet<W> tMaxs = max(t1, t2);
+	const FloatPacket<W> tMin = max(max(tMins.x, tMins.y), max(tMins.z, FloatPacket<W>(0.0f)));
+	const FloatPacket<W> tMax = min(min(tMaxs.x, tMaxs.y), min(tMaxs.z, rays.maxDist));
+	return select(lessThanEqual(tMin, tMax), tMin, FloatPacket<W>(RAY_MISS));
+}
+
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const Sphere& sphere) noexcept
+{
+	// Real-Time Collision Detection (chapter 5.3.2), generalized to non-normalized directions
+	const Vec3Packet<W> m = rays.origin - Vec3Packet<W>(sphere.position());
+	const FloatPacket<W> a = dot(rays.dir, rays.dir);
+	const FloatPacket<W> b = dot(m, rays.dir);
+	const FloatPacket<W> c = dot(m, m) - FloatPacket<W>(sphere.radius() * sphere.radius());
+	const FloatPacket<W> disc = b * b - a * c;
+
+	const LaneMask inside = lessThanEqual(c, FloatPacket<W>(0.0f));
+	const LaneMask validDisc = greaterThanEqual(disc, FloatPacket<W>(0.0f));
+	const FloatPacket<W> t = (-b - sqrt(max(disc, FloatPacket<W>(0.0f)))) / a;
+	const LaneMask hit = validDisc & greaterThanEqual(t, FloatPacket<W>(0.0f)) & lessThanEqual(t, rays.maxDist);
+	return select(inside, FloatPacket<W>(0.0f), select(hit, t, FloatPacket<W>(RAY_MISS)));
+}
+
+namespace detail {
+
+/// Shared Möller-Trumbore kernel, any of the inputs may be broadcasts
+template<size_t W>
+FloatPacket<W> raycastTriangles(const Vec3Packet<W>& origin, const Vec3Packet<W>& dir,
+                                const FloatPacket<W>& maxDist, const Vec3Packet<W>& v0,
+                                const Vec3Packet<W>& v1, const Vec3Packet<W>& v2) noexcept
+{
+	const FloatPacket<W> zero(0.0f);
+	const FloatPacket<W> one(1.0f);
+
+	const Vec3Packet<W> e1 = v1 - v0;
+	const Vec3Packet<W> e2 = v2 - v0;
+	const Vec3Packet<W> p = cross(dir, e2);
+	const FloatPacket<W> det = dot(e1, p);
+	const LaneMask nonParallel = greaterThan(abs(det), FloatPacket<W>(1e-20f));
+	const FloatPacket<W> invDet = one / select(nonParallel, det, one);
+
+	const Vec3Packet<W> s = origin - v0;
+	const FloatPacket<W> u = dot(s, p) * invDet;
+	const Vec3Packet<W> q = cross(s, e1);
+	const FloatPacket<W> v = dot(dir, q) * invDet;
+	const FloatPacket<W> t = dot(e2, q) * invDet;
+
+	const LaneMask hit = nonParallel
+	                   & greaterThanEqual(u, zero) & greaterThanEqual(v, zero)
+	                   & lessThanEqual(u + v, one)
+	                   & greaterThanEqual(t, zero) & lessThanEqual(t, maxDist);
+	return select(hit, t, FloatPacket<W>(RAY_MISS));
+}
+
+} // namespace detail
+
+template<size_t W>
+FloatPacket<W> raycast(const RayPacket<W>& rays, const vec3& v0, const vec3& v1, const vec3& v2) noexcept
+{
+	return detail::raycastTriangles<W>(rays.origin, rays.dir, rays.maxDist,
+	                                   Vec3Packet<W>(v0), Vec3Packet<W>(v1), Vec3Packet<W>(v2));
+}
+
+template<size_t W>
+FloatPacket<W> raycast(const Ray& ray, const Vec3Packet<W>& v0, const Vec3Packet<W>& v1,
+                       const Vec3Packet<W>& v2) noexcept
+{
+	return detail::raycastTriangles<W>(Vec3Packet<W>(ray.origin()), Vec3Packet<W>(ray.dir()),
+	                                   FloatPacket<W>(ray.maxDist()), v0, v1, v2);
+}
+
+} // namespace sfz
@@ -18,9 +18,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <functional> // std::hash
+#include <string>
 
 #include "sfz/Assert.hpp"
+#include "sfz/math/Matrix.hpp"
 #include "sfz/math/Vector.hpp"
 
 namespace sfz {
@@ -43,6 +47,10 @@ public:
 	inline std::string to_string() const noexcept;
 	inline vec3 closestPoint(const vec3& point) const noexcept;
 
+	/// Returns the sphere enclosing this sphere transformed by the (affine) matrix, the radius is
+	/// scaled by the largest scale factor of the matrix
+	inline Sphere transformSphere(const mat4& transform) const noexcept;
+
 	// Public getters/setters
 	// --------------------------------------------------------------------------------------------
 
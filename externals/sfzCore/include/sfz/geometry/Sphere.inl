@@ -32,6 +32,15 @@ inline Sphere::Sphere(const vec3& center, float radius) noexcept
 // Public member functions
 // ------------------------------------------------------------------------------------------------
 
+inline Sphere Sphere::transformSphere(const mat4& transform) const noexcept
+{
+	const vec3 newCenter = transformPoint(transform, mCenter);
+	const float maxScaleSquared = std::max(squaredLength(transformDir(transform, vec3{1.0f, 0.0f, 0.0f})),
+	                              std::max(squaredLength(transformDir(transform, vec3{0.0f, 1.0f, 0.0f})),
+	                                       squaredLength(transformDir(transform, vec3{0.0f, 0.0f, 1.0f}))));
+	return Sphere{newCenter, mRadius * std::sqrt(maxScaleSquared)};
+}
+
 inline vec3 Sphere::closestPoint(const vec3& point) const noexcept
 {
 	const vec3 distToPoint = point - mCenter;
@@ -0,0 +1,126 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/ConvexShape.hpp"
+#include "sfz/math/Matrix.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// Continuous collision detection
+// ------------------------------------------------------------------------------------------------
+
+// Discrete overlap tests miss collisions when a shape moves further than its own size between two
+// frames (e.g. a tracked controller swung through a thin object). A sweep instead finds the time
+// of impact (TOI) of a shape moving from its previous to its current transform, using
+// conservative advancement (Mirtich, "Impulse-based Dynamic Simulation of Rigid Body Systems"):
+// GJK finds the distance to the static shape, which is divided by an upper bound on how fast any
+// point of the moving shape can approach it. The resulting step in time never passes through the
+// static shape, and the steps shrink as the shapes get closer.
+//
+// The motion between the transforms is interpolated with constant linear velocity of the local
+// origin and constant angular velocity around it, so the transforms must be rigid (no scaling).
+
+/// The toi of a sweep which never hits anything
+constexpr float SWEEP_MISS = std::numeric_limits<float>::max();
+
+struct SweepHit final {
+	/// The fraction of the motion in [0, 1] before the shapes touch, SWEEP_MISS if they never do.
+	/// 0 if the shapes already intersect at the start of the motion.
+	float toi = SWEEP_MISS;
+
+	/// The contact point on the static shape and the contact normal (pointing from the static
+	/// shape towards the moving shape) at toi
+	vec3 point = vec3(0.0f);
+	vec3 normal = vec3(0.0f);
+
+	/// The triangle hit, only set by TriangleBVH::sweep()
+	uint32_t triangleIndex = ~0u;
+
+	inline bool isHit() const noexcept { return toi != SWEEP_MISS; }
+};
+
+/// A convex shape given in local space, moving from a previous to a current transform. Computes
+/// the interpolation of the motion once, so it is cheap to sweep the same motion against many
+/// static shapes. The local shape is referenced and not copied.
+class SweptShape final {
+public:
+	// Constants
+	// --------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t MAX_ITERATIONS = 32;
+
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	SweptShape() = delete;
+	SweptShape(const SweptShape&) noexcept = default;
+	SweptShape& operator= (const SweptShape&) noexcept = default;
+
+	/// \param tolerance the distance at which the shapes are considered to be touching
+	SweptShape(const ConvexShape& localShape, const mat4& prevTransform, const mat4& transform,
+	           float tolerance = 0.001f) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Returns the interpolated transform at time t in [0, 1]
+	mat4 transformAt(float t) const noexcept;
+
+	/// Returns an AABB containing the shape during the whole motion
+	AABB bounds() const noexcept;
+
+	/// Finds the first time of impact with a static shape given in world space. Hits later than
+	/// maxToi are not reported, pass the closest hit found so far when sweeping against several
+	/// shapes. Motions needing more than MAX_ITERATIONS steps report a (slightly early) hit at
+	/// the last step rather than risking a miss.
+	SweepHit sweep(const ConvexShape& staticShape, float maxToi = 1.0f) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline const ConvexShape& localShape() const noexcept { return *mLocalShape; }
+
+	/// The distance from the local origin to the point of the shape furthest from it (bounded
+	/// using the support function along the local axes)
+	inline float radius() const noexcept { return mRadius; }
+
+private:
+	const ConvexShape* mLocalShape;
+	mat3 mStartRotation;
+	vec3 mStartPos, mLinearMotion;
+	vec3 mRotationAxis;
+	float mRotationAngle;
+	float mRadius;
+	float mTolerance;
+};
+
+/// Convenience function sweeping a shape against a single static shape, see SweptShape
+SweepHit sweep(const ConvexShape& localShape, const mat4& prevTransform, const mat4& transform,
+               const ConvexShape& staticShape) noexcept;
+
+} // namespace sfz
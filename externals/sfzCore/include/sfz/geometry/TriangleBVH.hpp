@@ -0,0 +1,120 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/BVH.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sweep.hpp"
+#include "sfz/math/Vector.hpp"
+
+namespace sfz {
+
+using std::uint32_t;
+
+// RayHit
+// ------------------------------------------------------------------------------------------------
+
+/// The closest hit of a ray against a triangle mesh. uv are the barycentric coordinates of the
+/// hit point relative to the second and third vertices of the triangle, i.e. the hit point is
+/// (1 - u - v) * v0 + u * v1 + v * v2.
+struct RayHit final {
+	float dist = RAY_MISS;
+	uint32_t triangleIndex = ~0u;
+	vec2 uv = vec2(0.0f);
+
+	inline bool isHit() const noexcept { return dist != RAY_MISS; }
+};
+
+// TriangleBVH
+// ------------------------------------------------------------------------------------------------
+
+/// A BVH over the triangles of an indexed mesh, for ray casts against meshes with a large number
+/// of triangles (e.g. picking with a tracked controller).
+///
+/// The triangle vertices are copied into SoA arrays in leaf order when built, so a leaf (up to
+/// four triangles) is tested against the ray with a single packet intersection test and the
+/// original vertex data is not needed afterwards. Triangles are referred to by their index in the
+/// index array divided by 3.
+class TriangleBVH final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	TriangleBVH() noexcept = default;
+	TriangleBVH(const TriangleBVH&) noexcept = default;
+	TriangleBVH& operator= (const TriangleBVH&) noexcept = default;
+	TriangleBVH(TriangleBVH&&) noexcept = default;
+	TriangleBVH& operator= (TriangleBVH&&) noexcept = default;
+
+	TriangleBVH(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+	            uint32_t numThreads = 1) noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Builds the BVH from an indexed triangle list, numIndices must be a multiple of 3.
+	/// numThreads is forwarded to BVH::build().
+	void build(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+	           uint32_t numThreads = 1) noexcept;
+
+	/// Restores a BVH previously built from the same triangles using the nodes and primitive
+	/// indices of its bvh(), see BVH::restore(). Returns false and leaves the BVH empty if they
+	/// are invalid.
+	bool restore(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+	             const BVHNode* nodes, uint32_t numNodes, const uint32_t* primitiveIndices) noexcept;
+
+	/// Removes all triangles
+	void clear() noexcept;
+
+	/// Returns the closest (double sided) triangle hit by the ray within its max distance
+	RayHit raycast(const Ray& ray) const noexcept;
+
+	/// Returns the first (double sided) triangle hit by the swept shape, see SweptShape. Only
+	/// triangles overlapping the bounds of the whole motion are swept against.
+	SweepHit sweep(const SweptShape& swept) const noexcept;
+
+	// Getters
+	// --------------------------------------------------------------------------------------------
+
+	inline uint32_t numTriangles() const noexcept { return mBVH.numPrimitives(); }
+	inline const BVH& bvh() const noexcept { return mBVH; }
+
+private:
+	// Private methods
+	// --------------------------------------------------------------------------------------------
+
+	/// Copies the triangle vertices into the SoA arrays in the leaf order of mBVH
+	void copyVerticesInLeafOrder(const vec3* positions, const uint32_t* indices) noexcept;
+
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	BVH mBVH;
+
+	// Triangle vertices in leaf order as SoA arrays, padded so that four triangles can always be
+	// loaded from the start of a leaf
+	DynArray<float> mV0X, mV0Y, mV0Z;
+	DynArray<float> mV1X, mV1Y, mV1Z;
+	DynArray<float> mV2X, mV2Y, mV2Z;
+};
+
+} // namespace sfz
@@ -18,6 +18,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <sfz/geometry/Plane.hpp>
 #include <sfz/geometry/ViewFrustum.hpp>
 #include <sfz/math/Vector.hpp>
@@ -44,6 +47,22 @@ public:
 
 	ViewFrustum(vec3 position, vec3 direction, vec3 up, float verticalFovDeg, float aspect,
 	            float near, float far) noexcept;
+
+	/// Creates a frustum from an arbitrary (possibly asymmetric) OpenGL style view and projection
+	/// matrix. The six planes are extracted exactly from projMatrix * viewMatrix (Gribb/Hartmann).
+	/// The position, direction and clip distances are derived from the matrices, the fov and
+	/// aspect ratio getters return the total angles spanned by the frustum. Note that calling any
+	/// of the setters rebuilds the frustum from these (symmetric) parameters.
+	ViewFrustum(const mat4& viewMatrix, const mat4& projMatrix) noexcept;
+
+	/// Creates a single frustum enclosing both eye frustums of a stereo pair, so that a scene can
+	/// be culled once per frame instead of once per eye. The left and right planes are taken from
+	/// the respective eye, the remaining planes use the averaged normals of both eyes. Every plane
+	/// is pushed out until all corners of both eye frustums are on its inside, which makes the
+	/// result conservative even for canted or asymmetric lens frustums. viewMatrix() and
+	/// projMatrix() of the combined frustum are a symmetric approximation.
+	static ViewFrustum combinedStereo(const mat4& leftViewMatrix, const mat4& leftProjMatrix,
+	                                  const mat4& rightViewMatrix, const mat4& rightProjMatrix) noexcept;
 	
 	// Public methods
 	// --------------------------------------------------------------------------------------------
@@ -53,6 +72,21 @@ public:
 	bool isVisible(const Sphere& sphere) const noexcept;
 	bool isVisible(const ViewFrustum& viewFrustum) const noexcept;
 
+	// Public methods (batch)
+	// --------------------------------------------------------------------------------------------
+
+	/// Tests count spheres stored as SoA arrays (center x, y, z and radius) against the frustum.
+	/// Bit (i % 32) of visibleMaskOut[i / 32] is set if sphere i is visible, (count + 31) / 32
+	/// words are written. Objects are tested 8 at a time and a packet stops being tested against
+	/// the remaining planes as soon as all of its objects have been culled.
+	void cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+	                 const float* radius, size_t count, uint32_t* visibleMaskOut) const noexcept;
+
+	/// Same as cullSpheres(), but for count AABBs stored as SoA arrays of min and max corners.
+	void cullAABBs(const float* minX, const float* minY, const float* minZ,
+	               const float* maxX, const float* maxY, const float* maxZ,
+	               size_t count, uint32_t* visibleMaskOut) const noexcept;
+
 	// Getters
 	// --------------------------------------------------------------------------------------------
 
@@ -65,6 +99,12 @@ public:
 	inline float far() const noexcept { return mFar; }
 	inline const mat4& viewMatrix() const noexcept { return mViewMatrix; }
 	inline const mat4& projMatrix() const noexcept { return mProjMatrix; }
+	inline const Plane& nearPlane() const noexcept { return mNearPlane; }
+	inline const Plane& farPlane() const noexcept { return mFarPlane; }
+	inline const Plane& upPlane() const noexcept { return mUpPlane; }
+	inline const Plane& downPlane() const noexcept { return mDownPlane; }
+	inline const Plane& leftPlane() const noexcept { return mLeftPlane; }
+	inline const Plane& rightPlane() const noexcept { return mRightPlane; }
 
 	// Setters
 	// --------------------------------------------------------------------------------------------
@@ -85,6 +125,7 @@ private:
 	void update() noexcept;
 	void updateMatrices() noexcept;
 	void updatePlanes() noexcept;
+	void updateParamsFromPlanes() noexcept;
 
 	// Private members
 	// --------------------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include "sfz/math/Vector.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+/// Fast approximations of common math functions.
+///
+/// These are opt-in replacements for the standard library functions and are meant for hot loops
+/// where some precision can be traded for speed. Each function documents its maximum error over
+/// its valid input range, the bounds are verified in the tests. None of the functions handle
+/// NaN or infinity in any meaningful way.
+///
+/// All functions have a scalar and a packet (FloatPacket/Vec3Packet) version. The packet versions
+/// simply apply the inlined scalar function to each lane, they are not written with lane masks.
+/// Whether the lane loop is vectorized is up to the compiler, see the floatx8 entries of the math
+/// benchmarks.
+
+namespace sfz {
+
+// Scalar functions
+// ------------------------------------------------------------------------------------------------
+
+/// Approximates 1 / sqrt(x) for x > 0.
+/// Max relative error: 1.8e-3
+float fastRsqrt(float x) noexcept;
+
+/// Approximates sqrt(x) for x >= 0.
+/// Max relative error: 1.8e-3
+float fastSqrt(float x) noexcept;
+
+/// Normalizes a vector using fastRsqrt().
+/// Max relative error in length of result: 1.8e-3
+vec3 fastNormalize(const vec3& vector) noexcept;
+
+/// Approximates sin(x) for |x| <= 1e4 (radians).
+/// Max absolute error: 5e-7
+float fastSin(float x) noexcept;
+
+/// Approximates cos(x) for |x| <= 1e4 (radians).
+/// Max absolute error: 5e-7
+float fastCos(float x) noexcept;
+
+/// Approximates atan2(y, x), returns 0 if both x and y are 0.
+/// Max absolute error: 1.5e-5 radians
+float fastAtan2(float y, float x) noexcept;
+
+/// Approximates exp(x), x is clamped to [-87, 88].
+/// Max relative error: 5e-7
+float fastExp(float x) noexcept;
+
+// Packet functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W> fastRsqrt(const FloatPacket<W>& x) noexcept;
+
+template<size_t W>
+FloatPacket<W> fastSqrt(const FloatPacket<W>& x) noexcept;
+
+template<size_t W>
+Vec3Packet<W> fastNormalize(const Vec3Packet<W>& vector) noexcept;
+
+template<size_t W>
+FloatPacket<W> fastSin(const FloatPacket<W>& x) noexcept;
+
+template<size_t W>
+FloatPacket<W> fastCos(const FloatPacket<W>& x) noexcept;
+
+template<size_t W>
+FloatPacket<W> fastAtan2(const FloatPacket<W>& y, const FloatPacket<W>& x) noexcept;
+
+template<size_t W>
+FloatPacket<W> fastExp(const FloatPacket<W>& x) noexcept;
+
+} // namespace sfz
+
+#include "sfz/math/FastMath.inl"
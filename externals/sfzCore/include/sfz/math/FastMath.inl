@@ -0,0 +1,202 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include <cstdint>
+#include <cstring>
+
+#include "sfz/math/MathConstants.hpp"
+
+namespace sfz {
+
+// Scalar functions
+// ------------------------------------------------------------------------------------------------
+
+inline float fastRsqrt(float x) noexcept
+{
+	// Initial guess with magic constant from Lomont, "Fast inverse square root" (2003), followed
+	// by one Newton-Raphson iteration.
+	std::uint32_t bits;
+	std::memcpy(&bits, &x, sizeof(float));
+	bits = 0x5F375A86u - (bits >> 1);
+	float y;
+	std::memcpy(&y, &bits, sizeof(float));
+	return y * (1.5f - 0.5f * x * y * y);
+}
+
+inline float fastSqrt(float x) noexcept
+{
+	// Avoids 0 * inf for x == 0
+	return x <= 0.0f ? 0.0f : x * fastRsqrt(x);
+}
+
+inline vec3 fastNormalize(const vec3& vector) noexcept
+{
+	return vector * fastRsqrt(dot(vector, vector));
+}
+
+namespace detail {
+
+/// Reduces an angle to [-Pi, Pi]. The subtraction is done in double precision, which keeps the
+/// result accurate for large x. A Cody-Waite split of 2 * Pi into two float constants would not
+/// survive -ffast-math, the compiler may merge the two subtractions into one.
+inline float reduceAngle(float x) noexcept
+{
+	const double TWO_PI = 6.283185307179586476925;
+	const float k = x * (1.0f / (2.0f * PI<float>()));
+	const float rounded = float(std::int32_t(k + (k >= 0.0f ? 0.5f : -0.5f)));
+	return float(double(x) - double(rounded) * TWO_PI);
+}
+
+/// Approximates sin(x) for x in [-3Pi/2, 3Pi/2]
+inline float sinReduced(float x) noexcept
+{
+	// Fold to [-Pi/2, Pi/2] using sin(x) = sin(Pi - x)
+	x = x > (0.5f * PI<float>()) ? (PI<float>() - x) : x;
+	x = x < (-0.5f * PI<float>()) ? (-PI<float>() - x) : x;
+
+	// Taylor polynomial of degree 11 in Horner form
+	const float x2 = x * x;
+	return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f
+	         + x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+}
+
+} // namespace detail
+
+inline float fastSin(float x) noexcept
+{
+	return detail::sinReduced(detail::reduceAngle(x));
+}
+
+inline float fastCos(float x) noexcept
+{
+	// cos(x) = sin(x + Pi/2), the offset is added after reduction to not lose precision
+	return detail::sinReduced(detail::reduceAngle(x) + 0.5f * PI<float>());
+}
+
+inline float fastAtan2(float y, float x) noexcept
+{
+	const float absX = x < 0.0f ? -x : x;
+	const float absY = y < 0.0f ? -y : y;
+	const float maxVal = absX > absY ? absX : absY;
+	const float minVal = absX > absY ? absY : absX;
+
+	// Approximate atan(a) on [0, 1] with a minimax polynomial, see Abramowitz & Stegun 4.4.49
+	const float a = maxVal == 0.0f ? 0.0f : (minVal / maxVal);
+	const float s = a * a;
+	float r = ((((0.0208351f * s - 0.0851330f) * s + 0.1801410f) * s - 0.3302995f) * s
+	        + 0.9998660f) * a;
+
+	// Map back to the correct octant
+	r = absY > absX ? (0.5f * PI<float>() - r) : r;
+	r = x < 0.0f ? (PI<float>() - r) : r;
+	return y < 0.0f ? -r : r;
+}
+
+inline float fastExp(float x) noexcept
+{
+	// exp(x) = 2^n * exp(r), where x = n * ln(2) + r and |r| <= ln(2) / 2
+	// r is computed in double precision to stay accurate for large n, see reduceAngle()
+	const double LN2 = 0.693147180559945309417;
+	x = x < -87.0f ? -87.0f : x;
+	x = x > 88.0f ? 88.0f : x;
+	const float k = x * (1.0f / 0.69314718056f);
+	const std::int32_t n = std::int32_t(k + (k >= 0.0f ? 0.5f : -0.5f));
+	const float r = float(double(x) - double(n) * LN2);
+
+	// Taylor polynomial of degree 6 in Horner form
+	const float expR = 1.0f + r * (1.0f + r * (1.0f / 2.0f + r * (1.0f / 6.0f + r * (1.0f / 24.0f
+	                 + r * (1.0f / 120.0f + r * (1.0f / 720.0f))))));
+
+	// Construct 2^n directly in the exponent bits, n is in [-126, 127] due to the clamping above
+	const std::uint32_t bits = std::uint32_t(n + 127) << 23;
+	float scale;
+	std::memcpy(&scale, &bits, sizeof(float));
+	return expR * scale;
+}
+
+// Packet functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W> fastRsqrt(const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastRsqrt(x.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> fastSqrt(const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastSqrt(x.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+Vec3Packet<W> fastNormalize(const Vec3Packet<W>& vector) noexcept
+{
+	return vector * fastRsqrt(dot(vector, vector));
+}
+
+template<size_t W>
+FloatPacket<W> fastSin(const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastSin(x.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> fastCos(const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastCos(x.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> fastAtan2(const FloatPacket<W>& y, const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastAtan2(y.lanes[i], x.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> fastExp(const FloatPacket<W>& x) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = fastExp(x.lanes[i]);
+	}
+	return tmp;
+}
+
+} // namespace sfz
@@ -68,41 +68,41 @@ struct Matrix final {
 
 	/// \brief Constructs a matrix with the elements in an array.
 	/// The rowMajorData flag determines whether the array is in row major or column major order.
-	Matrix(const T* arrayPtr, bool rowMajorData) noexcept;
+	constexpr Matrix(const T* arrayPtr, bool rowMajorData) noexcept;
 
 	/// \brief Constructs a matrix with the given elements given in ROW-MAJOR order.
 	/// The elements are given in row-major order because it's more natural to write and read a
 	/// matrix that way in source. This is however not how the elements will be saved as the
 	/// internal representation uses column-major order. Any unspecified elements will be set to 0.
 	/// sfz_assert_debug: if any of the lists are larger than the row or column it's trying to fill
-	Matrix(std::initializer_list<std::initializer_list<T>> list) noexcept;
+	constexpr Matrix(std::initializer_list<std::initializer_list<T>> list) noexcept;
 
 	// Member functions
 	// --------------------------------------------------------------------------------------------
 
 	/// \brief General accessor returning the reference to element at the i:th row and j:th column
 	/// sfz_assert_debug: location must be in range
-	T& at(size_t i, size_t j) noexcept;
+	constexpr T& at(size_t i, size_t j) noexcept;
 
 	/// \brief Returns the element at the i:th row and j:th column
 	/// sfz_assert_debug: location must be in range
-	T at(size_t i, size_t j) const noexcept;
+	constexpr T at(size_t i, size_t j) const noexcept;
 
 	/// sfz_assert_debug: location must be in range
-	Vector<T,N> rowAt(size_t i) const noexcept;
+	constexpr Vector<T,N> rowAt(size_t i) const noexcept;
 
 	/// sfz_assert_debug: location must be in range
-	Vector<T,M> columnAt(size_t j) const noexcept;
+	constexpr Vector<T,M> columnAt(size_t j) const noexcept;
 
 	/// \brief Assigns value to element at the i:th row and j:th column
 	/// sfz_assert_debug: location must be in range
-	void set(size_t i, size_t j, T value) noexcept;
+	constexpr void set(size_t i, size_t j, T value) noexcept;
 
 	/// sfz_assert_debug: location must be in range
-	void setRow(size_t i, const Vector<T,N>& row) noexcept;
+	constexpr void setRow(size_t i, const Vector<T,N>& row) noexcept;
 
 	/// sfz_assert_debug: location must be in range
-	void setColumn(size_t j, const Vector<T,M>& column) noexcept;
+	constexpr void setColumn(size_t j, const Vector<T,M>& column) noexcept;
 };
 
 // Matrix constants
@@ -115,14 +115,14 @@ Matrix<T,M,N> ZERO_MATRIX() noexcept;
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-void fill(Matrix<T,M,N>& matrix, T value);
+constexpr void fill(Matrix<T,M,N>& matrix, T value) noexcept;
 
 /// Element-wise multiplication of two matrices
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> elemMult(const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N> elemMult(const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,N,M> transpose(const Matrix<T,M,N>& matrix) noexcept;
+constexpr Matrix<T,N,M> transpose(const Matrix<T,M,N>& matrix) noexcept;
 
 template<typename T, size_t M, size_t N>
 size_t hash(const Matrix<T,M,N>& matrix) noexcept;
@@ -147,49 +147,49 @@ void toString(const Matrix<int32_t,M,N>& matrix, StackString256& string, bool ro
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator+= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N>& operator+= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator-= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N>& operator-= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator*= (Matrix<T,M,N>& lhs, T rhs) noexcept;
+constexpr Matrix<T,M,N>& operator*= (Matrix<T,M,N>& lhs, T rhs) noexcept;
 
 template<typename T, size_t N>
-Matrix<T,N,N>& operator*= (Matrix<T,N,N>& lhs, const Matrix<T,N,N>& rhs) noexcept;
+constexpr Matrix<T,N,N>& operator*= (Matrix<T,N,N>& lhs, const Matrix<T,N,N>& rhs) noexcept;
 
 // Operators (arithmetic)
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator+ (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N> operator+ (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator- (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N> operator- (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator- (const Matrix<T,M,N>& matrix) noexcept;
+constexpr Matrix<T,M,N> operator- (const Matrix<T,M,N>& matrix) noexcept;
 
 template<typename T, size_t M, size_t N, size_t P>
-Matrix<T,M,P> operator* (const Matrix<T,M,N>& lhs, const Matrix<T,N,P>& rhs) noexcept;
+constexpr Matrix<T,M,P> operator* (const Matrix<T,M,N>& lhs, const Matrix<T,N,P>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Vector<T,M> operator* (const Matrix<T,M,N>& lhs, const Vector<T,N>& rhs) noexcept;
+constexpr Vector<T,M> operator* (const Matrix<T,M,N>& lhs, const Vector<T,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator* (const Matrix<T,M,N>& lhs, T rhs) noexcept;
+constexpr Matrix<T,M,N> operator* (const Matrix<T,M,N>& lhs, T rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator* (T lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr Matrix<T,M,N> operator* (T lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 // Operators (comparison)
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-bool operator== (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr bool operator== (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 template<typename T, size_t M, size_t N>
-bool operator!= (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
+constexpr bool operator!= (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept;
 
 // Standard typedefs
 // ------------------------------------------------------------------------------------------------
@@ -22,34 +22,33 @@ namespace sfz {
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>::Matrix(const T* arrayPtr, bool rowMajorData) noexcept
+constexpr Matrix<T,M,N>::Matrix(const T* arrayPtr, bool rowMajorData) noexcept
+:
+	elements{}
 {
 	static_assert(sizeof(elements) == (M*N*sizeof(T)), "Matrix is padded.");
-	T* data = this->data();
 	if (rowMajorData) {
 		for (size_t i = 0; i < M; ++i) {
 			for (size_t j = 0; j < N; ++j) {
-				data[j*M + i] = arrayPtr[i*N + j];
+				elements[j][i] = arrayPtr[i*N + j];
 			}
 		}
 	} else {
-		for (size_t i = 0; i < M*N; ++i) {
-			data[i] = arrayPtr[i];
+		for (size_t j = 0; j < N; ++j) {
+			for (size_t i = 0; i < M; ++i) {
+				elements[j][i] = arrayPtr[j*M + i];
+			}
 		}
 	}
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>::Matrix(std::initializer_list<std::initializer_list<T>> list) noexcept
+constexpr Matrix<T,M,N>::Matrix(std::initializer_list<std::initializer_list<T>> list) noexcept
+:
+	elements{}
 {
 	static_assert(sizeof(elements) == (M*N*sizeof(T)), "Matrix is padded.");
 
-	for (size_t j = 0; j < N; ++j) {
-		for (size_t i = 0; i < M; ++i) {
-			elements[j][i] = T(0);
-		}
-	}
-
 	sfz_assert_debug(list.size() <= M);
 	const std::initializer_list<T>* rowsPtr = list.begin();
 	for (size_t i = 0; i < list.size(); ++i) {
@@ -64,7 +63,7 @@ Matrix<T,M,N>::Matrix(std::initializer_list<std::initializer_list<T>> list) noex
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-T& Matrix<T,M,N>::at(size_t i, size_t j) noexcept
+constexpr T& Matrix<T,M,N>::at(size_t i, size_t j) noexcept
 {
 	sfz_assert_debug(i < M);
 	sfz_assert_debug(j < N);
@@ -72,7 +71,7 @@ T& Matrix<T,M,N>::at(size_t i, size_t j) noexcept
 }
 
 template<typename T, size_t M, size_t N>
-T Matrix<T,M,N>::at(size_t i, size_t j) const noexcept
+constexpr T Matrix<T,M,N>::at(size_t i, size_t j) const noexcept
 {
 	sfz_assert_debug(i < M);
 	sfz_assert_debug(j < N);
@@ -80,10 +79,10 @@ T Matrix<T,M,N>::at(size_t i, size_t j) const noexcept
 }
 
 template<typename T, size_t M, size_t N>
-Vector<T,N> Matrix<T,M,N>::rowAt(size_t i) const noexcept
+constexpr Vector<T,N> Matrix<T,M,N>::rowAt(size_t i) const noexcept
 {
 	sfz_assert_debug(i < M);
-	Vector<T,N> row;
+	Vector<T,N> row{};
 	for (size_t j = 0; j < N; j++) {
 		row[j] = elements[j][i];
 	}
@@ -91,10 +90,10 @@ Vector<T,N> Matrix<T,M,N>::rowAt(size_t i) const noexcept
 }
 
 template<typename T, size_t M, size_t N>
-Vector<T,M> Matrix<T,M,N>::columnAt(size_t j) const noexcept
+constexpr Vector<T,M> Matrix<T,M,N>::columnAt(size_t j) const noexcept
 {
 	sfz_assert_debug(j < N);
-	Vector<T,M> column;
+	Vector<T,M> column{};
 	for (size_t i = 0; i < M; i++) {
 		column[i] = elements[j][i];
 	}
@@ -102,7 +101,7 @@ Vector<T,M> Matrix<T,M,N>::columnAt(size_t j) const noexcept
 }
 
 template<typename T, size_t M, size_t N>
-void Matrix<T,M,N>::set(size_t i, size_t j, T value) noexcept
+constexpr void Matrix<T,M,N>::set(size_t i, size_t j, T value) noexcept
 {
 	sfz_assert_debug(i < M);
 	sfz_assert_debug(j < N);
@@ -110,24 +109,20 @@ void Matrix<T,M,N>::set(size_t i, size_t j, T value) noexcept
 }
 
 template<typename T, size_t M, size_t N>
-void Matrix<T,M,N>::setRow(size_t i, const Vector<T,N>& row) noexcept
+constexpr void Matrix<T,M,N>::setRow(size_t i, const Vector<T,N>& row) noexcept
 {
 	sfz_assert_debug(i < M);
-	size_t j = 0;
-	for (auto element : row) {
-		elements[j][i] = element;
-		j++;
+	for (size_t j = 0; j < N; j++) {
+		elements[j][i] = row.elements[j];
 	}
 }
 
 template<typename T, size_t M, size_t N>
-void Matrix<T,M,N>::setColumn(size_t j, const Vector<T,M>& column) noexcept
+constexpr void Matrix<T,M,N>::setColumn(size_t j, const Vector<T,M>& column) noexcept
 {
 	sfz_assert_debug(j < N);
-	size_t i = 0;
-	for (auto element : column) {
-		elements[j][i] = element;
-		i++;
+	for (size_t i = 0; i < M; i++) {
+		elements[j][i] = column.elements[i];
 	}
 }
 
@@ -145,7 +140,7 @@ Matrix<T,M,N> ZERO_MATRIX() noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-void fill(Matrix<T, M, N>& matrix, T value)
+constexpr void fill(Matrix<T, M, N>& matrix, T value) noexcept
 {
 	for (size_t i = 0; i < M; ++i) {
 		for (size_t j = 0; j < N; ++j) {
@@ -155,9 +150,9 @@ void fill(Matrix<T, M, N>& matrix, T value)
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> elemMult(const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N> elemMult(const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
-	Matrix<T,M,N> resMatrix;
+	Matrix<T,M,N> resMatrix{};
 	for (size_t i = 0; i < M; i++) {
 		for (size_t j = 0; j < N; j++) {
 			resMatrix.elements[j][i] = lhs.elements[j][i] * rhs.elements[j][i];
@@ -167,9 +162,9 @@ Matrix<T,M,N> elemMult(const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexc
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,N,M> transpose(const Matrix<T,M,N>& matrix) noexcept
+constexpr Matrix<T,N,M> transpose(const Matrix<T,M,N>& matrix) noexcept
 {
-	Matrix<T,N,M> resMatrix;
+	Matrix<T,N,M> resMatrix{};
 	for (size_t i = 0; i < N; i++) {
 		for (size_t j = 0; j < M; j++) {
 			resMatrix.elements[j][i] = matrix.elements[i][j];
@@ -252,7 +247,7 @@ void toString(const Matrix<int32_t,M,N>& matrix, StackString256& string, bool ro
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator+= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N>& operator+= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	for (size_t i = 0; i < M; ++i) {
 		for (size_t j = 0; j < N; ++j) {
@@ -263,7 +258,7 @@ Matrix<T,M,N>& operator+= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcep
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator-= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N>& operator-= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	for (size_t i = 0; i < M; ++i) {
 		for (size_t j = 0; j < N; ++j) {
@@ -274,7 +269,7 @@ Matrix<T,M,N>& operator-= (Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcep
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N>& operator*= (Matrix<T,M,N>& lhs, T rhs) noexcept
+constexpr Matrix<T,M,N>& operator*= (Matrix<T,M,N>& lhs, T rhs) noexcept
 {
 	for (size_t i = 0; i < M; i++) {
 		for (size_t j = 0; j < N; j++) {
@@ -285,7 +280,7 @@ Matrix<T,M,N>& operator*= (Matrix<T,M,N>& lhs, T rhs) noexcept
 }
 
 template<typename T, size_t N>
-Matrix<T,N,N>& operator*= (Matrix<T,N,N>& lhs, const Matrix<T,N,N>& rhs) noexcept
+constexpr Matrix<T,N,N>& operator*= (Matrix<T,N,N>& lhs, const Matrix<T,N,N>& rhs) noexcept
 {
 	return (lhs = lhs * rhs);
 }
@@ -294,30 +289,30 @@ Matrix<T,N,N>& operator*= (Matrix<T,N,N>& lhs, const Matrix<T,N,N>& rhs) noexcep
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator+ (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N> operator+ (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	Matrix<T,M,N> temp{lhs};
 	return (temp += rhs);
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator- (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N> operator- (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	Matrix<T,M,N> temp{lhs};
 	return (temp -= rhs);
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator- (const Matrix<T,M,N>& matrix) noexcept
+constexpr Matrix<T,M,N> operator- (const Matrix<T,M,N>& matrix) noexcept
 {
 	Matrix<T,M,N> temp{matrix};
 	return (temp *= T(-1));
 }
 
 template<typename T, size_t M, size_t N, size_t P>
-Matrix<T,M,P> operator* (const Matrix<T,M,N>& lhs, const Matrix<T,N,P>& rhs) noexcept
+constexpr Matrix<T,M,P> operator* (const Matrix<T,M,N>& lhs, const Matrix<T,N,P>& rhs) noexcept
 {
-	Matrix<T,M,P> resMatrix;
+	Matrix<T,M,P> resMatrix{};
 	for (size_t i = 0; i < M; i++) {
 		for (size_t j = 0; j < P; j++) {
 			T temp = 0;
@@ -335,9 +330,9 @@ Matrix<T,M,P> operator* (const Matrix<T,M,N>& lhs, const Matrix<T,N,P>& rhs) noe
 }
 
 template<typename T, size_t M, size_t N>
-Vector<T,M> operator* (const Matrix<T,M,N>& lhs, const Vector<T,N>& rhs) noexcept
+constexpr Vector<T,M> operator* (const Matrix<T,M,N>& lhs, const Vector<T,N>& rhs) noexcept
 {
-	Vector<T,M> resVector;
+	Vector<T,M> resVector{};
 	for (size_t i = 0; i < M; ++i) {
 		T temp = 0;
 		size_t jInnerThis = 0;
@@ -351,14 +346,14 @@ Vector<T,M> operator* (const Matrix<T,M,N>& lhs, const Vector<T,N>& rhs) noexcep
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator* (const Matrix<T,M,N>& lhs, T rhs) noexcept
+constexpr Matrix<T,M,N> operator* (const Matrix<T,M,N>& lhs, T rhs) noexcept
 {
 	Matrix<T,M,N> temp{lhs};
 	return (temp *= rhs);
 }
 
 template<typename T, size_t M, size_t N>
-Matrix<T,M,N> operator* (T lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr Matrix<T,M,N> operator* (T lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	return rhs * lhs;
 }
@@ -367,7 +362,7 @@ Matrix<T,M,N> operator* (T lhs, const Matrix<T,M,N>& rhs) noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t M, size_t N>
-bool operator== (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr bool operator== (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	for (size_t i = 0; i < M; i++) {
 		for (size_t j = 0; j < N; j++) {
@@ -380,7 +375,7 @@ bool operator== (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 }
 
 template<typename T, size_t M, size_t N>
-bool operator!= (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
+constexpr bool operator!= (const Matrix<T,M,N>& lhs, const Matrix<T,M,N>& rhs) noexcept
 {
 	return !(lhs == rhs);
 }
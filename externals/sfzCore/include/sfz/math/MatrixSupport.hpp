@@ -95,28 +95,28 @@ Matrix<T,4,4> rotationMatrix4(const sfz::Vector<T,3>& axis, T angleRads) noexcep
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Matrix<T,3,3> identityMatrix3() noexcept;
+constexpr Matrix<T,3,3> identityMatrix3() noexcept;
 
 template<typename T>
-Matrix<T,4,4> identityMatrix4() noexcept;
+constexpr Matrix<T,4,4> identityMatrix4() noexcept;
 
 template<typename T>
-Matrix<T,3,3> scalingMatrix3(T scaleFactor) noexcept;
+constexpr Matrix<T,3,3> scalingMatrix3(T scaleFactor) noexcept;
 
 template<typename T>
-Matrix<T,4,4> scalingMatrix4(T scaleFactor) noexcept;
+constexpr Matrix<T,4,4> scalingMatrix4(T scaleFactor) noexcept;
 
 template<typename T>
-Matrix<T,3,3> scalingMatrix3(T scaleX, T scaleY, T scaleZ) noexcept;
+constexpr Matrix<T,3,3> scalingMatrix3(T scaleX, T scaleY, T scaleZ) noexcept;
 
 template<typename T>
-Matrix<T,4,4> scalingMatrix4(T scaleX, T scaleY, T scaleZ) noexcept;
+constexpr Matrix<T,4,4> scalingMatrix4(T scaleX, T scaleY, T scaleZ) noexcept;
 
 template<typename T>
-Matrix<T,4,4> translationMatrix(T deltaX, T deltaY, T deltaZ) noexcept;
+constexpr Matrix<T,4,4> translationMatrix(T deltaX, T deltaY, T deltaZ) noexcept;
 
 template<typename T>
-Matrix<T,4,4> translationMatrix(const Vector<T,3>& delta) noexcept;
+constexpr Matrix<T,4,4> translationMatrix(const Vector<T,3>& delta) noexcept;
 
 // Projection matrices
 // ------------------------------------------------------------------------------------------------
@@ -281,7 +281,7 @@ Matrix<T,4,4> rotationMatrix4(const sfz::Vector<T,3>& axis, T angleRads) noexcep
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Matrix<T,3,3> identityMatrix3() noexcept
+constexpr Matrix<T,3,3> identityMatrix3() noexcept
 {
 	return Matrix<T,3,3>{{1, 0, 0},
 	                     {0, 1, 0},
@@ -289,7 +289,7 @@ Matrix<T,3,3> identityMatrix3() noexcept
 }
 
 template<typename T>
-Matrix<T,4,4> identityMatrix4() noexcept
+constexpr Matrix<T,4,4> identityMatrix4() noexcept
 {
 	return Matrix<T,4,4>{{1, 0, 0, 0},
 	                     {0, 1, 0, 0},
@@ -298,7 +298,7 @@ Matrix<T,4,4> identityMatrix4() noexcept
 }
 
 template<typename T>
-Matrix<T,3,3> scalingMatrix3(T scaleFactor) noexcept
+constexpr Matrix<T,3,3> scalingMatrix3(T scaleFactor) noexcept
 {
 	return Matrix<T,3,3>{{scaleFactor, 0, 0},
 	                     {0, scaleFactor, 0},
@@ -306,7 +306,7 @@ Matrix<T,3,3> scalingMatrix3(T scaleFactor) noexcept
 }
 
 template<typename T>
-Matrix<T,4,4> scalingMatrix4(T scaleFactor) noexcept
+constexpr Matrix<T,4,4> scalingMatrix4(T scaleFactor) noexcept
 {
 	return Matrix<T,4,4>{{scaleFactor, 0, 0, 0},
 	                     {0, scaleFactor, 0, 0},
@@ -315,7 +315,7 @@ Matrix<T,4,4> scalingMatrix4(T scaleFactor) noexcept
 }
 
 template<typename T>
-Matrix<T,3,3> scalingMatrix3(T scaleX, T scaleY, T scaleZ) noexcept
+constexpr Matrix<T,3,3> scalingMatrix3(T scaleX, T scaleY, T scaleZ) noexcept
 {
 	return Matrix<T,3,3>{{scaleX, 0, 0},
 	                     {0, scaleY, 0},
@@ -323,7 +323,7 @@ Matrix<T,3,3> scalingMatrix3(T scaleX, T scaleY, T scaleZ) noexcept
 }
 
 template<typename T>
-Matrix<T,4,4> scalingMatrix4(T scaleX, T scaleY, T scaleZ) noexcept
+constexpr Matrix<T,4,4> scalingMatrix4(T scaleX, T scaleY, T scaleZ) noexcept
 {
 	return Matrix<T,4,4>{{scaleX, 0, 0, 0},
 	                     {0, scaleY, 0, 0},
@@ -332,7 +332,7 @@ Matrix<T,4,4> scalingMatrix4(T scaleX, T scaleY, T scaleZ) noexcept
 }
 
 template<typename T>
-Matrix<T,4,4> translationMatrix(T deltaX, T deltaY, T deltaZ) noexcept
+constexpr Matrix<T,4,4> translationMatrix(T deltaX, T deltaY, T deltaZ) noexcept
 {
 	return Matrix<T,4,4>{{1, 0, 0, deltaX},
 	                     {0, 1, 0, deltaY},
@@ -341,7 +341,7 @@ Matrix<T,4,4> translationMatrix(T deltaX, T deltaY, T deltaZ) noexcept
 }
 
 template<typename T>
-Matrix<T,4,4> translationMatrix(const Vector<T,3>& delta) noexcept
+constexpr Matrix<T,4,4> translationMatrix(const Vector<T,3>& delta) noexcept
 {
 	return translationMatrix(delta[0], delta[1], delta[2]);
 }
@@ -0,0 +1,165 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::int16_t, std::uint16_t
+
+#include "sfz/math/Vector.hpp"
+
+/// Packed vector types used for vertex compression.
+///
+/// HalfVector stores IEEE 754 binary16 floats. Unorm16Vector and Snorm16Vector store normalized
+/// fixed point values in the ranges [0, 1] and [-1, 1] respectively. Unit normals are packed into
+/// a snorm16x2 using octahedral encoding, and positions are packed into an unorm16x3 relative to
+/// a bounding box.
+///
+/// The single element functions are meant for ad hoc use, for larger arrays the batch kernels
+/// should be used instead. The batch kernels are currently plain loops over the single element
+/// conversions, so the compiler can inline them and hoist the per-array setup (e.g. the
+/// quantization scale) out of the loop. They are not written with packets: versions using
+/// floatx4/vec3x4 (VectorPacket.hpp) measured slower, the AoS <-> SoA transposes and the per-lane
+/// integer conversions cost more than the vectorized float math saves.
+
+namespace sfz {
+
+using std::int16_t;
+using std::size_t;
+using std::uint16_t;
+
+// Packed vector structs
+// ------------------------------------------------------------------------------------------------
+
+/// Vector of N half-precision floats, stored as raw bits
+template<size_t N>
+struct HalfVector final {
+	uint16_t elements[N];
+};
+
+/// Vector of N unsigned normalized 16-bit values, 0 maps to 0.0 and 65535 maps to 1.0
+template<size_t N>
+struct Unorm16Vector final {
+	uint16_t elements[N];
+};
+
+/// Vector of N signed normalized 16-bit values, -32767 maps to -1.0 and 32767 maps to 1.0
+template<size_t N>
+struct Snorm16Vector final {
+	int16_t elements[N];
+};
+
+using half2 = HalfVector<2>;
+using half3 = HalfVector<3>;
+using half4 = HalfVector<4>;
+
+using unorm16x2 = Unorm16Vector<2>;
+using unorm16x3 = Unorm16Vector<3>;
+using unorm16x4 = Unorm16Vector<4>;
+
+using snorm16x2 = Snorm16Vector<2>;
+using snorm16x3 = Snorm16Vector<3>;
+using snorm16x4 = Snorm16Vector<4>;
+
+static_assert(sizeof(half4) == 8, "half4 is padded");
+static_assert(sizeof(unorm16x3) == 6, "unorm16x3 is padded");
+static_assert(sizeof(snorm16x2) == 4, "snorm16x2 is padded");
+
+// Scalar conversion functions
+// ------------------------------------------------------------------------------------------------
+
+/// Converts a float to half-precision, rounds to nearest even. Values too large to be represented
+/// become infinity and NaN is preserved.
+uint16_t floatToHalf(float value) noexcept;
+
+/// Converts a half-precision float to float, the conversion is exact.
+float halfToFloat(uint16_t value) noexcept;
+
+/// Converts a float in [0, 1] to unorm16, values outside the range are clamped.
+uint16_t floatToUnorm16(float value) noexcept;
+float unorm16ToFloat(uint16_t value) noexcept;
+
+/// Converts a float in [-1, 1] to snorm16, values outside the range are clamped.
+int16_t floatToSnorm16(float value) noexcept;
+float snorm16ToFloat(int16_t value) noexcept;
+
+// Vector packing functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t N>
+HalfVector<N> packHalf(const Vector<float,N>& vector) noexcept;
+
+template<size_t N>
+Vector<float,N> unpackHalf(const HalfVector<N>& packed) noexcept;
+
+template<size_t N>
+Unorm16Vector<N> packUnorm16(const Vector<float,N>& vector) noexcept;
+
+template<size_t N>
+Vector<float,N> unpackUnorm16(const Unorm16Vector<N>& packed) noexcept;
+
+template<size_t N>
+Snorm16Vector<N> packSnorm16(const Vector<float,N>& vector) noexcept;
+
+template<size_t N>
+Vector<float,N> unpackSnorm16(const Snorm16Vector<N>& packed) noexcept;
+
+/// Packs a unit normal using octahedral encoding. The normal does not need to be exactly
+/// normalized, but it may not be the zero vector.
+snorm16x2 packOctNormal(const vec3& normal) noexcept;
+
+/// Unpacks an octahedral encoded normal, the result is normalized.
+vec3 unpackOctNormal(const snorm16x2& packed) noexcept;
+
+/// Quantizes a position relative to the box defined by boundsMin and boundsMax. Positions outside
+/// the box are clamped to it.
+unorm16x3 quantizePosition(const vec3& position, const vec3& boundsMin, const vec3& boundsMax) noexcept;
+
+/// Reconstructs a position quantized with quantizePosition()
+vec3 dequantizePosition(const unorm16x3& packed, const vec3& boundsMin, const vec3& boundsMax) noexcept;
+
+// Batch kernels
+// ------------------------------------------------------------------------------------------------
+
+void packHalf(const float* src, uint16_t* dst, size_t count) noexcept;
+void unpackHalf(const uint16_t* src, float* dst, size_t count) noexcept;
+
+void packOctNormals(const vec3* src, snorm16x2* dst, size_t count) noexcept;
+void unpackOctNormals(const snorm16x2* src, vec3* dst, size_t count) noexcept;
+
+void quantizePositions(const vec3* src, unorm16x3* dst, size_t count,
+                       const vec3& boundsMin, const vec3& boundsMax) noexcept;
+void dequantizePositions(const unorm16x3* src, vec3* dst, size_t count,
+                         const vec3& boundsMin, const vec3& boundsMax) noexcept;
+
+// Error metrics
+// ------------------------------------------------------------------------------------------------
+
+/// Returns the largest distance between two corresponding positions in the arrays
+float maxPositionError(const vec3* original, const vec3* reconstructed, size_t count) noexcept;
+
+/// Returns the largest angle (in radians) between two corresponding normals in the arrays
+float maxAngularError(const vec3* original, const vec3* reconstructed, size_t count) noexcept;
+
+/// Returns the largest absolute difference between two corresponding floats in the arrays
+float maxAbsoluteError(const float* original, const float* reconstructed, size_t count) noexcept;
+
+} // namespace sfz
+
+#include "sfz/math/PackedVector.inl"
@@ -0,0 +1,85 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+namespace sfz {
+
+// Vector packing functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t N>
+HalfVector<N> packHalf(const Vector<float,N>& vector) noexcept
+{
+	HalfVector<N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp.elements[i] = floatToHalf(vector[i]);
+	}
+	return tmp;
+}
+
+template<size_t N>
+Vector<float,N> unpackHalf(const HalfVector<N>& packed) noexcept
+{
+	Vector<float,N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp[i] = halfToFloat(packed.elements[i]);
+	}
+	return tmp;
+}
+
+template<size_t N>
+Unorm16Vector<N> packUnorm16(const Vector<float,N>& vector) noexcept
+{
+	Unorm16Vector<N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp.elements[i] = floatToUnorm16(vector[i]);
+	}
+	return tmp;
+}
+
+template<size_t N>
+Vector<float,N> unpackUnorm16(const Unorm16Vector<N>& packed) noexcept
+{
+	Vector<float,N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp[i] = unorm16ToFloat(packed.elements[i]);
+	}
+	return tmp;
+}
+
+template<size_t N>
+Snorm16Vector<N> packSnorm16(const Vector<float,N>& vector) noexcept
+{
+	Snorm16Vector<N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp.elements[i] = floatToSnorm16(vector[i]);
+	}
+	return tmp;
+}
+
+template<size_t N>
+Vector<float,N> unpackSnorm16(const Snorm16Vector<N>& packed) noexcept
+{
+	Vector<float,N> tmp;
+	for (size_t i = 0; i < N; i++) {
+		tmp[i] = snorm16ToFloat(packed.elements[i]);
+	}
+	return tmp;
+}
+
+} // namespace sfz
@@ -61,13 +61,13 @@ struct Vector final {
 	Vector<T,N>& operator= (const Vector<T,N>&) noexcept = default;
 	~Vector() noexcept = default;
 
-	explicit Vector(const T* arrayPtr) noexcept;
+	explicit constexpr Vector(const T* arrayPtr) noexcept;
 
 	template<typename T2>
-	explicit Vector(const Vector<T2,N>& other) noexcept;
+	explicit constexpr Vector(const Vector<T2,N>& other) noexcept;
 
-	T& operator[] (const size_t index) noexcept;
-	T operator[] (const size_t index) const noexcept;
+	constexpr T& operator[] (const size_t index) noexcept;
+	constexpr T operator[] (const size_t index) const noexcept;
 };
 
 template<typename T>
@@ -82,15 +82,15 @@ struct Vector<T,2> final {
 	Vector<T,2>& operator= (const Vector<T,2>&) noexcept = default;
 	~Vector() noexcept = default;
 
-	explicit Vector(const T* arrayPtr) noexcept;
-	explicit Vector(T value) noexcept;
-	Vector(T x, T y) noexcept;
+	explicit constexpr Vector(const T* arrayPtr) noexcept;
+	explicit constexpr Vector(T value) noexcept;
+	constexpr Vector(T x, T y) noexcept;
 
 	template<typename T2>
-	explicit Vector(const Vector<T2,2>& other) noexcept;
+	explicit constexpr Vector(const Vector<T2,2>& other) noexcept;
 
-	T& operator[] (const size_t index) noexcept;
-	T operator[] (const size_t index) const noexcept;
+	constexpr T& operator[] (const size_t index) noexcept;
+	constexpr T operator[] (const size_t index) const noexcept;
 };
 
 template<typename T>
@@ -107,17 +107,17 @@ struct Vector<T,3> final {
 	Vector<T,3>& operator= (const Vector<T,3>&) noexcept = default;
 	~Vector() noexcept = default;
 
-	explicit Vector(const T* arrayPtr) noexcept;
-	explicit Vector(T value) noexcept;
-	Vector(T x, T y, T z) noexcept;
-	Vector(Vector<T,2> xy, T z) noexcept;
-	Vector(T x, Vector<T,2> yz) noexcept;
+	explicit constexpr Vector(const T* arrayPtr) noexcept;
+	explicit constexpr Vector(T value) noexcept;
+	constexpr Vector(T x, T y, T z) noexcept;
+	constexpr Vector(Vector<T,2> xy, T z) noexcept;
+	constexpr Vector(T x, Vector<T,2> yz) noexcept;
 
 	template<typename T2>
-	explicit Vector(const Vector<T2,3>& other) noexcept;
+	explicit constexpr Vector(const Vector<T2,3>& other) noexcept;
 
-	T& operator[] (const size_t index) noexcept;
-	T operator[] (const size_t index) const noexcept;
+	constexpr T& operator[] (const size_t index) noexcept;
+	constexpr T operator[] (const size_t index) const noexcept;
 };
 
 template<typename T>
@@ -136,21 +136,21 @@ struct Vector<T,4> final {
 	Vector<T,4>& operator= (const Vector<T,4>&) noexcept = default;
 	~Vector() noexcept = default;
 
-	explicit Vector(const T* arrayPtr) noexcept;
-	explicit Vector(T value) noexcept;
-	Vector(T x, T y, T z, T w) noexcept;
-	Vector(Vector<T,3> xyz, T w) noexcept;
-	Vector(T x, Vector<T,3> yzw) noexcept;
-	Vector(Vector<T,2> xy, Vector<T,2> zw) noexcept;
-	Vector(Vector<T,2> xy, T z, T w) noexcept;
-	Vector(T x, Vector<T,2> yz, T w) noexcept;
-	Vector(T x, T y, Vector<T,2> zw) noexcept;
+	explicit constexpr Vector(const T* arrayPtr) noexcept;
+	explicit constexpr Vector(T value) noexcept;
+	constexpr Vector(T x, T y, T z, T w) noexcept;
+	constexpr Vector(Vector<T,3> xyz, T w) noexcept;
+	constexpr Vector(T x, Vector<T,3> yzw) noexcept;
+	constexpr Vector(Vector<T,2> xy, Vector<T,2> zw) noexcept;
+	constexpr Vector(Vector<T,2> xy, T z, T w) noexcept;
+	constexpr Vector(T x, Vector<T,2> yz, T w) noexcept;
+	constexpr Vector(T x, T y, Vector<T,2> zw) noexcept;
 
 	template<typename T2>
-	explicit Vector(const Vector<T2,4>& other) noexcept;
+	explicit constexpr Vector(const Vector<T2,4>& other) noexcept;
 
-	T& operator[] (const size_t index) noexcept;
-	T operator[] (const size_t index) const noexcept;
+	constexpr T& operator[] (const size_t index) noexcept;
+	constexpr T operator[] (const size_t index) const noexcept;
 };
 
 using vec2 = Vector<float,2>;
@@ -165,13 +165,13 @@ using vec4i = Vector<int32_t,4>;
 // ------------------------------------------------------------------------------------------------
 
 template<typename T = float>
-Vector<T,3> UNIT_X() noexcept;
+constexpr Vector<T,3> UNIT_X() noexcept;
 
 template<typename T = float>
-Vector<T,3> UNIT_Y() noexcept;
+constexpr Vector<T,3> UNIT_Y() noexcept;
 
 template<typename T = float>
-Vector<T,3> UNIT_Z() noexcept;
+constexpr Vector<T,3> UNIT_Z() noexcept;
 
 // Vector functions
 // ------------------------------------------------------------------------------------------------
@@ -182,7 +182,7 @@ T length(const Vector<T,N>& vector) noexcept;
 
 /// Calculates squared length of vector
 template<typename T, size_t N>
-T squaredLength(const Vector<T,N>& vector) noexcept;
+constexpr T squaredLength(const Vector<T,N>& vector) noexcept;
 
 /// Normalizes vector
 /// sfz_assert_debug: length of vector is not zero
@@ -191,7 +191,7 @@ Vector<T,N> normalize(const Vector<T,N>& vector) noexcept;
 
 /// Calculates the dot product of two vectors
 template<typename T, size_t N>
-T dot(const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr T dot(const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 /// Calculates the cross product of two vectors
 template<typename T>
@@ -199,7 +199,7 @@ constexpr Vector<T,3> cross(const Vector<T,3>& left, const Vector<T,3>& right) n
 
 /// Calculates the sum of all the elements in the vector
 template<typename T, size_t N>
-T sum(const Vector<T,N>& vector) noexcept;
+constexpr T sum(const Vector<T,N>& vector) noexcept;
 
 /// Calculates the positive angle (in radians) between two vectors
 /// Range: [0, Pi)
@@ -265,64 +265,64 @@ void toString(const Vector<int32_t,N>& vector, StackString& string) noexcept;
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-Vector<T,N>& operator+= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N>& operator+= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N>& operator-= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N>& operator-= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N>& operator*= (Vector<T,N>& left, T right) noexcept;
+constexpr Vector<T,N>& operator*= (Vector<T,N>& left, T right) noexcept;
 
 /// Element-wise multiplication assignment
 template<typename T, size_t N>
-Vector<T,N>& operator*= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N>& operator*= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 /// sfz_assert_debug: rhs element != 0
 template<typename T, size_t N>
-Vector<T,N>& operator/= (Vector<T,N>& left, T right) noexcept;
+constexpr Vector<T,N>& operator/= (Vector<T,N>& left, T right) noexcept;
 
 /// Element-wise division assignment, @sfz_assert_debug all elements of rhs != 0.
 template<typename T, size_t N>
-Vector<T,N>& operator/= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N>& operator/= (Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 // Operators (arithmetic)
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-Vector<T,N> operator+ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N> operator+ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N> operator- (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N> operator- (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N> operator- (const Vector<T,N>& vector) noexcept;
+constexpr Vector<T,N> operator- (const Vector<T,N>& vector) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N> operator* (const Vector<T,N>& left, T right) noexcept;
+constexpr Vector<T,N> operator* (const Vector<T,N>& left, T right) noexcept;
 
 /// Element-wise multiplication of two vectors
 template<typename T, size_t N>
-Vector<T,N> operator* (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N> operator* (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-Vector<T,N> operator* (T left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N> operator* (T left, const Vector<T,N>& right) noexcept;
 
 /// sfz_assert_debug: rhs element != 0 */
 template<typename T, size_t N>
-Vector<T,N> operator/ (const Vector<T,N>& left, T right) noexcept;
+constexpr Vector<T,N> operator/ (const Vector<T,N>& left, T right) noexcept;
 
 /// Element-wise division of two vectors, @sfz_assert_debug all elements of rhs != 0.
 template<typename T, size_t N>
-Vector<T,N> operator/ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr Vector<T,N> operator/ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 // Operators (comparison)
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-bool operator== (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr bool operator== (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 template<typename T, size_t N>
-bool operator!= (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
+constexpr bool operator!= (const Vector<T,N>& left, const Vector<T,N>& right) noexcept;
 
 // Standard iterator functions
 // ------------------------------------------------------------------------------------------------
@@ -22,7 +22,9 @@ namespace sfz {
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-Vector<T,N>::Vector(const T* arrayPtr) noexcept
+constexpr Vector<T,N>::Vector(const T* arrayPtr) noexcept
+:
+	elements{}
 {
 	for (size_t i = 0; i < N; ++i) {
 		elements[i] = arrayPtr[i];
@@ -31,7 +33,9 @@ Vector<T,N>::Vector(const T* arrayPtr) noexcept
 
 template<typename T, size_t N>
 template<typename T2>
-Vector<T,N>::Vector(const Vector<T2,N>& other) noexcept
+constexpr Vector<T,N>::Vector(const Vector<T2,N>& other) noexcept
+:
+	elements{}
 {
 	for (size_t i = 0; i < N; ++i) {
 		elements[i] = static_cast<T>(other[i]);
@@ -39,14 +43,14 @@ Vector<T,N>::Vector(const Vector<T2,N>& other) noexcept
 }
 
 template<typename T, size_t N>
-T& Vector<T,N>::operator[] (const size_t index) noexcept
+constexpr T& Vector<T,N>::operator[] (const size_t index) noexcept
 {
 	sfz_assert_debug(index < N);
 	return elements[index];
 }
 
 template<typename T, size_t N>
-T Vector<T,N>::operator[] (const size_t index) const noexcept
+constexpr T Vector<T,N>::operator[] (const size_t index) const noexcept
 {
 	sfz_assert_debug(index < N);
 	return elements[index];
@@ -56,43 +60,39 @@ T Vector<T,N>::operator[] (const size_t index) const noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Vector<T,2>::Vector(const T* arrayPtr) noexcept
+constexpr Vector<T,2>::Vector(const T* arrayPtr) noexcept
 :
-	x{arrayPtr[0]},
-	y{arrayPtr[1]}
+	elements{arrayPtr[0], arrayPtr[1]}
 { }
 
 template<typename T>
-Vector<T,2>::Vector(T value) noexcept
+constexpr Vector<T,2>::Vector(T value) noexcept
 :
-	x{value},
-	y{value}
+	elements{value, value}
 { }
 
 template<typename T>
-Vector<T,2>::Vector(T x, T y) noexcept
+constexpr Vector<T,2>::Vector(T x, T y) noexcept
 :
-	x{x},
-	y{y}
+	elements{x, y}
 { }
 
 template<typename T>
 template<typename T2>
-Vector<T,2>::Vector(const Vector<T2,2>& other) noexcept
+constexpr Vector<T,2>::Vector(const Vector<T2,2>& other) noexcept
 :
-	x(static_cast<T>(other.x)),
-	y(static_cast<T>(other.y))
+	elements{static_cast<T>(other.elements[0]), static_cast<T>(other.elements[1])}
 { }
 
 template<typename T>
-T& Vector<T,2>::operator[] (const size_t index) noexcept
+constexpr T& Vector<T,2>::operator[] (const size_t index) noexcept
 {
 	sfz_assert_debug(index < 2);
 	return elements[index];
 }
 
 template<typename T>
-T Vector<T,2>::operator[] (const size_t index) const noexcept
+constexpr T Vector<T,2>::operator[] (const size_t index) const noexcept
 {
 	sfz_assert_debug(index < 2);
 	return elements[index];
@@ -102,63 +102,53 @@ T Vector<T,2>::operator[] (const size_t index) const noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Vector<T,3>::Vector(const T* arrayPtr) noexcept
+constexpr Vector<T,3>::Vector(const T* arrayPtr) noexcept
 :
-	x{arrayPtr[0]},
-	y{arrayPtr[1]},
-	z{arrayPtr[2]}
+	elements{arrayPtr[0], arrayPtr[1], arrayPtr[2]}
 { }
 
 template<typename T>
-Vector<T,3>::Vector(T value) noexcept
+constexpr Vector<T,3>::Vector(T value) noexcept
 :
-	x{value},
-	y{value},
-	z{value}
+	elements{value, value, value}
 { }
 
 template<typename T>
-Vector<T,3>::Vector(T x, T y, T z) noexcept
+constexpr Vector<T,3>::Vector(T x, T y, T z) noexcept
 :
-	x{x},
-	y{y},
-	z{z}
+	elements{x, y, z}
 { }
 
 template<typename T>
-Vector<T,3>::Vector(Vector<T,2> xy, T z) noexcept
+constexpr Vector<T,3>::Vector(Vector<T,2> xy, T z) noexcept
 :
-	x{xy.elements[0]},
-	y{xy.elements[1]},
-	z{z}
+	elements{xy.elements[0], xy.elements[1], z}
 { }
 
 template<typename T>
-Vector<T,3>::Vector(T x, Vector<T,2> yz) noexcept
+constexpr Vector<T,3>::Vector(T x, Vector<T,2> yz) noexcept
 :
-	x{x},
-	y{yz.elements[0]},
-	z{yz.elements[1]}
+	elements{x, yz.elements[0], yz.elements[1]}
 { }
 
 template<typename T>
 template<typename T2>
-Vector<T,3>::Vector(const Vector<T2,3>& other) noexcept
+constexpr Vector<T,3>::Vector(const Vector<T2,3>& other) noexcept
 :
-	x(static_cast<T>(other.x)),
-	y(static_cast<T>(other.y)),
-	z(static_cast<T>(other.z))
+	elements{static_cast<T>(other.elements[0]),
+	         static_cast<T>(other.elements[1]),
+	         static_cast<T>(other.elements[2])}
 { }
 
 template<typename T>
-T& Vector<T,3>::operator[] (const size_t index) noexcept
+constexpr T& Vector<T,3>::operator[] (const size_t index) noexcept
 {
 	sfz_assert_debug(index < 3);
 	return elements[index];
 }
 
 template<typename T>
-T Vector<T,3>::operator[] (const size_t index) const noexcept
+constexpr T Vector<T,3>::operator[] (const size_t index) const noexcept
 {
 	sfz_assert_debug(index < 3);
 	return elements[index];
@@ -168,105 +158,78 @@ T Vector<T,3>::operator[] (const size_t index) const noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Vector<T,4>::Vector(const T* arrayPtr) noexcept
+constexpr Vector<T,4>::Vector(const T* arrayPtr) noexcept
 :
-	x{arrayPtr[0]},
-	y{arrayPtr[1]},
-	z{arrayPtr[2]},
-	w{arrayPtr[3]}
+	elements{arrayPtr[0], arrayPtr[1], arrayPtr[2], arrayPtr[3]}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(T value) noexcept
+constexpr Vector<T,4>::Vector(T value) noexcept
 :
-	x{value},
-	y{value},
-	z{value},
-	w{value}
+	elements{value, value, value, value}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(T x, T y, T z, T w) noexcept
+constexpr Vector<T,4>::Vector(T x, T y, T z, T w) noexcept
 :
-	x{x},
-	y{y},
-	z{z},
-	w{w}
+	elements{x, y, z, w}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(Vector<T,3> xyz, T w) noexcept
+constexpr Vector<T,4>::Vector(Vector<T,3> xyz, T w) noexcept
 :
-	x{xyz.elements[0]},
-	y{xyz.elements[1]},
-	z{xyz.elements[2]},
-	w{w}
+	elements{xyz.elements[0], xyz.elements[1], xyz.elements[2], w}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(T x, Vector<T,3> yzw) noexcept
+constexpr Vector<T,4>::Vector(T x, Vector<T,3> yzw) noexcept
 :
-	x{x},
-	y{yzw.elements[0]},
-	z{yzw.elements[1]},
-	w{yzw.elements[2]}
+	elements{x, yzw.elements[0], yzw.elements[1], yzw.elements[2]}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(Vector<T,2> xy, Vector<T,2> zw) noexcept
+constexpr Vector<T,4>::Vector(Vector<T,2> xy, Vector<T,2> zw) noexcept
 :
-	x{xy.elements[0]},
-	y{xy.elements[1]},
-	z{zw.elements[0]},
-	w{zw.elements[1]}
+	elements{xy.elements[0], xy.elements[1], zw.elements[0], zw.elements[1]}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(Vector<T,2> xy, T z, T w) noexcept
+constexpr Vector<T,4>::Vector(Vector<T,2> xy, T z, T w) noexcept
 :
-	x{xy.elements[0]},
-	y{xy.elements[1]},
-	z{z},
-	w{w}
+	elements{xy.elements[0], xy.elements[1], z, w}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(T x, Vector<T,2> yz, T w) noexcept
+constexpr Vector<T,4>::Vector(T x, Vector<T,2> yz, T w) noexcept
 :
-	x{x},
-	y{yz.elements[0]},
-	z{yz.elements[1]},
-	w{w}
+	elements{x, yz.elements[0], yz.elements[1], w}
 { }
 
 template<typename T>
-Vector<T,4>::Vector(T x, T y, Vector<T,2> zw) noexcept
+constexpr Vector<T,4>::Vector(T x, T y, Vector<T,2> zw) noexcept
 :
-	x{x},
-	y{y},
-	z{zw.elements[0]},
-	w{zw.elements[1]}
+	elements{x, y, zw.elements[0], zw.elements[1]}
 { }
 
 template<typename T>
 template<typename T2>
-Vector<T,4>::Vector(const Vector<T2,4>& other) noexcept
+constexpr Vector<T,4>::Vector(const Vector<T2,4>& other) noexcept
 :
-	x(static_cast<T>(other.x)),
-	y(static_cast<T>(other.y)),
-	z(static_cast<T>(other.z)),
-	w(static_cast<T>(other.w))
+	elements{static_cast<T>(other.elements[0]),
+	         static_cast<T>(other.elements[1]),
+	         static_cast<T>(other.elements[2]),
+	         static_cast<T>(other.elements[3])}
 { }
 
 template<typename T>
-T& Vector<T,4>::operator[] (const size_t index) noexcept
+constexpr T& Vector<T,4>::operator[] (const size_t index) noexcept
 {
 	sfz_assert_debug(index < 4);
 	return elements[index];
 }
 
 template<typename T>
-T Vector<T,4>::operator[] (const size_t index) const noexcept
+constexpr T Vector<T,4>::operator[] (const size_t index) const noexcept
 {
 	sfz_assert_debug(index < 4);
 	return elements[index];
@@ -276,19 +239,19 @@ T Vector<T,4>::operator[] (const size_t index) const noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T>
-Vector<T,3> UNIT_X() noexcept
+constexpr Vector<T,3> UNIT_X() noexcept
 {
 	return Vector<T,3>{T(1), T(0), T(0)};
 }
 
 template<typename T>
-Vector<T,3> UNIT_Y() noexcept
+constexpr Vector<T,3> UNIT_Y() noexcept
 {
 	return Vector<T,3>{T(0), T(1), T(0)};
 }
 
 template<typename T>
-Vector<T,3> UNIT_Z() noexcept
+constexpr Vector<T,3> UNIT_Z() noexcept
 {
 	return Vector<T,3>{T(0), T(0), T(1)};
 }
@@ -303,7 +266,7 @@ T length(const Vector<T,N>& vector) noexcept
 }
 
 template<typename T, size_t N>
-T squaredLength(const Vector<T,N>& vector) noexcept
+constexpr T squaredLength(const Vector<T,N>& vector) noexcept
 {
 	return dot(vector, vector);
 }
@@ -317,7 +280,7 @@ Vector<T,N> normalize(const Vector<T,N>& vector) noexcept
 }
 
 template<typename T, size_t N>
-T dot(const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr T dot(const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	T product = T(0);
 	for (size_t i = 0; i < N; ++i) {
@@ -327,39 +290,39 @@ T dot(const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-T dot(const Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr T dot(const Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	return left.x * right.x
-	     + left.y * right.y;
+	return left.elements[0] * right.elements[0]
+	     + left.elements[1] * right.elements[1];
 }
 
 template<typename T>
-T dot(const Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr T dot(const Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	return left.x * right.x
-	     + left.y * right.y
-	     + left.z * right.z;
+	return left.elements[0] * right.elements[0]
+	     + left.elements[1] * right.elements[1]
+	     + left.elements[2] * right.elements[2];
 }
 
 template<typename T>
-T dot(const Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr T dot(const Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	return left.x * right.x
-	     + left.y * right.y
-	     + left.z * right.z
-	     + left.w * right.w;
+	return left.elements[0] * right.elements[0]
+	     + left.elements[1] * right.elements[1]
+	     + left.elements[2] * right.elements[2]
+	     + left.elements[3] * right.elements[3];
 }
 
 template<typename T>
 constexpr Vector<T,3> cross(const Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	return sfz::Vector<T,3>{left.y*right.z - left.z*right.y,
-	                        left.z*right.x - left.x*right.z,
-	                        left.x*right.y - left.y*right.x};
+	return sfz::Vector<T,3>{left.elements[1]*right.elements[2] - left.elements[2]*right.elements[1],
+	                        left.elements[2]*right.elements[0] - left.elements[0]*right.elements[2],
+	                        left.elements[0]*right.elements[1] - left.elements[1]*right.elements[0]};
 }
 
 template<typename T, size_t N>
-T sum(const Vector<T,N>& vector) noexcept
+constexpr T sum(const Vector<T,N>& vector) noexcept
 {
 	T result = T(0);
 	for (size_t i = 0; i < N; ++i) {
@@ -545,7 +508,7 @@ inline void toString(const vec4i& vector, StackString& string) noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-Vector<T,N>& operator+= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N>& operator+= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		left.elements[i] += right.elements[i];
@@ -554,34 +517,34 @@ Vector<T,N>& operator+= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator+= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr Vector<T,2>& operator+= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	left.x += right.x;
-	left.y += right.y;
+	left.elements[0] += right.elements[0];
+	left.elements[1] += right.elements[1];
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator+= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr Vector<T,3>& operator+= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	left.x += right.x;
-	left.y += right.y;
-	left.z += right.z;
+	left.elements[0] += right.elements[0];
+	left.elements[1] += right.elements[1];
+	left.elements[2] += right.elements[2];
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator+= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr Vector<T,4>& operator+= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	left.x += right.x;
-	left.y += right.y;
-	left.z += right.z;
-	left.w += right.w;
+	left.elements[0] += right.elements[0];
+	left.elements[1] += right.elements[1];
+	left.elements[2] += right.elements[2];
+	left.elements[3] += right.elements[3];
 	return left;
 }
 
 template<typename T, size_t N>
-Vector<T,N>& operator-= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N>& operator-= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		left.elements[i] -= right.elements[i];
@@ -590,34 +553,34 @@ Vector<T,N>& operator-= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator-= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr Vector<T,2>& operator-= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	left.x -= right.x;
-	left.y -= right.y;
+	left.elements[0] -= right.elements[0];
+	left.elements[1] -= right.elements[1];
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator-= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr Vector<T,3>& operator-= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	left.x -= right.x;
-	left.y -= right.y;
-	left.z -= right.z;
+	left.elements[0] -= right.elements[0];
+	left.elements[1] -= right.elements[1];
+	left.elements[2] -= right.elements[2];
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator-= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr Vector<T,4>& operator-= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	left.x -= right.x;
-	left.y -= right.y;
-	left.z -= right.z;
-	left.w -= right.w;
+	left.elements[0] -= right.elements[0];
+	left.elements[1] -= right.elements[1];
+	left.elements[2] -= right.elements[2];
+	left.elements[3] -= right.elements[3];
 	return left;
 }
 
 template<typename T, size_t N>
-Vector<T,N>& operator*= (Vector<T,N>& left, T right) noexcept
+constexpr Vector<T,N>& operator*= (Vector<T,N>& left, T right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		left.elements[i] *= right;
@@ -626,34 +589,34 @@ Vector<T,N>& operator*= (Vector<T,N>& left, T right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator*= (Vector<T,2>& left, T right) noexcept
+constexpr Vector<T,2>& operator*= (Vector<T,2>& left, T right) noexcept
 {
-	left.x *= right;
-	left.y *= right;
+	left.elements[0] *= right;
+	left.elements[1] *= right;
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator*= (Vector<T,3>& left, T right) noexcept
+constexpr Vector<T,3>& operator*= (Vector<T,3>& left, T right) noexcept
 {
-	left.x *= right;
-	left.y *= right;
-	left.z *= right;
+	left.elements[0] *= right;
+	left.elements[1] *= right;
+	left.elements[2] *= right;
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator*= (Vector<T,4>& left, T right) noexcept
+constexpr Vector<T,4>& operator*= (Vector<T,4>& left, T right) noexcept
 {
-	left.x *= right;
-	left.y *= right;
-	left.z *= right;
-	left.w *= right;
+	left.elements[0] *= right;
+	left.elements[1] *= right;
+	left.elements[2] *= right;
+	left.elements[3] *= right;
 	return left;
 }
 
 template<typename T, size_t N>
-Vector<T,N>& operator*= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N>& operator*= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		left.elements[i] *= right.elements[i];
@@ -662,34 +625,34 @@ Vector<T,N>& operator*= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator*= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr Vector<T,2>& operator*= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	left.x *= right.x;
-	left.y *= right.y;
+	left.elements[0] *= right.elements[0];
+	left.elements[1] *= right.elements[1];
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator*= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr Vector<T,3>& operator*= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	left.x *= right.x;
-	left.y *= right.y;
-	left.z *= right.z;
+	left.elements[0] *= right.elements[0];
+	left.elements[1] *= right.elements[1];
+	left.elements[2] *= right.elements[2];
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator*= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr Vector<T,4>& operator*= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	left.x *= right.x;
-	left.y *= right.y;
-	left.z *= right.z;
-	left.w *= right.w;
+	left.elements[0] *= right.elements[0];
+	left.elements[1] *= right.elements[1];
+	left.elements[2] *= right.elements[2];
+	left.elements[3] *= right.elements[3];
 	return left;
 }
 
 template<typename T, size_t N>
-Vector<T,N>& operator/= (Vector<T,N>& left, T right) noexcept
+constexpr Vector<T,N>& operator/= (Vector<T,N>& left, T right) noexcept
 {
 	sfz_assert_debug(right != T(0));
 	for (size_t i = 0; i < N; ++i) {
@@ -699,37 +662,37 @@ Vector<T,N>& operator/= (Vector<T,N>& left, T right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator/= (Vector<T,2>& left, T right) noexcept
+constexpr Vector<T,2>& operator/= (Vector<T,2>& left, T right) noexcept
 {
 	sfz_assert_debug(right != T(0));
-	left.x /= right;
-	left.y /= right;
+	left.elements[0] /= right;
+	left.elements[1] /= right;
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator/= (Vector<T,3>& left, T right) noexcept
+constexpr Vector<T,3>& operator/= (Vector<T,3>& left, T right) noexcept
 {
 	sfz_assert_debug(right != T(0));
-	left.x /= right;
-	left.y /= right;
-	left.z /= right;
+	left.elements[0] /= right;
+	left.elements[1] /= right;
+	left.elements[2] /= right;
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator/= (Vector<T,4>& left, T right) noexcept
+constexpr Vector<T,4>& operator/= (Vector<T,4>& left, T right) noexcept
 {
 	sfz_assert_debug(right != T(0));
-	left.x /= right;
-	left.y /= right;
-	left.z /= right;
-	left.w /= right;
+	left.elements[0] /= right;
+	left.elements[1] /= right;
+	left.elements[2] /= right;
+	left.elements[3] /= right;
 	return left;
 }
 
 template<typename T, size_t N>
-Vector<T,N>& operator/= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N>& operator/= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		sfz_assert_debug(right.elements[i] != T(0));
@@ -739,38 +702,38 @@ Vector<T,N>& operator/= (Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-Vector<T,2>& operator/= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr Vector<T,2>& operator/= (Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	sfz_assert_debug(right.x != T(0));
-	sfz_assert_debug(right.y != T(0));
-	left.x /= right.x;
-	left.y /= right.y;
+	sfz_assert_debug(right.elements[0] != T(0));
+	sfz_assert_debug(right.elements[1] != T(0));
+	left.elements[0] /= right.elements[0];
+	left.elements[1] /= right.elements[1];
 	return left;
 }
 
 template<typename T>
-Vector<T,3>& operator/= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr Vector<T,3>& operator/= (Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	sfz_assert_debug(right.x != T(0));
-	sfz_assert_debug(right.y != T(0));
-	sfz_assert_debug(right.z != T(0));
-	left.x /= right.x;
-	left.y /= right.y;
-	left.z /= right.z;
+	sfz_assert_debug(right.elements[0] != T(0));
+	sfz_assert_debug(right.elements[1] != T(0));
+	sfz_assert_debug(right.elements[2] != T(0));
+	left.elements[0] /= right.elements[0];
+	left.elements[1] /= right.elements[1];
+	left.elements[2] /= right.elements[2];
 	return left;
 }
 
 template<typename T>
-Vector<T,4>& operator/= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr Vector<T,4>& operator/= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	sfz_assert_debug(right.x != T(0));
-	sfz_assert_debug(right.y != T(0));
-	sfz_assert_debug(right.z != T(0));
-	sfz_assert_debug(right.w != T(0));
-	left.x /= right.x;
-	left.y /= right.y;
-	left.z /= right.z;
-	left.w /= right.w;
+	sfz_assert_debug(right.elements[0] != T(0));
+	sfz_assert_debug(right.elements[1] != T(0));
+	sfz_assert_debug(right.elements[2] != T(0));
+	sfz_assert_debug(right.elements[3] != T(0));
+	left.elements[0] /= right.elements[0];
+	left.elements[1] /= right.elements[1];
+	left.elements[2] /= right.elements[2];
+	left.elements[3] /= right.elements[3];
 	return left;
 }
 
@@ -778,55 +741,55 @@ Vector<T,4>& operator/= (Vector<T,4>& left, const Vector<T,4>& right) noexcept
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-Vector<T,N> operator+ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N> operator+ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp += right);
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator- (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N> operator- (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp -= right);
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator- (const Vector<T,N>& vector) noexcept
+constexpr Vector<T,N> operator- (const Vector<T,N>& vector) noexcept
 {
 	Vector<T,N> temp = vector;
 	return (temp *= T(-1));
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator* (const Vector<T,N>& left, T right) noexcept
+constexpr Vector<T,N> operator* (const Vector<T,N>& left, T right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp *= right);
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator* (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N> operator* (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp *= right);
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator* (T left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N> operator* (T left, const Vector<T,N>& right) noexcept
 {
 	return right * left;
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator/ (const Vector<T,N>& left, T right) noexcept
+constexpr Vector<T,N> operator/ (const Vector<T,N>& left, T right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp /= right);
 }
 
 template<typename T, size_t N>
-Vector<T,N> operator/ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr Vector<T,N> operator/ (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	Vector<T,N> temp = left;
 	return (temp /= right);
@@ -836,7 +799,7 @@ Vector<T,N> operator/ (const Vector<T,N>& left, const Vector<T,N>& right) noexce
 // ------------------------------------------------------------------------------------------------
 
 template<typename T, size_t N>
-bool operator== (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr bool operator== (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	for (size_t i = 0; i < N; ++i) {
 		if (left.elements[i] != right.elements[i]) return false;
@@ -845,31 +808,31 @@ bool operator== (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 }
 
 template<typename T>
-bool operator== (const Vector<T,2>& left, const Vector<T,2>& right) noexcept
+constexpr bool operator== (const Vector<T,2>& left, const Vector<T,2>& right) noexcept
 {
-	return left.x == right.x
-	    && left.y == right.y;
+	return left.elements[0] == right.elements[0]
+	    && left.elements[1] == right.elements[1];
 }
 
 template<typename T>
-bool operator== (const Vector<T,3>& left, const Vector<T,3>& right) noexcept
+constexpr bool operator== (const Vector<T,3>& left, const Vector<T,3>& right) noexcept
 {
-	return left.x == right.x
-	    && left.y == right.y
-	    && left.z == right.z;
+	return left.elements[0] == right.elements[0]
+	    && left.elements[1] == right.elements[1]
+	    && left.elements[2] == right.elements[2];
 }
 
 template<typename T>
-bool operator== (const Vector<T,4>& left, const Vector<T,4>& right) noexcept
+constexpr bool operator== (const Vector<T,4>& left, const Vector<T,4>& right) noexcept
 {
-	return left.x == right.x
-	    && left.y == right.y
-	    && left.z == right.z
-	    && left.w == right.w;
+	return left.elements[0] == right.elements[0]
+	    && left.elements[1] == right.elements[1]
+	    && left.elements[2] == right.elements[2]
+	    && left.elements[3] == right.elements[3];
 }
 
 template<typename T, size_t N>
-bool operator!= (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
+constexpr bool operator!= (const Vector<T,N>& left, const Vector<T,N>& right) noexcept
 {
 	return !(left == right);
 }
@@ -0,0 +1,317 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <cmath>
+#include <cstdint> // std::uint32_t
+
+#include "sfz/Assert.hpp"
+#include "sfz/math/Vector.hpp"
+
+/// Packet types storing W floats or W vec3s in SoA (structure of arrays) lanes.
+///
+/// Typedefs are provided for 4 and 8 wide packets (floatx4, floatx8, vec3x4 and vec3x8). A packet
+/// is meant to be used as the substrate for batched geometry tests, i.e. instead of testing one
+/// primitive at a time you test W of them at once. All operations are implemented as simple
+/// fixed-width loops over the lanes, which compilers readily turn into SIMD instructions.
+///
+/// Comparisons return a LaneMask, a bitmask where bit i is set if the comparison was true for
+/// lane i. The masks can be combined with the standard bitwise operators and used to select
+/// lanes from two packets with select().
+
+namespace sfz {
+
+using std::size_t;
+using std::uint32_t;
+
+// LaneMask
+// ------------------------------------------------------------------------------------------------
+
+/// Bitmask where bit i represents lane i of a packet
+using LaneMask = uint32_t;
+
+/// Returns a LaneMask with all W lanes set
+template<size_t W>
+constexpr LaneMask ALL_LANES() noexcept { return (LaneMask(1) << W) - LaneMask(1); }
+
+/// Checks whether any lane in the mask is set
+inline bool anyLane(LaneMask mask) noexcept { return mask != 0; }
+
+/// Checks whether all of the first W lanes in the mask are set
+template<size_t W>
+bool allLanes(LaneMask mask) noexcept { return (mask & ALL_LANES<W>()) == ALL_LANES<W>(); }
+
+// Packet struct declarations
+// ------------------------------------------------------------------------------------------------
+
+/// A packet of W floats, aligned to its own size
+template<size_t W>
+struct FloatPacket final {
+	static_assert(W == 4 || W == 8, "Only 4 and 8 wide packets are supported");
+
+	alignas(W * sizeof(float)) float lanes[W];
+
+	constexpr FloatPacket() noexcept = default;
+	constexpr FloatPacket(const FloatPacket<W>&) noexcept = default;
+	FloatPacket<W>& operator= (const FloatPacket<W>&) noexcept = default;
+	~FloatPacket() noexcept = default;
+
+	/// Broadcasts value to all lanes
+	explicit FloatPacket(float value) noexcept;
+
+	/// Loads W consecutive floats from arrayPtr
+	explicit FloatPacket(const float* arrayPtr) noexcept;
+
+	float& operator[] (const size_t lane) noexcept;
+	float operator[] (const size_t lane) const noexcept;
+};
+
+/// A packet of W vec3s, each component stored in its own FloatPacket
+template<size_t W>
+struct Vec3Packet final {
+	FloatPacket<W> x, y, z;
+
+	constexpr Vec3Packet() noexcept = default;
+	constexpr Vec3Packet(const Vec3Packet<W>&) noexcept = default;
+	Vec3Packet<W>& operator= (const Vec3Packet<W>&) noexcept = default;
+	~Vec3Packet() noexcept = default;
+
+	/// Broadcasts value to all lanes
+	explicit Vec3Packet(const vec3& value) noexcept;
+	Vec3Packet(const FloatPacket<W>& x, const FloatPacket<W>& y, const FloatPacket<W>& z) noexcept;
+
+	/// Returns the vec3 stored in the specified lane
+	vec3 lane(size_t lane) const noexcept;
+
+	/// Sets the vec3 stored in the specified lane
+	void setLane(size_t lane, const vec3& value) noexcept;
+};
+
+using floatx4 = FloatPacket<4>;
+using floatx8 = FloatPacket<8>;
+
+using vec3x4 = Vec3Packet<4>;
+using vec3x8 = Vec3Packet<8>;
+
+// Loading & storing
+// ------------------------------------------------------------------------------------------------
+
+/// Loads W vec3s from an array of vec3s (AoS), transposing them into lanes
+template<size_t W>
+Vec3Packet<W> loadAoS(const vec3* arrayPtr) noexcept;
+
+/// Stores the lanes of a packet to an array of W vec3s (AoS)
+template<size_t W>
+void storeAoS(const Vec3Packet<W>& packet, vec3* arrayPtr) noexcept;
+
+/// Loads W vec3s from three separate component arrays (SoA)
+template<size_t W>
+Vec3Packet<W> loadSoA(const float* xArrayPtr, const float* yArrayPtr, const float* zArrayPtr) noexcept;
+
+/// Stores the lanes of a packet to three separate component arrays (SoA)
+template<size_t W>
+void storeSoA(const Vec3Packet<W>& packet, float* xArrayPtr, float* yArrayPtr, float* zArrayPtr) noexcept;
+
+// FloatPacket functions
+// ------------------------------------------------------------------------------------------------
+
+/// Returns the lane-wise minimum of two packets
+template<size_t W>
+FloatPacket<W> min(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+/// Returns the lane-wise maximum of two packets
+template<size_t W>
+FloatPacket<W> max(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+/// Returns the lane-wise abs() of the packet
+template<size_t W>
+FloatPacket<W> abs(const FloatPacket<W>& packet) noexcept;
+
+/// Returns the lane-wise sqrt() of the packet
+template<size_t W>
+FloatPacket<W> sqrt(const FloatPacket<W>& packet) noexcept;
+
+/// Returns the lane-wise a * b + c
+template<size_t W>
+FloatPacket<W> multiplyAdd(const FloatPacket<W>& a, const FloatPacket<W>& b, const FloatPacket<W>& c) noexcept;
+
+/// Selects lane i from ifSet if bit i in mask is set, otherwise from ifNotSet
+template<size_t W>
+FloatPacket<W> select(LaneMask mask, const FloatPacket<W>& ifSet, const FloatPacket<W>& ifNotSet) noexcept;
+
+/// Returns the minimum of all lanes
+template<size_t W>
+float horizontalMin(const FloatPacket<W>& packet) noexcept;
+
+/// Returns the maximum of all lanes
+template<size_t W>
+float horizontalMax(const FloatPacket<W>& packet) noexcept;
+
+// Vec3Packet functions
+// ------------------------------------------------------------------------------------------------
+
+/// Calculates the lane-wise dot product of two packets
+template<size_t W>
+FloatPacket<W> dot(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+/// Calculates the dot product between each lane and a single vector
+template<size_t W>
+FloatPacket<W> dot(const Vec3Packet<W>& left, const vec3& right) noexcept;
+
+/// Calculates the lane-wise cross product of two packets
+template<size_t W>
+Vec3Packet<W> cross(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+/// Calculates the lane-wise length
+template<size_t W>
+FloatPacket<W> length(const Vec3Packet<W>& packet) noexcept;
+
+/// Calculates the lane-wise squared length
+template<size_t W>
+FloatPacket<W> squaredLength(const Vec3Packet<W>& packet) noexcept;
+
+/// Returns the lane-wise (and element-wise) minimum of two packets
+template<size_t W>
+Vec3Packet<W> min(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+/// Returns the lane-wise (and element-wise) maximum of two packets
+template<size_t W>
+Vec3Packet<W> max(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+/// Returns the lane-wise (and element-wise) abs() of the packet
+template<size_t W>
+Vec3Packet<W> abs(const Vec3Packet<W>& packet) noexcept;
+
+/// Selects lane i from ifSet if bit i in mask is set, otherwise from ifNotSet
+template<size_t W>
+Vec3Packet<W> select(LaneMask mask, const Vec3Packet<W>& ifSet, const Vec3Packet<W>& ifNotSet) noexcept;
+
+/// Returns the element-wise minimum of all lanes
+template<size_t W>
+vec3 horizontalMin(const Vec3Packet<W>& packet) noexcept;
+
+/// Returns the element-wise maximum of all lanes
+template<size_t W>
+vec3 horizontalMax(const Vec3Packet<W>& packet) noexcept;
+
+// Comparisons (returning LaneMask)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+LaneMask lessThan(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+LaneMask lessThanEqual(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+LaneMask greaterThan(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+LaneMask greaterThanEqual(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+LaneMask equal(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+/// Compares each lane, a lane is only set if all three components are equal
+template<size_t W>
+LaneMask equal(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+// Operators (FloatPacket)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W>& operator+= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W>& operator-= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W>& operator*= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W>& operator/= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator+ (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator- (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator- (const FloatPacket<W>& packet) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator* (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator* (const FloatPacket<W>& left, float right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator* (float left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+FloatPacket<W> operator/ (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept;
+
+// Operators (Vec3Packet)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+Vec3Packet<W>& operator+= (Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W>& operator-= (Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W>& operator*= (Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator+ (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator- (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator- (const Vec3Packet<W>& packet) noexcept;
+
+/// Element-wise multiplication of two packets
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept;
+
+/// Multiplies each lane with the float in the corresponding lane
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator* (const FloatPacket<W>& left, const Vec3Packet<W>& right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, float right) noexcept;
+
+template<size_t W>
+Vec3Packet<W> operator* (float left, const Vec3Packet<W>& right) noexcept;
+
+/// Divides each lane with the float in the corresponding lane
+template<size_t W>
+Vec3Packet<W> operator/ (const Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept;
+
+} // namespace sfz
+
+#include "sfz/math/VectorPacket.inl"
@@ -0,0 +1,532 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+namespace sfz {
+
+// Packet struct declarations: FloatPacket<W>
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W>::FloatPacket(float value) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		lanes[i] = value;
+	}
+}
+
+template<size_t W>
+FloatPacket<W>::FloatPacket(const float* arrayPtr) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		lanes[i] = arrayPtr[i];
+	}
+}
+
+template<size_t W>
+float& FloatPacket<W>::operator[] (const size_t lane) noexcept
+{
+	sfz_assert_debug(lane < W);
+	return lanes[lane];
+}
+
+template<size_t W>
+float FloatPacket<W>::operator[] (const size_t lane) const noexcept
+{
+	sfz_assert_debug(lane < W);
+	return lanes[lane];
+}
+
+// Packet struct declarations: Vec3Packet<W>
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+Vec3Packet<W>::Vec3Packet(const vec3& value) noexcept
+:
+	x(value.x),
+	y(value.y),
+	z(value.z)
+{ }
+
+template<size_t W>
+Vec3Packet<W>::Vec3Packet(const FloatPacket<W>& x, const FloatPacket<W>& y,
+                          const FloatPacket<W>& z) noexcept
+:
+	x(x),
+	y(y),
+	z(z)
+{ }
+
+template<size_t W>
+vec3 Vec3Packet<W>::lane(size_t lane) const noexcept
+{
+	sfz_assert_debug(lane < W);
+	return vec3{x.lanes[lane], y.lanes[lane], z.lanes[lane]};
+}
+
+template<size_t W>
+void Vec3Packet<W>::setLane(size_t lane, const vec3& value) noexcept
+{
+	sfz_assert_debug(lane < W);
+	x.lanes[lane] = value.x;
+	y.lanes[lane] = value.y;
+	z.lanes[lane] = value.z;
+}
+
+// Loading & storing
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+Vec3Packet<W> loadAoS(const vec3* arrayPtr) noexcept
+{
+	Vec3Packet<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.x.lanes[i] = arrayPtr[i].x;
+		tmp.y.lanes[i] = arrayPtr[i].y;
+		tmp.z.lanes[i] = arrayPtr[i].z;
+	}
+	return tmp;
+}
+
+template<size_t W>
+void storeAoS(const Vec3Packet<W>& packet, vec3* arrayPtr) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		arrayPtr[i].x = packet.x.lanes[i];
+		arrayPtr[i].y = packet.y.lanes[i];
+		arrayPtr[i].z = packet.z.lanes[i];
+	}
+}
+
+template<size_t W>
+Vec3Packet<W> loadSoA(const float* xArrayPtr, const float* yArrayPtr, const float* zArrayPtr) noexcept
+{
+	return Vec3Packet<W>{FloatPacket<W>{xArrayPtr}, FloatPacket<W>{yArrayPtr}, FloatPacket<W>{zArrayPtr}};
+}
+
+template<size_t W>
+void storeSoA(const Vec3Packet<W>& packet, float* xArrayPtr, float* yArrayPtr, float* zArrayPtr) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		xArrayPtr[i] = packet.x.lanes[i];
+		yArrayPtr[i] = packet.y.lanes[i];
+		zArrayPtr[i] = packet.z.lanes[i];
+	}
+}
+
+// FloatPacket functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W> min(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = left.lanes[i] < right.lanes[i] ? left.lanes[i] : right.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> max(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = left.lanes[i] > right.lanes[i] ? left.lanes[i] : right.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> abs(const FloatPacket<W>& packet) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = std::abs(packet.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> sqrt(const FloatPacket<W>& packet) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = std::sqrt(packet.lanes[i]);
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> multiplyAdd(const FloatPacket<W>& a, const FloatPacket<W>& b, const FloatPacket<W>& c) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = a.lanes[i] * b.lanes[i] + c.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> select(LaneMask mask, const FloatPacket<W>& ifSet, const FloatPacket<W>& ifNotSet) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = ((mask >> i) & 1) ? ifSet.lanes[i] : ifNotSet.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+float horizontalMin(const FloatPacket<W>& packet) noexcept
+{
+	float result = packet.lanes[0];
+	for (size_t i = 1; i < W; i++) {
+		result = packet.lanes[i] < result ? packet.lanes[i] : result;
+	}
+	return result;
+}
+
+template<size_t W>
+float horizontalMax(const FloatPacket<W>& packet) noexcept
+{
+	float result = packet.lanes[0];
+	for (size_t i = 1; i < W; i++) {
+		result = packet.lanes[i] > result ? packet.lanes[i] : result;
+	}
+	return result;
+}
+
+// Vec3Packet functions
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W> dot(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = left.x.lanes[i] * right.x.lanes[i]
+		             + left.y.lanes[i] * right.y.lanes[i]
+		             + left.z.lanes[i] * right.z.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> dot(const Vec3Packet<W>& left, const vec3& right) noexcept
+{
+	FloatPacket<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.lanes[i] = left.x.lanes[i] * right.x
+		             + left.y.lanes[i] * right.y
+		             + left.z.lanes[i] * right.z;
+	}
+	return tmp;
+}
+
+template<size_t W>
+Vec3Packet<W> cross(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	Vec3Packet<W> tmp;
+	for (size_t i = 0; i < W; i++) {
+		tmp.x.lanes[i] = left.y.lanes[i] * right.z.lanes[i] - left.z.lanes[i] * right.y.lanes[i];
+		tmp.y.lanes[i] = left.z.lanes[i] * right.x.lanes[i] - left.x.lanes[i] * right.z.lanes[i];
+		tmp.z.lanes[i] = left.x.lanes[i] * right.y.lanes[i] - left.y.lanes[i] * right.x.lanes[i];
+	}
+	return tmp;
+}
+
+template<size_t W>
+FloatPacket<W> length(const Vec3Packet<W>& packet) noexcept
+{
+	return sqrt(dot(packet, packet));
+}
+
+template<size_t W>
+FloatPacket<W> squaredLength(const Vec3Packet<W>& packet) noexcept
+{
+	return dot(packet, packet);
+}
+
+template<size_t W>
+Vec3Packet<W> min(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	return Vec3Packet<W>{min(left.x, right.x), min(left.y, right.y), min(left.z, right.z)};
+}
+
+template<size_t W>
+Vec3Packet<W> max(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	return Vec3Packet<W>{max(left.x, right.x), max(left.y, right.y), max(left.z, right.z)};
+}
+
+template<size_t W>
+Vec3Packet<W> abs(const Vec3Packet<W>& packet) noexcept
+{
+	return Vec3Packet<W>{abs(packet.x), abs(packet.y), abs(packet.z)};
+}
+
+template<size_t W>
+Vec3Packet<W> select(LaneMask mask, const Vec3Packet<W>& ifSet, const Vec3Packet<W>& ifNotSet) noexcept
+{
+	return Vec3Packet<W>{select(mask, ifSet.x, ifNotSet.x),
+	                     select(mask, ifSet.y, ifNotSet.y),
+	                     select(mask, ifSet.z, ifNotSet.z)};
+}
+
+template<size_t W>
+vec3 horizontalMin(const Vec3Packet<W>& packet) noexcept
+{
+	return vec3{horizontalMin(packet.x), horizontalMin(packet.y), horizontalMin(packet.z)};
+}
+
+template<size_t W>
+vec3 horizontalMax(const Vec3Packet<W>& packet) noexcept
+{
+	return vec3{horizontalMax(packet.x), horizontalMax(packet.y), horizontalMax(packet.z)};
+}
+
+// Comparisons (returning LaneMask)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+LaneMask lessThan(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	LaneMask mask = 0;
+	for (size_t i = 0; i < W; i++) {
+		mask |= LaneMask(left.lanes[i] < right.lanes[i]) << i;
+	}
+	return mask;
+}
+
+template<size_t W>
+LaneMask lessThanEqual(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	LaneMask mask = 0;
+	for (size_t i = 0; i < W; i++) {
+		mask |= LaneMask(left.lanes[i] <= right.lanes[i]) << i;
+	}
+	return mask;
+}
+
+template<size_t W>
+LaneMask greaterThan(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	return lessThan(right, left);
+}
+
+template<size_t W>
+LaneMask greaterThanEqual(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	return lessThanEqual(right, left);
+}
+
+template<size_t W>
+LaneMask equal(const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	LaneMask mask = 0;
+	for (size_t i = 0; i < W; i++) {
+		mask |= LaneMask(left.lanes[i] == right.lanes[i]) << i;
+	}
+	return mask;
+}
+
+template<size_t W>
+LaneMask equal(const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	return equal(left.x, right.x) & equal(left.y, right.y) & equal(left.z, right.z);
+}
+
+// Operators (FloatPacket)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+FloatPacket<W>& operator+= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		left.lanes[i] += right.lanes[i];
+	}
+	return left;
+}
+
+template<size_t W>
+FloatPacket<W>& operator-= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		left.lanes[i] -= right.lanes[i];
+	}
+	return left;
+}
+
+template<size_t W>
+FloatPacket<W>& operator*= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		left.lanes[i] *= right.lanes[i];
+	}
+	return left;
+}
+
+template<size_t W>
+FloatPacket<W>& operator/= (FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	for (size_t i = 0; i < W; i++) {
+		left.lanes[i] /= right.lanes[i];
+	}
+	return left;
+}
+
+template<size_t W>
+FloatPacket<W> operator+ (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> temp = left;
+	return (temp += right);
+}
+
+template<size_t W>
+FloatPacket<W> operator- (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> temp = left;
+	return (temp -= right);
+}
+
+template<size_t W>
+FloatPacket<W> operator- (const FloatPacket<W>& packet) noexcept
+{
+	FloatPacket<W> temp;
+	for (size_t i = 0; i < W; i++) {
+		temp.lanes[i] = -packet.lanes[i];
+	}
+	return temp;
+}
+
+template<size_t W>
+FloatPacket<W> operator* (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> temp = left;
+	return (temp *= right);
+}
+
+template<size_t W>
+FloatPacket<W> operator* (const FloatPacket<W>& left, float right) noexcept
+{
+	FloatPacket<W> temp = left;
+	return (temp *= FloatPacket<W>{right});
+}
+
+template<size_t W>
+FloatPacket<W> operator* (float left, const FloatPacket<W>& right) noexcept
+{
+	return right * left;
+}
+
+template<size_t W>
+FloatPacket<W> operator/ (const FloatPacket<W>& left, const FloatPacket<W>& right) noexcept
+{
+	FloatPacket<W> temp = left;
+	return (temp /= right);
+}
+
+// Operators (Vec3Packet)
+// ------------------------------------------------------------------------------------------------
+
+template<size_t W>
+Vec3Packet<W>& operator+= (Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	left.x += right.x;
+	left.y += right.y;
+	left.z += right.z;
+	return left;
+}
+
+template<size_t W>
+Vec3Packet<W>& operator-= (Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	left.x -= right.x;
+	left.y -= right.y;
+	left.z -= right.z;
+	return left;
+}
+
+template<size_t W>
+Vec3Packet<W>& operator*= (Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept
+{
+	left.x *= right;
+	left.y *= right;
+	left.z *= right;
+	return left;
+}
+
+template<size_t W>
+Vec3Packet<W> operator+ (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	Vec3Packet<W> temp = left;
+	return (temp += right);
+}
+
+template<size_t W>
+Vec3Packet<W> operator- (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	Vec3Packet<W> temp = left;
+	return (temp -= right);
+}
+
+template<size_t W>
+Vec3Packet<W> operator- (const Vec3Packet<W>& packet) noexcept
+{
+	return Vec3Packet<W>{-packet.x, -packet.y, -packet.z};
+}
+
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	return Vec3Packet<W>{left.x * right.x, left.y * right.y, left.z * right.z};
+}
+
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept
+{
+	Vec3Packet<W> temp = left;
+	return (temp *= right);
+}
+
+template<size_t W>
+Vec3Packet<W> operator* (const FloatPacket<W>& left, const Vec3Packet<W>& right) noexcept
+{
+	return right * left;
+}
+
+template<size_t W>
+Vec3Packet<W> operator* (const Vec3Packet<W>& left, float right) noexcept
+{
+	return left * FloatPacket<W>{right};
+}
+
+template<size_t W>
+Vec3Packet<W> operator* (float left, const Vec3Packet<W>& right) noexcept
+{
+	return right * FloatPacket<W>{left};
+}
+
+template<size_t W>
+Vec3Packet<W> operator/ (const Vec3Packet<W>& left, const FloatPacket<W>& right) noexcept
+{
+	return Vec3Packet<W>{left.x / right, left.y / right, left.z / right};
+}
+
+} // namespace sfz
@@ -27,6 +27,7 @@ namespace sfz {
 
 using std::int32_t;
 using std::int64_t;
+using std::size_t;
 using std::uint8_t;
 
 // Paths
@@ -71,6 +72,10 @@ bool copyFile(const char* srcPath, const char* dstPath) noexcept;
 /// Returns size of file in bytes, negative value if error.
 int64_t sizeofFile(const char* path) noexcept;
 
+/// Returns the time a file was last modified in seconds since the Unix epoch, negative value if
+/// error.
+int64_t fileModificationTime(const char* path) noexcept;
+
 /// Reads binary file to pre-allocated memory.
 /// \return 0 on success, -1 on error, -2 if file was larger than pre-allocated memory
 int32_t readBinaryFile(const char* path, uint8_t* dataOut, size_t maxNumBytes) noexcept;
@@ -84,4 +89,46 @@ DynString readTextFile(const char* path) noexcept;
 /// Writes memory to binary file, returns whether successful or not.
 bool writeBinaryFile(const char* path, const uint8_t* data, size_t numBytes) noexcept;
 
+// MappedFile
+// ------------------------------------------------------------------------------------------------
+
+/// A read-only memory mapping of a whole file. The contents are paged in by the OS when accessed,
+/// so nothing is copied and only the parts of the file actually read are loaded.
+class MappedFile final {
+public:
+	// Constructors & destructors
+	// --------------------------------------------------------------------------------------------
+
+	MappedFile() noexcept = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	/// Maps the file at the given path, isMapped() returns false if the file could not be opened
+	/// or mapped. Empty files can not be mapped.
+	explicit MappedFile(const char* path) noexcept;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator= (MappedFile&& other) noexcept;
+	~MappedFile() noexcept;
+
+	// Public methods
+	// --------------------------------------------------------------------------------------------
+
+	void swap(MappedFile& other) noexcept;
+
+	/// Unmaps the file, the result will be an unmapped MappedFile.
+	void destroy() noexcept;
+
+	bool isMapped() const noexcept { return mData != nullptr; }
+	const uint8_t* data() const noexcept { return mData; }
+	size_t size() const noexcept { return mSize; }
+
+private:
+	// Private members
+	// --------------------------------------------------------------------------------------------
+
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0;
+};
+
 } // namespace sfz
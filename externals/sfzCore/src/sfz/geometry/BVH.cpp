@@ -0,0 +1,625 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/BVH.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <thread>
+
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+/// Number of node levels built using SAH before falling back to median splits, bounds the depth
+/// of the tree (and thus the traversal stack) for degenerate inputs.
+static const uint32_t MAX_SAH_DEPTH = 40;
+
+/// Deepest tree the traversal stacks can hold, each level pushes at most 3 more nodes than it pops
+static const uint32_t MAX_TRAVERSAL_DEPTH = (BVH::TRAVERSAL_STACK_SIZE - 4) / 3;
+
+/// Smallest number of primitives for which a parallel build is attempted
+static const uint32_t MIN_PARALLEL_PRIMITIVES = 8192;
+
+namespace {
+
+struct Bounds final {
+	vec3 min = vec3(FLT_MAX);
+	vec3 max = vec3(-FLT_MAX);
+
+	void extend(const vec3& point) noexcept
+	{
+		min = sfz::min(min, point);
+		max = sfz::max(max, point);
+	}
+
+	void extend(const Bounds& other) noexcept
+	{
+		min = sfz::min(min, other.min);
+		max = sfz::max(max, other.max);
+	}
+
+	void extend(const AABB& aabb) noexcept
+	{
+		min = sfz::min(min, aabb.min());
+		max = sfz::max(max, aabb.max());
+	}
+
+	/// Half the surface area, which is all that is needed for SAH cost comparisons
+	float halfArea() const noexcept
+	{
+		vec3 e = max - min;
+		if (e[0] < 0.0f) return 0.0f;
+		return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+	}
+};
+
+struct PrimRef final {
+	Bounds bounds;
+	vec3 centroid;
+	uint32_t index;
+};
+
+struct BuildRange final {
+	uint32_t begin, end;
+};
+
+struct BuildContext final {
+	PrimRef* prims = nullptr; // Shared between contexts, which work on disjoint ranges
+	DynArray<BVHNode> nodes;
+};
+
+} // anonymous namespace
+
+static Bounds rangeBounds(const BuildContext& ctx, uint32_t begin, uint32_t end) noexcept
+{
+	Bounds bounds;
+	for (uint32_t i = begin; i < end; i++) {
+		bounds.extend(ctx.prims[i].bounds);
+	}
+	return bounds;
+}
+
+/// Splits [begin, end) in two using a binned SAH over all three axes, returns the first index of
+/// the right half. Both halves are guaranteed to be non-empty.
+static uint32_t splitRange(BuildContext& ctx, uint32_t begin, uint32_t end, uint32_t depth) noexcept
+{
+	sfz_assert_debug((end - begin) >= 2);
+	PrimRef* prims = ctx.prims;
+
+	Bounds centroidBounds;
+	for (uint32_t i = begin; i < end; i++) {
+		centroidBounds.extend(prims[i].centroid);
+	}
+	const vec3 centroidExtent = centroidBounds.max - centroidBounds.min;
+
+	auto medianSplit = [&]() {
+		uint32_t axis = 0;
+		if (centroidExtent[1] > centroidExtent[axis]) axis = 1;
+		if (centroidExtent[2] > centroidExtent[axis]) axis = 2;
+		const uint32_t mid = begin + (end - begin) / 2;
+		std::nth_element(prims + begin, prims + mid, prims + end, [&](const PrimRef& lhs, const PrimRef& rhs) {
+			return lhs.centroid[axis] < rhs.centroid[axis];
+		});
+		return mid;
+	};
+	if (depth >= MAX_SAH_DEPTH) return medianSplit();
+
+	// Flat axes get a scale of 0, which puts everything in the first bin (and is never chosen)
+	vec3 binScale;
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		binScale[axis] = centroidExtent[axis] > 0.0f ? float(BVH::NUM_BINS) / centroidExtent[axis] : 0.0f;
+	}
+	auto binIndex = [&](const vec3& centroid, uint32_t axis) {
+		uint32_t bin = uint32_t((centroid[axis] - centroidBounds.min[axis]) * binScale[axis]);
+		return std::min(bin, BVH::NUM_BINS - 1);
+	};
+
+	// Bin all three axes in a single pass
+	Bounds bins[3][BVH::NUM_BINS];
+	uint32_t binCounts[3][BVH::NUM_BINS] = {};
+	for (uint32_t i = begin; i < end; i++) {
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			uint32_t bin = binIndex(prims[i].centroid, axis);
+			bins[axis][bin].extend(prims[i].bounds);
+			binCounts[axis][bin] += 1;
+		}
+	}
+
+	float bestCost = FLT_MAX;
+	uint32_t bestAxis = 3;
+	uint32_t bestBin = 0;
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		if (centroidExtent[axis] <= 0.0f) continue;
+
+		// Sweep from the right to find the area and count to the right of each split plane
+		float rightAreas[BVH::NUM_BINS];
+		uint32_t rightCounts[BVH::NUM_BINS];
+		Bounds accBounds;
+		uint32_t accCount = 0;
+		for (uint32_t i = BVH::NUM_BINS - 1; i > 0; i--) {
+			accBounds.extend(bins[axis][i]);
+			accCount += binCounts[axis][i];
+			rightAreas[i] = accBounds.halfArea();
+			rightCounts[i] = accCount;
+		}
+
+		// Sweep from the left, evaluating the split after each bin
+		accBounds = Bounds();
+		accCount = 0;
+		for (uint32_t i = 0; i < BVH::NUM_BINS - 1; i++) {
+			accBounds.extend(bins[axis][i]);
+			accCount += binCounts[axis][i];
+			if (accCount == 0 || rightCounts[i + 1] == 0) continue;
+			float cost = accBounds.halfArea() * float(accCount)
+			           + rightAreas[i + 1] * float(rightCounts[i + 1]);
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = i;
+			}
+		}
+	}
+
+	// All centroids coincide, any split is as good as any other
+	if (bestAxis == 3) return medianSplit();
+
+	PrimRef* mid = std::partition(prims + begin, prims + end, [&](const PrimRef& prim) {
+		return binIndex(prim.centroid, bestAxis) <= bestBin;
+	});
+	return uint32_t(mid - prims);
+}
+
+/// Splits [begin, end) into up to four child ranges by splitting twice, returns number of ranges
+static uint32_t splitIntoChildren(BuildContext& ctx, uint32_t begin, uint32_t end, uint32_t depth,
+                                  BuildRange rangesOut[4]) noexcept
+{
+	if ((end - begin) <= BVH::MAX_LEAF_SIZE) {
+		rangesOut[0] = BuildRange{begin, end};
+		return 1;
+	}
+
+	const uint32_t mid = splitRange(ctx, begin, end, depth);
+	uint32_t numRanges = 0;
+	for (BuildRange half : { BuildRange{begin, mid}, BuildRange{mid, end} }) {
+		if ((half.end - half.begin) <= BVH::MAX_LEAF_SIZE) {
+			rangesOut[numRanges++] = half;
+			continue;
+		}
+		const uint32_t quarter = splitRange(ctx, half.begin, half.end, depth);
+		rangesOut[numRanges++] = BuildRange{half.begin, quarter};
+		rangesOut[numRanges++] = BuildRange{quarter, half.end};
+	}
+	return numRanges;
+}
+
+static void setSlotBounds(BVHNode& node, uint32_t slot, const Bounds& bounds) noexcept
+{
+	node.minX[slot] = bounds.min[0];
+	node.minY[slot] = bounds.min[1];
+	node.minZ[slot] = bounds.min[2];
+	node.maxX[slot] = bounds.max[0];
+	node.maxY[slot] = bounds.max[1];
+	node.maxZ[slot] = bounds.max[2];
+}
+
+static uint32_t allocateNode(BuildContext& ctx) noexcept
+{
+	BVHNode node;
+	for (uint32_t slot = 0; slot < 4; slot++) {
+		setSlotBounds(node, slot, Bounds());
+		node.children[slot] = BVH_INVALID_INDEX;
+		node.counts[slot] = 0;
+	}
+	ctx.nodes.add(node);
+	return ctx.nodes.size() - 1;
+}
+
+/// Sets a slot to a leaf if the range is small enough, otherwise allocates a child node for it.
+/// Returns the index of the allocated child node or BVH_INVALID_INDEX if the slot is a leaf.
+static uint32_t setSlot(BuildContext& ctx, uint32_t nodeIndex, uint32_t slot, BuildRange range) noexcept
+{
+	const uint32_t count = range.end - range.begin;
+	setSlotBounds(ctx.nodes[nodeIndex], slot, rangeBounds(ctx, range.begin, range.end));
+	if (count <= BVH::MAX_LEAF_SIZE) {
+		ctx.nodes[nodeIndex].children[slot] = range.begin;
+		ctx.nodes[nodeIndex].counts[slot] = count;
+		return BVH_INVALID_INDEX;
+	}
+	const uint32_t childIndex = allocateNode(ctx);
+	ctx.nodes[nodeIndex].children[slot] = childIndex;
+	ctx.nodes[nodeIndex].counts[slot] = 0;
+	return childIndex;
+}
+
+static void buildNode(BuildContext& ctx, uint32_t nodeIndex, BuildRange range, uint32_t depth) noexcept
+{
+	BuildRange childRanges[4];
+	const uint32_t numChildren = splitIntoChildren(ctx, range.begin, range.end, depth, childRanges);
+	for (uint32_t slot = 0; slot < numChildren; slot++) {
+		// Note: ctx.nodes may be reallocated by the recursion, so nodes are accessed by index
+		uint32_t childIndex = setSlot(ctx, nodeIndex, slot, childRanges[slot]);
+		if (childIndex != BVH_INVALID_INDEX) {
+			buildNode(ctx, childIndex, childRanges[slot], depth + 1);
+		}
+	}
+}
+
+static void loadSlotBounds(const BVHNode& node, vec3x4& minOut, vec3x4& maxOut) noexcept
+{
+	minOut = loadSoA<4>(node.minX, node.minY, node.minZ);
+	maxOut = loadSoA<4>(node.maxX, node.maxY, node.maxZ);
+}
+
+// BVH: Static members
+// ------------------------------------------------------------------------------------------------
+
+// Definitions needed (before C++17) if the constants are ODR-used, e.g. bound to a reference
+constexpr uint32_t BVH::MAX_LEAF_SIZE;
+constexpr uint32_t BVH::NUM_BINS;
+constexpr uint32_t BVH::TRAVERSAL_STACK_SIZE;
+
+// BVH: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+BVH::BVH(const AABB* aabbs, uint32_t numAABBs, uint32_t numThreads) noexcept
+{
+	this->build(aabbs, numAABBs, numThreads);
+}
+
+// BVH: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void BVH::build(const AABB* aabbs, uint32_t numAABBs, uint32_t numThreads) noexcept
+{
+	mNodes.clear();
+	mPrimIndices.clear();
+	mPrimBounds.clear();
+	if (numAABBs == 0) return;
+
+	// The primitive references are reordered in place during the build, ending up in leaf order
+	DynArray<PrimRef> prims(0, numAABBs);
+	for (uint32_t i = 0; i < numAABBs; i++) {
+		PrimRef prim;
+		prim.bounds.extend(aabbs[i]);
+		prim.centroid = (aabbs[i].min() + aabbs[i].max()) * 0.5f;
+		prim.index = i;
+		prims.add(prim);
+	}
+
+	BuildContext ctx;
+	ctx.prims = prims.data();
+	const uint32_t root = allocateNode(ctx);
+
+	if (numThreads <= 1 || numAABBs < MIN_PARALLEL_PRIMITIVES) {
+		buildNode(ctx, root, BuildRange{0, numAABBs}, 0);
+	}
+	else {
+		// Split the root on this thread, then build each of its subtrees into a separate node
+		// array (on separate threads) and append them afterwards.
+		BuildRange childRanges[4];
+		const uint32_t numChildren = splitIntoChildren(ctx, 0, numAABBs, 0, childRanges);
+		BuildContext subContexts[4];
+		std::thread threads[4];
+		uint32_t numWorkers = 0;
+		for (uint32_t slot = 0; slot < numChildren; slot++) {
+			if (setSlot(ctx, root, slot, childRanges[slot]) == BVH_INVALID_INDEX) continue;
+
+			BuildContext& sub = subContexts[slot];
+			sub.prims = ctx.prims;
+			auto buildSubtree = [&sub, range = childRanges[slot]]() {
+				uint32_t subRoot = allocateNode(sub);
+				buildNode(sub, subRoot, range, 1);
+			};
+			if ((numWorkers + 1) < numThreads) threads[numWorkers++] = std::thread(buildSubtree);
+			else buildSubtree();
+		}
+		for (uint32_t i = 0; i < numWorkers; i++) {
+			threads[i].join();
+		}
+
+		// Drop the child nodes allocated by setSlot(), the subtree roots take their place
+		ctx.nodes.setSize(1);
+		for (uint32_t slot = 0; slot < numChildren; slot++) {
+			if (!ctx.nodes[root].isInner(slot)) continue;
+			const uint32_t offset = ctx.nodes.size();
+			ctx.nodes[root].children[slot] = offset;
+			for (BVHNode node : subContexts[slot].nodes) {
+				for (uint32_t i = 0; i < 4; i++) {
+					if (node.isInner(i)) node.children[i] += offset;
+				}
+				ctx.nodes.add(node);
+			}
+		}
+	}
+
+	mNodes.swap(ctx.nodes);
+	mPrimIndices.ensureCapacity(numAABBs);
+	mPrimBounds.ensureCapacity(numAABBs);
+	for (uint32_t i = 0; i < numAABBs; i++) {
+		mPrimIndices.add(prims[i].index);
+		mPrimBounds.add(aabbs[prims[i].index]);
+	}
+}
+
+void BVH::refit(const AABB* aabbs) noexcept
+{
+	for (uint32_t i = 0; i < mPrimIndices.size(); i++) {
+		mPrimBounds[i] = aabbs[mPrimIndices[i]];
+	}
+
+	// Children always have higher indices than their parents
+	for (uint32_t i = mNodes.size(); i > 0; i--) {
+		BVHNode& node = mNodes[i - 1];
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			Bounds bounds;
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				for (uint32_t p = first; p < (first + node.counts[slot]); p++) {
+					bounds.extend(mPrimBounds[p]);
+				}
+			}
+			else if (node.isInner(slot)) {
+				const BVHNode& child = mNodes[node.children[slot]];
+				for (uint32_t childSlot = 0; childSlot < 4; childSlot++) {
+					if (child.isEmpty(childSlot)) continue;
+					bounds.extend(vec3(child.minX[childSlot], child.minY[childSlot], child.minZ[childSlot]));
+					bounds.extend(vec3(child.maxX[childSlot], child.maxY[childSlot], child.maxZ[childSlot]));
+				}
+			}
+			else {
+				continue;
+			}
+			setSlotBounds(node, slot, bounds);
+		}
+	}
+}
+
+bool BVH::restore(const AABB* aabbs, uint32_t numAABBs, const BVHNode* nodes, uint32_t numNodes,
+                  const uint32_t* primitiveIndices) noexcept
+{
+	mNodes.clear();
+	mPrimIndices.clear();
+	mPrimBounds.clear();
+	if (numAABBs == 0 || numNodes == 0) return numAABBs == 0 && numNodes == 0;
+
+	// Primitive indices must be a permutation
+	DynArray<uint8_t> seen(numAABBs, uint8_t(0));
+	for (uint32_t i = 0; i < numAABBs; i++) {
+		const uint32_t index = primitiveIndices[i];
+		if (index >= numAABBs || seen[index] != 0) return false;
+		seen[index] = 1;
+	}
+
+	// Every node except the root must have exactly one parent with a lower index (so that
+	// refit() works), leaves must cover every primitive exactly once
+	DynArray<uint32_t> depths(numNodes, uint32_t(0), 0);
+	DynArray<uint8_t> covered(numAABBs, uint8_t(0));
+	for (uint32_t i = 0; i < numNodes; i++) {
+		const BVHNode& node = nodes[i];
+		if (i != 0 && depths[i] == 0) return false;
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				const uint32_t count = node.counts[slot];
+				if (count > MAX_LEAF_SIZE || first >= numAABBs || count > (numAABBs - first)) {
+					return false;
+				}
+				for (uint32_t p = first; p < (first + count); p++) {
+					if (covered[p] != 0) return false;
+					covered[p] = 1;
+				}
+			}
+			else if (node.isInner(slot)) {
+				const uint32_t child = node.children[slot];
+				if (child <= i || child >= numNodes || depths[child] != 0) return false;
+				depths[child] = depths[i] + 1;
+				if (depths[child] > MAX_TRAVERSAL_DEPTH) return false;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < numAABBs; i++) {
+		if (covered[i] == 0) return false;
+	}
+
+	// Empty slots get inverted bounds, the rest are computed by refit()
+	mNodes.add(nodes, numNodes);
+	for (BVHNode& node : mNodes) {
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if (node.isEmpty(slot)) setSlotBounds(node, slot, Bounds());
+		}
+	}
+	mPrimIndices.add(primitiveIndices, numAABBs);
+	mPrimBounds.setCapacity(numAABBs);
+	mPrimBounds.setSize(numAABBs);
+	this->refit(aabbs);
+	return true;
+}
+
+void BVH::queryFrustum(const ViewFrustum& frustum, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const Plane* planes[6] = { &frustum.leftPlane(), &frustum.rightPlane(), &frustum.nearPlane(),
+	                           &frustum.farPlane(), &frustum.upPlane(), &frustum.downPlane() };
+	const uint32_t ALL_PLANES = 0x3F;
+
+	// Each stack entry also stores the planes its node is not completely inside of
+	uint32_t nodeStack[TRAVERSAL_STACK_SIZE];
+	uint32_t planeMaskStack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	nodeStack[stackSize] = 0;
+	planeMaskStack[stackSize] = ALL_PLANES;
+	stackSize++;
+
+	while (stackSize > 0) {
+		stackSize--;
+		const BVHNode& node = mNodes[nodeStack[stackSize]];
+		const uint32_t planeMask = planeMaskStack[stackSize];
+
+		vec3x4 nodeMin, nodeMax;
+		loadSlotBounds(node, nodeMin, nodeMax);
+		const vec3x4 center = (nodeMin + nodeMax) * 0.5f;
+		const vec3x4 halfExtents = (nodeMax - nodeMin) * 0.5f;
+
+		LaneMask visible = ALL_LANES<4>();
+		uint32_t childPlaneMasks[4] = { planeMask, planeMask, planeMask, planeMask };
+		for (uint32_t p = 0; p < 6 && visible != 0; p++) {
+			if ((planeMask & (1u << p)) == 0) continue;
+			const vec3 normal = planes[p]->normal();
+			const floatx4 dist = dot(center, normal) - floatx4(planes[p]->d());
+			const floatx4 projectedRadius = dot(halfExtents, abs(normal));
+			visible &= lessThanEqual(dist, projectedRadius);
+			const LaneMask inside = lessThanEqual(dist + projectedRadius, floatx4(0.0f));
+			for (uint32_t slot = 0; slot < 4; slot++) {
+				if ((inside & (1u << slot)) != 0) childPlaneMasks[slot] &= ~(1u << p);
+			}
+		}
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if ((visible & (1u << slot)) == 0) continue;
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				for (uint32_t p = first; p < (first + node.counts[slot]); p++) {
+					if (childPlaneMasks[slot] == 0 || frustum.isVisible(mPrimBounds[p])) {
+						resultOut.add(mPrimIndices[p]);
+					}
+				}
+			}
+			else if (node.isInner(slot)) {
+				sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+				nodeStack[stackSize] = node.children[slot];
+				planeMaskStack[stackSize] = childPlaneMasks[slot];
+				stackSize++;
+			}
+		}
+	}
+}
+
+void BVH::queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const vec3x4 queryMin(aabb.min());
+	const vec3x4 queryMax(aabb.max());
+
+	uint32_t stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const BVHNode& node = mNodes[stack[--stackSize]];
+
+		vec3x4 nodeMin, nodeMax;
+		loadSlotBounds(node, nodeMin, nodeMax);
+		const LaneMask hits = lessThanEqual(nodeMin.x, queryMax.x) & greaterThanEqual(nodeMax.x, queryMin.x)
+		                    & lessThanEqual(nodeMin.y, queryMax.y) & greaterThanEqual(nodeMax.y, queryMin.y)
+		                    & lessThanEqual(nodeMin.z, queryMax.z) & greaterThanEqual(nodeMax.z, queryMin.z);
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if ((hits & (1u << slot)) == 0) continue;
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				for (uint32_t p = first; p < (first + node.counts[slot]); p++) {
+					if (intersects(aabb, mPrimBounds[p])) resultOut.add(mPrimIndices[p]);
+				}
+			}
+			else if (node.isInner(slot)) {
+				sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+				stack[stackSize++] = node.children[slot];
+			}
+		}
+	}
+}
+
+void BVH::queryOverlap(const Sphere& sphere, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const vec3x4 center(sphere.position());
+	const floatx4 radiusSquared(sphere.radius() * sphere.radius());
+
+	uint32_t stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const BVHNode& node = mNodes[stack[--stackSize]];
+
+		vec3x4 nodeMin, nodeMax;
+		loadSlotBounds(node, nodeMin, nodeMax);
+		const vec3x4 closest = max(nodeMin, min(center, nodeMax));
+		const LaneMask hits = lessThanEqual(squaredLength(closest - center), radiusSquared);
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if ((hits & (1u << slot)) == 0) continue;
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				for (uint32_t p = first; p < (first + node.counts[slot]); p++) {
+					if (intersects(mPrimBounds[p], sphere)) resultOut.add(mPrimIndices[p]);
+				}
+			}
+			else if (node.isInner(slot)) {
+				sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+				stack[stackSize++] = node.children[slot];
+			}
+		}
+	}
+}
+
+void BVH::queryRay(const Ray& ray, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const RayPacket<4> rays(ray);
+
+	uint32_t stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const BVHNode& node = mNodes[stack[--stackSize]];
+
+		// Slab test against all four children at once
+		const LaneMask hits = ~equal(detail::raycastNodeSlots(rays, node), floatx4(RAY_MISS));
+
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if ((hits & (1u << slot)) == 0) continue;
+			if (node.isLeaf(slot)) {
+				const uint32_t first = node.children[slot];
+				for (uint32_t p = first; p < (first + node.counts[slot]); p++) {
+					if (raycast(ray, mPrimBounds[p]) != RAY_MISS) resultOut.add(mPrimIndices[p]);
+				}
+			}
+			else if (node.isInner(slot)) {
+				sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+				stack[stackSize++] = node.children[slot];
+			}
+		}
+	}
+}
+
+} // namespace sfz
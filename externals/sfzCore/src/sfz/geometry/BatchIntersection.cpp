@@ -0,0 +1,195 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/BatchIntersection.hpp"
+
+#include <algorithm>
+
+#include "sfz/Assert.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+/// Loads count (<= 8) floats into a packet, remaining lanes are set to 0
+static floatx8 loadPartial(const float* arrayPtr, size_t count) noexcept
+{
+	if (count == BATCH_PACKET_WIDTH) return floatx8(arrayPtr);
+	floatx8 packet(0.0f);
+	for (size_t i = 0; i < count; i++) {
+		packet.lanes[i] = arrayPtr[i];
+	}
+	return packet;
+}
+
+/// Writes the lane mask of the packet starting at index packetStart into the bitmask
+static void writePacketMask(uint32_t* maskOut, size_t packetStart, LaneMask mask) noexcept
+{
+	const size_t word = packetStart / 32;
+	const size_t shift = packetStart % 32;
+	if (shift == 0) maskOut[word] = 0;
+	maskOut[word] |= (uint32_t(mask) << shift);
+}
+
+/// Runs the OBB vs OBB SAT test from intersects(const OBB&, const OBB&) for the packet of boxes
+/// starting at index first, only lanes set in alive are considered.
+static LaneMask intersectsPacket(const OBB& a, const OBBBatch& boxes, uint32_t first,
+                                 LaneMask alive) noexcept
+{
+	const std::array<vec3,3>& aU = a.axes();
+	const vec3 aE = a.halfExtents();
+	const floatx8 EPSILON(0.00001f);
+
+	// Rotation matrix from b to a, R[i][j] = dot(aU[i], bU[j])
+	floatx8 R[3][3], AbsR[3][3];
+	for (uint32_t j = 0; j < 3; j++) {
+		const uint32_t c = 3 + 3 * j;
+		const vec3x8 bU = loadSoA<8>(boxes.component(c) + first, boxes.component(c + 1) + first,
+		                             boxes.component(c + 2) + first);
+		for (uint32_t i = 0; i < 3; i++) {
+			R[i][j] = dot(bU, aU[i]);
+			AbsR[i][j] = abs(R[i][j]) + EPSILON;
+		}
+	}
+
+	// Translation vector from a to b in a's frame of reference
+	const vec3x8 bPos = loadSoA<8>(boxes.component(0) + first, boxes.component(1) + first,
+	                               boxes.component(2) + first);
+	const vec3x8 tWorld = bPos - vec3x8(a.position());
+	const floatx8 t[3] = { dot(tWorld, aU[0]), dot(tWorld, aU[1]), dot(tWorld, aU[2]) };
+
+	const floatx8 bE[3] = { floatx8(boxes.component(12) + first),
+	                        floatx8(boxes.component(13) + first),
+	                        floatx8(boxes.component(14) + first) };
+
+	// Test axes L = aU[0], aU[1], aU[2]
+	for (uint32_t i = 0; i < 3; i++) {
+		floatx8 rb = bE[0] * AbsR[i][0] + bE[1] * AbsR[i][1] + bE[2] * AbsR[i][2];
+		alive &= lessThanEqual(abs(t[i]), floatx8(aE[i]) + rb);
+	}
+	if (alive == 0) return 0;
+
+	// Test axes L = bU[0], bU[1], bU[2]
+	for (uint32_t j = 0; j < 3; j++) {
+		floatx8 ra = aE[0] * AbsR[0][j] + aE[1] * AbsR[1][j] + aE[2] * AbsR[2][j];
+		floatx8 dist = t[0] * R[0][j] + t[1] * R[1][j] + t[2] * R[2][j];
+		alive &= lessThanEqual(abs(dist), ra + bE[j]);
+	}
+	if (alive == 0) return 0;
+
+	// Test axes L = aU[i] x bU[j]
+	for (uint32_t i = 0; i < 3; i++) {
+		const uint32_t i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+		for (uint32_t j = 0; j < 3; j++) {
+			const uint32_t j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			floatx8 ra = aE[i1] * AbsR[i2][j] + aE[i2] * AbsR[i1][j];
+			floatx8 rb = bE[j1] * AbsR[i][j2] + bE[j2] * AbsR[i][j1];
+			floatx8 dist = t[i2] * R[i1][j] - t[i1] * R[i2][j];
+			alive &= lessThanEqual(abs(dist), ra + rb);
+		}
+		if (alive == 0) return 0;
+	}
+
+	return alive;
+}
+
+// OBBBatch: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void OBBBatch::add(const OBB& obb) noexcept
+{
+	if (mSize % BATCH_PACKET_WIDTH == 0) {
+		const float zeroes[BATCH_PACKET_WIDTH] = {};
+		for (DynArray<float>& component : mComponents) {
+			component.add(zeroes, BATCH_PACKET_WIDTH);
+		}
+	}
+	mSize += 1;
+	set(mSize - 1, obb);
+}
+
+void OBBBatch::set(uint32_t index, const OBB& obb) noexcept
+{
+	sfz_assert_debug(index < mSize);
+	const vec3 center = obb.position();
+	const vec3 halfExtents = obb.halfExtents();
+	for (uint32_t i = 0; i < 3; i++) {
+		mComponents[i][index] = center[i];
+		mComponents[3 + i][index] = obb.xAxis()[i];
+		mComponents[6 + i][index] = obb.yAxis()[i];
+		mComponents[9 + i][index] = obb.zAxis()[i];
+		mComponents[12 + i][index] = halfExtents[i];
+	}
+}
+
+OBB OBBBatch::get(uint32_t index) const noexcept
+{
+	sfz_assert_debug(index < mSize);
+	vec3 comps[5];
+	for (uint32_t i = 0; i < 5; i++) {
+		comps[i] = vec3{mComponents[3 * i][index], mComponents[3 * i + 1][index],
+		                mComponents[3 * i + 2][index]};
+	}
+	return OBB(comps[0], comps[1], comps[2], comps[3], comps[4] * 2.0f);
+}
+
+void OBBBatch::clear() noexcept
+{
+	mSize = 0;
+	for (DynArray<float>& component : mComponents) {
+		component.clear();
+	}
+}
+
+// Batched intersection tests
+// ------------------------------------------------------------------------------------------------
+
+void intersects(const OBB& box, const OBBBatch& boxes, uint32_t* intersectMaskOut) noexcept
+{
+	const uint32_t count = boxes.size();
+	for (uint32_t i = 0; i < count; i += BATCH_PACKET_WIDTH) {
+		const uint32_t numInPacket = std::min(BATCH_PACKET_WIDTH, count - i);
+		const LaneMask alive = (LaneMask(1) << numInPacket) - LaneMask(1);
+		writePacketMask(intersectMaskOut, i, intersectsPacket(box, boxes, i, alive));
+	}
+}
+
+void intersects(const Sphere& sphere, const float* centerX, const float* centerY,
+                const float* centerZ, const float* radius, size_t count,
+                uint32_t* intersectMaskOut) noexcept
+{
+	const vec3x8 spherePos(sphere.position());
+	const floatx8 sphereRadius(sphere.radius());
+
+	for (size_t i = 0; i < count; i += BATCH_PACKET_WIDTH) {
+		const size_t numInPacket = std::min(size_t(BATCH_PACKET_WIDTH), count - i);
+		const vec3x8 center{loadPartial(centerX + i, numInPacket),
+		                    loadPartial(centerY + i, numInPacket),
+		                    loadPartial(centerZ + i, numInPacket)};
+		const floatx8 radiusSum = loadPartial(radius + i, numInPacket) + sphereRadius;
+
+		const LaneMask valid = (LaneMask(1) << numInPacket) - LaneMask(1);
+		const LaneMask hit = lessThanEqual(squaredLength(center - spherePos), radiusSum * radiusSum);
+		writePacketMask(intersectMaskOut, i, hit & valid);
+	}
+}
+
+} // namespace sfz
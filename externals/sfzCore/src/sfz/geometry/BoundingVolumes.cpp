@@ -0,0 +1,275 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/BoundingVolumes.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const float MIN_HALF_EXTENT = 1e-5f;
+static const uint32_t NUM_SPHERE_REFINEMENTS = 8;
+
+static const vec3& pointAt(const vec3* points, uint32_t stride, uint32_t index) noexcept
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(points) + size_t(index) * stride;
+	return *reinterpret_cast<const vec3*>(bytes);
+}
+
+static vec3x4 loadPoints(const vec3* points, uint32_t stride, uint32_t first) noexcept
+{
+	vec3x4 result;
+	for (size_t lane = 0; lane < 4; lane++) {
+		result.setLane(lane, pointAt(points, stride, first + uint32_t(lane)));
+	}
+	return result;
+}
+
+/// Grows the sphere to contain the point, the new sphere also contains the old one
+static void growSphere(vec3& center, float& radius, const vec3& point) noexcept
+{
+	const vec3 diff = point - center;
+	const float dist = length(diff);
+	if (dist <= radius) return;
+	const float newRadius = (radius + dist) * 0.5f;
+	center += diff * ((newRadius - radius) / dist);
+	radius = newRadius;
+}
+
+/// Grows the sphere to contain the points in [first, last). Four points at a time are tested and
+/// only the (rare) points outside the sphere are handled one by one.
+static void growSphere(vec3& center, float& radius, const vec3* points, uint32_t stride,
+                       uint32_t first, uint32_t last) noexcept
+{
+	uint32_t i = first;
+	for (; i + 4 <= last; i += 4) {
+		const vec3x4 p = loadPoints(points, stride, i);
+		const floatx4 distSquared = squaredLength(p - vec3x4(center));
+		const LaneMask outside = greaterThan(distSquared, floatx4(radius * radius));
+		if (outside == 0) continue;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			if ((outside & (1u << lane)) != 0) growSphere(center, radius, pointAt(points, stride, i + lane));
+		}
+	}
+	for (; i < last; i++) {
+		growSphere(center, radius, pointAt(points, stride, i));
+	}
+}
+
+/// Eigenvectors of a symmetric 3x3 matrix using the cyclic Jacobi method (Ericson, Real-Time
+/// Collision Detection, chapter 4.3.3). The eigenvectors are returned as the columns of v.
+static void jacobiEigenvectors(float a[3][3], float v[3][3]) noexcept
+{
+	for (uint32_t i = 0; i < 3; i++) {
+		for (uint32_t j = 0; j < 3; j++) v[i][j] = (i == j) ? 1.0f : 0.0f;
+	}
+
+	for (uint32_t iteration = 0; iteration < 50; iteration++) {
+		// Find largest off-diagonal element
+		uint32_t p = 0, q = 1;
+		for (uint32_t i = 0; i < 3; i++) {
+			for (uint32_t j = i + 1; j < 3; j++) {
+				if (std::abs(a[i][j]) > std::abs(a[p][q])) {
+					p = i;
+					q = j;
+				}
+			}
+		}
+		if (std::abs(a[p][q]) <= 1e-9f * (std::abs(a[p][p]) + std::abs(a[q][q])) + 1e-30f) break;
+
+		// Compute the rotation zeroing a[p][q]
+		const float tau = (a[q][q] - a[p][p]) / (2.0f * a[p][q]);
+		const float t = (tau >= 0.0f) ? 1.0f / (tau + std::sqrt(1.0f + tau * tau))
+		                              : -1.0f / (-tau + std::sqrt(1.0f + tau * tau));
+		const float c = 1.0f / std::sqrt(1.0f + t * t);
+		const float s = t * c;
+
+		// a = J^T * a * J, v = v * J
+		for (uint32_t k = 0; k < 3; k++) {
+			const float akp = a[k][p], akq = a[k][q];
+			a[k][p] = c * akp - s * akq;
+			a[k][q] = s * akp + c * akq;
+		}
+		for (uint32_t k = 0; k < 3; k++) {
+			const float apk = a[p][k], aqk = a[q][k];
+			a[p][k] = c * apk - s * aqk;
+			a[q][k] = s * apk + c * aqk;
+		}
+		for (uint32_t k = 0; k < 3; k++) {
+			const float vkp = v[k][p], vkq = v[k][q];
+			v[k][p] = c * vkp - s * vkq;
+			v[k][q] = s * vkp + c * vkq;
+		}
+	}
+}
+
+// Bounding volume computation
+// ------------------------------------------------------------------------------------------------
+
+AABB computeAABB(const vec3* points, uint32_t numPoints, uint32_t stride) noexcept
+{
+	sfz_assert_debug(numPoints > 0);
+
+	vec3x4 minPacket(pointAt(points, stride, 0));
+	vec3x4 maxPacket = minPacket;
+	uint32_t i = 0;
+	for (; i + 4 <= numPoints; i += 4) {
+		const vec3x4 p = loadPoints(points, stride, i);
+		minPacket = min(minPacket, p);
+		maxPacket = max(maxPacket, p);
+	}
+	vec3 minPos = horizontalMin(minPacket);
+	vec3 maxPos = horizontalMax(maxPacket);
+	for (; i < numPoints; i++) {
+		minPos = min(minPos, pointAt(points, stride, i));
+		maxPos = max(maxPos, pointAt(points, stride, i));
+	}
+
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		if ((maxPos[axis] - minPos[axis]) < 2.0f * MIN_HALF_EXTENT) {
+			minPos[axis] -= MIN_HALF_EXTENT;
+			maxPos[axis] += MIN_HALF_EXTENT;
+		}
+	}
+	return AABB(minPos, maxPos);
+}
+
+Sphere computeBoundingSphere(const vec3* points, uint32_t numPoints, uint32_t stride) noexcept
+{
+	sfz_assert_debug(numPoints > 0);
+
+	// Initial sphere from the most separated pair of the extreme points along the axes
+	uint32_t minIndex[3] = { 0, 0, 0 };
+	uint32_t maxIndex[3] = { 0, 0, 0 };
+	for (uint32_t i = 1; i < numPoints; i++) {
+		const vec3& p = pointAt(points, stride, i);
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			if (p[axis] < pointAt(points, stride, minIndex[axis])[axis]) minIndex[axis] = i;
+			if (p[axis] > pointAt(points, stride, maxIndex[axis])[axis]) maxIndex[axis] = i;
+		}
+	}
+	uint32_t widestAxis = 0;
+	float widestDistSquared = -1.0f;
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		const float distSquared = squaredLength(pointAt(points, stride, maxIndex[axis]) -
+		                                        pointAt(points, stride, minIndex[axis]));
+		if (distSquared > widestDistSquared) {
+			widestAxis = axis;
+			widestDistSquared = distSquared;
+		}
+	}
+	const vec3 p0 = pointAt(points, stride, minIndex[widestAxis]);
+	const vec3 p1 = pointAt(points, stride, maxIndex[widestAxis]);
+	vec3 center = (p0 + p1) * 0.5f;
+	float radius = length(p1 - p0) * 0.5f;
+	growSphere(center, radius, points, stride, 0, numPoints);
+
+	// Refine by shrinking the sphere and regrowing it, visiting the points from different
+	// starting points since the result of growing depends on the order
+	vec3 bestCenter = center;
+	float bestRadius = radius;
+	for (uint32_t k = 1; k <= NUM_SPHERE_REFINEMENTS; k++) {
+		const uint32_t start = uint32_t((uint64_t(numPoints) * k) / (NUM_SPHERE_REFINEMENTS + 1));
+		center = bestCenter;
+		radius = bestRadius * 0.95f;
+		growSphere(center, radius, points, stride, start, numPoints);
+		growSphere(center, radius, points, stride, 0, start);
+		if (radius < bestRadius) {
+			bestCenter = center;
+			bestRadius = radius;
+		}
+	}
+
+	// Pad for rounding errors when growing
+	return Sphere(bestCenter, bestRadius * 1.0001f + MIN_HALF_EXTENT);
+}
+
+OBB computePCAOBB(const vec3* points, uint32_t numPoints, uint32_t stride) noexcept
+{
+	sfz_assert_debug(numPoints > 0);
+
+	// Mean and covariance, accumulated in double to not lose precision for large models
+	double mean[3] = { 0.0, 0.0, 0.0 };
+	for (uint32_t i = 0; i < numPoints; i++) {
+		const vec3& p = pointAt(points, stride, i);
+		for (uint32_t axis = 0; axis < 3; axis++) mean[axis] += double(p[axis]);
+	}
+	for (double& m : mean) m /= double(numPoints);
+
+	double cov[3][3] = {};
+	for (uint32_t i = 0; i < numPoints; i++) {
+		const vec3& p = pointAt(points, stride, i);
+		const double d[3] = { p.x - mean[0], p.y - mean[1], p.z - mean[2] };
+		for (uint32_t r = 0; r < 3; r++) {
+			for (uint32_t c = r; c < 3; c++) cov[r][c] += d[r] * d[c];
+		}
+	}
+	float a[3][3];
+	for (uint32_t r = 0; r < 3; r++) {
+		for (uint32_t c = r; c < 3; c++) {
+			a[r][c] = float(cov[r][c] / double(numPoints));
+			a[c][r] = a[r][c];
+		}
+	}
+
+	// Orthonormal right-handed axes from the eigenvectors
+	float v[3][3];
+	jacobiEigenvectors(a, v);
+	const vec3 xAxis = normalize(vec3(v[0][0], v[1][0], v[2][0]));
+	vec3 yAxis = vec3(v[0][1], v[1][1], v[2][1]);
+	yAxis = normalize(yAxis - xAxis * dot(xAxis, yAxis));
+	const vec3 zAxis = cross(xAxis, yAxis);
+
+	// Extents along the axes
+	const vec3x4 xAxisPacket(xAxis), yAxisPacket(yAxis), zAxisPacket(zAxis);
+	const vec3 first = pointAt(points, stride, 0);
+	vec3x4 minProj(vec3(dot(first, xAxis), dot(first, yAxis), dot(first, zAxis)));
+	vec3x4 maxProj = minProj;
+	uint32_t i = 0;
+	for (; i + 4 <= numPoints; i += 4) {
+		const vec3x4 p = loadPoints(points, stride, i);
+		vec3x4 proj;
+		proj.x = dot(p, xAxisPacket);
+		proj.y = dot(p, yAxisPacket);
+		proj.z = dot(p, zAxisPacket);
+		minProj = min(minProj, proj);
+		maxProj = max(maxProj, proj);
+	}
+	vec3 minPos = horizontalMin(minProj);
+	vec3 maxPos = horizontalMax(maxProj);
+	for (; i < numPoints; i++) {
+		const vec3& p = pointAt(points, stride, i);
+		const vec3 proj(dot(p, xAxis), dot(p, yAxis), dot(p, zAxis));
+		minPos = min(minPos, proj);
+		maxPos = max(maxPos, proj);
+	}
+
+	const vec3 localCenter = (minPos + maxPos) * 0.5f;
+	const vec3 center = xAxis * localCenter.x + yAxis * localCenter.y + zAxis * localCenter.z;
+	const vec3 halfExtents = max((maxPos - minPos) * 0.5f * 1.0001f, vec3(MIN_HALF_EXTENT));
+	return OBB(center, xAxis, yAxis, zAxis, halfExtents * 2.0f);
+}
+
+} // namespace sfz
@@ -0,0 +1,287 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/Broadphase.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/Intersection.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static BroadphasePair makePair(uint32_t a, uint32_t b) noexcept
+{
+	return (a < b) ? BroadphasePair{a, b} : BroadphasePair{b, a};
+}
+
+static uint32_t allocateHandle(DynArray<uint32_t>& freeHandles, uint32_t numHandles) noexcept
+{
+	if (freeHandles.size() == 0) return numHandles;
+	uint32_t handle = freeHandles.last();
+	freeHandles.remove(freeHandles.size() - 1);
+	return handle;
+}
+
+// SweepAndPrune: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+SweepAndPrune::SweepAndPrune(uint32_t axis) noexcept
+:
+	mAxis(axis)
+{
+	sfz_assert_debug(axis < 3);
+}
+
+// SweepAndPrune: Public methods
+// ------------------------------------------------------------------------------------------------
+
+uint32_t SweepAndPrune::add(const AABB& bounds) noexcept
+{
+	uint32_t handle = allocateHandle(mFreeHandles, mBounds.size());
+	if (handle == mBounds.size()) mBounds.add(bounds);
+	else mBounds[handle] = bounds;
+	mEntries.add(Entry{bounds, handle});
+	return handle;
+}
+
+void SweepAndPrune::remove(uint32_t handle) noexcept
+{
+	for (uint32_t i = 0; i < mEntries.size(); i++) {
+		if (mEntries[i].handle == handle) {
+			mEntries.remove(i);
+			mFreeHandles.add(handle);
+			return;
+		}
+	}
+	sfz_assert_debug(false);
+}
+
+void SweepAndPrune::update(uint32_t handle, const AABB& bounds) noexcept
+{
+	sfz_assert_debug(handle < mBounds.size());
+	mBounds[handle] = bounds;
+}
+
+void SweepAndPrune::clear() noexcept
+{
+	mEntries.clear();
+	mBounds.clear();
+	mFreeHandles.clear();
+}
+
+void SweepAndPrune::findPairs(DynArray<BroadphasePair>& pairsOut) noexcept
+{
+	const uint32_t axis = mAxis;
+	const uint32_t numEntries = mEntries.size();
+	Entry* entries = mEntries.data();
+
+	// Pull in updated bounds, then restore the order with an insertion sort. The order from the
+	// previous call is kept, so this is close to linear when objects move little between calls.
+	for (uint32_t i = 0; i < numEntries; i++) {
+		entries[i].bounds = mBounds[entries[i].handle];
+	}
+	for (uint32_t i = 1; i < numEntries; i++) {
+		const Entry entry = entries[i];
+		const float key = entry.bounds.min()[axis];
+		uint32_t j = i;
+		while (j > 0 && entries[j - 1].bounds.min()[axis] > key) {
+			entries[j] = entries[j - 1];
+			j--;
+		}
+		entries[j] = entry;
+	}
+
+	// Sweep, only objects starting before the current object ends can overlap it along the axis
+	for (uint32_t i = 0; i < numEntries; i++) {
+		const AABB& bounds = entries[i].bounds;
+		const float maxOnAxis = bounds.max()[axis];
+		for (uint32_t j = i + 1; j < numEntries; j++) {
+			if (entries[j].bounds.min()[axis] > maxOnAxis) break;
+			if (intersects(bounds, entries[j].bounds)) {
+				pairsOut.add(makePair(entries[i].handle, entries[j].handle));
+			}
+		}
+	}
+}
+
+// HashGrid: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+HashGrid::HashGrid(float cellSize, uint32_t numBuckets) noexcept
+:
+	mCellSize(cellSize),
+	mInvCellSize(1.0f / cellSize)
+{
+	sfz_assert_debug(cellSize > 0.0f);
+	sfz_assert_debug(numBuckets > 0);
+	uint32_t powerOfTwo = 1;
+	while (powerOfTwo < numBuckets) powerOfTwo *= 2;
+	mBuckets = DynArray<DynArray<CellEntry>>(powerOfTwo);
+}
+
+// HashGrid: Public methods
+// ------------------------------------------------------------------------------------------------
+
+uint32_t HashGrid::add(const AABB& bounds) noexcept
+{
+	uint32_t handle = allocateHandle(mFreeHandles, mObjects.size());
+	if (handle == mObjects.size()) mObjects.add(Object());
+	Object& object = mObjects[handle];
+	object.bounds = bounds;
+	object.cellMin = cellOf(bounds.min());
+	object.cellMax = cellOf(bounds.max());
+	object.alive = true;
+	insertIntoCells(handle);
+	return handle;
+}
+
+void HashGrid::remove(uint32_t handle) noexcept
+{
+	sfz_assert_debug(handle < mObjects.size() && mObjects[handle].alive);
+	removeFromCells(handle);
+	mObjects[handle].alive = false;
+	mFreeHandles.add(handle);
+}
+
+void HashGrid::update(uint32_t handle, const AABB& bounds) noexcept
+{
+	sfz_assert_debug(handle < mObjects.size() && mObjects[handle].alive);
+	Object& object = mObjects[handle];
+	object.bounds = bounds;
+	const vec3i cellMin = cellOf(bounds.min());
+	const vec3i cellMax = cellOf(bounds.max());
+	if (cellMin == object.cellMin && cellMax == object.cellMax) return;
+
+	removeFromCells(handle);
+	object.cellMin = cellMin;
+	object.cellMax = cellMax;
+	insertIntoCells(handle);
+}
+
+void HashGrid::clear() noexcept
+{
+	for (DynArray<CellEntry>& bucket : mBuckets) bucket.clear();
+	mObjects.clear();
+	mFreeHandles.clear();
+}
+
+void HashGrid::findPairs(DynArray<BroadphasePair>& pairsOut) const noexcept
+{
+	for (const DynArray<CellEntry>& bucket : mBuckets) {
+		const uint32_t bucketSize = bucket.size();
+		for (uint32_t i = 0; i < bucketSize; i++) {
+			const CellEntry& entryA = bucket[i];
+			const AABB& boundsA = mObjects[entryA.handle].bounds;
+			for (uint32_t j = i + 1; j < bucketSize; j++) {
+				const CellEntry& entryB = bucket[j];
+
+				// Several cells may hash to the same bucket
+				if (entryA.cell != entryB.cell) continue;
+				const AABB& boundsB = mObjects[entryB.handle].bounds;
+				if (!intersects(boundsA, boundsB)) continue;
+
+				// Objects overlapping in several cells are only reported by the cell containing
+				// the minimum corner of the overlap
+				vec3i overlapCell = cellOf(max(boundsA.min(), boundsB.min()));
+				if (overlapCell != entryA.cell) continue;
+
+				pairsOut.add(makePair(entryA.handle, entryB.handle));
+			}
+		}
+	}
+}
+
+void HashGrid::queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept
+{
+	const vec3i cellMin = cellOf(aabb.min());
+	const vec3i cellMax = cellOf(aabb.max());
+	for (int32_t z = cellMin.z; z <= cellMax.z; z++) {
+		for (int32_t y = cellMin.y; y <= cellMax.y; y++) {
+			for (int32_t x = cellMin.x; x <= cellMax.x; x++) {
+				const vec3i cell(x, y, z);
+				for (const CellEntry& entry : mBuckets[bucketOf(cell)]) {
+					if (entry.cell != cell) continue;
+					const AABB& bounds = mObjects[entry.handle].bounds;
+					if (!intersects(aabb, bounds)) continue;
+
+					// Same deduplication as in findPairs()
+					if (cellOf(max(aabb.min(), bounds.min())) != cell) continue;
+					resultOut.add(entry.handle);
+				}
+			}
+		}
+	}
+}
+
+// HashGrid: Private methods
+// ------------------------------------------------------------------------------------------------
+
+vec3i HashGrid::cellOf(const vec3& point) const noexcept
+{
+	const vec3 scaled = point * mInvCellSize;
+	return vec3i(int32_t(std::floor(scaled.x)), int32_t(std::floor(scaled.y)),
+	             int32_t(std::floor(scaled.z)));
+}
+
+uint32_t HashGrid::bucketOf(const vec3i& cell) const noexcept
+{
+	// Hash from "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+	// (Teschner et al. 2003)
+	const uint32_t hash = (uint32_t(cell.x) * 73856093u) ^ (uint32_t(cell.y) * 19349663u)
+	                    ^ (uint32_t(cell.z) * 83492791u);
+	return hash & (mBuckets.size() - 1);
+}
+
+void HashGrid::insertIntoCells(uint32_t handle) noexcept
+{
+	const Object& object = mObjects[handle];
+	for (int32_t z = object.cellMin.z; z <= object.cellMax.z; z++) {
+		for (int32_t y = object.cellMin.y; y <= object.cellMax.y; y++) {
+			for (int32_t x = object.cellMin.x; x <= object.cellMax.x; x++) {
+				const vec3i cell(x, y, z);
+				mBuckets[bucketOf(cell)].add(CellEntry{cell, handle});
+			}
+		}
+	}
+}
+
+void HashGrid::removeFromCells(uint32_t handle) noexcept
+{
+	const Object& object = mObjects[handle];
+	for (int32_t z = object.cellMin.z; z <= object.cellMax.z; z++) {
+		for (int32_t y = object.cellMin.y; y <= object.cellMax.y; y++) {
+			for (int32_t x = object.cellMin.x; x <= object.cellMax.x; x++) {
+				const vec3i cell(x, y, z);
+				DynArray<CellEntry>& bucket = mBuckets[bucketOf(cell)];
+				for (uint32_t i = 0; i < bucket.size(); i++) {
+					if (bucket[i].handle != handle || bucket[i].cell != cell) continue;
+					bucket[i] = bucket.last();
+					bucket.remove(bucket.size() - 1);
+					break;
+				}
+			}
+		}
+	}
+}
+
+} // namespace sfz
@@ -0,0 +1,280 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/ConvexHull.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t NO_POINT = ~0u;
+
+struct HullFace final {
+	uint32_t indices[3];
+	vec3 normal;
+	float dist;
+	bool alive;
+
+	// The points above this face, and the one furthest above it
+	DynArray<uint32_t> outside;
+	uint32_t furthest;
+	float furthestDist;
+
+	inline float distanceTo(const vec3& point) const noexcept { return dot(normal, point) - dist; }
+};
+
+/// The state of the hull being built, the faces form a closed triangle mesh at all times
+struct HullBuilder final {
+	DynArray<vec3> points;
+	DynArray<HullFace> faces;
+	DynArray<uint32_t> refCounts; // Number of alive faces using each point
+	uint32_t numHullVertices = 0;
+	float eps = 0.0f;
+
+	uint32_t addFace(uint32_t i0, uint32_t i1, uint32_t i2) noexcept
+	{
+		HullFace face;
+		face.indices[0] = i0;
+		face.indices[1] = i1;
+		face.indices[2] = i2;
+		const vec3 p0 = points[i0];
+		const vec3 n = cross(points[i1] - p0, points[i2] - p0);
+		const float len = length(n);
+		face.normal = (len > 0.0f) ? (n / len) : vec3(0.0f);
+		face.dist = dot(face.normal, p0);
+		face.alive = true;
+		face.furthest = NO_POINT;
+		face.furthestDist = 0.0f;
+		for (uint32_t index : face.indices) {
+			if (refCounts[index]++ == 0) numHullVertices++;
+		}
+		faces.add(face);
+		return faces.size() - 1;
+	}
+
+	void removeFace(uint32_t faceIndex) noexcept
+	{
+		HullFace& face = faces[faceIndex];
+		face.alive = false;
+		face.outside.destroy();
+		for (uint32_t index : face.indices) {
+			if (--refCounts[index] == 0) numHullVertices--;
+		}
+	}
+
+	/// Adds the point to the outside set of the face it is furthest above among faces
+	/// [firstFace, faces.size()), points not above any of them are inside the hull and dropped
+	void assignPoint(uint32_t pointIndex, uint32_t firstFace) noexcept
+	{
+		const vec3 point = points[pointIndex];
+		uint32_t bestFace = NO_POINT;
+		float bestDist = eps;
+		for (uint32_t i = firstFace; i < faces.size(); i++) {
+			if (!faces[i].alive) continue;
+			const float dist = faces[i].distanceTo(point);
+			if (dist > bestDist) {
+				bestDist = dist;
+				bestFace = i;
+			}
+		}
+		if (bestFace == NO_POINT) return;
+
+		HullFace& face = faces[bestFace];
+		face.outside.add(pointIndex);
+		if (bestDist > face.furthestDist) {
+			face.furthestDist = bestDist;
+			face.furthest = pointIndex;
+		}
+	}
+};
+
+static float squaredDistanceToLine(const vec3& p, const vec3& a, const vec3& b) noexcept
+{
+	const vec3 ab = b - a;
+	return squaredLength(cross(p - a, ab)) / squaredLength(ab);
+}
+
+// Convex hull
+// ------------------------------------------------------------------------------------------------
+
+ConvexHull computeConvexHull(const vec3* points, uint32_t numPoints, uint32_t stride,
+                             uint32_t maxVertices) noexcept
+{
+	sfz_assert_debug(maxVertices == 0 || maxVertices >= 4);
+	ConvexHull hull;
+	if (numPoints == 0) return hull;
+
+	HullBuilder builder;
+	DynArray<vec3>& pts = builder.points;
+	pts.ensureCapacity(numPoints);
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(points);
+	vec3 maxAbs(0.0f);
+	for (uint32_t i = 0; i < numPoints; i++) {
+		pts.add(*reinterpret_cast<const vec3*>(bytes + size_t(i) * stride));
+		maxAbs = max(maxAbs, abs(pts.last()));
+	}
+
+	// Distances within eps of a plane are considered to be on it, scaled with the magnitude of
+	// the coordinates like in qhull
+	builder.eps = 3.0f * FLT_EPSILON * (maxAbs.x + maxAbs.y + maxAbs.z);
+	const float eps = builder.eps;
+
+	// Initial tetrahedron, starting with the two most distant of the extreme points along the axes
+	uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	for (uint32_t i = 1; i < numPoints; i++) {
+		for (uint32_t axis = 0; axis < 3; axis++) {
+			if (pts[i][axis] < pts[extremes[axis * 2]][axis]) extremes[axis * 2] = i;
+			if (pts[i][axis] > pts[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+		}
+	}
+	uint32_t i0 = 0, i1 = 0;
+	float maxDist = -1.0f;
+	for (uint32_t a = 0; a < 6; a++) {
+		for (uint32_t b = a + 1; b < 6; b++) {
+			const float dist = squaredLength(pts[extremes[a]] - pts[extremes[b]]);
+			if (dist > maxDist) {
+				maxDist = dist;
+				i0 = extremes[a];
+				i1 = extremes[b];
+			}
+		}
+	}
+	hull.vertices.add(pts[i0]);
+	if (maxDist <= eps * eps) return hull;
+	hull.vertices.add(pts[i1]);
+
+	uint32_t i2 = 0;
+	maxDist = -1.0f;
+	for (uint32_t i = 0; i < numPoints; i++) {
+		const float dist = squaredDistanceToLine(pts[i], pts[i0], pts[i1]);
+		if (dist > maxDist) {
+			maxDist = dist;
+			i2 = i;
+		}
+	}
+	if (maxDist <= eps * eps) return hull;
+	hull.vertices.add(pts[i2]);
+
+	const vec3 planeNormal = normalize(cross(pts[i1] - pts[i0], pts[i2] - pts[i0]));
+	uint32_t i3 = 0;
+	maxDist = -1.0f;
+	for (uint32_t i = 0; i < numPoints; i++) {
+		const float dist = std::abs(dot(planeNormal, pts[i] - pts[i0]));
+		if (dist > maxDist) {
+			maxDist = dist;
+			i3 = i;
+		}
+	}
+	if (maxDist <= eps) return hull;
+	hull.vertices.clear();
+
+	// Wind the tetrahedron so that the base triangle faces away from the fourth point
+	if (dot(planeNormal, pts[i3] - pts[i0]) > 0.0f) std::swap(i1, i2);
+	builder.refCounts = DynArray<uint32_t>(numPoints, 0u, numPoints);
+	builder.addFace(i0, i1, i2);
+	builder.addFace(i0, i3, i1);
+	builder.addFace(i1, i3, i2);
+	builder.addFace(i2, i3, i0);
+	for (uint32_t i = 0; i < numPoints; i++) {
+		if (i != i0 && i != i1 && i != i2 && i != i3) builder.assignPoint(i, 0);
+	}
+
+	DynArray<uint32_t> horizon; // Pairs of vertex indices
+	DynArray<uint32_t> orphans;
+	while (maxVertices == 0 || builder.numHullVertices < maxVertices) {
+		// Add the point furthest outside of the hull
+		uint32_t eyeFace = NO_POINT;
+		float eyeDist = 0.0f;
+		for (uint32_t i = 0; i < builder.faces.size(); i++) {
+			const HullFace& face = builder.faces[i];
+			if (face.alive && face.furthest != NO_POINT && face.furthestDist > eyeDist) {
+				eyeDist = face.furthestDist;
+				eyeFace = i;
+			}
+		}
+		if (eyeFace == NO_POINT) break;
+		const uint32_t eyeIndex = builder.faces[eyeFace].furthest;
+		const vec3 eye = pts[eyeIndex];
+
+		// Remove the faces visible from the eye point. The horizon is the boundary of the removed
+		// region, each edge of a removed face is added or cancels its reverse if already added.
+		horizon.clear();
+		orphans.clear();
+		const uint32_t numFaces = builder.faces.size();
+		for (uint32_t i = 0; i < numFaces; i++) {
+			HullFace& face = builder.faces[i];
+			if (!face.alive || face.distanceTo(eye) <= eps) continue;
+			for (uint32_t j = 0; j < 3; j++) {
+				const uint32_t e0 = face.indices[j];
+				const uint32_t e1 = face.indices[(j + 1) % 3];
+				bool cancelled = false;
+				for (uint32_t k = 0; k < horizon.size(); k += 2) {
+					if (horizon[k] == e1 && horizon[k + 1] == e0) {
+						horizon[k] = horizon[horizon.size() - 2];
+						horizon[k + 1] = horizon[horizon.size() - 1];
+						horizon.remove(horizon.size() - 2, 2);
+						cancelled = true;
+						break;
+					}
+				}
+				if (!cancelled) {
+					horizon.add(e0);
+					horizon.add(e1);
+				}
+			}
+			for (uint32_t pointIndex : face.outside) {
+				if (pointIndex != eyeIndex) orphans.add(pointIndex);
+			}
+			builder.removeFace(i);
+		}
+
+		// Connect the horizon to the eye point and give the orphaned points to the new faces
+		const uint32_t firstNewFace = builder.faces.size();
+		for (uint32_t k = 0; k < horizon.size(); k += 2) {
+			builder.addFace(horizon[k], horizon[k + 1], eyeIndex);
+		}
+		for (uint32_t pointIndex : orphans) {
+			builder.assignPoint(pointIndex, firstNewFace);
+		}
+	}
+
+	// Copy the alive faces, only keeping the vertices they use
+	DynArray<uint32_t> remap(numPoints, NO_POINT, numPoints);
+	for (const HullFace& face : builder.faces) {
+		if (!face.alive) continue;
+		for (uint32_t index : face.indices) {
+			if (remap[index] == NO_POINT) {
+				remap[index] = hull.vertices.size();
+				hull.vertices.add(pts[index]);
+			}
+			hull.indices.add(remap[index]);
+		}
+	}
+	return hull;
+}
+
+} // namespace sfz
@@ -0,0 +1,117 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/ConvexShape.hpp"
+
+#include "sfz/Assert.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+namespace sfz {
+
+// Shapes
+// ------------------------------------------------------------------------------------------------
+
+vec3 SphereShape::support(const vec3& dir) const noexcept
+{
+	return mSphere.position() + dir * (mSphere.radius() / length(dir));
+}
+
+vec3 AABBShape::support(const vec3& dir) const noexcept
+{
+	const vec3 min = mAABB.min();
+	const vec3 max = mAABB.max();
+	return vec3(dir.x < 0.0f ? min.x : max.x, dir.y < 0.0f ? min.y : max.y,
+	            dir.z < 0.0f ? min.z : max.z);
+}
+
+vec3 OBBShape::support(const vec3& dir) const noexcept
+{
+	vec3 result = mOBB.position();
+	for (uint32_t i = 0; i < 3; i++) {
+		const vec3& axis = mOBB.axes()[i];
+		const float halfExtent = mOBB.halfExtents()[i];
+		result += (dot(axis, dir) < 0.0f) ? (-halfExtent * axis) : (halfExtent * axis);
+	}
+	return result;
+}
+
+// ConvexHullShape
+// ------------------------------------------------------------------------------------------------
+
+ConvexHullShape::ConvexHullShape(const vec3* points, uint32_t numPoints, uint32_t stride) noexcept
+:
+	mPoints(points),
+	mNumPoints(numPoints),
+	mStride(stride),
+	mHasTransform(false)
+{
+	sfz_assert_debug(numPoints > 0);
+}
+
+ConvexHullShape::ConvexHullShape(const vec3* points, uint32_t numPoints, uint32_t stride,
+                                 const mat4& transform) noexcept
+:
+	mPoints(points),
+	mNumPoints(numPoints),
+	mStride(stride),
+	mHasTransform(true),
+	mTransform(transform)
+{
+	sfz_assert_debug(numPoints > 0);
+}
+
+vec3 ConvexHullShape::support(const vec3& dir) const noexcept
+{
+	// max dot(dir, M * p) = max dot(transpose(M) * dir, p) for the linear part of M
+	vec3 localDir = dir;
+	if (mHasTransform) {
+		for (uint32_t i = 0; i < 3; i++) {
+			localDir[i] = mTransform.at(0, i) * dir.x + mTransform.at(1, i) * dir.y
+			            + mTransform.at(2, i) * dir.z;
+		}
+	}
+
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(mPoints);
+	const vec3* best = mPoints;
+	float bestDot = dot(*best, localDir);
+	for (uint32_t i = 1; i < mNumPoints; i++) {
+		const vec3* point = reinterpret_cast<const vec3*>(bytes + size_t(i) * mStride);
+		const float d = dot(*point, localDir);
+		if (d > bestDot) {
+			bestDot = d;
+			best = point;
+		}
+	}
+	return mHasTransform ? transformPoint(mTransform, *best) : *best;
+}
+
+// TransformedShape
+// ------------------------------------------------------------------------------------------------
+
+vec3 TransformedShape::support(const vec3& dir) const noexcept
+{
+	vec3 localDir;
+	for (uint32_t i = 0; i < 3; i++) {
+		localDir[i] = mTransform.at(0, i) * dir.x + mTransform.at(1, i) * dir.y
+		            + mTransform.at(2, i) * dir.z;
+	}
+	return transformPoint(mTransform, mLocalShape->support(localDir));
+}
+
+} // namespace sfz
@@ -0,0 +1,508 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/GJK.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "sfz/Assert.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t MAX_GJK_ITERATIONS = 64;
+static constexpr uint32_t MAX_EPA_ITERATIONS = 64;
+static constexpr uint32_t MAX_EPA_VERTICES = MAX_EPA_ITERATIONS + 4;
+static constexpr uint32_t MAX_EPA_FACES = 2 * MAX_EPA_VERTICES; // Closed polytope: F = 2V - 4
+static constexpr uint32_t MAX_EPA_EDGES = 3 * MAX_EPA_FACES;
+
+/// GJK stops when the squared distance improves by less than this fraction
+static constexpr float GJK_RELATIVE_TOLERANCE = 1e-6f;
+
+/// The origin is considered to lie on the simplex when the squared distance to it is less than
+/// this fraction of the squared length of the simplex vertices
+static constexpr float GJK_ZERO_TOLERANCE = 1e-10f;
+
+/// EPA stops when the support point along the normal of the closest face is less than this
+/// fraction of the depth further out than the face
+static constexpr float EPA_RELATIVE_TOLERANCE = 1e-4f;
+
+/// Squared distances below this are treated as zero when expanding degenerate simplices
+static constexpr float EPA_DEGENERATE_TOLERANCE = 1e-12f;
+
+/// A vertex of the Minkowski difference A - B along with the points of A and B it came from
+struct SupportPoint final {
+	vec3 w, a, b, dir;
+};
+
+struct Simplex final {
+	SupportPoint points[4];
+	float lambdas[4];
+	uint32_t size = 0;
+};
+
+struct EPAFace final {
+	uint32_t indices[3];
+	vec3 normal;
+	float dist;
+};
+
+static SupportPoint computeSupport(const ConvexShape& a, const ConvexShape& b, const vec3& dir) noexcept
+{
+	SupportPoint point;
+	point.dir = dir;
+	point.a = a.support(dir);
+	point.b = b.support(-dir);
+	point.w = point.a - point.b;
+	return point;
+}
+
+static bool containsPoint(const Simplex& simplex, const vec3& w) noexcept
+{
+	for (uint32_t i = 0; i < simplex.size; i++) {
+		if (simplex.points[i].w == w) return true;
+	}
+	return false;
+}
+
+static vec3 setVertex(Simplex& out, const SupportPoint& p) noexcept
+{
+	out.size = 1;
+	out.points[0] = p;
+	out.lambdas[0] = 1.0f;
+	return p.w;
+}
+
+static vec3 setEdge(Simplex& out, const SupportPoint& p0, const SupportPoint& p1, float t) noexcept
+{
+	out.size = 2;
+	out.points[0] = p0;
+	out.points[1] = p1;
+	out.lambdas[0] = 1.0f - t;
+	out.lambdas[1] = t;
+	return p0.w + t * (p1.w - p0.w);
+}
+
+// Closest point on simplex (Ericson, Real-Time Collision Detection, chapter 5.1)
+// ------------------------------------------------------------------------------------------------
+
+// The functions below find the point on a simplex closest to the origin and write the smallest
+// sub-simplex containing it (with barycentric coordinates) to out. The vertices are taken by
+// value since out may be the simplex they are stored in.
+
+static vec3 closestOnSegment(SupportPoint p0, SupportPoint p1, Simplex& out) noexcept
+{
+	const vec3 ab = p1.w - p0.w;
+	const float t = -dot(p0.w, ab);
+	const float denom = dot(ab, ab);
+	if (t <= 0.0f || denom <= 0.0f) return setVertex(out, p0);
+	if (t >= denom) return setVertex(out, p1);
+	return setEdge(out, p0, p1, t / denom);
+}
+
+static vec3 closestOnTriangle(SupportPoint p0, SupportPoint p1, SupportPoint p2, Simplex& out) noexcept
+{
+	const vec3 a = p0.w, b = p1.w, c = p2.w;
+	const vec3 ab = b - a;
+	const vec3 ac = c - a;
+
+	const float d1 = -dot(ab, a);
+	const float d2 = -dot(ac, a);
+	if (d1 <= 0.0f && d2 <= 0.0f) return setVertex(out, p0);
+
+	const float d3 = -dot(ab, b);
+	const float d4 = -dot(ac, b);
+	if (d3 >= 0.0f && d4 <= d3) return setVertex(out, p1);
+
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return setEdge(out, p0, p1, d1 / (d1 - d3));
+
+	const float d5 = -dot(ab, c);
+	const float d6 = -dot(ac, c);
+	if (d6 >= 0.0f && d5 <= d6) return setVertex(out, p2);
+
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return setEdge(out, p0, p2, d2 / (d2 - d6));
+
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+		return setEdge(out, p1, p2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+
+	const float denom = va + vb + vc;
+	if (denom <= 0.0f) {
+		// Degenerate triangle, the closest point is on one of its edges
+		Simplex edges[3];
+		const vec3 candidates[3] = { closestOnSegment(p0, p1, edges[0]),
+		                             closestOnSegment(p0, p2, edges[1]),
+		                             closestOnSegment(p1, p2, edges[2]) };
+		uint32_t best = 0;
+		for (uint32_t i = 1; i < 3; i++) {
+			if (dot(candidates[i], candidates[i]) < dot(candidates[best], candidates[best])) best = i;
+		}
+		out = edges[best];
+		return candidates[best];
+	}
+
+	const float v = vb / denom;
+	const float w = vc / denom;
+	out.size = 3;
+	out.points[0] = p0;
+	out.points[1] = p1;
+	out.points[2] = p2;
+	out.lambdas[0] = 1.0f - v - w;
+	out.lambdas[1] = v;
+	out.lambdas[2] = w;
+	return a + v * ab + w * ac;
+}
+
+/// Returns whether the origin and d are on opposite sides of the plane through a, b and c.
+/// Degenerate planes count as separating so that all faces of a flat tetrahedron are tested.
+static bool originOutsideOfPlane(const vec3& a, const vec3& b, const vec3& c, const vec3& d) noexcept
+{
+	const vec3 n = cross(b - a, c - a);
+	const float signOrigin = -dot(a, n);
+	const float signD = dot(d - a, n);
+	if (signD == 0.0f) return true;
+	return signOrigin * signD < 0.0f;
+}
+
+/// Returns true if the origin is inside the tetrahedron, in which case out is the tetrahedron
+static bool closestOnTetrahedron(Simplex s, Simplex& out, vec3& closestOut) noexcept
+{
+	static const uint32_t faces[4][4] = { {0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0} };
+	const SupportPoint* p = s.points;
+
+	bool inside = true;
+	float bestDist = std::numeric_limits<float>::infinity();
+	for (const uint32_t* f : faces) {
+		if (!originOutsideOfPlane(p[f[0]].w, p[f[1]].w, p[f[2]].w, p[f[3]].w)) continue;
+		inside = false;
+		Simplex candidate;
+		const vec3 closest = closestOnTriangle(p[f[0]], p[f[1]], p[f[2]], candidate);
+		const float dist = dot(closest, closest);
+		if (dist < bestDist) {
+			bestDist = dist;
+			out = candidate;
+			closestOut = closest;
+		}
+	}
+
+	if (inside) {
+		out = s;
+		closestOut = vec3(0.0f);
+	}
+	return inside;
+}
+
+/// Reduces the simplex to the sub-simplex closest to the origin. Returns true if the origin is
+/// inside the simplex (only possible for a tetrahedron).
+static bool reduceSimplex(Simplex& s, vec3& closestOut) noexcept
+{
+	switch (s.size) {
+	case 1:
+		closestOut = setVertex(s, s.points[0]);
+		return false;
+	case 2:
+		closestOut = closestOnSegment(s.points[0], s.points[1], s);
+		return false;
+	case 3:
+		closestOut = closestOnTriangle(s.points[0], s.points[1], s.points[2], s);
+		return false;
+	case 4:
+		return closestOnTetrahedron(s, s, closestOut);
+	}
+	sfz_assert_debug(false);
+	return false;
+}
+
+// GJK
+// ------------------------------------------------------------------------------------------------
+
+/// Runs GJK and returns whether the shapes intersect. If earlyOut is set GJK stops as soon as a
+/// separating axis is found, otherwise it runs until the closest point v has converged.
+static bool runGJK(const ConvexShape& a, const ConvexShape& b, GJKSimplex& stored, bool earlyOut,
+                   Simplex& s, vec3& v, uint32_t& iterations) noexcept
+{
+	// Warm start by recomputing the support points of the previous simplex
+	s.size = 0;
+	for (uint32_t i = 0; i < stored.size; i++) {
+		SupportPoint p = computeSupport(a, b, stored.dirs[i]);
+		if (!containsPoint(s, p.w)) s.points[s.size++] = p;
+	}
+	if (s.size == 0) s.points[s.size++] = computeSupport(a, b, vec3(1.0f, 0.0f, 0.0f));
+	bool intersecting = reduceSimplex(s, v);
+
+	iterations = 0;
+	while (!intersecting && iterations < MAX_GJK_ITERATIONS) {
+		iterations++;
+		const float vv = dot(v, v);
+		float maxVertexDist = 0.0f;
+		for (uint32_t i = 0; i < s.size; i++) {
+			maxVertexDist = std::max(maxVertexDist, dot(s.points[i].w, s.points[i].w));
+		}
+		if (vv <= GJK_ZERO_TOLERANCE * maxVertexDist) {
+			intersecting = true;
+			break;
+		}
+
+		const SupportPoint p = computeSupport(a, b, -v);
+		const float vw = dot(v, p.w);
+		if (earlyOut && vw > 0.0f) break;
+		if ((vv - vw) <= GJK_RELATIVE_TOLERANCE * vv) break;
+		if (containsPoint(s, p.w)) break;
+
+		s.points[s.size++] = p;
+		intersecting = reduceSimplex(s, v);
+		if (!intersecting && dot(v, v) >= vv) break; // No progress due to rounding errors
+	}
+
+	stored.size = s.size;
+	for (uint32_t i = 0; i < s.size; i++) {
+		stored.dirs[i] = s.points[i].dir;
+		stored.pointsA[i] = s.points[i].a;
+		stored.pointsB[i] = s.points[i].b;
+	}
+	return intersecting;
+}
+
+GJKResult gjkDistance(const ConvexShape& a, const ConvexShape& b, GJKSimplex& simplex) noexcept
+{
+	Simplex s;
+	vec3 v;
+	GJKResult result;
+	result.intersecting = runGJK(a, b, simplex, false, s, v, result.iterations);
+	if (result.intersecting) return result;
+
+	result.distance = length(v);
+	for (uint32_t i = 0; i < s.size; i++) {
+		result.pointA += s.lambdas[i] * s.points[i].a;
+		result.pointB += s.lambdas[i] * s.points[i].b;
+	}
+	return result;
+}
+
+bool gjkIntersects(const ConvexShape& a, const ConvexShape& b, GJKSimplex& simplex) noexcept
+{
+	Simplex s;
+	vec3 v;
+	uint32_t iterations;
+	return runGJK(a, b, simplex, true, s, v, iterations);
+}
+
+// EPA
+// ------------------------------------------------------------------------------------------------
+
+/// Adds support points until the simplex is a tetrahedron, needed when GJK terminated with the
+/// origin on a vertex, edge or triangle of the simplex. Returns false if the Minkowski difference
+/// is flat in some direction.
+static bool expandToTetrahedron(const ConvexShape& a, const ConvexShape& b, SupportPoint* verts,
+                                uint32_t& numVerts) noexcept
+{
+	static const vec3 axes[6] = { vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+	                              vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+	                              vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f) };
+
+	if (numVerts == 1) {
+		for (const vec3& axis : axes) {
+			const SupportPoint p = computeSupport(a, b, axis);
+			if (squaredLength(p.w - verts[0].w) > EPA_DEGENERATE_TOLERANCE) {
+				verts[numVerts++] = p;
+				break;
+			}
+		}
+		if (numVerts == 1) return false;
+	}
+
+	if (numVerts == 2) {
+		// Search directions perpendicular to the segment, 60 degrees apart
+		const vec3 d = verts[1].w - verts[0].w;
+		const vec3 absD = abs(d);
+		const vec3 axis = (absD.x <= absD.y && absD.x <= absD.z) ? axes[0] : (absD.y <= absD.z ? axes[2] : axes[4]);
+		const vec3 u = normalize(cross(d, axis));
+		const vec3 w = normalize(cross(d, u));
+		for (uint32_t i = 0; i < 6 && numVerts == 2; i++) {
+			const float angle = float(i) * 1.0471975512f;
+			const SupportPoint p = computeSupport(a, b, std::cos(angle) * u + std::sin(angle) * w);
+			if (squaredLength(cross(p.w - verts[0].w, d)) > EPA_DEGENERATE_TOLERANCE * dot(d, d)) {
+				verts[numVerts++] = p;
+			}
+		}
+		if (numVerts == 2) return false;
+	}
+
+	if (numVerts == 3) {
+		const vec3 n = cross(verts[1].w - verts[0].w, verts[2].w - verts[0].w);
+		const float minDist = std::sqrt(EPA_DEGENERATE_TOLERANCE * dot(n, n));
+		for (float sign : { 1.0f, -1.0f }) {
+			const SupportPoint p = computeSupport(a, b, sign * n);
+			if (std::abs(dot(p.w - verts[0].w, n)) > minDist) {
+				verts[numVerts++] = p;
+				break;
+			}
+		}
+		if (numVerts == 3) return false;
+	}
+
+	return true;
+}
+
+static EPAFace makeFace(const SupportPoint* verts, uint32_t i0, uint32_t i1, uint32_t i2) noexcept
+{
+	EPAFace face;
+	face.indices[0] = i0;
+	face.indices[1] = i1;
+	face.indices[2] = i2;
+	const vec3 n = cross(verts[i1].w - verts[i0].w, verts[i2].w - verts[i0].w);
+	const float len = length(n);
+	if (len > 0.0f) {
+		face.normal = n / len;
+		face.dist = dot(face.normal, verts[i0].w);
+	}
+	else {
+		// Degenerate faces are never the closest and never visible
+		face.normal = vec3(0.0f);
+		face.dist = std::numeric_limits<float>::infinity();
+	}
+	return face;
+}
+
+Penetration epaPenetration(const ConvexShape& a, const ConvexShape& b,
+                           const GJKSimplex& simplex) noexcept
+{
+	Penetration result;
+	SupportPoint verts[MAX_EPA_VERTICES];
+	uint32_t numVerts = simplex.size;
+	for (uint32_t i = 0; i < numVerts; i++) {
+		verts[i].a = simplex.pointsA[i];
+		verts[i].b = simplex.pointsB[i];
+		verts[i].w = simplex.pointsA[i] - simplex.pointsB[i];
+		verts[i].dir = simplex.dirs[i];
+	}
+	if (numVerts == 0 || !expandToTetrahedron(a, b, verts, numVerts)) return result;
+
+	// Initial tetrahedron with faces wound so their normals point away from the opposite vertex
+	EPAFace faces[MAX_EPA_FACES];
+	uint32_t numFaces = 0;
+	static const uint32_t tetFaces[4][4] = { {0, 1, 2, 3}, {0, 3, 1, 2}, {0, 2, 3, 1}, {1, 3, 2, 0} };
+	for (const uint32_t* f : tetFaces) {
+		EPAFace face = makeFace(verts, f[0], f[1], f[2]);
+		if (dot(face.normal, verts[f[3]].w - verts[f[0]].w) > 0.0f) {
+			face = makeFace(verts, f[0], f[2], f[1]);
+		}
+		faces[numFaces++] = face;
+	}
+
+	uint32_t closest = 0;
+	for (uint32_t iteration = 0; iteration < MAX_EPA_ITERATIONS; iteration++) {
+		closest = 0;
+		for (uint32_t i = 1; i < numFaces; i++) {
+			if (faces[i].dist < faces[closest].dist) closest = i;
+		}
+		const EPAFace& face = faces[closest];
+		if (face.dist == std::numeric_limits<float>::infinity()) return result;
+
+		const SupportPoint p = computeSupport(a, b, face.normal);
+		const float gap = dot(p.w, face.normal) - face.dist;
+		if (gap <= EPA_RELATIVE_TOLERANCE * std::max(face.dist, 0.0f) || numVerts == MAX_EPA_VERTICES) break;
+
+		// Find the horizon, the edges between faces visible from p and the rest. Each edge of a
+		// visible face is added, or cancels its reverse if that was already added.
+		uint32_t edges[MAX_EPA_EDGES][2];
+		uint32_t numEdges = 0;
+		bool visible[MAX_EPA_FACES];
+		for (uint32_t i = 0; i < numFaces; i++) {
+			const EPAFace& f = faces[i];
+			visible[i] = dot(f.normal, p.w - verts[f.indices[0]].w) > 0.0f;
+			if (!visible[i]) continue;
+			for (uint32_t j = 0; j < 3; j++) {
+				const uint32_t e0 = f.indices[j];
+				const uint32_t e1 = f.indices[(j + 1) % 3];
+				bool cancelled = false;
+				for (uint32_t k = 0; k < numEdges; k++) {
+					if (edges[k][0] == e1 && edges[k][1] == e0) {
+						edges[k][0] = edges[numEdges - 1][0];
+						edges[k][1] = edges[numEdges - 1][1];
+						numEdges--;
+						cancelled = true;
+						break;
+					}
+				}
+				if (!cancelled) {
+					edges[numEdges][0] = e0;
+					edges[numEdges][1] = e1;
+					numEdges++;
+				}
+			}
+		}
+
+		// Stop with the current closest face if the polytope would grow too large
+		uint32_t numRemaining = 0;
+		for (uint32_t i = 0; i < numFaces; i++) {
+			if (!visible[i]) numRemaining++;
+		}
+		if (numEdges == 0 || (numRemaining + numEdges) > MAX_EPA_FACES) break;
+
+		// Replace the visible faces with a fan from the horizon to p
+		uint32_t numKept = 0;
+		for (uint32_t i = 0; i < numFaces; i++) {
+			if (!visible[i]) faces[numKept++] = faces[i];
+		}
+		numFaces = numKept;
+		const uint32_t pIndex = numVerts++;
+		verts[pIndex] = p;
+		for (uint32_t i = 0; i < numEdges; i++) {
+			faces[numFaces++] = makeFace(verts, edges[i][0], edges[i][1], pIndex);
+		}
+	}
+
+	for (uint32_t i = 0; i < numFaces; i++) {
+		if (faces[i].dist < faces[closest].dist) closest = i;
+	}
+	const EPAFace& face = faces[closest];
+
+	// Barycentric coordinates of the projection of the origin onto the closest face
+	const SupportPoint& p0 = verts[face.indices[0]];
+	const SupportPoint& p1 = verts[face.indices[1]];
+	const SupportPoint& p2 = verts[face.indices[2]];
+	const vec3 projected = face.normal * face.dist;
+	const vec3 v0 = p1.w - p0.w, v1 = p2.w - p0.w, v2 = projected - p0.w;
+	const float d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+	const float d20 = dot(v2, v0), d21 = dot(v2, v1);
+	const float denom = d00 * d11 - d01 * d01;
+	float v = 0.0f, w = 0.0f;
+	if (denom > 0.0f) {
+		v = (d11 * d20 - d01 * d21) / denom;
+		w = (d00 * d21 - d01 * d20) / denom;
+	}
+	const float u = 1.0f - v - w;
+
+	result.valid = true;
+	result.normal = face.normal;
+	result.depth = std::max(face.dist, 0.0f);
+	result.pointA = u * p0.a + v * p1.a + w * p2.a;
+	result.pointB = u * p0.b + v * p1.b + w * p2.b;
+	return result;
+}
+
+} // namespace sfz
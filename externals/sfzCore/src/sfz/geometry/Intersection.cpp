@@ -18,11 +18,15 @@
 
 #include "sfz/geometry/Intersection.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "sfz/geometry/AABB.hpp"
 #include "sfz/geometry/AABB2D.hpp"
 #include "sfz/geometry/Circle.hpp"
 #include "sfz/geometry/OBB.hpp"
 #include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Ray.hpp"
 #include "sfz/geometry/Sphere.hpp"
 
 namespace sfz {
@@ -248,6 +252,21 @@ bool overlaps(const AABB2D& rect, const Circle& circle) noexcept
 	return overlaps(circle, rect);
 }
 
+// AABB & Sphere tests
+// ------------------------------------------------------------------------------------------------
+
+bool intersects(const AABB& aabb, const Sphere& sphere) noexcept
+{
+	// Same as the AABB2D & Circle test, compares squared distance to the closest point on the box
+	vec3 diff = aabb.closestPoint(sphere.position()) - sphere.position();
+	return squaredLength(diff) <= sphere.radius() * sphere.radius();
+}
+
+bool intersects(const Sphere& sphere, const AABB& aabb) noexcept
+{
+	return intersects(aabb, sphere);
+}
+
 // Plane & AABB tests
 // ------------------------------------------------------------------------------------------------
 
@@ -355,4 +374,98 @@ bool belowPlane(const Plane& plane, const Sphere& sphere) noexcept
 	return belowPlane(plane, sphere.position(), sphere.radius());
 }
 
+// Ray tests
+// ------------------------------------------------------------------------------------------------
+
+float raycast(const Ray& ray, const AABB& aabb) noexcept
+{
+	// Slab test from Real-Time Collision Detection (chapter 5.3.3)
+	const vec3 t1 = (aabb.min() - ray.origin()) * ray.invDir();
+	const vec3 t2 = (aabb.max() - ray.origin()) * ray.invDir();
+	const vec3 tMins = min(t1, t2);
+	const vec3 tMaxs = max(t1, t2);
+	const float tMin = std::max(std::max(tMins[0], tMins[1]), std::max(tMins[2], 0.0f));
+	const float tMax = std::min(std::min(tMaxs[0], tMaxs[1]), std::min(tMaxs[2], ray.maxDist()));
+	return (tMin <= tMax) ? tMin : RAY_MISS;
+}
+
+float raycast(const Ray& ray, const OBB& obb) noexcept
+{
+	// Slab test on the OBB axes, equivalent to an AABB slab test in the local space of the OBB
+	const vec3 diff = obb.position() - ray.origin();
+	const vec3 halfExtents = obb.halfExtents();
+	float tMin = 0.0f;
+	float tMax = ray.maxDist();
+	for (size_t i = 0; i < 3; i++) {
+		const vec3 axis = obb.axes()[i];
+		const float e = dot(axis, diff);
+		const float f = dot(axis, ray.dir());
+		if (std::abs(f) < 1e-20f) {
+			// Parallel to slab, miss if origin is outside it
+			if (std::abs(e) > halfExtents[i]) return RAY_MISS;
+			continue;
+		}
+		float t1 = (e - halfExtents[i]) / f;
+		float t2 = (e + halfExtents[i]) / f;
+		if (t1 > t2) std::swap(t1, t2);
+		tMin = std::max(tMin, t1);
+		tMax = std::min(tMax, t2);
+		if (tMin > tMax) return RAY_MISS;
+	}
+	return tMin;
+}
+
+float raycast(const Ray& ray, const Sphere& sphere) noexcept
+{
+	// Real-Time Collision Detection (chapter 5.3.2), generalized to non-normalized directions
+	const vec3 m = ray.origin() - sphere.position();
+	const float c = dot(m, m) - sphere.radius() * sphere.radius();
+	if (c <= 0.0f) return 0.0f; // Origin inside sphere
+	const float b = dot(m, ray.dir());
+	if (b > 0.0f) return RAY_MISS; // Origin outside and pointing away
+	const float a = dot(ray.dir(), ray.dir());
+	const float disc = b * b - a * c;
+	if (disc < 0.0f) return RAY_MISS;
+	const float t = (-b - std::sqrt(disc)) / a;
+	return (t <= ray.maxDist()) ? t : RAY_MISS;
+}
+
+float raycast(const Ray& ray, const Plane& plane) noexcept
+{
+	const float denom = dot(plane.normal(), ray.dir());
+	if (std::abs(denom) < 1e-20f) return RAY_MISS;
+	const float t = -plane.signedDistance(ray.origin()) / denom;
+	return (0.0f <= t && t <= ray.maxDist()) ? t : RAY_MISS;
+}
+
+float raycast(const Ray& ray, const vec3& v0, const vec3& v1, const vec3& v2) noexcept
+{
+	vec2 uv;
+	return raycast(ray, v0, v1, v2, uv);
+}
+
+float raycast(const Ray& ray, const vec3& v0, const vec3& v1, const vec3& v2, vec2& uvOut) noexcept
+{
+	// Mller-Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection"
+	const vec3 e1 = v1 - v0;
+	const vec3 e2 = v2 - v0;
+	const vec3 p = cross(ray.dir(), e2);
+	const float det = dot(e1, p);
+	if (std::abs(det) < 1e-20f) return RAY_MISS;
+	const float invDet = 1.0f / det;
+
+	const vec3 s = ray.origin() - v0;
+	const float u = dot(s, p) * invDet;
+	if (u < 0.0f || u > 1.0f) return RAY_MISS;
+
+	const vec3 q = cross(s, e1);
+	const float v = dot(ray.dir(), q) * invDet;
+	if (v < 0.0f || (u + v) > 1.0f) return RAY_MISS;
+
+	const float t = dot(e2, q) * invDet;
+	if (t < 0.0f || t > ray.maxDist()) return RAY_MISS;
+	uvOut = vec2(u, v);
+	return t;
+}
+
 } // namespace sfz
@@ -0,0 +1,348 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/LooseOctree.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+/// Enough for all siblings along a path from the root to a leaf at the max depth limit
+static const uint32_t TRAVERSAL_STACK_SIZE = 8 * (LooseOctree::MAX_DEPTH_LIMIT + 1);
+
+static uint32_t childSlot(const vec3i& childCell) noexcept
+{
+	return uint32_t(childCell.x & 1) | (uint32_t(childCell.y & 1) << 1) | (uint32_t(childCell.z & 1) << 2);
+}
+
+// LooseOctree: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+LooseOctree::LooseOctree(const AABB& worldBounds, uint32_t maxDepth, float looseness) noexcept
+:
+	mWorldMin(worldBounds.min()),
+	mMaxDepth(maxDepth),
+	mLooseness(looseness)
+{
+	sfz_assert_debug(maxDepth <= MAX_DEPTH_LIMIT);
+	sfz_assert_debug(1.0f < looseness && looseness <= 2.0f);
+	const vec3 extents = worldBounds.extents();
+	mWorldSize = std::max(extents.x, std::max(extents.y, extents.z));
+	allocateNode(OCTREE_INVALID_INDEX, 0, vec3i(0));
+}
+
+// LooseOctree: Public methods
+// ------------------------------------------------------------------------------------------------
+
+uint32_t LooseOctree::insert(const AABB& bounds) noexcept
+{
+	sfz_assert_debug(mNodes.size() > 0);
+	uint32_t handle;
+	if (mFreeObjects.size() > 0) {
+		handle = mFreeObjects.last();
+		mFreeObjects.remove(mFreeObjects.size() - 1);
+	} else {
+		handle = mObjects.size();
+		mObjects.add(Object());
+	}
+
+	uint32_t depth;
+	vec3i cell;
+	targetCell(bounds, depth, cell);
+	link(handle, bounds, depth, cell);
+	return handle;
+}
+
+void LooseOctree::move(uint32_t handle, const AABB& bounds) noexcept
+{
+	sfz_assert_debug(handle < mObjects.size() && mObjects[handle].node != OCTREE_INVALID_INDEX);
+	const Object& object = mObjects[handle];
+
+	uint32_t depth;
+	vec3i cell;
+	targetCell(bounds, depth, cell);
+	if (object.depth == depth && object.cell == cell) {
+		mNodes[object.node].objectBounds[object.index] = bounds;
+		return;
+	}
+
+	unlink(handle);
+	link(handle, bounds, depth, cell);
+}
+
+void LooseOctree::remove(uint32_t handle) noexcept
+{
+	sfz_assert_debug(handle < mObjects.size() && mObjects[handle].node != OCTREE_INVALID_INDEX);
+	unlink(handle);
+	mObjects[handle].node = OCTREE_INVALID_INDEX;
+	mFreeObjects.add(handle);
+}
+
+void LooseOctree::clear() noexcept
+{
+	mNodes.clear();
+	mFreeNodes.clear();
+	mObjects.clear();
+	mFreeObjects.clear();
+	allocateNode(OCTREE_INVALID_INDEX, 0, vec3i(0));
+}
+
+void LooseOctree::queryFrustum(const ViewFrustum& frustum, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	const Plane* planes[6] = { &frustum.leftPlane(), &frustum.rightPlane(), &frustum.nearPlane(),
+	                           &frustum.farPlane(), &frustum.upPlane(), &frustum.downPlane() };
+	const uint32_t ALL_PLANES = 0x3F;
+
+	// Each stack entry also stores the planes its parent is not completely inside of
+	uint32_t nodeStack[TRAVERSAL_STACK_SIZE];
+	uint32_t planeMaskStack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	nodeStack[stackSize] = 0;
+	planeMaskStack[stackSize] = ALL_PLANES;
+	stackSize++;
+
+	while (stackSize > 0) {
+		stackSize--;
+		const uint32_t nodeIndex = nodeStack[stackSize];
+		const Node& node = mNodes[nodeIndex];
+		uint32_t planeMask = planeMaskStack[stackSize];
+
+		// The root is always visited since it contains the objects outside the world bounds
+		if (nodeIndex != 0) {
+			const float looseHalfSize = node.halfSize * mLooseness;
+			bool visible = true;
+			for (uint32_t p = 0; p < 6; p++) {
+				if ((planeMask & (1u << p)) == 0) continue;
+				const vec3 normal = planes[p]->normal();
+				const float dist = planes[p]->signedDistance(node.center);
+				const float projectedRadius = looseHalfSize * (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+				if (dist > projectedRadius) {
+					visible = false;
+					break;
+				}
+				if (dist + projectedRadius <= 0.0f) planeMask &= ~(1u << p);
+			}
+			if (!visible) continue;
+		}
+
+		const uint32_t numObjects = node.objectHandles.size();
+		if (planeMask == 0) {
+			resultOut.add(node.objectHandles.data(), numObjects);
+		} else {
+			for (uint32_t i = 0; i < numObjects; i++) {
+				if (frustum.isVisible(node.objectBounds[i])) resultOut.add(node.objectHandles[i]);
+			}
+		}
+		for (uint32_t child : node.children) {
+			if (child == OCTREE_INVALID_INDEX) continue;
+			sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+			nodeStack[stackSize] = child;
+			planeMaskStack[stackSize] = planeMask;
+			stackSize++;
+		}
+	}
+}
+
+void LooseOctree::queryOverlap(const AABB& aabb, DynArray<uint32_t>& resultOut) const noexcept
+{
+	auto test = [&](const AABB& bounds) { return intersects(bounds, aabb); };
+	query(test, test, resultOut);
+}
+
+void LooseOctree::queryOverlap(const Sphere& sphere, DynArray<uint32_t>& resultOut) const noexcept
+{
+	auto test = [&](const AABB& bounds) { return intersects(bounds, sphere); };
+	query(test, test, resultOut);
+}
+
+void LooseOctree::queryRay(const Ray& ray, DynArray<uint32_t>& resultOut) const noexcept
+{
+	auto test = [&](const AABB& bounds) { return raycast(ray, bounds) != RAY_MISS; };
+	query(test, test, resultOut);
+}
+
+// LooseOctree: Private methods
+// ------------------------------------------------------------------------------------------------
+
+void LooseOctree::targetCell(const AABB& bounds, uint32_t& depthOut, vec3i& cellOut) const noexcept
+{
+	// An object fits in the loose bounds of any node whose cell contains its center if its half
+	// extent is at most (looseness - 1) * halfSize, pick the deepest such level
+	const vec3 extents = bounds.extents();
+	const float maxExtent = std::max(extents.x, std::max(extents.y, extents.z));
+	const float fitLimit = (mLooseness - 1.0f) * mWorldSize;
+	uint32_t depth = mMaxDepth;
+	if (maxExtent * float(uint32_t(1) << mMaxDepth) > fitLimit) {
+		// Deepest depth with maxExtent * 2^depth <= fitLimit, i.e. floor(log2(fitLimit / maxExtent))
+		int exponent = 0;
+		std::frexp(fitLimit / maxExtent, &exponent);
+		depth = uint32_t(std::max(exponent - 1, 0));
+	}
+
+	const vec3 center = bounds.position();
+	const vec3 halfExtents = bounds.halfExtents();
+	while (true) {
+		const int32_t numCells = int32_t(1) << depth;
+		const float cellSize = mWorldSize / float(numCells);
+		const vec3 local = (center - mWorldMin) * (float(numCells) / mWorldSize);
+		vec3i cell;
+		for (uint32_t i = 0; i < 3; i++) {
+			cell[i] = std::min(std::max(int32_t(std::floor(local[i])), 0), numCells - 1);
+		}
+
+		// Objects with their center outside the world may not fit, move them up the tree
+		const vec3 cellCenter = mWorldMin + (vec3(cell) + vec3(0.5f)) * cellSize;
+		const float looseHalfSize = cellSize * 0.5f * mLooseness;
+		const vec3 dist = abs(center - cellCenter) + halfExtents;
+		if (depth == 0 || (dist.x <= looseHalfSize && dist.y <= looseHalfSize && dist.z <= looseHalfSize)) {
+			depthOut = depth;
+			cellOut = cell;
+			return;
+		}
+		depth--;
+	}
+}
+
+uint32_t LooseOctree::allocateNode(uint32_t parent, uint32_t depth, const vec3i& cell) noexcept
+{
+	uint32_t index;
+	if (mFreeNodes.size() > 0) {
+		index = mFreeNodes.last();
+		mFreeNodes.remove(mFreeNodes.size() - 1);
+	} else {
+		index = mNodes.size();
+		mNodes.add(Node());
+	}
+
+	Node& node = mNodes[index];
+	const float cellSize = mWorldSize / float(uint32_t(1) << depth);
+	node.center = mWorldMin + (vec3(cell) + vec3(0.5f)) * cellSize;
+	node.halfSize = cellSize * 0.5f;
+	node.cell = cell;
+	node.depth = depth;
+	node.parent = parent;
+	for (uint32_t& child : node.children) child = OCTREE_INVALID_INDEX;
+	node.numObjectsInSubtree = 0;
+	sfz_assert_debug(node.objectHandles.size() == 0);
+	return index;
+}
+
+void LooseOctree::link(uint32_t handle, const AABB& bounds, uint32_t depth, const vec3i& cell) noexcept
+{
+	// Walk down from the root, creating nodes as needed
+	uint32_t nodeIndex = 0;
+	mNodes[0].numObjectsInSubtree++;
+	for (uint32_t d = 1; d <= depth; d++) {
+		const vec3i childCell(cell.x >> (depth - d), cell.y >> (depth - d), cell.z >> (depth - d));
+		const uint32_t slot = childSlot(childCell);
+		uint32_t child = mNodes[nodeIndex].children[slot];
+		if (child == OCTREE_INVALID_INDEX) {
+			child = allocateNode(nodeIndex, d, childCell);
+			mNodes[nodeIndex].children[slot] = child;
+		}
+		nodeIndex = child;
+		mNodes[nodeIndex].numObjectsInSubtree++;
+	}
+
+	Node& node = mNodes[nodeIndex];
+	Object& object = mObjects[handle];
+	object.cell = cell;
+	object.depth = depth;
+	object.node = nodeIndex;
+	object.index = node.objectHandles.size();
+	node.objectBounds.add(bounds);
+	node.objectHandles.add(handle);
+}
+
+void LooseOctree::unlink(uint32_t handle) noexcept
+{
+	// Swap-remove from the node's object arrays
+	const Object& object = mObjects[handle];
+	{
+		Node& node = mNodes[object.node];
+		const uint32_t lastIndex = node.objectHandles.size() - 1;
+		const uint32_t movedHandle = node.objectHandles[lastIndex];
+		node.objectBounds[object.index] = node.objectBounds[lastIndex];
+		node.objectHandles[object.index] = movedHandle;
+		mObjects[movedHandle].index = object.index;
+		node.objectBounds.remove(lastIndex);
+		node.objectHandles.remove(lastIndex);
+	}
+
+	// Walk up to the root, returning nodes with empty subtrees to the pool
+	uint32_t nodeIndex = object.node;
+	while (nodeIndex != OCTREE_INVALID_INDEX) {
+		Node& node = mNodes[nodeIndex];
+		sfz_assert_debug(node.numObjectsInSubtree > 0);
+		node.numObjectsInSubtree--;
+		const uint32_t parent = node.parent;
+		if (node.numObjectsInSubtree == 0 && nodeIndex != 0) {
+			mNodes[parent].children[childSlot(node.cell)] = OCTREE_INVALID_INDEX;
+			mFreeNodes.add(nodeIndex);
+		}
+		nodeIndex = parent;
+	}
+}
+
+AABB LooseOctree::looseBounds(const Node& node) const noexcept
+{
+	const vec3 looseHalfExtents = vec3(node.halfSize * mLooseness);
+	return AABB(node.center - looseHalfExtents, node.center + looseHalfExtents);
+}
+
+template<typename NodeTest, typename ObjectTest>
+void LooseOctree::query(NodeTest&& nodeTest, ObjectTest&& objectTest, DynArray<uint32_t>& resultOut) const noexcept
+{
+	if (mNodes.size() == 0) return;
+
+	uint32_t stack[TRAVERSAL_STACK_SIZE];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0) {
+		const uint32_t nodeIndex = stack[--stackSize];
+		const Node& node = mNodes[nodeIndex];
+
+		// The root is always visited since it contains the objects outside the world bounds
+		if (nodeIndex != 0 && !nodeTest(looseBounds(node))) continue;
+
+		for (uint32_t i = 0; i < node.objectHandles.size(); i++) {
+			if (objectTest(node.objectBounds[i])) resultOut.add(node.objectHandles[i]);
+		}
+		for (uint32_t child : node.children) {
+			if (child == OCTREE_INVALID_INDEX) continue;
+			sfz_assert_debug(stackSize < TRAVERSAL_STACK_SIZE);
+			stack[stackSize++] = child;
+		}
+	}
+}
+
+} // namespace sfz
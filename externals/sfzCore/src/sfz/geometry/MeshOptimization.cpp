@@ -0,0 +1,370 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/MeshOptimization.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/containers/DynArray.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t NO_VERTEX = ~0u;
+static constexpr uint32_t NO_TRIANGLE = ~0u;
+
+// Forsyth's constants, the simulated cache is LRU
+static constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+static constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+static constexpr uint32_t FORSYTH_MAX_VALENCE = 64; // Valences above share the last score
+
+// Size of the FIFO cache used to find clusters in optimizeOverdraw()
+static constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+/// FIFO cache simulated with timestamps, a vertex is in the cache if it was added among the last
+/// cacheSize additions
+struct FifoCache final {
+	DynArray<uint32_t> timestamps;
+	uint32_t timestamp;
+	uint32_t cacheSize;
+
+	FifoCache(uint32_t numVertices, uint32_t cacheSize) noexcept
+	:
+		timestamps(numVertices, 0u, 0u),
+		timestamp(cacheSize + 1),
+		cacheSize(cacheSize)
+	{ }
+
+	/// Returns the number of misses
+	uint32_t addTriangle(const uint32_t* triangle) noexcept
+	{
+		uint32_t misses = 0;
+		for (uint32_t i = 0; i < 3; i++) {
+			const uint32_t vertex = triangle[i];
+			if ((timestamp - timestamps[vertex]) > cacheSize) {
+				timestamps[vertex] = timestamp++;
+				misses++;
+			}
+		}
+		return misses;
+	}
+
+	void flush() noexcept
+	{
+		timestamp += cacheSize + 1;
+	}
+};
+
+struct ForsythScoreTables final {
+	float cachePosition[FORSYTH_CACHE_SIZE];
+	float valence[FORSYTH_MAX_VALENCE + 1];
+
+	ForsythScoreTables() noexcept
+	{
+		for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+			if (i < 3) {
+				// The vertices of the last triangle get a fixed score, otherwise it would be
+				// favourable to use the same edge over and over again
+				cachePosition[i] = FORSYTH_LAST_TRIANGLE_SCORE;
+			}
+			else {
+				const float scaler = 1.0f / float(FORSYTH_CACHE_SIZE - 3);
+				cachePosition[i] = std::pow(1.0f - float(i - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+			}
+		}
+		valence[0] = 0.0f;
+		for (uint32_t i = 1; i <= FORSYTH_MAX_VALENCE; i++) {
+			valence[i] = FORSYTH_VALENCE_BOOST_SCALE * std::pow(float(i), -FORSYTH_VALENCE_BOOST_POWER);
+		}
+	}
+
+	/// Score of a vertex with numTriangles remaining triangles, at a position in the cache (or
+	/// NO_VERTEX if not in the cache)
+	float vertexScore(uint32_t position, uint32_t numTriangles) const noexcept
+	{
+		if (numTriangles == 0) return -1.0f; // No triangles left, never picked
+		float score = valence[std::min(numTriangles, FORSYTH_MAX_VALENCE)];
+		if (position != NO_VERTEX) score += cachePosition[position];
+		return score;
+	}
+};
+
+// Vertex cache statistics
+// ------------------------------------------------------------------------------------------------
+
+VertexCacheStats analyzeVertexCache(const uint32_t* indices, uint32_t numIndices,
+                                    uint32_t numVertices, uint32_t cacheSize) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	VertexCacheStats stats;
+	if (numIndices == 0) return stats;
+
+	FifoCache cache(numVertices, cacheSize);
+	DynArray<bool> referenced(numVertices, false, 0u);
+	uint32_t numReferenced = 0;
+	for (uint32_t i = 0; i < numIndices; i += 3) {
+		stats.numTransformed += cache.addTriangle(indices + i);
+		for (uint32_t j = 0; j < 3; j++) {
+			if (!referenced[indices[i + j]]) {
+				referenced[indices[i + j]] = true;
+				numReferenced++;
+			}
+		}
+	}
+	stats.acmr = float(stats.numTransformed) / float(numIndices / 3);
+	stats.atvr = float(stats.numTransformed) / float(numReferenced);
+	return stats;
+}
+
+// Mesh optimization functions
+// ------------------------------------------------------------------------------------------------
+
+void optimizeVertexCache(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                         uint32_t numVertices) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	const uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0) return;
+	static const ForsythScoreTables tables;
+
+	// Adjacency, the remaining triangles of each vertex are stored in a range of adjacentTriangles
+	// starting at adjacencyOffsets[vertex]. Emitted triangles are swapped out of the ranges.
+	DynArray<uint32_t> numRemaining(numVertices, 0u, 0u);
+	for (uint32_t i = 0; i < numIndices; i++) {
+		sfz_assert_debug(indices[i] < numVertices);
+		numRemaining[indices[i]]++;
+	}
+	DynArray<uint32_t> adjacencyOffsets(numVertices, 0u, 0u);
+	uint32_t offset = 0;
+	for (uint32_t v = 0; v < numVertices; v++) {
+		adjacencyOffsets[v] = offset;
+		offset += numRemaining[v];
+	}
+	DynArray<uint32_t> adjacentTriangles(numIndices, 0u, 0u);
+	{
+		DynArray<uint32_t> fill(numVertices, 0u, 0u);
+		for (uint32_t i = 0; i < numIndices; i++) {
+			const uint32_t v = indices[i];
+			adjacentTriangles[adjacencyOffsets[v] + fill[v]++] = i / 3;
+		}
+	}
+
+	// Scores
+	DynArray<uint32_t> cachePositions(numVertices, NO_VERTEX, 0u);
+	DynArray<float> vertexScores(0u, 0u, numVertices);
+	for (uint32_t v = 0; v < numVertices; v++) {
+		vertexScores.add(tables.vertexScore(NO_VERTEX, numRemaining[v]));
+	}
+	DynArray<float> triangleScores(0u, 0u, numTriangles);
+	DynArray<bool> emitted(numTriangles, false, 0u);
+	uint32_t bestTriangle = 0;
+	for (uint32_t t = 0; t < numTriangles; t++) {
+		const uint32_t* tri = indices + t * 3;
+		triangleScores.add(vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]]);
+		if (triangleScores[t] > triangleScores[bestTriangle]) bestTriangle = t;
+	}
+
+	// The cache has room for the vertices pushed out by the last triangle
+	uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+	uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+	uint32_t cacheSize = 0;
+	uint32_t deadEndCursor = 0;
+	DynArray<uint32_t> result(0u, 0u, numIndices);
+
+	for (uint32_t numEmitted = 0; numEmitted < numTriangles; numEmitted++) {
+		// Dead end, no triangle uses a vertex in the cache. Continue with the first triangle not
+		// yet emitted, scanning for the best one would make the algorithm quadratic.
+		if (bestTriangle == NO_TRIANGLE) {
+			while (emitted[deadEndCursor]) deadEndCursor++;
+			bestTriangle = deadEndCursor;
+		}
+
+		// Emit triangle and remove it from the adjacency of its vertices
+		const uint32_t* tri = indices + bestTriangle * 3;
+		emitted[bestTriangle] = true;
+		for (uint32_t i = 0; i < 3; i++) {
+			const uint32_t v = tri[i];
+			result.add(v);
+			uint32_t* adjacent = adjacentTriangles.data() + adjacencyOffsets[v];
+			const uint32_t count = numRemaining[v];
+			for (uint32_t j = 0; j < count; j++) {
+				if (adjacent[j] == bestTriangle) {
+					adjacent[j] = adjacent[count - 1];
+					numRemaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// The vertices of the triangle are moved to the front of the LRU cache
+		uint32_t newCacheSize = 0;
+		for (uint32_t i = 0; i < 3; i++) {
+			const uint32_t v = tri[i];
+			bool duplicate = false;
+			for (uint32_t j = 0; j < newCacheSize; j++) duplicate = duplicate || newCache[j] == v;
+			if (!duplicate) newCache[newCacheSize++] = v;
+		}
+		for (uint32_t i = 0; i < cacheSize; i++) {
+			const uint32_t v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCacheSize++] = v;
+		}
+
+		// Update scores of all vertices in (or pushed out of) the cache and of their triangles,
+		// the best of these triangles is emitted next
+		bestTriangle = NO_TRIANGLE;
+		float bestScore = -1.0f;
+		for (uint32_t i = 0; i < newCacheSize; i++) {
+			const uint32_t v = newCache[i];
+			cachePositions[v] = (i < FORSYTH_CACHE_SIZE) ? i : NO_VERTEX;
+			const float newScore = tables.vertexScore(cachePositions[v], numRemaining[v]);
+			const float diff = newScore - vertexScores[v];
+			vertexScores[v] = newScore;
+			const uint32_t* adjacent = adjacentTriangles.data() + adjacencyOffsets[v];
+			for (uint32_t j = 0; j < numRemaining[v]; j++) {
+				const uint32_t t = adjacent[j];
+				triangleScores[t] += diff;
+				if (triangleScores[t] > bestScore) {
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+		cacheSize = std::min(newCacheSize, FORSYTH_CACHE_SIZE);
+		std::copy(newCache, newCache + cacheSize, cache);
+	}
+
+	std::copy(result.data(), result.data() + numIndices, indicesOut);
+}
+
+void optimizeOverdraw(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                      const vec3* positions, uint32_t numVertices, uint32_t stride,
+                      float threshold) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	sfz_assert_debug(indicesOut != indices);
+	const uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0) return;
+	const uint8_t* positionBytes = reinterpret_cast<const uint8_t*>(positions);
+	auto position = [&](uint32_t vertex) -> const vec3& {
+		return *reinterpret_cast<const vec3*>(positionBytes + size_t(vertex) * stride);
+	};
+
+	// Hard boundaries, where the vertex cache optimized order misses on all three vertices. These
+	// are usually the start of a new disjoint patch of the mesh.
+	FifoCache cache(numVertices, OVERDRAW_CACHE_SIZE);
+	DynArray<uint32_t> hardBoundaries;
+	for (uint32_t t = 0; t < numTriangles; t++) {
+		if (cache.addTriangle(indices + t * 3) == 3 || t == 0) hardBoundaries.add(t);
+	}
+	hardBoundaries.add(numTriangles);
+
+	// Soft boundaries, hard clusters are split as soon as the ACMR (with a cold cache) of the
+	// current cluster gets below threshold times the ACMR of the hard cluster
+	DynArray<uint32_t> clusters; // Start of each cluster
+	for (uint32_t h = 0; (h + 1) < hardBoundaries.size(); h++) {
+		const uint32_t begin = hardBoundaries[h];
+		const uint32_t end = hardBoundaries[h + 1];
+
+		cache.flush();
+		uint32_t hardMisses = 0;
+		for (uint32_t t = begin; t < end; t++) hardMisses += cache.addTriangle(indices + t * 3);
+		const float clusterThreshold = threshold * float(hardMisses) / float(end - begin);
+
+		clusters.add(begin);
+		cache.flush();
+		uint32_t misses = 0, numClusterTriangles = 0;
+		for (uint32_t t = begin; t < end; t++) {
+			misses += cache.addTriangle(indices + t * 3);
+			numClusterTriangles++;
+			if (float(misses) <= clusterThreshold * float(numClusterTriangles)) {
+				clusters.add(t + 1);
+				cache.flush();
+				misses = 0;
+				numClusterTriangles = 0;
+			}
+		}
+
+		// The last cluster is typically small with a bad ACMR, merge it with the one before it
+		// (also removes the empty cluster added if the last triangle ended a cluster)
+		if (clusters.last() != begin) clusters.remove(clusters.size() - 1);
+	}
+	clusters.add(numTriangles);
+	const uint32_t numClusters = clusters.size() - 1;
+
+	// Sort key of each cluster, how much its (area weighted) normal points away from the center
+	vec3 meshCenter = vec3(0.0f);
+	for (uint32_t i = 0; i < numIndices; i++) meshCenter += position(indices[i]);
+	meshCenter /= float(numIndices);
+
+	DynArray<float> sortKeys(0u, 0u, numClusters);
+	for (uint32_t c = 0; c < numClusters; c++) {
+		vec3 centroid = vec3(0.0f), normal = vec3(0.0f);
+		float area = 0.0f;
+		for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+			const vec3& p0 = position(indices[t * 3]);
+			const vec3& p1 = position(indices[t * 3 + 1]);
+			const vec3& p2 = position(indices[t * 3 + 2]);
+			const vec3 triNormal = cross(p1 - p0, p2 - p0);
+			const float triArea = length(triNormal);
+			centroid += (p0 + p1 + p2) * (triArea / 3.0f);
+			normal += triNormal;
+			area += triArea;
+		}
+		const float normalLength = length(normal);
+		if (area > 0.0f) centroid /= area;
+		if (normalLength > 0.0f) normal /= normalLength;
+		sortKeys.add(dot(centroid - meshCenter, normal));
+	}
+
+	// Clusters facing outwards first, stable so that the result is deterministic
+	DynArray<uint32_t> order(0u, 0u, numClusters);
+	for (uint32_t c = 0; c < numClusters; c++) order.add(c);
+	std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+		return sortKeys[lhs] > sortKeys[rhs];
+	});
+
+	uint32_t* out = indicesOut;
+	for (uint32_t c : order) {
+		const uint32_t begin = clusters[c] * 3;
+		const uint32_t end = clusters[c + 1] * 3;
+		out = std::copy(indices + begin, indices + end, out);
+	}
+}
+
+uint32_t optimizeVertexFetch(uint32_t* remapOut, uint32_t* indices, uint32_t numIndices,
+                             uint32_t numVertices) noexcept
+{
+	for (uint32_t v = 0; v < numVertices; v++) remapOut[v] = NO_VERTEX;
+	uint32_t numReferenced = 0;
+	for (uint32_t i = 0; i < numIndices; i++) {
+		uint32_t& index = indices[i];
+		sfz_assert_debug(index < numVertices);
+		if (remapOut[index] == NO_VERTEX) remapOut[index] = numReferenced++;
+		index = remapOut[index];
+	}
+	return numReferenced;
+}
+
+} // namespace sfz
@@ -0,0 +1,465 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/MeshSimplification.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/containers/DynArray.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static constexpr uint32_t NO_VERTEX = ~0u;
+
+// Weight of the planes perpendicular to borders and seams, relative to the planes of triangles
+static constexpr float BORDER_WEIGHT = 10.0f;
+
+// The collapses of a pass stop when the error exceeds this factor times the error of the
+// collapse that would reach the target if all collapses could be performed
+static constexpr float PASS_ERROR_FACTOR = 1.5f;
+
+// Collapses creating triangles with a smaller sine of the angle at the moved vertex are rejected,
+// such triangles are degenerate apart from rounding errors
+static constexpr float MIN_TRIANGLE_SINE = 1e-3f;
+
+enum class VertexKind : uint8_t {
+	MANIFOLD, // Can be collapsed onto any neighbour
+	BORDER, // On an open border, can only be collapsed along it
+	SEAM, // On a seam with one sibling, can only be collapsed along it together with its sibling
+	LOCKED // Never collapsed
+};
+
+/// Sum of squared distances to planes, Q(p) = p^T * A * p + 2 * dot(b, p) + c, weighted by area
+struct Quadric final {
+	float a00 = 0.0f, a11 = 0.0f, a22 = 0.0f, a10 = 0.0f, a20 = 0.0f, a21 = 0.0f;
+	float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+	float c = 0.0f;
+	float weight = 0.0f;
+
+	/// The plane dot(normal, p) + d = 0, normal must be normalized
+	static Quadric plane(const vec3& normal, float d, float weight) noexcept
+	{
+		Quadric q;
+		q.a00 = weight * normal.x * normal.x;
+		q.a11 = weight * normal.y * normal.y;
+		q.a22 = weight * normal.z * normal.z;
+		q.a10 = weight * normal.y * normal.x;
+		q.a20 = weight * normal.z * normal.x;
+		q.a21 = weight * normal.z * normal.y;
+		q.b0 = weight * normal.x * d;
+		q.b1 = weight * normal.y * d;
+		q.b2 = weight * normal.z * d;
+		q.c = weight * d * d;
+		q.weight = weight;
+		return q;
+	}
+
+	Quadric& operator+= (const Quadric& o) noexcept
+	{
+		a00 += o.a00; a11 += o.a11; a22 += o.a22; a10 += o.a10; a20 += o.a20; a21 += o.a21;
+		b0 += o.b0; b1 += o.b1; b2 += o.b2;
+		c += o.c;
+		weight += o.weight;
+		return *this;
+	}
+
+	/// Weighted mean squared distance from p to the planes
+	float error(const vec3& p) const noexcept
+	{
+		const float rx = a00 * p.x + a10 * p.y + a20 * p.z;
+		const float ry = a10 * p.x + a11 * p.y + a21 * p.z;
+		const float rz = a20 * p.x + a21 * p.y + a22 * p.z;
+		const float r = p.x * rx + p.y * ry + p.z * rz + 2.0f * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+		return weight > 0.0f ? std::abs(r) / weight : 0.0f;
+	}
+};
+
+struct Collapse final {
+	uint32_t vertex;
+	uint32_t target;
+	float error;
+};
+
+/// Triangles using each vertex, the triangles of a vertex are the range
+/// [offsets[vertex], offsets[vertex] + counts[vertex]) of triangles
+struct Adjacency final {
+	DynArray<uint32_t> counts;
+	DynArray<uint32_t> offsets;
+	DynArray<uint32_t> triangles;
+
+	void build(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices) noexcept
+	{
+		counts = DynArray<uint32_t>(numVertices, 0u, 0u);
+		offsets = DynArray<uint32_t>(numVertices, 0u, 0u);
+		triangles = DynArray<uint32_t>(numIndices, 0u, 0u);
+		for (uint32_t i = 0; i < numIndices; i++) counts[indices[i]]++;
+		uint32_t offset = 0;
+		for (uint32_t v = 0; v < numVertices; v++) {
+			offsets[v] = offset;
+			offset += counts[v];
+			counts[v] = 0;
+		}
+		for (uint32_t i = 0; i < numIndices; i++) {
+			const uint32_t v = indices[i];
+			triangles[offsets[v] + counts[v]++] = i / 3;
+		}
+	}
+
+	const uint32_t* begin(uint32_t vertex) const noexcept { return triangles.data() + offsets[vertex]; }
+	const uint32_t* end(uint32_t vertex) const noexcept { return begin(vertex) + counts[vertex]; }
+};
+
+static bool hasHalfEdge(const uint32_t* tri, uint32_t from, uint32_t to) noexcept
+{
+	return (tri[0] == from && tri[1] == to) || (tri[1] == from && tri[2] == to) ||
+	       (tri[2] == from && tri[0] == to);
+}
+
+static bool hasVertex(const uint32_t* tri, uint32_t vertex) noexcept
+{
+	return tri[0] == vertex || tri[1] == vertex || tri[2] == vertex;
+}
+
+/// Returns whether moving vertex to the position of target flips (or degenerates) any triangle of
+/// vertex that doesn't also use target. Also counts the triangles removed by the collapse.
+static bool collapseFlips(const uint32_t* indices, const vec3* positions, const Adjacency& adjacency,
+                          uint32_t vertex, uint32_t target, uint32_t& numRemovedOut) noexcept
+{
+	for (const uint32_t* it = adjacency.begin(vertex); it != adjacency.end(vertex); it++) {
+		const uint32_t* tri = indices + *it * 3;
+		if (hasVertex(tri, target)) {
+			numRemovedOut++;
+			continue;
+		}
+		// Rotate so that vertex is first
+		const uint32_t i1 = (tri[0] == vertex) ? tri[1] : (tri[1] == vertex) ? tri[2] : tri[0];
+		const uint32_t i2 = (tri[0] == vertex) ? tri[2] : (tri[1] == vertex) ? tri[0] : tri[1];
+		const vec3& p1 = positions[i1];
+		const vec3& p2 = positions[i2];
+		const vec3& p = positions[target];
+		const vec3 normalBefore = cross(p1 - positions[vertex], p2 - positions[vertex]);
+		const vec3 normalAfter = cross(p1 - p, p2 - p);
+		if (dot(normalBefore, normalAfter) <= 0.0f) return true;
+		if (length(normalAfter) <= MIN_TRIANGLE_SINE * length(p1 - p) * length(p2 - p)) return true;
+	}
+	return false;
+}
+
+/// Updates the border/seam neighbours after collapses, a vertex whose neighbour was collapsed onto
+/// itself gets the neighbour's neighbour
+static void remapLoop(DynArray<uint32_t>& loop, const DynArray<uint32_t>& remap) noexcept
+{
+	for (uint32_t i = 0; i < loop.size(); i++) {
+		const uint32_t neighbour = loop[i];
+		if (neighbour == NO_VERTEX) continue;
+		const uint32_t r = remap[neighbour];
+		loop[i] = (r == i) ? loop[neighbour] : r;
+	}
+}
+
+// Mesh simplification
+// ------------------------------------------------------------------------------------------------
+
+uint32_t simplifyMesh(uint32_t* indicesOut, const uint32_t* indices, uint32_t numIndices,
+                      const vec3* positions, uint32_t numVertices, uint32_t stride,
+                      uint32_t targetNumIndices, float maxError, float* errorOut,
+                      const bool* lockedVertices) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	if (errorOut != nullptr) *errorOut = 0.0f;
+
+	// Non-degenerate triangles of the input
+	DynArray<uint32_t> result(0u, 0u, numIndices);
+	for (uint32_t i = 0; i < numIndices; i += 3) {
+		const uint32_t* tri = indices + i;
+		sfz_assert_debug(tri[0] < numVertices && tri[1] < numVertices && tri[2] < numVertices);
+		if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) continue;
+		result.add(tri, 3);
+	}
+	if (result.size() <= targetNumIndices) {
+		std::copy(result.data(), result.data() + result.size(), indicesOut);
+		return result.size();
+	}
+
+	// The referenced vertices are given local indices, so that the cost only depends on the size
+	// of the part of the mesh being simplified. Positions are scaled to the unit cube so that the
+	// errors are independent of the scale of the mesh.
+	DynArray<uint32_t> localIndices(numVertices, NO_VERTEX, 0u);
+	DynArray<uint32_t> vertexIds(0u, 0u, std::min(numVertices, result.size()));
+	for (uint32_t& index : result) {
+		if (localIndices[index] == NO_VERTEX) {
+			localIndices[index] = vertexIds.size();
+			vertexIds.add(index);
+		}
+		index = localIndices[index];
+	}
+	const uint32_t numLocal = vertexIds.size();
+	const uint8_t* positionBytes = reinterpret_cast<const uint8_t*>(positions);
+	DynArray<vec3> pos(0, numLocal);
+	for (uint32_t id : vertexIds) {
+		pos.add(*reinterpret_cast<const vec3*>(positionBytes + size_t(id) * stride));
+	}
+	vec3 min = pos[0], max = pos[0];
+	for (const vec3& p : pos) {
+		min = sfz::min(min, p);
+		max = sfz::max(max, p);
+	}
+	const vec3 extent = max - min;
+	const float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+	const float scale = maxExtent > 0.0f ? 1.0f / maxExtent : 1.0f;
+	for (vec3& p : pos) p = (p - min) * scale;
+	const float errorLimit = (maxError * scale) * (maxError * scale);
+
+	// Vertices with the same position form a circular list through siblings, the first vertex of
+	// each position is used to store the quadric of the position
+	DynArray<uint32_t> siblings(numLocal, NO_VERTEX, 0u);
+	DynArray<uint32_t> roots(numLocal, NO_VERTEX, 0u);
+	{
+		DynArray<uint32_t> order(0u, 0u, numLocal);
+		for (uint32_t v = 0; v < numLocal; v++) order.add(v);
+		std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+			const vec3& a = pos[lhs];
+			const vec3& b = pos[rhs];
+			if (a.x != b.x) return a.x < b.x;
+			if (a.y != b.y) return a.y < b.y;
+			if (a.z != b.z) return a.z < b.z;
+			return lhs < rhs;
+		});
+		uint32_t first = 0;
+		for (uint32_t i = 1; i <= numLocal; i++) {
+			if (i < numLocal && pos[order[i]] == pos[order[first]]) continue;
+			for (uint32_t j = first; j < i; j++) {
+				roots[order[j]] = order[first];
+				siblings[order[j]] = order[(j + 1 < i) ? (j + 1) : first];
+			}
+			first = i;
+		}
+	}
+
+	// Open half-edges, i.e. half-edges without an opposite half-edge, which are the borders and
+	// seams of the mesh. Vertices with several open half-edges in the same direction are complex
+	// (e.g. where two borders meet) and will be locked.
+	Adjacency adjacency;
+	adjacency.build(result.data(), result.size(), numLocal);
+	DynArray<uint32_t> openOut(numLocal, NO_VERTEX, 0u); // Next vertex along the border
+	DynArray<uint32_t> openIn(numLocal, NO_VERTEX, 0u); // Previous vertex along the border
+	DynArray<bool> complex(numLocal, false, 0u);
+	DynArray<Quadric> quadrics(numLocal, Quadric(), 0u);
+	for (uint32_t i = 0; i < result.size(); i += 3) {
+		const uint32_t* tri = result.data() + i;
+		const vec3 normal = cross(pos[tri[1]] - pos[tri[0]], pos[tri[2]] - pos[tri[0]]);
+		const float normalLength = length(normal);
+		if (normalLength > 0.0f) {
+			const vec3 n = normal / normalLength;
+			const Quadric q = Quadric::plane(n, -dot(n, pos[tri[0]]), 0.5f * normalLength);
+			for (uint32_t j = 0; j < 3; j++) quadrics[roots[tri[j]]] += q;
+		}
+
+		for (uint32_t j = 0; j < 3; j++) {
+			const uint32_t from = tri[j];
+			const uint32_t to = tri[(j + 1) % 3];
+			bool open = true;
+			for (const uint32_t* it = adjacency.begin(to); it != adjacency.end(to) && open; it++) {
+				open = !hasHalfEdge(result.data() + *it * 3, to, from);
+			}
+			if (!open) continue;
+
+			if (openOut[from] != NO_VERTEX) complex[from] = true;
+			if (openIn[to] != NO_VERTEX) complex[to] = true;
+			openOut[from] = to;
+			openIn[to] = from;
+
+			// Plane through the edge perpendicular to the triangle, keeps the border in place
+			const vec3 edge = pos[to] - pos[from];
+			const vec3 edgeNormal = cross(edge, normal);
+			const float edgeNormalLength = length(edgeNormal);
+			if (edgeNormalLength > 0.0f) {
+				const vec3 n = edgeNormal / edgeNormalLength;
+				const Quadric q = Quadric::plane(n, -dot(n, pos[from]), BORDER_WEIGHT * dot(edge, edge));
+				quadrics[roots[from]] += q;
+				quadrics[roots[to]] += q;
+			}
+		}
+	}
+
+	// Classify vertices
+	auto isLocked = [&](uint32_t v) {
+		return complex[v] || (lockedVertices != nullptr && lockedVertices[vertexIds[v]]);
+	};
+	DynArray<VertexKind> kinds(numLocal, VertexKind::LOCKED, 0u);
+	for (uint32_t v = 0; v < numLocal; v++) {
+		if (isLocked(v)) continue;
+		const bool hasOpen = openOut[v] != NO_VERTEX || openIn[v] != NO_VERTEX;
+		const bool isBorder = openOut[v] != NO_VERTEX && openIn[v] != NO_VERTEX;
+		const uint32_t w = siblings[v];
+		if (w == v) {
+			kinds[v] = !hasOpen ? VertexKind::MANIFOLD : isBorder ? VertexKind::BORDER : VertexKind::LOCKED;
+		}
+		else if (siblings[w] == v && !isLocked(w) && isBorder &&
+		         openOut[w] != NO_VERTEX && openIn[w] != NO_VERTEX &&
+		         roots[openOut[v]] == roots[openIn[w]] && roots[openIn[v]] == roots[openOut[w]]) {
+			// Two sides of a seam, the open edges of one side run opposite to those of the other
+			kinds[v] = VertexKind::SEAM;
+		}
+	}
+
+	// The sibling of target that is a neighbour of vertex along the seam, NO_VERTEX if none
+	auto seamTarget = [&](uint32_t vertex, uint32_t target) {
+		if (openOut[vertex] != NO_VERTEX && roots[openOut[vertex]] == roots[target]) return openOut[vertex];
+		if (openIn[vertex] != NO_VERTEX && roots[openIn[vertex]] == roots[target]) return openIn[vertex];
+		return NO_VERTEX;
+	};
+	auto canCollapse = [&](uint32_t vertex, uint32_t target) {
+		switch (kinds[vertex]) {
+		case VertexKind::MANIFOLD:
+			return true;
+		case VertexKind::BORDER:
+			return (target == openOut[vertex] || target == openIn[vertex]) &&
+			       (kinds[target] == VertexKind::BORDER || kinds[target] == VertexKind::LOCKED);
+		case VertexKind::SEAM:
+			return (target == openOut[vertex] || target == openIn[vertex]) &&
+			       (kinds[target] == VertexKind::SEAM || kinds[target] == VertexKind::LOCKED) &&
+			       seamTarget(siblings[vertex], target) != NO_VERTEX;
+		case VertexKind::LOCKED:
+			return false;
+		}
+		return false;
+	};
+	auto collapseError = [&](uint32_t vertex, uint32_t target) {
+		Quadric q = quadrics[roots[vertex]];
+		q += quadrics[roots[target]];
+		return q.error(pos[target]);
+	};
+
+	DynArray<Collapse> collapses(0, result.size());
+	DynArray<uint32_t> remap(numLocal, 0u, 0u);
+	DynArray<bool> lockedInPass(numLocal, false, 0u);
+	float maxCollapseError = 0.0f;
+
+	for (bool firstPass = true; result.size() > targetNumIndices; firstPass = false) {
+		if (!firstPass) adjacency.build(result.data(), result.size(), numLocal);
+
+		// Cheapest valid direction of each edge. Edges shared by two triangles are only added from
+		// the triangle where the edge goes from the higher index to the lower.
+		collapses.clear();
+		for (uint32_t i = 0; i < result.size(); i += 3) {
+			const uint32_t* tri = result.data() + i;
+			for (uint32_t j = 0; j < 3; j++) {
+				const uint32_t a = tri[j];
+				const uint32_t b = tri[(j + 1) % 3];
+				if (a < b && openOut[a] != b && openIn[b] != a) continue;
+				const bool aToB = canCollapse(a, b);
+				const bool bToA = canCollapse(b, a);
+				if (!aToB && !bToA) continue;
+				const float errorAToB = aToB ? collapseError(a, b) : 0.0f;
+				const float errorBToA = bToA ? collapseError(b, a) : 0.0f;
+				if (aToB && (!bToA || errorAToB <= errorBToA)) collapses.add({ a, b, errorAToB });
+				else collapses.add({ b, a, errorBToA });
+			}
+		}
+		if (collapses.size() == 0) break;
+
+		// Each collapse typically removes two triangles. Only the collapses below the error limit
+		// of the pass are sorted.
+		auto lessError = [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; };
+		const uint32_t numTrianglesToRemove = (result.size() - targetNumIndices + 2) / 3;
+		const uint32_t goalIndex = std::min(numTrianglesToRemove / 2, collapses.size() - 1);
+		std::nth_element(collapses.begin(), collapses.begin() + goalIndex, collapses.end(), lessError);
+		const float minError = std::min_element(collapses.begin(), collapses.begin() + goalIndex + 1, lessError)->error;
+		const float passErrorLimit = std::min(errorLimit,
+		    std::max(collapses[goalIndex].error * PASS_ERROR_FACTOR, minError));
+		auto sortBelow = [&](Collapse* begin, float limit) {
+			Collapse* end = std::partition(begin, collapses.end(),
+			    [&](const Collapse& c) { return c.error <= limit; });
+			std::sort(begin, end, lessError);
+			return end;
+		};
+
+		// Perform collapses, each vertex may only be affected by one collapse per pass so that the
+		// adjacency and the flip checks stay valid
+		for (uint32_t v = 0; v < numLocal; v++) {
+			remap[v] = v;
+			lockedInPass[v] = false;
+		}
+		uint32_t numRemoved = 0, numCollapses = 0;
+		auto performCollapses = [&](const Collapse* begin, const Collapse* end) {
+			for (const Collapse* collapse = begin; collapse != end; collapse++) {
+				const uint32_t v = collapse->vertex;
+				const uint32_t t = collapse->target;
+				if (lockedInPass[v] || lockedInPass[t]) continue;
+
+				const bool seam = kinds[v] == VertexKind::SEAM;
+				const uint32_t w = seam ? siblings[v] : NO_VERTEX;
+				const uint32_t tw = seam ? seamTarget(w, t) : NO_VERTEX;
+				if (seam && (lockedInPass[w] || lockedInPass[tw])) continue;
+
+				uint32_t numCollapseRemoved = 0;
+				if (collapseFlips(result.data(), pos.data(), adjacency, v, t, numCollapseRemoved)) continue;
+				if (seam && collapseFlips(result.data(), pos.data(), adjacency, w, tw, numCollapseRemoved)) continue;
+
+				remap[v] = t;
+				if (seam) remap[w] = tw;
+				quadrics[roots[t]] += quadrics[roots[v]];
+				maxCollapseError = std::max(maxCollapseError, collapse->error);
+				numRemoved += numCollapseRemoved;
+				numCollapses++;
+
+				for (uint32_t moved : { v, w }) {
+					if (moved == NO_VERTEX) continue;
+					for (const uint32_t* it = adjacency.begin(moved); it != adjacency.end(moved); it++) {
+						const uint32_t* tri = result.data() + *it * 3;
+						lockedInPass[tri[0]] = lockedInPass[tri[1]] = lockedInPass[tri[2]] = true;
+					}
+				}
+				if (numRemoved >= numTrianglesToRemove) return;
+			}
+		};
+		Collapse* passEnd = sortBelow(collapses.begin(), passErrorLimit);
+		performCollapses(collapses.begin(), passEnd);
+
+		// If all cheap collapses were rejected (e.g. flips), continue with the more expensive ones
+		if (numCollapses == 0 && passErrorLimit < errorLimit) {
+			performCollapses(passEnd, sortBelow(passEnd, errorLimit));
+		}
+		if (numCollapses == 0) break;
+
+		// Apply collapses and remove the triangles that became degenerate
+		uint32_t numKept = 0;
+		for (uint32_t i = 0; i < result.size(); i += 3) {
+			const uint32_t i0 = remap[result[i]], i1 = remap[result[i + 1]], i2 = remap[result[i + 2]];
+			if (i0 == i1 || i1 == i2 || i2 == i0) continue;
+			result[numKept++] = i0;
+			result[numKept++] = i1;
+			result[numKept++] = i2;
+		}
+		result.setSize(numKept);
+		remapLoop(openOut, remap);
+		remapLoop(openIn, remap);
+	}
+
+	if (errorOut != nullptr) *errorOut = std::sqrt(maxCollapseError) / scale;
+	for (uint32_t i = 0; i < result.size(); i++) indicesOut[i] = vertexIds[result[i]];
+	return result.size();
+}
+
+} // namespace sfz
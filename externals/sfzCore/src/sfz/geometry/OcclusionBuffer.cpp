@@ -0,0 +1,318 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/OcclusionBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "sfz/Assert.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+/// The depth of empty pixels. Not infinity, -ffast-math lets the compiler assume it never occurs.
+static constexpr float FAR_DEPTH = std::numeric_limits<float>::max();
+
+/// Vertices with a clip space w at or below this are considered to be behind the near plane
+static constexpr float MIN_CLIP_W = 1e-5f;
+
+static_assert(OcclusionBuffer::TILE_WIDTH % 8 == 0, "Tiles must be a multiple of the packet width");
+
+/// The x offsets of the pixel centers in an 8 pixel packet
+static floatx8 pixelCenterOffsets() noexcept
+{
+	floatx8 offsets;
+	for (size_t i = 0; i < 8; i++) {
+		offsets.lanes[i] = float(i) + 0.5f;
+	}
+	return offsets;
+}
+
+static void storePacket(const floatx8& packet, float* arrayPtr) noexcept
+{
+	for (size_t i = 0; i < 8; i++) {
+		arrayPtr[i] = packet.lanes[i];
+	}
+}
+
+/// Returns the lane mask of the pixels in [x, x + 8) which are inside [first, last]
+static LaneMask pixelRangeMask(int32_t x, int32_t first, int32_t last) noexcept
+{
+	const int32_t lo = std::max(first - x, 0);
+	const int32_t hi = std::min(last - x, 7);
+	if (lo > hi) return 0;
+	return ((LaneMask(1) << (hi + 1)) - LaneMask(1)) & ~((LaneMask(1) << lo) - LaneMask(1));
+}
+
+// OcclusionBuffer: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) noexcept
+{
+	sfz_assert_debug(width > 0);
+	sfz_assert_debug(height > 0);
+	mNumTilesX = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+	mNumTilesY = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+	mWidth = mNumTilesX * TILE_WIDTH;
+	mHeight = mNumTilesY * TILE_HEIGHT;
+
+	const uint32_t numTiles = mNumTilesX * mNumTilesY;
+	mDepth = DynArray<float>(mWidth * mHeight, mWidth * mHeight);
+	mTileMaxDepth = DynArray<float>(numTiles, numTiles);
+	mTileBins = DynArray<DynArray<uint32_t>>(numTiles, numTiles);
+	this->clear();
+}
+
+// OcclusionBuffer: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void OcclusionBuffer::clear() noexcept
+{
+	std::fill(mDepth.data(), mDepth.data() + mDepth.size(), FAR_DEPTH);
+	std::fill(mTileMaxDepth.data(), mTileMaxDepth.data() + mTileMaxDepth.size(), FAR_DEPTH);
+	mTriangles.clear();
+	for (DynArray<uint32_t>& bin : mTileBins) {
+		bin.clear();
+	}
+}
+
+void OcclusionBuffer::addOccluder(const mat4& modelViewProj, const vec3* positions,
+                                  const uint32_t* indices, uint32_t numIndices) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	const float halfWidth = float(mWidth) * 0.5f;
+	const float halfHeight = float(mHeight) * 0.5f;
+
+	for (uint32_t i = 0; i < numIndices; i += 3) {
+		vec3 v[3];
+		bool behindNear = false;
+		for (uint32_t j = 0; j < 3; j++) {
+			const vec4 clip = modelViewProj * vec4(positions[indices[i + j]], 1.0f);
+			if (clip.w <= MIN_CLIP_W || clip.z < -clip.w) {
+				behindNear = true;
+				break;
+			}
+			const float invW = 1.0f / clip.w;
+			v[j] = vec3((clip.x * invW + 1.0f) * halfWidth, (clip.y * invW + 1.0f) * halfHeight,
+			            clip.z * invW);
+		}
+		// Skipping a triangle can only make the buffer less occluding, so no clipping is needed
+		if (behindNear) continue;
+
+		// Both windings are rendered, flip clockwise triangles so the edge functions are positive
+		// inside
+		float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+		if (area < 0.0f) {
+			std::swap(v[1], v[2]);
+			area = -area;
+		}
+		if (area <= 0.0f) continue;
+
+		// Pixel (x, y) is sampled at (x + 0.5, y + 0.5)
+		const vec3 minPos = sfz::min(sfz::min(v[0], v[1]), v[2]);
+		const vec3 maxPos = sfz::max(sfz::max(v[0], v[1]), v[2]);
+		ScreenTriangle tri;
+		tri.minX = std::max(int32_t(std::ceil(minPos.x - 0.5f)), 0);
+		tri.minY = std::max(int32_t(std::ceil(minPos.y - 0.5f)), 0);
+		tri.maxX = std::min(int32_t(std::floor(maxPos.x - 0.5f)), int32_t(mWidth) - 1);
+		tri.maxY = std::min(int32_t(std::floor(maxPos.y - 0.5f)), int32_t(mHeight) - 1);
+		if (tri.minX > tri.maxX || tri.minY > tri.maxY) continue;
+
+		// Edge i is opposite of vertex i, so edge i / area is the barycentric coordinate of vertex i
+		const float invArea = 1.0f / area;
+		tri.depthA = 0.0f; tri.depthB = 0.0f; tri.depthC = 0.0f;
+		for (uint32_t j = 0; j < 3; j++) {
+			const vec3& a = v[(j + 1) % 3];
+			const vec3& b = v[(j + 2) % 3];
+			tri.edgeA[j] = a.y - b.y;
+			tri.edgeB[j] = b.x - a.x;
+			tri.edgeC[j] = -(tri.edgeA[j] * a.x + tri.edgeB[j] * a.y);
+			tri.depthA += tri.edgeA[j] * invArea * v[j].z;
+			tri.depthB += tri.edgeB[j] * invArea * v[j].z;
+			tri.depthC += tri.edgeC[j] * invArea * v[j].z;
+		}
+
+		const uint32_t triIndex = mTriangles.size();
+		mTriangles.add(tri);
+		const uint32_t tileMinX = uint32_t(tri.minX) / TILE_WIDTH;
+		const uint32_t tileMaxX = uint32_t(tri.maxX) / TILE_WIDTH;
+		const uint32_t tileMinY = uint32_t(tri.minY) / TILE_HEIGHT;
+		const uint32_t tileMaxY = uint32_t(tri.maxY) / TILE_HEIGHT;
+		for (uint32_t ty = tileMinY; ty <= tileMaxY; ty++) {
+			for (uint32_t tx = tileMinX; tx <= tileMaxX; tx++) {
+				mTileBins[ty * mNumTilesX + tx].add(triIndex);
+			}
+		}
+	}
+}
+
+void OcclusionBuffer::rasterize(uint32_t numThreads) noexcept
+{
+	numThreads = std::max(1u, std::min(numThreads, uint32_t(MAX_THREADS)));
+	const uint32_t numTiles = mNumTilesX * mNumTilesY;
+
+	// Tiles are interleaved between the threads since occluders tend to be clustered on screen
+	auto rasterizeTiles = [this, numThreads, numTiles](uint32_t first) {
+		for (uint32_t tile = first; tile < numTiles; tile += numThreads) {
+			this->rasterizeTile(tile);
+		}
+	};
+	std::thread threads[MAX_THREADS];
+	for (uint32_t i = 1; i < numThreads; i++) {
+		threads[i] = std::thread(rasterizeTiles, i);
+	}
+	rasterizeTiles(0);
+	for (uint32_t i = 1; i < numThreads; i++) {
+		threads[i].join();
+	}
+
+	mTriangles.clear();
+}
+
+bool OcclusionBuffer::testAABB(const mat4& viewProj, const AABB& aabb) const noexcept
+{
+	// Project the corners and find their screen rectangle and nearest depth
+	const vec3 corners[2] = { aabb.min(), aabb.max() };
+	vec2 minScreen(std::numeric_limits<float>::max());
+	vec2 maxScreen(-std::numeric_limits<float>::max());
+	float minDepth = std::numeric_limits<float>::max();
+	for (uint32_t i = 0; i < 8; i++) {
+		const vec3 corner(corners[i & 1].x, corners[(i >> 1) & 1].y, corners[(i >> 2) & 1].z);
+		const vec4 clip = viewProj * vec4(corner, 1.0f);
+		if (clip.w <= MIN_CLIP_W) return true;
+		const float invW = 1.0f / clip.w;
+		const vec2 screen(clip.x * invW, clip.y * invW);
+		minScreen = sfz::min(minScreen, screen);
+		maxScreen = sfz::max(maxScreen, screen);
+		minDepth = std::min(minDepth, clip.z * invW);
+	}
+
+	// Every pixel touched by the rectangle is tested, not only those whose center it covers
+	const float halfWidth = float(mWidth) * 0.5f;
+	const float halfHeight = float(mHeight) * 0.5f;
+	const float minX = (minScreen.x + 1.0f) * halfWidth;
+	const float minY = (minScreen.y + 1.0f) * halfHeight;
+	const float maxX = (maxScreen.x + 1.0f) * halfWidth;
+	const float maxY = (maxScreen.y + 1.0f) * halfHeight;
+	if (maxX < 0.0f || maxY < 0.0f || minX >= float(mWidth) || minY >= float(mHeight)) return false;
+	const int32_t x0 = std::max(int32_t(std::floor(minX)), 0);
+	const int32_t y0 = std::max(int32_t(std::floor(minY)), 0);
+	const int32_t x1 = std::min(int32_t(std::floor(maxX)), int32_t(mWidth) - 1);
+	const int32_t y1 = std::min(int32_t(std::floor(maxY)), int32_t(mHeight) - 1);
+
+	const floatx8 depth8(minDepth);
+	for (int32_t ty = y0 / int32_t(TILE_HEIGHT); ty <= y1 / int32_t(TILE_HEIGHT); ty++) {
+		for (int32_t tx = x0 / int32_t(TILE_WIDTH); tx <= x1 / int32_t(TILE_WIDTH); tx++) {
+			// Skip tiles where every pixel is closer than the object
+			if (minDepth > mTileMaxDepth[ty * mNumTilesX + tx]) continue;
+
+			const int32_t rowBegin = std::max(y0, ty * int32_t(TILE_HEIGHT));
+			const int32_t rowEnd = std::min(y1, (ty + 1) * int32_t(TILE_HEIGHT) - 1);
+			const int32_t colBegin = std::max(x0, tx * int32_t(TILE_WIDTH)) & ~7;
+			const int32_t colEnd = std::min(x1, (tx + 1) * int32_t(TILE_WIDTH) - 1);
+			for (int32_t y = rowBegin; y <= rowEnd; y++) {
+				const float* row = mDepth.data() + y * int32_t(mWidth);
+				for (int32_t x = colBegin; x <= colEnd; x += 8) {
+					const LaneMask visible = greaterThanEqual(floatx8(row + x), depth8)
+					                       & pixelRangeMask(x, x0, x1);
+					if (anyLane(visible)) return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+void OcclusionBuffer::testAABBs(const mat4& viewProj, const AABB* aabbs, size_t count,
+                                uint32_t* visibleMaskOut) const noexcept
+{
+	for (size_t i = 0; i < count; i += 32) {
+		const size_t numInWord = std::min(size_t(32), count - i);
+		uint32_t word = 0;
+		for (size_t j = 0; j < numInWord; j++) {
+			if (testAABB(viewProj, aabbs[i + j])) word |= (1u << j);
+		}
+		visibleMaskOut[i / 32] = word;
+	}
+}
+
+// OcclusionBuffer: Private methods
+// ------------------------------------------------------------------------------------------------
+
+void OcclusionBuffer::rasterizeTile(uint32_t tileIndex) noexcept
+{
+	DynArray<uint32_t>& bin = mTileBins[tileIndex];
+	if (bin.size() == 0) return;
+
+	const int32_t tileX0 = int32_t((tileIndex % mNumTilesX) * TILE_WIDTH);
+	const int32_t tileY0 = int32_t((tileIndex / mNumTilesX) * TILE_HEIGHT);
+	const int32_t tileX1 = tileX0 + int32_t(TILE_WIDTH) - 1;
+	const int32_t tileY1 = tileY0 + int32_t(TILE_HEIGHT) - 1;
+	const floatx8 centerOffsets = pixelCenterOffsets();
+	const floatx8 zero(0.0f);
+
+	for (uint32_t triIndex : bin) {
+		const ScreenTriangle& tri = mTriangles[triIndex];
+		const int32_t xBegin = std::max(tri.minX, tileX0) & ~7;
+		const int32_t xEnd = std::min(tri.maxX, tileX1);
+		const int32_t yBegin = std::max(tri.minY, tileY0);
+		const int32_t yEnd = std::min(tri.maxY, tileY1);
+
+		const floatx8 edgeA0(tri.edgeA[0]), edgeA1(tri.edgeA[1]), edgeA2(tri.edgeA[2]);
+		const floatx8 depthA(tri.depthA);
+		for (int32_t y = yBegin; y <= yEnd; y++) {
+			const float py = float(y) + 0.5f;
+			const floatx8 rowEdge0(tri.edgeB[0] * py + tri.edgeC[0]);
+			const floatx8 rowEdge1(tri.edgeB[1] * py + tri.edgeC[1]);
+			const floatx8 rowEdge2(tri.edgeB[2] * py + tri.edgeC[2]);
+			const floatx8 rowDepth(tri.depthB * py + tri.depthC);
+			float* row = mDepth.data() + y * int32_t(mWidth);
+
+			for (int32_t x = xBegin; x <= xEnd; x += 8) {
+				const floatx8 px = floatx8(float(x)) + centerOffsets;
+				const LaneMask inside = greaterThanEqual(edgeA0 * px + rowEdge0, zero)
+				                      & greaterThanEqual(edgeA1 * px + rowEdge1, zero)
+				                      & greaterThanEqual(edgeA2 * px + rowEdge2, zero);
+				if (!anyLane(inside)) continue;
+				const floatx8 oldDepth(row + x);
+				const floatx8 newDepth = min(oldDepth, depthA * px + rowDepth);
+				storePacket(select(inside, newDepth, oldDepth), row + x);
+			}
+		}
+	}
+	bin.clear();
+
+	// Update the max depth of the tile used to early out in testAABB()
+	floatx8 maxDepth(-FAR_DEPTH);
+	for (int32_t y = tileY0; y <= tileY1; y++) {
+		const float* row = mDepth.data() + y * int32_t(mWidth);
+		for (int32_t x = tileX0; x <= tileX1; x += 8) {
+			maxDepth = max(maxDepth, floatx8(row + x));
+		}
+	}
+	mTileMaxDepth[tileIndex] = horizontalMax(maxDepth);
+}
+
+} // namespace sfz
@@ -0,0 +1,183 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/geometry/Sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/GJK.hpp"
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static mat3 rotationPart(const mat4& transform) noexcept
+{
+	mat3 rot;
+	for (uint32_t i = 0; i < 3; i++) {
+		for (uint32_t j = 0; j < 3; j++) {
+			rot.at(i, j) = transform.at(i, j);
+		}
+	}
+	return rot;
+}
+
+/// Extracts the axis and angle (in [0, pi]) of a rotation matrix
+static void toAxisAngle(const mat3& rot, vec3& axisOut, float& angleOut) noexcept
+{
+	// The antisymmetric part is 2 * sin(angle) * axis, atan2 is accurate for all angles unlike acos
+	const vec3 antisym(rot.at(2, 1) - rot.at(1, 2), rot.at(0, 2) - rot.at(2, 0), rot.at(1, 0) - rot.at(0, 1));
+	const float sinAngle = 0.5f * length(antisym);
+	const float cosAngle = 0.5f * (rot.at(0, 0) + rot.at(1, 1) + rot.at(2, 2) - 1.0f);
+	angleOut = std::atan2(sinAngle, cosAngle);
+
+	if (angleOut < 1e-6f) {
+		axisOut = vec3(1.0f, 0.0f, 0.0f);
+		angleOut = 0.0f;
+		return;
+	}
+
+	// The antisymmetric part vanishes close to pi, use the symmetric part instead. Column k of
+	// R + R^T - 2 * cos(angle) * I is 2 * (1 - cos(angle)) * a[k] * a, the sign is taken from the
+	// antisymmetric part.
+	if (sinAngle < 1e-3f) {
+		uint32_t k = 0;
+		if (rot.at(1, 1) > rot.at(k, k)) k = 1;
+		if (rot.at(2, 2) > rot.at(k, k)) k = 2;
+		vec3 column = rot.columnAt(k) + rot.rowAt(k);
+		column[k] = 2.0f * (rot.at(k, k) - cosAngle);
+		axisOut = normalize(column);
+		if (dot(axisOut, antisym) < 0.0f) axisOut = -axisOut;
+		return;
+	}
+
+	axisOut = antisym / (2.0f * sinAngle);
+}
+
+// SweptShape: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+SweptShape::SweptShape(const ConvexShape& localShape, const mat4& prevTransform,
+                       const mat4& transform, float tolerance) noexcept
+:
+	mLocalShape(&localShape),
+	mTolerance(tolerance)
+{
+	sfz_assert_debug(tolerance >= 0.0f);
+
+	mStartRotation = rotationPart(prevTransform);
+	mStartPos = translation(prevTransform);
+	mLinearMotion = translation(transform) - mStartPos;
+	toAxisAngle(rotationPart(transform) * transpose(mStartRotation), mRotationAxis, mRotationAngle);
+
+	// Bound the shape by its local AABB, found with the support function along the axes
+	vec3 maxAbs(0.0f);
+	for (uint32_t i = 0; i < 3; i++) {
+		vec3 dir(0.0f);
+		dir[i] = 1.0f;
+		maxAbs[i] = std::max(std::abs(localShape.support(dir)[i]), std::abs(localShape.support(-dir)[i]));
+	}
+	mRadius = length(maxAbs);
+}
+
+// SweptShape: Public methods
+// ------------------------------------------------------------------------------------------------
+
+mat4 SweptShape::transformAt(float t) const noexcept
+{
+	const mat3 rot = rotationMatrix3(mRotationAxis, mRotationAngle * t) * mStartRotation;
+	const vec3 pos = mStartPos + mLinearMotion * t;
+	mat4 result = identityMatrix4<float>();
+	for (uint32_t i = 0; i < 3; i++) {
+		for (uint32_t j = 0; j < 3; j++) {
+			result.at(i, j) = rot.at(i, j);
+		}
+	}
+	translation(result, pos);
+	return result;
+}
+
+AABB SweptShape::bounds() const noexcept
+{
+	// The shape stays within mRadius of its origin, which moves along a straight line
+	const vec3 endPos = mStartPos + mLinearMotion;
+	return AABB(sfz::min(mStartPos, endPos) - vec3(mRadius), sfz::max(mStartPos, endPos) + vec3(mRadius));
+}
+
+SweepHit SweptShape::sweep(const ConvexShape& staticShape, float maxToi) const noexcept
+{
+	SweepHit hit;
+	GJKSimplex simplex;
+	vec3 lastNormal = vec3(0.0f);
+	float t = 0.0f;
+
+	for (uint32_t iter = 0; iter < MAX_ITERATIONS; iter++) {
+		const TransformedShape shape(*mLocalShape, transformAt(t));
+		const GJKResult result = gjkDistance(shape, staticShape, simplex);
+
+		if (result.intersecting) {
+			// Only happens at the start of the motion, or when rounding errors moved us past the
+			// tolerance. The contact from the previous step is only used if EPA fails, since the
+			// shapes may have moved a long way since then.
+			hit.toi = t;
+			hit.normal = lastNormal;
+			const Penetration pen = epaPenetration(shape, staticShape, simplex);
+			if (pen.valid) {
+				hit.point = pen.pointB;
+				hit.normal = -pen.normal;
+			}
+			return hit;
+		}
+
+		// Normal from the static shape towards the moving shape
+		hit.point = result.pointB;
+		if (result.distance > 0.0f) lastNormal = (result.pointA - result.pointB) / result.distance;
+		if (result.distance <= mTolerance) break;
+
+		// Upper bound of how fast any point of the moving shape approaches the static shape along
+		// the normal, the rotation moves points at most mRotationAngle * mRadius
+		const float approachSpeed = -dot(mLinearMotion, lastNormal) + mRotationAngle * mRadius;
+		if (approachSpeed <= 0.0f) return SweepHit();
+
+		// Aim for half the tolerance so that the next step ends up touching but not intersecting
+		t += (result.distance - 0.5f * mTolerance) / approachSpeed;
+		if (t > maxToi) return SweepHit();
+	}
+
+	// Within tolerance, or out of iterations in which case the contact from the last step is used
+	hit.toi = t;
+	hit.normal = lastNormal;
+	return hit;
+}
+
+// Sweep functions
+// ------------------------------------------------------------------------------------------------
+
+SweepHit sweep(const ConvexShape& localShape, const mat4& prevTransform, const mat4& transform,
+               const ConvexShape& staticShape) noexcept
+{
+	return SweptShape(localShape, prevTransform, transform).sweep(staticShape);
+}
+
+} // namespace sfz
@@ -0,0 +1,186 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/geometry/TriangleBVH.hpp"
+
+#include <algorithm>
+
+#include "sfz/Assert.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+namespace sfz {
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+/// The bounds of each triangle, flat triangles get slightly padded bounds since AABB requires
+/// min < max
+static DynArray<AABB> triangleBounds(const vec3* positions, const uint32_t* indices,
+                                     uint32_t numTriangles) noexcept
+{
+	DynArray<AABB> bounds(0, numTriangles);
+	for (uint32_t i = 0; i < numTriangles; i++) {
+		const vec3 v0 = positions[indices[i * 3]];
+		const vec3 v1 = positions[indices[i * 3 + 1]];
+		const vec3 v2 = positions[indices[i * 3 + 2]];
+		const vec3 minPos = sfz::min(sfz::min(v0, v1), v2);
+		const vec3 maxPos = sfz::max(sfz::max(v0, v1), v2);
+		const vec3 pad = sfz::max((maxPos - minPos) * 1e-4f, vec3(1e-6f)) + abs(minPos) * 1e-6f;
+		bounds.add(AABB(minPos - pad, maxPos + pad));
+	}
+	return bounds;
+}
+
+// TriangleBVH: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+TriangleBVH::TriangleBVH(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+                         uint32_t numThreads) noexcept
+{
+	this->build(positions, indices, numIndices, numThreads);
+}
+
+// TriangleBVH: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void TriangleBVH::build(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+                        uint32_t numThreads) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	this->clear();
+	const uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0) return;
+
+	DynArray<AABB> bounds = triangleBounds(positions, indices, numTriangles);
+	mBVH.build(bounds.data(), numTriangles, numThreads);
+	copyVerticesInLeafOrder(positions, indices);
+}
+
+bool TriangleBVH::restore(const vec3* positions, const uint32_t* indices, uint32_t numIndices,
+                          const BVHNode* nodes, uint32_t numNodes,
+                          const uint32_t* primitiveIndices) noexcept
+{
+	sfz_assert_debug((numIndices % 3) == 0);
+	this->clear();
+	const uint32_t numTriangles = numIndices / 3;
+	if (numTriangles == 0) return numNodes == 0;
+
+	DynArray<AABB> bounds = triangleBounds(positions, indices, numTriangles);
+	if (!mBVH.restore(bounds.data(), numTriangles, nodes, numNodes, primitiveIndices)) return false;
+	copyVerticesInLeafOrder(positions, indices);
+	return true;
+}
+
+void TriangleBVH::clear() noexcept
+{
+	mBVH = BVH();
+	mV0X.clear(); mV0Y.clear(); mV0Z.clear();
+	mV1X.clear(); mV1Y.clear(); mV1Z.clear();
+	mV2X.clear(); mV2Y.clear(); mV2Z.clear();
+}
+
+RayHit TriangleBVH::raycast(const Ray& ray) const noexcept
+{
+	static_assert(BVH::MAX_LEAF_SIZE <= 4, "Leaves must fit in one packet");
+
+	RayHit hit;
+	uint32_t closestLeafPos = ~0u;
+	const vec3x4 origin(ray.origin());
+	const vec3x4 dir(ray.dir());
+
+	hit.dist = mBVH.raycastClosest(ray, [&](uint32_t first, uint32_t count, float maxDist) {
+		const vec3x4 v0 = loadSoA<4>(mV0X.data() + first, mV0Y.data() + first, mV0Z.data() + first);
+		const vec3x4 v1 = loadSoA<4>(mV1X.data() + first, mV1Y.data() + first, mV1Z.data() + first);
+		const vec3x4 v2 = loadSoA<4>(mV2X.data() + first, mV2Y.data() + first, mV2Z.data() + first);
+		floatx4 dists = detail::raycastTriangles<4>(origin, dir, floatx4(maxDist), v0, v1, v2);
+
+		// Lanes past the end of the leaf belong to other leaves (or padding)
+		const LaneMask inLeaf = (LaneMask(1) << count) - LaneMask(1);
+		dists = select(inLeaf, dists, floatx4(RAY_MISS));
+
+		const float closest = horizontalMin(dists);
+		if (closest == RAY_MISS) return RAY_MISS;
+		for (uint32_t i = 0; i < count; i++) {
+			if (dists[i] == closest) {
+				closestLeafPos = first + i;
+				break;
+			}
+		}
+		return closest;
+	});
+	if (!hit.isHit()) return hit;
+
+	// Compute barycentrics for the closest triangle only
+	sfz_assert_debug(closestLeafPos != ~0u);
+	hit.triangleIndex = mBVH.primitiveIndices()[closestLeafPos];
+	const uint32_t i = closestLeafPos;
+	sfz::raycast(Ray(ray.origin(), ray.dir()), vec3(mV0X[i], mV0Y[i], mV0Z[i]),
+	             vec3(mV1X[i], mV1Y[i], mV1Z[i]), vec3(mV2X[i], mV2Y[i], mV2Z[i]), hit.uv);
+	return hit;
+}
+
+SweepHit TriangleBVH::sweep(const SweptShape& swept) const noexcept
+{
+	SweepHit closest;
+	const AABB bounds = swept.bounds();
+	const DynArray<AABB>& primBounds = mBVH.primitiveBounds();
+
+	mBVH.forEachLeafOverlapping(bounds, [&](uint32_t first, uint32_t count) {
+		for (uint32_t i = first; i < (first + count); i++) {
+			if (!intersects(bounds, primBounds[i])) continue;
+			const vec3 triangle[3] = { vec3(mV0X[i], mV0Y[i], mV0Z[i]),
+			                           vec3(mV1X[i], mV1Y[i], mV1Z[i]),
+			                           vec3(mV2X[i], mV2Y[i], mV2Z[i]) };
+			const SweepHit hit = swept.sweep(ConvexHullShape(triangle, 3),
+			                                 closest.isHit() ? closest.toi : 1.0f);
+			if (hit.isHit() && (!closest.isHit() || hit.toi < closest.toi)) {
+				closest = hit;
+				closest.triangleIndex = mBVH.primitiveIndices()[i];
+			}
+		}
+	});
+	return closest;
+}
+
+// TriangleBVH: Private methods
+// ------------------------------------------------------------------------------------------------
+
+void TriangleBVH::copyVerticesInLeafOrder(const vec3* positions, const uint32_t* indices) noexcept
+{
+	const uint32_t numTriangles = mBVH.numPrimitives();
+	const uint32_t paddedSize = numTriangles + 3;
+	DynArray<float>* arrays[9] = { &mV0X, &mV0Y, &mV0Z, &mV1X, &mV1Y, &mV1Z, &mV2X, &mV2Y, &mV2Z };
+	for (DynArray<float>* arr : arrays) {
+		arr->ensureCapacity(paddedSize);
+		arr->setSize(paddedSize);
+	}
+	const DynArray<uint32_t>& primIndices = mBVH.primitiveIndices();
+	for (uint32_t i = 0; i < paddedSize; i++) {
+		const uint32_t tri = primIndices[std::min(i, numTriangles - 1)];
+		const vec3 v0 = positions[indices[tri * 3]];
+		const vec3 v1 = positions[indices[tri * 3 + 1]];
+		const vec3 v2 = positions[indices[tri * 3 + 2]];
+		mV0X[i] = v0.x; mV0Y[i] = v0.y; mV0Z[i] = v0.z;
+		mV1X[i] = v1.x; mV1Y[i] = v1.y; mV1Z[i] = v1.z;
+		mV2X[i] = v2.x; mV2Y[i] = v2.y; mV2Z[i] = v2.z;
+	}
+}
+
+} // namespace sfz
@@ -18,10 +18,14 @@
 
 #include "sfz/geometry/ViewFrustum.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <sfz/geometry/AABB.hpp>
 #include <sfz/geometry/Intersection.hpp>
 #include <sfz/geometry/OBB.hpp>
 #include <sfz/geometry/Sphere.hpp>
+#include <sfz/math/VectorPacket.hpp>
 
 namespace sfz {
 
@@ -39,6 +43,60 @@ static OBB obbApproximation(const ViewFrustum& frustum) noexcept
 	           frustum.far() * tanf(xHalfRadAngle) * 2.0f, frustum.far() * tanf(yHalfRadAngle) * 2.0f, nearMFar};
 }
 
+/// Creates a plane from a row combination of a clip matrix (Gribb/Hartmann). The combination
+/// describes the half-space dot(p.xyz, x) + p.w >= 0 that is inside the frustum, so the sfz Plane
+/// normal (pointing out of the frustum) is its negation.
+static Plane planeFromClipRows(const vec4& row3, const vec4& row, float sign) noexcept
+{
+	const vec4 p = row3 + sign * row;
+	const float invLength = 1.0f / length(p.xyz);
+	return Plane{-p.xyz * invLength, p.w * invLength};
+}
+
+/// Calculates the 8 world space corners of the frustum described by a clip matrix
+static void frustumCorners(const mat4& clipMatrix, vec3* cornersOut) noexcept
+{
+	const mat4 invClipMatrix = inverse(clipMatrix);
+	size_t i = 0;
+	for (float z : { -1.0f, 1.0f }) {
+		for (float y : { -1.0f, 1.0f }) {
+			for (float x : { -1.0f, 1.0f }) {
+				vec4 corner = invClipMatrix * vec4(x, y, z, 1.0f);
+				cornersOut[i++] = corner.xyz / corner[3];
+			}
+		}
+	}
+}
+
+/// Returns the angle in degrees spanned by two outward facing frustum plane normals
+static float spannedAngleDeg(const vec3& normalA, const vec3& normalB) noexcept
+{
+	const float cosAngle = std::max(-1.0f, std::min(1.0f, dot(normalA, normalB)));
+	return 180.0f - std::acos(cosAngle) * RAD_TO_DEG();
+}
+
+static const size_t CULL_PACKET_WIDTH = 8;
+
+/// Loads count (<= 8) floats into a packet, remaining lanes are set to 0
+static floatx8 loadPartial(const float* arrayPtr, size_t count) noexcept
+{
+	if (count == CULL_PACKET_WIDTH) return floatx8(arrayPtr);
+	floatx8 packet(0.0f);
+	for (size_t i = 0; i < count; i++) {
+		packet.lanes[i] = arrayPtr[i];
+	}
+	return packet;
+}
+
+/// Writes the lane mask of the packet starting at object index packetStart into the bitmask
+static void writePacketMask(uint32_t* visibleMaskOut, size_t packetStart, LaneMask mask) noexcept
+{
+	const size_t word = packetStart / 32;
+	const size_t shift = packetStart % 32;
+	if (shift == 0) visibleMaskOut[word] = 0;
+	visibleMaskOut[word] |= (uint32_t(mask) << shift);
+}
+
 // ViewFrustum: Constructors & destructors
 // ------------------------------------------------------------------------------------------------
 
@@ -48,6 +106,70 @@ ViewFrustum::ViewFrustum(vec3 position, vec3 direction, vec3 up, float verticalF
 	this->set(position, direction, up, verticalFovDeg, aspect, near, far);
 }
 
+ViewFrustum::ViewFrustum(const mat4& viewMatrix, const mat4& projMatrix) noexcept
+{
+	mViewMatrix = viewMatrix;
+	mProjMatrix = projMatrix;
+
+	const mat4 clipMatrix = projMatrix * viewMatrix;
+	const vec4 row0 = clipMatrix.rowAt(0);
+	const vec4 row1 = clipMatrix.rowAt(1);
+	const vec4 row2 = clipMatrix.rowAt(2);
+	const vec4 row3 = clipMatrix.rowAt(3);
+	mLeftPlane = planeFromClipRows(row3, row0, 1.0f);
+	mRightPlane = planeFromClipRows(row3, row0, -1.0f);
+	mDownPlane = planeFromClipRows(row3, row1, 1.0f);
+	mUpPlane = planeFromClipRows(row3, row1, -1.0f);
+	mNearPlane = planeFromClipRows(row3, row2, 1.0f);
+	mFarPlane = planeFromClipRows(row3, row2, -1.0f);
+
+	// OpenGL convention, camera looks down negative z in view space
+	const mat4 invViewMatrix = inverse(viewMatrix);
+	mPos = invViewMatrix.columnAt(3).xyz;
+	mDir = normalize(-invViewMatrix.columnAt(2).xyz);
+	mUp = normalize(invViewMatrix.columnAt(1).xyz);
+
+	updateParamsFromPlanes();
+}
+
+ViewFrustum ViewFrustum::combinedStereo(const mat4& leftViewMatrix, const mat4& leftProjMatrix,
+                                        const mat4& rightViewMatrix, const mat4& rightProjMatrix) noexcept
+{
+	const ViewFrustum left(leftViewMatrix, leftProjMatrix);
+	const ViewFrustum right(rightViewMatrix, rightProjMatrix);
+
+	vec3 corners[16];
+	frustumCorners(leftProjMatrix * leftViewMatrix, corners);
+	frustumCorners(rightProjMatrix * rightViewMatrix, corners + 8);
+
+	// Plane with the specified normal that has all corners of both frustums on its inside
+	auto enclosingPlane = [&](vec3 normal) {
+		normal = normalize(normal);
+		float d = dot(normal, corners[0]);
+		for (const vec3& corner : corners) {
+			d = std::max(d, dot(normal, corner));
+		}
+		return Plane{normal, d};
+	};
+
+	ViewFrustum combined;
+	combined.mPos = (left.mPos + right.mPos) / 2.0f;
+	combined.mDir = normalize(left.mDir + right.mDir);
+	const vec3 up = left.mUp + right.mUp;
+	combined.mUp = normalize(up - dot(up, combined.mDir) * combined.mDir);
+
+	combined.mLeftPlane = enclosingPlane(left.mLeftPlane.normal());
+	combined.mRightPlane = enclosingPlane(right.mRightPlane.normal());
+	combined.mUpPlane = enclosingPlane(left.mUpPlane.normal() + right.mUpPlane.normal());
+	combined.mDownPlane = enclosingPlane(left.mDownPlane.normal() + right.mDownPlane.normal());
+	combined.mNearPlane = enclosingPlane(left.mNearPlane.normal() + right.mNearPlane.normal());
+	combined.mFarPlane = enclosingPlane(left.mFarPlane.normal() + right.mFarPlane.normal());
+
+	combined.updateParamsFromPlanes();
+	combined.updateMatrices();
+	return combined;
+}
+
 // ViewFrustum: Public methods
 // ------------------------------------------------------------------------------------------------
 
@@ -82,6 +204,61 @@ bool ViewFrustum::isVisible(const ViewFrustum& viewFrustum) const noexcept
 	return this->isVisible(approx);
 }
 
+// ViewFrustum: Public methods (batch)
+// ------------------------------------------------------------------------------------------------
+
+void ViewFrustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+                              const float* radius, size_t count, uint32_t* visibleMaskOut) const noexcept
+{
+	const Plane* planes[6] = { &mLeftPlane, &mRightPlane, &mNearPlane, &mFarPlane, &mUpPlane, &mDownPlane };
+
+	for (size_t i = 0; i < count; i += CULL_PACKET_WIDTH) {
+		const size_t numInPacket = std::min(CULL_PACKET_WIDTH, count - i);
+		const vec3x8 center{loadPartial(centerX + i, numInPacket),
+		                    loadPartial(centerY + i, numInPacket),
+		                    loadPartial(centerZ + i, numInPacket)};
+		const floatx8 rad = loadPartial(radius + i, numInPacket);
+
+		LaneMask visible = (LaneMask(1) << numInPacket) - LaneMask(1);
+		for (const Plane* plane : planes) {
+			floatx8 dist = dot(center, plane->normal()) - floatx8(plane->d());
+			visible &= lessThanEqual(dist, rad);
+			if (visible == 0) break;
+		}
+		writePacketMask(visibleMaskOut, i, visible);
+	}
+}
+
+void ViewFrustum::cullAABBs(const float* minX, const float* minY, const float* minZ,
+                            const float* maxX, const float* maxY, const float* maxZ,
+                            size_t count, uint32_t* visibleMaskOut) const noexcept
+{
+	const Plane* planes[6] = { &mLeftPlane, &mRightPlane, &mNearPlane, &mFarPlane, &mUpPlane, &mDownPlane };
+
+	for (size_t i = 0; i < count; i += CULL_PACKET_WIDTH) {
+		const size_t numInPacket = std::min(CULL_PACKET_WIDTH, count - i);
+		const vec3x8 min{loadPartial(minX + i, numInPacket),
+		                 loadPartial(minY + i, numInPacket),
+		                 loadPartial(minZ + i, numInPacket)};
+		const vec3x8 max{loadPartial(maxX + i, numInPacket),
+		                 loadPartial(maxY + i, numInPacket),
+		                 loadPartial(maxZ + i, numInPacket)};
+		const vec3x8 center = (min + max) * 0.5f;
+		const vec3x8 halfExtents = (max - min) * 0.5f;
+
+		LaneMask visible = (LaneMask(1) << numInPacket) - LaneMask(1);
+		for (const Plane* plane : planes) {
+			// Same projected radius test as belowPlane(const Plane&, const AABB&)
+			const vec3 n = plane->normal();
+			floatx8 projectedRadius = dot(halfExtents, abs(n));
+			floatx8 dist = dot(center, n) - floatx8(plane->d());
+			visible &= lessThanEqual(dist, projectedRadius);
+			if (visible == 0) break;
+		}
+		writePacketMask(visibleMaskOut, i, visible);
+	}
+}
+
 // ViewFrustum: Setters
 // ------------------------------------------------------------------------------------------------
 
@@ -185,4 +362,15 @@ void ViewFrustum::updatePlanes() noexcept
 	mLeftPlane = Plane{leftPlaneNormal, mPos};
 }
 
-} // namespace sfz
\ No newline at end of file
+void ViewFrustum::updateParamsFromPlanes() noexcept
+{
+	mNear = mNearPlane.signedDistance(mPos);
+	mFar = -mFarPlane.signedDistance(mPos);
+	mVerticalFovDeg = spannedAngleDeg(mUpPlane.normal(), mDownPlane.normal());
+	// Aspect ratio is defined as the ratio between the horizontal and vertical angle, see updatePlanes()
+	mAspectRatio = spannedAngleDeg(mLeftPlane.normal(), mRightPlane.normal()) / mVerticalFovDeg;
+	sfz_assert_debug(0.0f < mNear);
+	sfz_assert_debug(mNear < mFar);
+}
+
+} // namespace sfz
@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include "sfz/gl/IncludeOpenGL.hpp"
+#include "sfz/math/Vector.hpp"
 
 namespace sfz {
 
@@ -28,41 +29,48 @@ namespace gl {
 
 using std::int32_t;
 
+// Static data
+// ------------------------------------------------------------------------------------------------
+
+static constexpr vec3 POSITIONS[] = {
+	vec3(-1.0f, -1.0f, 0.0f), // bottom-left
+	vec3(1.0f, -1.0f, 0.0f), // bottom-right
+	vec3(-1.0f, 1.0f, 0.0f), // top-left
+	vec3(1.0f, 1.0f, 0.0f) // top-right
+};
+
+static constexpr vec2 UV_COORDS[] = {
+	vec2(0.0f, 0.0f), // bottom-left
+	vec2(1.0f, 0.0f), // bottom-right
+	vec2(0.0f, 1.0f), // top-left
+	vec2(1.0f, 1.0f) // top-right
+};
+
+static constexpr unsigned int INDICES[] = {
+	0, 1, 2,
+	1, 3, 2
+};
+
+static_assert(sizeof(POSITIONS) == sizeof(float) * 12, "Positions are padded");
+static_assert(sizeof(UV_COORDS) == sizeof(float) * 8, "UV coordinates are padded");
+
+// FullscreenQuad
+// ------------------------------------------------------------------------------------------------
+
 FullscreenQuad::FullscreenQuad() noexcept
 {
-	const float positions[] = {
-		-1.0f, -1.0f, 0.0f, // bottom-left
-		1.0f, -1.0f, 0.0f, // bottom-right
-		-1.0f, 1.0f, 0.0f, // top-left
-		1.0f, 1.0f, 0.0f // top-right
-	};
-	const float uvCoords[] = {
-		// bottom-left UV
-		0.0f, 0.0f,
-		// bottom-right UV
-		1.0f, 0.0f,
-		// top-left UV
-		0.0f, 1.0f,
-		// top-right UV
-		1.0f, 1.0f
-	};
-	const unsigned int indices[] = {
-		0, 1, 2,
-		1, 3, 2
-	};
-
 	// Buffer objects
 	glGenBuffers(1, &mPosBuffer);
 	glBindBuffer(GL_ARRAY_BUFFER, mPosBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(POSITIONS), POSITIONS, GL_STATIC_DRAW);
 
 	glGenBuffers(1, &mUVBuffer);
 	glBindBuffer(GL_ARRAY_BUFFER, mUVBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(uvCoords), uvCoords, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(UV_COORDS), UV_COORDS, GL_STATIC_DRAW);
 
 	glGenBuffers(1, &mIndexBuffer);
 	glBindBuffer(GL_ARRAY_BUFFER, mIndexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(INDICES), INDICES, GL_STATIC_DRAW);
 
 	// Vertex Array Object
 	glGenVertexArrays(1, &mVAO);
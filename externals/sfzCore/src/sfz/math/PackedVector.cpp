@@ -0,0 +1,337 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/math/PackedVector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace sfz {
+
+using std::uint32_t;
+
+// Static functions
+// ------------------------------------------------------------------------------------------------
+
+static inline uint32_t floatBits(float value) noexcept
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+	return bits;
+}
+
+static inline float bitsToFloat(uint32_t bits) noexcept
+{
+	float value;
+	std::memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+static inline float clampFloat(float value, float minVal, float maxVal) noexcept
+{
+	return std::min(std::max(value, minVal), maxVal);
+}
+
+static inline uint16_t floatToHalfImpl(float value) noexcept
+{
+	// Based on "float_to_half_fast3_rtne" by Fabian Giesen (public domain)
+	const uint32_t F32_INFINITY = 255u << 23;
+	const uint32_t F16_MAX = (127u + 16u) << 23;
+	const uint32_t DENORM_MAGIC = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+	uint32_t bits = floatBits(value);
+	const uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint32_t result;
+	if (bits >= F16_MAX) {
+		// Inf or NaN (all exponent bits set), NaN->qNaN and Inf->Inf
+		result = (bits > F32_INFINITY) ? 0x7E00u : 0x7C00u;
+	}
+	else if (bits < (113u << 23)) {
+		// Resulting half is a denormal or zero, use a magic value to align the mantissa and
+		// let the floating point addition do the rounding.
+		float tmp = bitsToFloat(bits) + bitsToFloat(DENORM_MAGIC);
+		result = floatBits(tmp) - DENORM_MAGIC;
+	}
+	else {
+		// Normalized number, rebias exponent and round to nearest even
+		const uint32_t mantissaOdd = (bits >> 13) & 1u;
+		bits += (uint32_t(15 - 127) << 23) + 0xFFFu;
+		bits += mantissaOdd;
+		result = bits >> 13;
+	}
+	return uint16_t(result | (sign >> 16));
+}
+
+static inline float halfToFloatImpl(uint16_t value) noexcept
+{
+	// Based on "half_to_float" by Fabian Giesen (public domain)
+	const uint32_t SHIFTED_EXP = 0x7C00u << 13;
+	const float MAGIC = bitsToFloat(113u << 23);
+
+	uint32_t bits = uint32_t(value & 0x7FFFu) << 13;
+	const uint32_t exponent = bits & SHIFTED_EXP;
+	bits += (127u - 15u) << 23;
+
+	if (exponent == SHIFTED_EXP) {
+		// Inf or NaN, extra exponent adjust
+		bits += (128u - 16u) << 23;
+	}
+	else if (exponent == 0) {
+		// Zero or denormal, renormalize
+		bits += 1u << 23;
+		bits = floatBits(bitsToFloat(bits) - MAGIC);
+	}
+	return bitsToFloat(bits | (uint32_t(value & 0x8000u) << 16));
+}
+
+static inline uint16_t floatToUnorm16Impl(float value) noexcept
+{
+	return uint16_t(clampFloat(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+static inline float unorm16ToFloatImpl(uint16_t value) noexcept
+{
+	return float(value) * (1.0f / 65535.0f);
+}
+
+static inline int16_t floatToSnorm16Impl(float value) noexcept
+{
+	float scaled = clampFloat(value, -1.0f, 1.0f) * 32767.0f;
+	return int16_t(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+}
+
+static inline float snorm16ToFloatImpl(int16_t value) noexcept
+{
+	// -32768 and -32767 both map to -1.0
+	return std::max(float(value) * (1.0f / 32767.0f), -1.0f);
+}
+
+static inline float signNotZero(float value) noexcept
+{
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+static inline snorm16x2 packOctNormalImpl(const vec3& normal) noexcept
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower hemisphere over
+	// the upper one.
+	float invL1Norm = 1.0f / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+	float x = normal.x * invL1Norm;
+	float y = normal.y * invL1Norm;
+	if (normal.z < 0.0f) {
+		float tmpX = (1.0f - std::abs(y)) * signNotZero(x);
+		float tmpY = (1.0f - std::abs(x)) * signNotZero(y);
+		x = tmpX;
+		y = tmpY;
+	}
+	snorm16x2 tmp;
+	tmp.elements[0] = floatToSnorm16Impl(x);
+	tmp.elements[1] = floatToSnorm16Impl(y);
+	return tmp;
+}
+
+static inline vec3 unpackOctNormalImpl(const snorm16x2& packed) noexcept
+{
+	float x = snorm16ToFloatImpl(packed.elements[0]);
+	float y = snorm16ToFloatImpl(packed.elements[1]);
+	float z = 1.0f - std::abs(x) - std::abs(y);
+
+	// Unfold lower hemisphere, t is 0 for the upper hemisphere
+	float t = std::max(-z, 0.0f);
+	x += (x >= 0.0f) ? -t : t;
+	y += (y >= 0.0f) ? -t : t;
+
+	float invLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+	return vec3(x * invLength, y * invLength, z * invLength);
+}
+
+static inline vec3 quantizationScale(const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	vec3 extent = boundsMax - boundsMin;
+	vec3 scale;
+	for (size_t i = 0; i < 3; i++) {
+		scale[i] = extent[i] > 0.0f ? (1.0f / extent[i]) : 0.0f;
+	}
+	return scale;
+}
+
+static inline unorm16x3 quantizePositionImpl(const vec3& position, const vec3& boundsMin,
+                                             const vec3& scale) noexcept
+{
+	unorm16x3 tmp;
+	tmp.elements[0] = floatToUnorm16Impl((position.x - boundsMin.x) * scale.x);
+	tmp.elements[1] = floatToUnorm16Impl((position.y - boundsMin.y) * scale.y);
+	tmp.elements[2] = floatToUnorm16Impl((position.z - boundsMin.z) * scale.z);
+	return tmp;
+}
+
+static inline vec3 dequantizePositionImpl(const unorm16x3& packed, const vec3& boundsMin,
+                                          const vec3& extent) noexcept
+{
+	return vec3(boundsMin.x + unorm16ToFloatImpl(packed.elements[0]) * extent.x,
+	            boundsMin.y + unorm16ToFloatImpl(packed.elements[1]) * extent.y,
+	            boundsMin.z + unorm16ToFloatImpl(packed.elements[2]) * extent.z);
+}
+
+// Scalar conversion functions
+// ------------------------------------------------------------------------------------------------
+
+uint16_t floatToHalf(float value) noexcept
+{
+	return floatToHalfImpl(value);
+}
+
+float halfToFloat(uint16_t value) noexcept
+{
+	return halfToFloatImpl(value);
+}
+
+uint16_t floatToUnorm16(float value) noexcept
+{
+	return floatToUnorm16Impl(value);
+}
+
+float unorm16ToFloat(uint16_t value) noexcept
+{
+	return unorm16ToFloatImpl(value);
+}
+
+int16_t floatToSnorm16(float value) noexcept
+{
+	return floatToSnorm16Impl(value);
+}
+
+float snorm16ToFloat(int16_t value) noexcept
+{
+	return snorm16ToFloatImpl(value);
+}
+
+// Vector packing functions
+// ------------------------------------------------------------------------------------------------
+
+snorm16x2 packOctNormal(const vec3& normal) noexcept
+{
+	return packOctNormalImpl(normal);
+}
+
+vec3 unpackOctNormal(const snorm16x2& packed) noexcept
+{
+	return unpackOctNormalImpl(packed);
+}
+
+unorm16x3 quantizePosition(const vec3& position, const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	return quantizePositionImpl(position, boundsMin, quantizationScale(boundsMin, boundsMax));
+}
+
+vec3 dequantizePosition(const unorm16x3& packed, const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	return dequantizePositionImpl(packed, boundsMin, boundsMax - boundsMin);
+}
+
+// Batch kernels
+// ------------------------------------------------------------------------------------------------
+
+// Scalar loops, see the comment at the top of PackedVector.hpp
+
+void packHalf(const float* src, uint16_t* dst, size_t count) noexcept
+{
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = floatToHalfImpl(src[i]);
+	}
+}
+
+void unpackHalf(const uint16_t* src, float* dst, size_t count) noexcept
+{
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = halfToFloatImpl(src[i]);
+	}
+}
+
+void packOctNormals(const vec3* src, snorm16x2* dst, size_t count) noexcept
+{
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = packOctNormalImpl(src[i]);
+	}
+}
+
+void unpackOctNormals(const snorm16x2* src, vec3* dst, size_t count) noexcept
+{
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = unpackOctNormalImpl(src[i]);
+	}
+}
+
+void quantizePositions(const vec3* src, unorm16x3* dst, size_t count,
+                       const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	const vec3 scale = quantizationScale(boundsMin, boundsMax);
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = quantizePositionImpl(src[i], boundsMin, scale);
+	}
+}
+
+void dequantizePositions(const unorm16x3* src, vec3* dst, size_t count,
+                         const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	const vec3 extent = boundsMax - boundsMin;
+	for (size_t i = 0; i < count; i++) {
+		dst[i] = dequantizePositionImpl(src[i], boundsMin, extent);
+	}
+}
+
+// Error metrics
+// ------------------------------------------------------------------------------------------------
+
+float maxPositionError(const vec3* original, const vec3* reconstructed, size_t count) noexcept
+{
+	float maxError = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		maxError = std::max(maxError, length(original[i] - reconstructed[i]));
+	}
+	return maxError;
+}
+
+float maxAngularError(const vec3* original, const vec3* reconstructed, size_t count) noexcept
+{
+	// atan2() of the sine and cosine is more accurate than acos() for small angles
+	float maxError = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		vec3 a = normalize(original[i]);
+		vec3 b = normalize(reconstructed[i]);
+		float angle = std::atan2(length(cross(a, b)), dot(a, b));
+		maxError = std::max(maxError, angle);
+	}
+	return maxError;
+}
+
+float maxAbsoluteError(const float* original, const float* reconstructed, size_t count) noexcept
+{
+	float maxError = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		maxError = std::max(maxError, std::abs(original[i] - reconstructed[i]));
+	}
+	return maxError;
+}
+
+} // namespace sfz
@@ -23,6 +23,7 @@
 #include <cstdio> // fopen, fwrite, BUFSIZ
 #include <cstdint>
 #include <cstring>
+#include <utility> // std::swap()
 
 #include <SDL.h>
 
@@ -36,10 +37,16 @@
 #include <direct.h>
 
 #elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #elif defined(__unix)
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 #include "sfz/PopWarnings.hpp"
@@ -241,6 +248,24 @@ int64_t sizeofFile(const char* path) noexcept
 	return size;
 }
 
+int64_t fileModificationTime(const char* path) noexcept
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) return -1;
+
+	// FILETIME is in 100 ns intervals since 1601-01-01
+	ULARGE_INTEGER time;
+	time.LowPart = attributes.ftLastWriteTime.dwLowDateTime;
+	time.HighPart = attributes.ftLastWriteTime.dwHighDateTime;
+	return int64_t(time.QuadPart / 10000000ull) - 11644473600ll;
+#else
+	struct stat status;
+	if (stat(path, &status) != 0) return -1;
+	return int64_t(status.st_mtime);
+#endif
+}
+
 int32_t readBinaryFile(const char* path, uint8_t* dataOut, size_t maxNumBytes) noexcept
 {
 	// Open file
@@ -297,4 +322,85 @@ bool writeBinaryFile(const char* path, const uint8_t* data, size_t numBytes) noe
 	return (numWritten == numBytes);
 }
 
+// MappedFile: Constructors & destructors
+// ------------------------------------------------------------------------------------------------
+
+MappedFile::MappedFile(const char* path) noexcept
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	// The view keeps the file and the mapping alive until it is unmapped
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL) return;
+	const void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (ptr == NULL) return;
+
+	mData = static_cast<const uint8_t*>(ptr);
+	mSize = size_t(size.QuadPart);
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return;
+	struct stat status;
+	if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+		close(fd);
+		return;
+	}
+
+	// The mapping keeps the file alive until it is unmapped
+	void* ptr = mmap(NULL, size_t(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (ptr == MAP_FAILED) return;
+
+	mData = static_cast<const uint8_t*>(ptr);
+	mSize = size_t(status.st_size);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	this->swap(other);
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other) noexcept
+{
+	this->swap(other);
+	return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+	this->destroy();
+}
+
+// MappedFile: Public methods
+// ------------------------------------------------------------------------------------------------
+
+void MappedFile::swap(MappedFile& other) noexcept
+{
+	std::swap(this->mData, other.mData);
+	std::swap(this->mSize, other.mSize);
+}
+
+void MappedFile::destroy() noexcept
+{
+	if (mData == nullptr) return;
+#ifdef _WIN32
+	UnmapViewOfFile(mData);
+#else
+	munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+	mData = nullptr;
+	mSize = 0;
+}
+
 } // namespace sfz
\ No newline at end of file
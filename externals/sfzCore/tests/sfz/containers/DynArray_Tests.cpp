@@ -273,6 +273,15 @@ TEST_CASE("remove()", "[sfz::DynArray]")
 	v.remove(0, 2);
 	REQUIRE(v.size() == 1);
 	REQUIRE(v[0] == 3);
+
+	const int moreVals[] = {4, 5, 6, 7, 8};
+	v.add(moreVals, 5);
+	v.remove(1, 2);
+	REQUIRE(v.size() == 4);
+	REQUIRE(v[0] == 3);
+	REQUIRE(v[1] == 6);
+	REQUIRE(v[2] == 7);
+	REQUIRE(v[3] == 8);
 }
 
 TEST_CASE("find()", "[sfz::DynArray]")
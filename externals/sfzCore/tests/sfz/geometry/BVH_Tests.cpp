@@ -0,0 +1,228 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/BVH.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/Sphere.hpp"
+
+#include "SpatialQueryTestHelpers.hpp"
+
+using namespace sfz;
+
+static std::vector<AABB> randomAABBs(std::mt19937& gen, uint32_t count, float range) noexcept
+{
+	std::uniform_real_distribution<float> posDistr(-range, range);
+	std::uniform_real_distribution<float> sizeDistr(0.1f, 4.0f);
+	std::vector<AABB> aabbs;
+	for (uint32_t i = 0; i < count; i++) {
+		vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+		aabbs.emplace_back(pos, sizeDistr(gen), sizeDistr(gen), sizeDistr(gen));
+	}
+	return aabbs;
+}
+
+static void checkQueries(const BVH& bvh, const std::vector<AABB>& aabbs, std::mt19937& gen) noexcept
+{
+	std::vector<uint32_t> ids(aabbs.size());
+	for (uint32_t i = 0; i < ids.size(); i++) ids[i] = i;
+	checkSpatialQueries(bvh, aabbs, ids, gen, 50.0f, 20);
+
+	std::uniform_real_distribution<float> posDistr(-50.0f, 50.0f);
+	for (int i = 0; i < 5; i++) {
+		vec3 origin(posDistr(gen), posDistr(gen), posDistr(gen));
+		vec3 dir = normalize(vec3(posDistr(gen), posDistr(gen), posDistr(gen)));
+		Ray ray(origin, dir, 60.0f);
+
+		// Closest hit, testing the primitive AABBs themselves in the leaves
+		float closest = RAY_MISS;
+		for (const AABB& a : aabbs) closest = std::min(closest, raycast(ray, a));
+		const DynArray<AABB>& leafBounds = bvh.primitiveBounds();
+		float bvhClosest = bvh.raycastClosest(ray, [&](uint32_t first, uint32_t count, float maxDist) {
+			float leafClosest = RAY_MISS;
+			for (uint32_t j = first; j < first + count; j++) {
+				float dist = raycast(ray, leafBounds[j]);
+				if (dist <= maxDist) leafClosest = std::min(leafClosest, dist);
+			}
+			return leafClosest;
+		});
+		REQUIRE(bvhClosest == closest);
+	}
+}
+
+TEST_CASE("BVH build", "[sfz::BVH]")
+{
+	std::mt19937 gen(1);
+
+	SECTION("Empty and tiny") {
+		BVH empty(nullptr, 0);
+		REQUIRE(empty.nodes().size() == 0);
+		DynArray<uint32_t> result;
+		empty.queryOverlap(AABB(vec3(-1.0f), vec3(1.0f)), result);
+		REQUIRE(result.size() == 0);
+
+		std::vector<AABB> aabbs = randomAABBs(gen, 3, 5.0f);
+		BVH tiny(aabbs.data(), 3);
+		REQUIRE(tiny.nodes().size() == 1);
+		REQUIRE(tiny.nodes()[0].isLeaf(0));
+		REQUIRE(tiny.nodes()[0].isEmpty(1));
+		tiny.queryOverlap(AABB(vec3(-100.0f), vec3(100.0f)), result);
+		REQUIRE(sorted(result) == std::vector<uint32_t>({ 0, 1, 2 }));
+	}
+	SECTION("Structure") {
+		std::vector<AABB> aabbs = randomAABBs(gen, 5000, 50.0f);
+		BVH bvh(aabbs.data(), uint32_t(aabbs.size()));
+		REQUIRE(bvh.numPrimitives() == 5000);
+
+		std::vector<uint32_t> seen(aabbs.size(), 0);
+		for (uint32_t i = 0; i < bvh.nodes().size(); i++) {
+			const BVHNode& node = bvh.nodes()[i];
+			for (uint32_t slot = 0; slot < 4; slot++) {
+				if (node.isInner(slot)) {
+					REQUIRE(node.children[slot] > i);
+				}
+				if (!node.isLeaf(slot)) continue;
+				REQUIRE(node.counts[slot] <= BVH::MAX_LEAF_SIZE);
+				for (uint32_t p = node.children[slot]; p < node.children[slot] + node.counts[slot]; p++) {
+					const AABB& aabb = aabbs[bvh.primitiveIndices()[p]];
+					REQUIRE(node.minX[slot] <= aabb.min()[0]);
+					REQUIRE(node.maxZ[slot] >= aabb.max()[2]);
+					seen[bvh.primitiveIndices()[p]]++;
+				}
+			}
+		}
+		REQUIRE(std::all_of(seen.begin(), seen.end(), [](uint32_t n) { return n == 1; }));
+	}
+	SECTION("Degenerate input") {
+		std::vector<AABB> aabbs(1000, AABB(vec3(1.0f), vec3(2.0f)));
+		BVH bvh(aabbs.data(), uint32_t(aabbs.size()));
+		DynArray<uint32_t> result;
+		bvh.queryOverlap(Sphere(vec3(0.0f), 2.0f), result);
+		REQUIRE(result.size() == 1000);
+	}
+}
+
+TEST_CASE("BVH queries", "[sfz::BVH]")
+{
+	std::mt19937 gen(2);
+	std::vector<AABB> aabbs = randomAABBs(gen, 20000, 50.0f);
+
+	SECTION("Single threaded build") {
+		BVH bvh(aabbs.data(), uint32_t(aabbs.size()));
+		checkQueries(bvh, aabbs, gen);
+	}
+	SECTION("Parallel build") {
+		BVH bvh(aabbs.data(), uint32_t(aabbs.size()), 4);
+		checkQueries(bvh, aabbs, gen);
+	}
+	SECTION("Refit") {
+		BVH bvh(aabbs.data(), uint32_t(aabbs.size()), 2);
+		std::uniform_real_distribution<float> moveDistr(-3.0f, 3.0f);
+		for (AABB& aabb : aabbs) {
+			vec3 move(moveDistr(gen), moveDistr(gen), moveDistr(gen));
+			aabb = AABB(aabb.min() + move, aabb.max() + move);
+		}
+		bvh.refit(aabbs.data());
+		checkQueries(bvh, aabbs, gen);
+	}
+	SECTION("Restore") {
+		BVH built(aabbs.data(), uint32_t(aabbs.size()), 2);
+		BVH bvh;
+		REQUIRE(bvh.restore(aabbs.data(), uint32_t(aabbs.size()), built.nodes().data(),
+		                    built.nodes().size(), built.primitiveIndices().data()));
+		REQUIRE(bvh.nodes().size() == built.nodes().size());
+		REQUIRE(std::memcmp(bvh.nodes().data(), built.nodes().data(), sizeof(BVHNode) * bvh.nodes().size()) == 0);
+		checkQueries(bvh, aabbs, gen);
+	}
+}
+
+TEST_CASE("BVH restore invalid", "[sfz::BVH]")
+{
+	std::mt19937 gen(3);
+	std::vector<AABB> aabbs = randomAABBs(gen, 200, 20.0f);
+	const uint32_t numAABBs = uint32_t(aabbs.size());
+	BVH built(aabbs.data(), numAABBs);
+	std::vector<BVHNode> nodes(built.nodes().begin(), built.nodes().end());
+	std::vector<uint32_t> prims(built.primitiveIndices().begin(), built.primitiveIndices().end());
+	REQUIRE(nodes.size() > 1);
+
+	BVH bvh;
+	REQUIRE(bvh.restore(aabbs.data(), numAABBs, nodes.data(), uint32_t(nodes.size()), prims.data()));
+	REQUIRE(bvh.numPrimitives() == numAABBs);
+
+	// Wrong number of primitives or nodes
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs - 1, nodes.data(), uint32_t(nodes.size()), prims.data()));
+	REQUIRE(bvh.numPrimitives() == 0);
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, nodes.data(), uint32_t(nodes.size() - 1), prims.data()));
+	REQUIRE(bvh.restore(nullptr, 0, nullptr, 0, nullptr));
+
+	// Primitive indices not a permutation
+	std::vector<uint32_t> badPrims = prims;
+	badPrims[1] = badPrims[0];
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, nodes.data(), uint32_t(nodes.size()), badPrims.data()));
+	badPrims[1] = numAABBs;
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, nodes.data(), uint32_t(nodes.size()), badPrims.data()));
+
+	// Find an inner and a leaf slot of the root
+	uint32_t innerSlot = ~0u, leafSlot = ~0u;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if (i == 0 && nodes[0].isInner(slot)) innerSlot = slot;
+		}
+	}
+	REQUIRE(innerSlot != ~0u);
+	uint32_t leafNode = ~0u;
+	for (uint32_t i = 0; i < nodes.size() && leafNode == ~0u; i++) {
+		for (uint32_t slot = 0; slot < 4; slot++) {
+			if (nodes[i].isLeaf(slot)) {
+				leafNode = i;
+				leafSlot = slot;
+				break;
+			}
+		}
+	}
+	REQUIRE(leafNode != ~0u);
+
+	// Child pointing backwards (a cycle) or out of range
+	std::vector<BVHNode> badNodes = nodes;
+	badNodes[0].children[innerSlot] = 0;
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, badNodes.data(), uint32_t(badNodes.size()), prims.data()));
+	badNodes[0].children[innerSlot] = uint32_t(nodes.size());
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, badNodes.data(), uint32_t(badNodes.size()), prims.data()));
+
+	// Leaf out of range, too large or overlapping another leaf
+	badNodes = nodes;
+	badNodes[leafNode].children[leafSlot] = numAABBs - 1;
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, badNodes.data(), uint32_t(badNodes.size()), prims.data()));
+	badNodes = nodes;
+	badNodes[leafNode].counts[leafSlot] = BVH::MAX_LEAF_SIZE + 1;
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, badNodes.data(), uint32_t(badNodes.size()), prims.data()));
+	badNodes = nodes;
+	badNodes[leafNode].children[leafSlot] += 1;
+	REQUIRE(!bvh.restore(aabbs.data(), numAABBs, badNodes.data(), uint32_t(badNodes.size()), prims.data()));
+	REQUIRE(bvh.nodes().size() == 0);
+}
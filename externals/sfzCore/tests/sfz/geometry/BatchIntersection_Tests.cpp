@@ -0,0 +1,127 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <random>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/BatchIntersection.hpp"
+#include "sfz/geometry/Intersection.hpp"
+
+#include "ShapeTestHelpers.hpp"
+
+using namespace sfz;
+
+static bool maskBit(const uint32_t* mask, uint32_t i) noexcept
+{
+	return ((mask[i / 32] >> (i % 32)) & 1u) != 0;
+}
+
+TEST_CASE("OBBBatch", "[sfz::BatchIntersection]")
+{
+	std::mt19937 gen(7);
+	OBBBatch batch;
+	REQUIRE(batch.size() == 0);
+
+	OBB boxes[11];
+	for (OBB& box : boxes) {
+		box = randomOBB(gen, 6.0f, 0.5f, 3.0f);
+		batch.add(box);
+	}
+	REQUIRE(batch.size() == 11);
+	for (uint32_t i = 0; i < 11; i++) {
+		const OBB box = batch.get(i);
+		REQUIRE(approxEqual(box.position(), boxes[i].position()));
+		REQUIRE(approxEqual(box.xAxis(), boxes[i].xAxis()));
+		REQUIRE(approxEqual(box.zAxis(), boxes[i].zAxis()));
+		REQUIRE(approxEqual(box.halfExtents(), boxes[i].halfExtents()));
+	}
+
+	batch.set(3, boxes[0]);
+	REQUIRE(approxEqual(batch.get(3).position(), boxes[0].position()));
+
+	// Padding lanes are zero
+	REQUIRE(batch.component(12)[11] == 0.0f);
+	REQUIRE(batch.component(12)[15] == 0.0f);
+
+	batch.clear();
+	REQUIRE(batch.size() == 0);
+}
+
+TEST_CASE("Batched OBB vs OBB test", "[sfz::BatchIntersection]")
+{
+	std::mt19937 gen(13);
+	const uint32_t NUM_BOXES = 77;
+	DynArray<OBB> boxes(NUM_BOXES);
+	OBBBatch batch;
+	for (uint32_t i = 0; i < NUM_BOXES; i++) {
+		boxes[i] = randomOBB(gen, 6.0f, 0.5f, 3.0f);
+		batch.add(boxes[i]);
+	}
+
+	uint32_t mask[3];
+	uint32_t numHits = 0;
+	for (uint32_t iter = 0; iter < 20; iter++) {
+		const OBB box = randomOBB(gen, 6.0f, 0.5f, 3.0f);
+		intersects(box, batch, mask);
+		for (uint32_t i = 0; i < NUM_BOXES; i++) {
+			REQUIRE(maskBit(mask, i) == intersects(box, boxes[i]));
+			if (maskBit(mask, i)) numHits += 1;
+		}
+
+		// Bits after the last box are never set
+		REQUIRE((mask[2] >> (NUM_BOXES % 32)) == 0u);
+	}
+	REQUIRE(numHits > 0);
+	REQUIRE(numHits < 20 * NUM_BOXES);
+}
+
+TEST_CASE("Batched Sphere vs Sphere test", "[sfz::BatchIntersection]")
+{
+	std::mt19937 gen(17);
+	std::uniform_real_distribution<float> posDist(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> radiusDist(0.5f, 3.0f);
+
+	const uint32_t NUM_SPHERES = 45;
+	float x[NUM_SPHERES], y[NUM_SPHERES], z[NUM_SPHERES], r[NUM_SPHERES];
+	for (uint32_t i = 0; i < NUM_SPHERES; i++) {
+		x[i] = posDist(gen);
+		y[i] = posDist(gen);
+		z[i] = posDist(gen);
+		r[i] = radiusDist(gen);
+	}
+
+	uint32_t mask[2];
+	for (uint32_t iter = 0; iter < 20; iter++) {
+		const Sphere sphere(vec3(posDist(gen), posDist(gen), posDist(gen)), radiusDist(gen));
+		intersects(sphere, x, y, z, r, NUM_SPHERES, mask);
+		for (uint32_t i = 0; i < NUM_SPHERES; i++) {
+			REQUIRE(maskBit(mask, i) == intersects(sphere, Sphere(vec3(x[i], y[i], z[i]), r[i])));
+		}
+		REQUIRE((mask[1] >> (NUM_SPHERES % 32)) == 0u);
+	}
+
+	// Touching spheres intersect
+	const float tx = 2.0f, ty = 0.0f, tz = 0.0f, tr = 1.0f;
+	intersects(Sphere(vec3(0.0f), 1.0f), &tx, &ty, &tz, &tr, 1, mask);
+	REQUIRE(mask[0] == 1u);
+}
@@ -0,0 +1,155 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/BoundingVolumes.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+using namespace sfz;
+
+static bool sphereContains(const Sphere& sphere, const vec3& point) noexcept
+{
+	return length(point - sphere.position()) <= sphere.radius() * 1.0001f;
+}
+
+static bool aabbContains(const AABB& aabb, const vec3& point) noexcept
+{
+	return aabb.min() == min(aabb.min(), point) && aabb.max() == max(aabb.max(), point);
+}
+
+static bool obbContains(const OBB& obb, const vec3& point) noexcept
+{
+	const vec3 diff = point - obb.position();
+	for (size_t i = 0; i < 3; i++) {
+		if (std::abs(dot(diff, obb.axes()[i])) > obb.halfExtents()[i] * 1.0001f + 1e-4f) return false;
+	}
+	return true;
+}
+
+TEST_CASE("Bounding volumes of point sets", "[sfz::BoundingVolumes]")
+{
+	std::mt19937 gen(17);
+	std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+
+	SECTION("Points on a sphere, interleaved with other data") {
+		struct Vertex { vec3 pos; vec2 uv; };
+		std::vector<Vertex> vertices;
+		const vec3 center(3.0f, -2.0f, 1.0f);
+		for (uint32_t i = 0; i < 1001; i++) {
+			vec3 dir(distr(gen), distr(gen), distr(gen));
+			if (length(dir) < 0.01f) continue;
+			vertices.push_back(Vertex{ center + normalize(dir) * 5.0f, vec2(0.0f) });
+		}
+		const uint32_t n = uint32_t(vertices.size());
+		const uint32_t stride = sizeof(Vertex);
+
+		AABB aabb = computeAABB(&vertices[0].pos, n, stride);
+		Sphere sphere = computeBoundingSphere(&vertices[0].pos, n, stride);
+		OBB obb = computePCAOBB(&vertices[0].pos, n, stride);
+
+		vec3 minPos(1000.0f), maxPos(-1000.0f);
+		for (const Vertex& v : vertices) {
+			minPos = min(minPos, v.pos);
+			maxPos = max(maxPos, v.pos);
+			REQUIRE(sphereContains(sphere, v.pos));
+			REQUIRE(obbContains(obb, v.pos));
+		}
+		REQUIRE(aabb.min() == minPos);
+		REQUIRE(aabb.max() == maxPos);
+
+		// Close to the optimal sphere
+		REQUIRE(sphere.radius() <= 5.0f * 1.05f);
+		REQUIRE(approxEqual(sphere.position(), center, 0.25f));
+	}
+
+	SECTION("Rotated box") {
+		const mat4 rot = rotationMatrix4(normalize(vec3(1.0f, 2.0f, 3.0f)), 0.7f);
+		const vec3 halfExtents(8.0f, 2.0f, 0.5f);
+		std::vector<vec3> points;
+		for (uint32_t i = 0; i < 4000; i++) {
+			vec3 local = vec3(distr(gen), distr(gen), distr(gen)) * halfExtents;
+			points.push_back(transformPoint(rot, local) + vec3(10.0f, 0.0f, 0.0f));
+		}
+		const uint32_t n = uint32_t(points.size());
+
+		AABB aabb = computeAABB(points.data(), n);
+		Sphere sphere = computeBoundingSphere(points.data(), n);
+		OBB obb = computePCAOBB(points.data(), n);
+		for (const vec3& p : points) {
+			REQUIRE(aabbContains(aabb, p));
+			REQUIRE(sphereContains(sphere, p));
+			REQUIRE(obbContains(obb, p));
+		}
+
+		// The PCA OBB should find the box, with much less volume than the AABB
+		const float boxVolume = 8.0f * halfExtents.x * halfExtents.y * halfExtents.z;
+		const vec3 obbExt = obb.extents();
+		const float obbVolume = obbExt.x * obbExt.y * obbExt.z;
+		const vec3 aabbExt = aabb.extents();
+		REQUIRE(obbVolume <= boxVolume * 1.1f);
+		REQUIRE(obbVolume < 0.5f * aabbExt.x * aabbExt.y * aabbExt.z);
+		REQUIRE(approxEqual(std::abs(dot(obb.xAxis(), transformDir(rot, vec3(1.0f, 0.0f, 0.0f)))), 1.0f, 0.01f));
+	}
+
+	SECTION("Degenerate inputs") {
+		const vec3 single(1.0f, 2.0f, 3.0f);
+		AABB aabb = computeAABB(&single, 1);
+		REQUIRE(aabbContains(aabb, single));
+		REQUIRE(aabb.xExtent() > 0.0f);
+		Sphere sphere = computeBoundingSphere(&single, 1);
+		REQUIRE(sphere.radius() > 0.0f);
+		REQUIRE(sphereContains(sphere, single));
+
+		const vec3 flat[] = { vec3(0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f), vec3(0.5f, 0.2f, 0.0f) };
+		OBB obb = computePCAOBB(flat, 5);
+		for (const vec3& p : flat) REQUIRE(obbContains(obb, p));
+		REQUIRE(computeAABB(flat, 5).zExtent() > 0.0f);
+	}
+}
+
+TEST_CASE("Transforming bounding volumes", "[sfz::BoundingVolumes]")
+{
+	const mat4 transform = translationMatrix(vec3(1.0f, -3.0f, 2.0f)) *
+	                       rotationMatrix4(normalize(vec3(-1.0f, 2.0f, 0.5f)), 1.1f) *
+	                       scalingMatrix4(2.0f, 0.5f, 1.5f);
+
+	const AABB aabb(vec3(-1.0f, 0.0f, 2.0f), vec3(3.0f, 1.0f, 4.0f));
+	const AABB transformedAABB = aabb.transformAABB(transform);
+	for (const vec3& corner : aabb.corners()) {
+		vec3 p = transformPoint(transform, corner);
+		REQUIRE(aabbContains(AABB(transformedAABB.min() - vec3(1e-4f), transformedAABB.max() + vec3(1e-4f)), p));
+	}
+
+	const Sphere sphere(vec3(1.0f, 2.0f, 3.0f), 2.0f);
+	const Sphere transformedSphere = sphere.transformSphere(transform);
+	REQUIRE(approxEqual(transformedSphere.radius(), 4.0f));
+	for (int i = 0; i < 100; i++) {
+		float theta = PI<float>() * float(i) / 100.0f, phi = 0.37f * float(i);
+		vec3 onSphere = sphere.position() + 2.0f * vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+		REQUIRE(sphereContains(transformedSphere, transformPoint(transform, onSphere)));
+	}
+}
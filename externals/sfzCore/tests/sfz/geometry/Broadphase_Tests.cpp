@@ -0,0 +1,167 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/Broadphase.hpp"
+
+using namespace sfz;
+
+static std::vector<BroadphasePair> sorted(const DynArray<BroadphasePair>& pairs) noexcept
+{
+	std::vector<BroadphasePair> result(pairs.data(), pairs.data() + pairs.size());
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+static std::vector<BroadphasePair> bruteForcePairs(const std::vector<AABB>& bounds,
+                                                   const std::vector<uint32_t>& handles,
+                                                   const std::vector<bool>& alive) noexcept
+{
+	std::vector<BroadphasePair> pairs;
+	for (size_t i = 0; i < bounds.size(); i++) {
+		if (!alive[i]) continue;
+		for (size_t j = i + 1; j < bounds.size(); j++) {
+			if (!alive[j]) continue;
+			const AABB& a = bounds[i];
+			const AABB& b = bounds[j];
+			bool overlap = a.min().x <= b.max().x && b.min().x <= a.max().x
+			            && a.min().y <= b.max().y && b.min().y <= a.max().y
+			            && a.min().z <= b.max().z && b.min().z <= a.max().z;
+			if (!overlap) continue;
+			uint32_t ha = handles[i], hb = handles[j];
+			pairs.push_back(ha < hb ? BroadphasePair{ha, hb} : BroadphasePair{hb, ha});
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+
+template<typename Broadphase>
+static void testBroadphase(Broadphase& broadphase) noexcept
+{
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<float> posDistr(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> sizeDistr(0.2f, 3.0f);
+	std::uniform_real_distribution<float> moveDistr(-0.3f, 0.3f);
+
+	const uint32_t NUM_OBJECTS = 400;
+	std::vector<AABB> bounds;
+	std::vector<uint32_t> handles;
+	std::vector<bool> alive;
+	for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+		vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+		bounds.emplace_back(pos, sizeDistr(gen), sizeDistr(gen), sizeDistr(gen));
+		handles.push_back(broadphase.add(bounds.back()));
+		alive.push_back(true);
+	}
+
+	DynArray<BroadphasePair> pairs;
+	broadphase.findPairs(pairs);
+	REQUIRE(pairs.size() > 0);
+	REQUIRE(sorted(pairs) == bruteForcePairs(bounds, handles, alive));
+
+	// Move objects around for a number of frames, removing and re-adding some of them
+	for (int frame = 0; frame < 20; frame++) {
+		for (uint32_t i = 0; i < NUM_OBJECTS; i++) {
+			if (!alive[i]) continue;
+			vec3 offset(moveDistr(gen), moveDistr(gen), moveDistr(gen));
+			bounds[i] = AABB(bounds[i].min() + offset, bounds[i].max() + offset);
+			broadphase.update(handles[i], bounds[i]);
+		}
+		for (uint32_t i = frame; i < NUM_OBJECTS; i += 37) {
+			if (alive[i]) {
+				broadphase.remove(handles[i]);
+				alive[i] = false;
+			} else {
+				handles[i] = broadphase.add(bounds[i]);
+				alive[i] = true;
+			}
+		}
+
+		pairs.clear();
+		broadphase.findPairs(pairs);
+		REQUIRE(sorted(pairs) == bruteForcePairs(bounds, handles, alive));
+	}
+}
+
+TEST_CASE("SweepAndPrune", "[sfz::Broadphase]")
+{
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		SweepAndPrune sap(axis);
+		testBroadphase(sap);
+	}
+
+	SweepAndPrune sap;
+	uint32_t a = sap.add(AABB(vec3(0.0f), vec3(1.0f)));
+	uint32_t b = sap.add(AABB(vec3(2.0f), vec3(3.0f)));
+	DynArray<BroadphasePair> pairs;
+	sap.findPairs(pairs);
+	REQUIRE(pairs.size() == 0);
+	sap.update(b, AABB(vec3(0.5f), vec3(1.5f)));
+	sap.findPairs(pairs);
+	REQUIRE(pairs.size() == 1);
+	REQUIRE(pairs[0].first == std::min(a, b));
+	REQUIRE(pairs[0].second == std::max(a, b));
+	sap.clear();
+	REQUIRE(sap.numObjects() == 0);
+}
+
+TEST_CASE("HashGrid", "[sfz::Broadphase]")
+{
+	SECTION("Cell size close to object size") {
+		HashGrid grid(2.0f);
+		testBroadphase(grid);
+	}
+	SECTION("Small cells and few buckets, many cells and hash collisions per object") {
+		HashGrid grid(0.5f, 64);
+		testBroadphase(grid);
+	}
+	SECTION("queryOverlap") {
+		HashGrid grid(1.0f);
+		std::vector<AABB> bounds;
+		std::mt19937 gen(9);
+		std::uniform_real_distribution<float> posDistr(-10.0f, 10.0f);
+		for (uint32_t i = 0; i < 200; i++) {
+			bounds.emplace_back(vec3(posDistr(gen), posDistr(gen), posDistr(gen)), 1.5f, 0.5f, 2.5f);
+			REQUIRE(grid.add(bounds.back()) == i);
+		}
+		AABB query(vec3(-3.0f), vec3(4.0f));
+		DynArray<uint32_t> result;
+		grid.queryOverlap(query, result);
+		std::vector<uint32_t> found(result.data(), result.data() + result.size());
+		std::sort(found.begin(), found.end());
+		std::vector<uint32_t> expected;
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			const AABB& b = bounds[i];
+			if (b.min().x <= query.max().x && query.min().x <= b.max().x
+			 && b.min().y <= query.max().y && query.min().y <= b.max().y
+			 && b.min().z <= query.max().z && query.min().z <= b.max().z) {
+				expected.push_back(i);
+			}
+		}
+		REQUIRE(expected.size() > 0);
+		REQUIRE(found == expected);
+	}
+}
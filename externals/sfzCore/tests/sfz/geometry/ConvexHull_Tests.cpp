@@ -0,0 +1,155 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/ConvexHull.hpp"
+
+using namespace sfz;
+
+static float hullVolume(const ConvexHull& hull) noexcept
+{
+	float volume = 0.0f;
+	for (uint32_t i = 0; i < hull.indices.size(); i += 3) {
+		const vec3 a = hull.vertices[hull.indices[i]];
+		const vec3 b = hull.vertices[hull.indices[i + 1]];
+		const vec3 c = hull.vertices[hull.indices[i + 2]];
+		volume += dot(a, cross(b, c)) / 6.0f;
+	}
+	return volume;
+}
+
+/// Checks that the hull is closed (V - E + F = 2), that every edge is shared by exactly two
+/// triangles with opposite winding and that all points are inside or on the hull
+static void checkHull(const ConvexHull& hull, const std::vector<vec3>& points, float tolerance) noexcept
+{
+	const uint32_t numTriangles = hull.numTriangles();
+	REQUIRE(numTriangles >= 4);
+	REQUIRE(int(hull.vertices.size()) - int(numTriangles * 3 / 2) + int(numTriangles) == 2);
+
+	bool edgesMatch = true;
+	for (uint32_t i = 0; i < hull.indices.size(); i++) {
+		const uint32_t e0 = hull.indices[i];
+		const uint32_t e1 = hull.indices[(i % 3 == 2) ? (i - 2) : (i + 1)];
+		uint32_t numReversed = 0;
+		for (uint32_t j = 0; j < hull.indices.size(); j++) {
+			const uint32_t f0 = hull.indices[j];
+			const uint32_t f1 = hull.indices[(j % 3 == 2) ? (j - 2) : (j + 1)];
+			if (f0 == e1 && f1 == e0) numReversed++;
+		}
+		edgesMatch = edgesMatch && numReversed == 1;
+	}
+	REQUIRE(edgesMatch);
+
+	bool allInside = true;
+	for (uint32_t i = 0; i < hull.indices.size(); i += 3) {
+		const vec3 a = hull.vertices[hull.indices[i]];
+		const vec3 n = normalize(cross(hull.vertices[hull.indices[i + 1]] - a, hull.vertices[hull.indices[i + 2]] - a));
+		for (const vec3& p : points) {
+			allInside = allInside && dot(n, p - a) <= tolerance;
+		}
+	}
+	REQUIRE(allInside);
+}
+
+TEST_CASE("Convex hull of box with interior points", "[sfz::ConvexHull]")
+{
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<float> dist(-0.99f, 0.99f);
+	std::vector<vec3> points;
+	for (uint32_t i = 0; i < 500; i++) points.emplace_back(dist(gen), dist(gen), dist(gen));
+	for (uint32_t i = 0; i < 8; i++) {
+		points.insert(points.begin() + i * 50, vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 2.0f : -2.0f, (i & 4) ? 3.0f : -3.0f));
+	}
+
+	const ConvexHull hull = computeConvexHull(points.data(), uint32_t(points.size()));
+	REQUIRE(hull.vertices.size() == 8);
+	REQUIRE(hull.numTriangles() == 12);
+	REQUIRE(std::abs(hullVolume(hull) - 48.0f) < 1e-3f);
+	checkHull(hull, points, 1e-5f);
+}
+
+TEST_CASE("Convex hull of points on a sphere", "[sfz::ConvexHull]")
+{
+	std::mt19937 gen(2);
+	std::normal_distribution<float> dist(0.0f, 1.0f);
+	std::vector<vec3> points;
+	for (uint32_t i = 0; i < 1000; i++) {
+		points.push_back(normalize(vec3(dist(gen), dist(gen), dist(gen))) * 5.0f + vec3(10.0f, 0.0f, -3.0f));
+	}
+
+	const ConvexHull full = computeConvexHull(points.data(), uint32_t(points.size()));
+	REQUIRE(full.vertices.size() > 990);
+	checkHull(full, points, 1e-4f);
+	const float sphereVolume = 4.0f / 3.0f * 3.14159265f * 125.0f;
+	REQUIRE(hullVolume(full) > 0.97f * sphereVolume);
+
+	SECTION("Reduced to a max vertex count") {
+		const ConvexHull reduced = computeConvexHull(points.data(), uint32_t(points.size()), sizeof(vec3), 32);
+		REQUIRE(reduced.vertices.size() <= 32);
+		REQUIRE(reduced.vertices.size() >= 28);
+		std::vector<vec3> reducedPoints(reduced.vertices.begin(), reduced.vertices.end());
+		checkHull(reduced, reducedPoints, 1e-4f);
+		checkHull(full, reducedPoints, 1e-4f);
+		REQUIRE(hullVolume(reduced) > 0.75f * hullVolume(full));
+		REQUIRE(hullVolume(reduced) <= hullVolume(full));
+	}
+}
+
+TEST_CASE("Convex hull of degenerate point sets", "[sfz::ConvexHull]")
+{
+	SECTION("Empty and single point") {
+		REQUIRE(computeConvexHull(nullptr, 0).vertices.size() == 0);
+		const vec3 point(1.0f, 2.0f, 3.0f);
+		const ConvexHull hull = computeConvexHull(&point, 1);
+		REQUIRE(hull.vertices.size() == 1);
+		REQUIRE(hull.numTriangles() == 0);
+	}
+	SECTION("Collinear and coplanar") {
+		const vec3 line[4] = { vec3(0.0f), vec3(1.0f), vec3(3.0f), vec3(2.0f) };
+		const ConvexHull lineHull = computeConvexHull(line, 4);
+		REQUIRE(lineHull.vertices.size() == 2);
+		REQUIRE(lineHull.numTriangles() == 0);
+
+		const vec3 plane[5] = { vec3(0.0f, 0.0f, 1.0f), vec3(1.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 1.0f),
+		                        vec3(1.0f, 1.0f, 1.0f), vec3(0.5f, 0.5f, 1.0f) };
+		const ConvexHull planeHull = computeConvexHull(plane, 5);
+		REQUIRE(planeHull.vertices.size() == 3);
+		REQUIRE(planeHull.numTriangles() == 0);
+	}
+	SECTION("Duplicates and stride") {
+		struct Vertex { vec3 pos; vec3 normal; };
+		std::vector<Vertex> vertices;
+		for (uint32_t copy = 0; copy < 3; copy++) {
+			for (uint32_t i = 0; i < 4; i++) {
+				vertices.push_back(Vertex{ vec3(i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f, i == 3 ? 1.0f : 0.0f), vec3(0.0f) });
+			}
+		}
+		const ConvexHull hull = computeConvexHull(&vertices[0].pos, uint32_t(vertices.size()), sizeof(Vertex));
+		REQUIRE(hull.vertices.size() == 4);
+		REQUIRE(hull.numTriangles() == 4);
+		REQUIRE(std::abs(hullVolume(hull) - 1.0f / 6.0f) < 1e-6f);
+	}
+}
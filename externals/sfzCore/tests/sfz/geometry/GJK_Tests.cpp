@@ -0,0 +1,203 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+#include <random>
+
+#include "sfz/geometry/GJK.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/math/MathHelpers.hpp"
+
+#include "ShapeTestHelpers.hpp"
+
+using namespace sfz;
+
+TEST_CASE("ConvexShape support functions", "[sfz::GJK]")
+{
+	const Sphere sphere(vec3(1.0f, 2.0f, 3.0f), 2.0f);
+	REQUIRE(approxEqual(SphereShape(sphere).support(vec3(0.0f, 5.0f, 0.0f)), vec3(1.0f, 4.0f, 3.0f)));
+
+	const AABB aabb(vec3(-1.0f, -2.0f, -3.0f), vec3(1.0f, 2.0f, 3.0f));
+	REQUIRE(AABBShape(aabb).support(vec3(1.0f, -1.0f, 1.0f)) == vec3(1.0f, -2.0f, 3.0f));
+	REQUIRE(approxEqual(OBBShape(OBB(aabb)).support(vec3(-1.0f, 1.0f, -1.0f)), vec3(-1.0f, 2.0f, -3.0f)));
+
+	// Hull of the AABB corners interleaved with other data, plus interior points
+	struct Vertex { vec3 pos; float padding[2]; };
+	Vertex vertices[12];
+	for (uint32_t i = 0; i < 12; i++) {
+		vertices[i].pos = (i < 8) ? vec3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 2.0f : -2.0f, (i & 4) ? 3.0f : -3.0f)
+		                          : vec3(0.1f * float(i));
+	}
+	const ConvexHullShape hull(&vertices[0].pos, 12, sizeof(Vertex));
+	REQUIRE(hull.support(vec3(1.0f, -1.0f, 1.0f)) == vec3(1.0f, -2.0f, 3.0f));
+
+	const mat4 transform = translationMatrix(vec3(10.0f, 0.0f, 0.0f)) * scalingMatrix4(2.0f);
+	const ConvexHullShape transformedHull(&vertices[0].pos, 12, sizeof(Vertex), transform);
+	REQUIRE(approxEqual(transformedHull.support(vec3(1.0f, -1.0f, 1.0f)), vec3(12.0f, -4.0f, 6.0f)));
+}
+
+TEST_CASE("GJK distance", "[sfz::GJK]")
+{
+	SECTION("Spheres") {
+		const Sphere sphereA(vec3(0.0f), 1.0f), sphereB(vec3(3.0f, 4.0f, 0.0f), 2.0f);
+		GJKSimplex simplex;
+		const GJKResult result = gjkDistance(SphereShape(sphereA), SphereShape(sphereB), simplex);
+		REQUIRE(!result.intersecting);
+		REQUIRE(approxEqual(result.distance, 2.0f, 1e-3f));
+		REQUIRE(approxEqual(result.pointA, vec3(0.6f, 0.8f, 0.0f), 1e-2f));
+		REQUIRE(approxEqual(result.pointB, vec3(1.8f, 2.4f, 0.0f), 1e-2f));
+	}
+	SECTION("AABBs") {
+		const AABB boxA(vec3(0.0f), vec3(1.0f)), boxB(vec3(2.0f, 3.0f, 0.5f), vec3(4.0f, 5.0f, 2.0f));
+		GJKSimplex simplex;
+		const GJKResult result = gjkDistance(AABBShape(boxA), AABBShape(boxB), simplex);
+		REQUIRE(!result.intersecting);
+		REQUIRE(approxEqual(result.distance, std::sqrt(5.0f), 1e-4f));
+		REQUIRE(approxEqual(length(result.pointB - result.pointA), result.distance, 1e-4f));
+
+		const AABB boxC(vec3(0.5f), vec3(2.0f));
+		REQUIRE(gjkDistance(AABBShape(boxA), AABBShape(boxC), simplex).intersecting);
+	}
+	SECTION("Random OBBs and spheres against closest point") {
+		std::mt19937 gen(3);
+		std::uniform_real_distribution<float> posDist(-6.0f, 6.0f);
+		std::uniform_real_distribution<float> radiusDist(0.2f, 2.0f);
+		for (uint32_t i = 0; i < 500; i++) {
+			const OBB obb = randomOBB(gen, 3.0f, 0.5f, 3.0f);
+			const Sphere sphere(vec3(posDist(gen), posDist(gen), posDist(gen)), radiusDist(gen));
+			const float expected = length(obb.closestPoint(sphere.position()) - sphere.position()) - sphere.radius();
+			GJKSimplex simplex;
+			const GJKResult result = gjkDistance(OBBShape(obb), SphereShape(sphere), simplex);
+			if (expected > 1e-3f) {
+				REQUIRE(!result.intersecting);
+				REQUIRE(approxEqual(result.distance, expected, 1e-2f));
+			}
+			else if (expected < -1e-3f) {
+				REQUIRE(result.intersecting);
+			}
+		}
+	}
+}
+
+TEST_CASE("GJK intersection matches SAT for OBBs", "[sfz::GJK]")
+{
+	std::mt19937 gen(11);
+	uint32_t numIntersecting = 0;
+	for (uint32_t i = 0; i < 1000; i++) {
+		const OBB boxA = randomOBB(gen, 3.0f, 0.5f, 3.0f), boxB = randomOBB(gen, 3.0f, 0.5f, 3.0f);
+		GJKSimplex simplex;
+		const GJKResult distResult = gjkDistance(OBBShape(boxA), OBBShape(boxB), simplex);
+		// Skip nearly touching boxes where the result depends on rounding
+		if (!distResult.intersecting && distResult.distance < 1e-3f) continue;
+		const bool expected = intersects(boxA, boxB);
+		REQUIRE(distResult.intersecting == expected);
+		GJKSimplex simplex2;
+		REQUIRE(gjkIntersects(OBBShape(boxA), OBBShape(boxB), simplex2) == expected);
+		if (expected) numIntersecting++;
+	}
+	REQUIRE(numIntersecting > 100);
+	REQUIRE(numIntersecting < 900);
+}
+
+TEST_CASE("EPA penetration", "[sfz::GJK]")
+{
+	SECTION("Spheres") {
+		const Sphere sphereA(vec3(0.0f), 1.0f), sphereB(vec3(1.5f, 0.0f, 0.0f), 1.0f);
+		const SphereShape shapeA(sphereA), shapeB(sphereB);
+		GJKSimplex simplex;
+		REQUIRE(gjkIntersects(shapeA, shapeB, simplex));
+		const Penetration pen = epaPenetration(shapeA, shapeB, simplex);
+		REQUIRE(pen.valid);
+		REQUIRE(approxEqual(pen.depth, 0.5f, 1e-2f));
+		REQUIRE(approxEqual(pen.normal, vec3(1.0f, 0.0f, 0.0f), 5e-2f));
+		REQUIRE(approxEqual(pen.pointA - pen.pointB, pen.normal * pen.depth, 1e-3f));
+	}
+	SECTION("AABBs") {
+		const AABB boxA(vec3(0.0f), vec3(2.0f)), boxB(vec3(0.5f, 1.8f, 0.2f), vec3(1.5f, 3.0f, 1.0f));
+		const AABBShape shapeA(boxA), shapeB(boxB);
+		GJKSimplex simplex;
+		REQUIRE(gjkDistance(shapeA, shapeB, simplex).intersecting);
+		const Penetration pen = epaPenetration(shapeA, shapeB, simplex);
+		REQUIRE(pen.valid);
+		REQUIRE(approxEqual(pen.depth, 0.2f, 1e-4f));
+		REQUIRE(approxEqual(pen.normal, vec3(0.0f, 1.0f, 0.0f), 1e-4f));
+
+		// Translating B by the penetration separates the shapes
+		const AABB moved(boxB.min() + pen.normal * (pen.depth + 1e-3f), boxB.max() + pen.normal * (pen.depth + 1e-3f));
+		GJKSimplex simplex2;
+		REQUIRE(!gjkIntersects(shapeA, AABBShape(moved), simplex2));
+	}
+	SECTION("Random OBBs are separated by the penetration") {
+		std::mt19937 gen(5);
+		uint32_t numTested = 0;
+		for (uint32_t i = 0; i < 300; i++) {
+			const OBB boxA = randomOBB(gen, 3.0f, 0.5f, 3.0f), boxB = randomOBB(gen, 3.0f, 0.5f, 3.0f);
+			GJKSimplex simplex;
+			if (!gjkIntersects(OBBShape(boxA), OBBShape(boxB), simplex)) continue;
+			const Penetration pen = epaPenetration(OBBShape(boxA), OBBShape(boxB), simplex);
+			REQUIRE(pen.valid);
+			REQUIRE(pen.depth >= 0.0f);
+
+			OBB moved = boxB;
+			moved.position(boxB.position() + pen.normal * (pen.depth + 1e-2f));
+			GJKSimplex simplex2;
+			REQUIRE(!gjkIntersects(OBBShape(boxA), OBBShape(moved), simplex2));
+
+			// No shorter translation along the box axes separates them
+			for (const vec3& axis : boxA.axes()) {
+				for (float sign : { 1.0f, -1.0f }) {
+					OBB shorter = boxB;
+					shorter.position(boxB.position() + sign * axis * (pen.depth * 0.95f - 1e-3f));
+					REQUIRE(intersects(boxA, shorter));
+				}
+			}
+			numTested++;
+		}
+		REQUIRE(numTested > 30);
+	}
+}
+
+TEST_CASE("GJK warm starting", "[sfz::GJK]")
+{
+	std::mt19937 gen(7);
+	uint32_t coldIterations = 0, warmIterations = 0;
+	for (uint32_t i = 0; i < 100; i++) {
+		OBB boxA = randomOBB(gen, 3.0f, 0.5f, 3.0f), boxB = randomOBB(gen, 3.0f, 0.5f, 3.0f);
+		boxB.position(boxA.position() + vec3(8.0f, 0.0f, 0.0f));
+		GJKSimplex warm;
+		gjkDistance(OBBShape(boxA), OBBShape(boxB), warm);
+
+		// Move B a little, as between two frames
+		for (uint32_t frame = 0; frame < 10; frame++) {
+			boxB.position(boxB.position() + vec3(-0.05f, 0.02f, 0.01f));
+			GJKSimplex cold;
+			const GJKResult coldResult = gjkDistance(OBBShape(boxA), OBBShape(boxB), cold);
+			const GJKResult warmResult = gjkDistance(OBBShape(boxA), OBBShape(boxB), warm);
+			REQUIRE(coldResult.intersecting == warmResult.intersecting);
+			REQUIRE(approxEqual(coldResult.distance, warmResult.distance, 1e-3f));
+			coldIterations += coldResult.iterations;
+			warmIterations += warmResult.iterations;
+		}
+	}
+	REQUIRE(warmIterations < coldIterations);
+}
@@ -222,6 +222,24 @@ TEST_CASE("AABB2D vs Circle test", "[sfz::Intersection]")
 	REQUIRE(overlaps(cLeft, rLeft));
 }
 
+TEST_CASE("AABB vs Sphere test", "[sfz::Intersection]")
+{
+	using namespace sfz;
+
+	AABB aabb{vec3{1.0f, 1.0f, 1.0f}, vec3{3.0f, 3.0f, 3.0f}};
+	Sphere inside{vec3{2.0f, 2.0f, 2.0f}, 0.1f};
+	Sphere touchingFace{vec3{0.0f, 2.0f, 2.0f}, 1.0f};
+	Sphere nearCorner{vec3{0.0f, 0.0f, 0.0f}, 1.8f};
+	Sphere offCorner{vec3{0.0f, 0.0f, 0.0f}, 1.7f};
+
+	REQUIRE(intersects(aabb, inside));
+	REQUIRE(intersects(aabb, touchingFace));
+	REQUIRE(intersects(aabb, nearCorner));
+	REQUIRE(!intersects(aabb, offCorner));
+	REQUIRE(intersects(inside, aabb));
+	REQUIRE(!intersects(offCorner, aabb));
+}
+
 TEST_CASE("Plane vs AABB test", "[sfz::Intersection]")
 {
 	using namespace sfz;
@@ -0,0 +1,85 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/LooseOctree.hpp"
+
+#include "SpatialQueryTestHelpers.hpp"
+
+using namespace sfz;
+
+TEST_CASE("LooseOctree", "[sfz::LooseOctree]")
+{
+	std::mt19937 gen(13);
+	std::uniform_real_distribution<float> posDistr(-55.0f, 55.0f); // World is [-50, 50]
+	std::uniform_real_distribution<float> sizeDistr(0.1f, 4.0f);
+	std::uniform_real_distribution<float> moveDistr(-2.0f, 2.0f);
+
+	LooseOctree octree(AABB(vec3(-50.0f), vec3(50.0f)), 6);
+	REQUIRE(octree.numObjects() == 0);
+	REQUIRE(octree.numNodes() == 1);
+
+	std::vector<AABB> aabbs;
+	std::vector<uint32_t> handles;
+	for (uint32_t i = 0; i < 2000; i++) {
+		vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+		float scale = (i % 100 == 0) ? 10.0f : 1.0f;
+		aabbs.emplace_back(pos, sizeDistr(gen) * scale, sizeDistr(gen), sizeDistr(gen));
+		handles.push_back(octree.insert(aabbs.back()));
+		REQUIRE(handles.back() == i);
+	}
+	REQUIRE(octree.numObjects() == 2000);
+	checkSpatialQueries(octree, aabbs, handles, gen, 60.0f, 10);
+
+	// Move everything and remove/reinsert some objects for a few frames
+	for (int frame = 0; frame < 5; frame++) {
+		for (uint32_t i = 0; i < aabbs.size(); i++) {
+			if (handles[i] == OCTREE_INVALID_INDEX) continue;
+			vec3 offset(moveDistr(gen), moveDistr(gen), moveDistr(gen));
+			aabbs[i] = AABB(aabbs[i].min() + offset, aabbs[i].max() + offset);
+			octree.move(handles[i], aabbs[i]);
+		}
+		for (uint32_t i = frame; i < aabbs.size(); i += 7) {
+			if (handles[i] != OCTREE_INVALID_INDEX) {
+				octree.remove(handles[i]);
+				handles[i] = OCTREE_INVALID_INDEX;
+			} else {
+				handles[i] = octree.insert(aabbs[i]);
+			}
+		}
+		checkSpatialQueries(octree, aabbs, handles, gen, 60.0f, 10);
+	}
+
+	// Removing all objects returns all nodes except the root to the pool
+	for (uint32_t handle : handles) {
+		if (handle != OCTREE_INVALID_INDEX) octree.remove(handle);
+	}
+	REQUIRE(octree.numObjects() == 0);
+	REQUIRE(octree.numNodes() == 1);
+
+	octree.insert(aabbs[0]);
+	octree.clear();
+	REQUIRE(octree.numObjects() == 0);
+	REQUIRE(octree.numNodes() == 1);
+}
@@ -0,0 +1,200 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/MeshOptimization.hpp"
+#include "sfz/math/MathHelpers.hpp"
+
+using namespace sfz;
+
+/// Height field grid of size x size vertices with its triangles in random order
+static void createShuffledGrid(uint32_t size, std::vector<vec3>& positions,
+                               std::vector<uint32_t>& indices) noexcept
+{
+	std::mt19937 gen(7);
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			positions.emplace_back(float(x), 0.0f, float(y));
+		}
+	}
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t y = 0; y < size - 1; y++) {
+		for (uint32_t x = 0; x < size - 1; x++) {
+			uint32_t i0 = y * size + x;
+			uint32_t i1 = i0 + size;
+			triangles.push_back({{ i0, i1, i0 + 1 }});
+			triangles.push_back({{ i0 + 1, i1, i1 + 1 }});
+		}
+	}
+	std::shuffle(triangles.begin(), triangles.end(), gen);
+	for (const auto& tri : triangles) indices.insert(indices.end(), tri.begin(), tri.end());
+}
+
+/// The triangles (with their winding and first vertex) in sorted order
+static std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t>& indices) noexcept
+{
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		triangles.push_back({{ indices[i], indices[i + 1], indices[i + 2] }});
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST_CASE("analyzeVertexCache", "[sfz::MeshOptimization]")
+{
+	// Two triangles sharing an edge, 4 vertices transformed
+	const uint32_t quad[] = { 0, 1, 2, 2, 1, 3 };
+	VertexCacheStats stats = analyzeVertexCache(quad, 6, 4);
+	REQUIRE(stats.numTransformed == 4);
+	REQUIRE(approxEqual(stats.acmr, 2.0f));
+	REQUIRE(approxEqual(stats.atvr, 1.0f));
+
+	// Unreferenced vertices don't count towards ATVR
+	stats = analyzeVertexCache(quad, 6, 100);
+	REQUIRE(approxEqual(stats.atvr, 1.0f));
+
+	// With a cache of 3 entries vertex 0 is evicted before it is used again
+	const uint32_t fan[] = { 0, 1, 2, 3, 4, 5, 0, 5, 6 };
+	stats = analyzeVertexCache(fan, 9, 7, 3);
+	REQUIRE(stats.numTransformed == 8);
+	REQUIRE(approxEqual(stats.atvr, 8.0f / 7.0f));
+	stats = analyzeVertexCache(fan, 9, 7, 16);
+	REQUIRE(stats.numTransformed == 7);
+
+	stats = analyzeVertexCache(quad, 0, 4);
+	REQUIRE(stats.numTransformed == 0);
+	REQUIRE(stats.acmr == 0.0f);
+}
+
+TEST_CASE("optimizeVertexCache", "[sfz::MeshOptimization]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createShuffledGrid(64, positions, indices);
+	const uint32_t numIndices = uint32_t(indices.size());
+	const uint32_t numVertices = uint32_t(positions.size());
+
+	std::vector<uint32_t> optimized(numIndices);
+	optimizeVertexCache(optimized.data(), indices.data(), numIndices, numVertices);
+	REQUIRE(sortedTriangles(optimized) == sortedTriangles(indices));
+
+	VertexCacheStats before = analyzeVertexCache(indices.data(), numIndices, numVertices);
+	VertexCacheStats after = analyzeVertexCache(optimized.data(), numIndices, numVertices);
+	REQUIRE(before.acmr > 2.5f);
+	REQUIRE(after.acmr < 0.8f);
+	REQUIRE(after.atvr < 1.5f);
+
+	// Also good on a smaller cache than the one it optimized for
+	REQUIRE(analyzeVertexCache(optimized.data(), numIndices, numVertices, 8).acmr < 1.0f);
+
+	// In place
+	std::vector<uint32_t> inPlace = indices;
+	optimizeVertexCache(inPlace.data(), inPlace.data(), numIndices, numVertices);
+	REQUIRE(inPlace == optimized);
+}
+
+TEST_CASE("optimizeOverdraw", "[sfz::MeshOptimization]")
+{
+	SECTION("Grid") {
+		std::vector<vec3> positions;
+		std::vector<uint32_t> indices;
+		createShuffledGrid(64, positions, indices);
+		const uint32_t numIndices = uint32_t(indices.size());
+		const uint32_t numVertices = uint32_t(positions.size());
+
+		std::vector<uint32_t> cacheOptimized(numIndices);
+		optimizeVertexCache(cacheOptimized.data(), indices.data(), numIndices, numVertices);
+		std::vector<uint32_t> optimized(numIndices);
+		optimizeOverdraw(optimized.data(), cacheOptimized.data(), numIndices, positions.data(), numVertices);
+		REQUIRE(sortedTriangles(optimized) == sortedTriangles(indices));
+
+		float acmrBefore = analyzeVertexCache(cacheOptimized.data(), numIndices, numVertices).acmr;
+		float acmrAfter = analyzeVertexCache(optimized.data(), numIndices, numVertices).acmr;
+		REQUIRE(acmrAfter <= acmrBefore * 1.15f);
+	}
+	SECTION("Outward facing patches first") {
+		// Three disjoint quads, the middle one (at the center of the mesh) is drawn first in the
+		// input but should be drawn last as it can't occlude the others from the outside
+		std::vector<vec3> positions;
+		std::vector<uint32_t> indices;
+		const float depths[] = { 0.0f, 1.0f, -1.0f };
+		for (uint32_t q = 0; q < 3; q++) {
+			const uint32_t base = uint32_t(positions.size());
+			const float z = depths[q];
+			positions.emplace_back(-1.0f, -1.0f, z);
+			positions.emplace_back(1.0f, -1.0f, z);
+			positions.emplace_back(-1.0f, 1.0f, z);
+			positions.emplace_back(1.0f, 1.0f, z);
+			if (z >= 0.0f) { // Facing +z
+				indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 1, base + 3 });
+			}
+			else { // Facing -z
+				indices.insert(indices.end(), { base, base + 2, base + 1, base + 2, base + 3, base + 1 });
+			}
+		}
+		std::vector<uint32_t> optimized(indices.size());
+		optimizeOverdraw(optimized.data(), indices.data(), uint32_t(indices.size()),
+		                 positions.data(), uint32_t(positions.size()));
+		REQUIRE(std::vector<uint32_t>(optimized.begin(), optimized.begin() + 6) ==
+		        std::vector<uint32_t>(indices.begin() + 6, indices.begin() + 12));
+		REQUIRE(std::vector<uint32_t>(optimized.begin() + 6, optimized.begin() + 12) ==
+		        std::vector<uint32_t>(indices.begin() + 12, indices.begin() + 18));
+		REQUIRE(std::vector<uint32_t>(optimized.begin() + 12, optimized.end()) ==
+		        std::vector<uint32_t>(indices.begin(), indices.begin() + 6));
+	}
+	SECTION("Strided positions") {
+		struct Vertex { vec3 pos; vec3 normal; };
+		const Vertex vertices[] = {
+			{ vec3(0.0f, 0.0f, 0.0f), vec3(0.0f) },
+			{ vec3(1.0f, 0.0f, 0.0f), vec3(0.0f) },
+			{ vec3(0.0f, 1.0f, 0.0f), vec3(0.0f) }
+		};
+		const uint32_t indices[] = { 0, 1, 2 };
+		uint32_t optimized[3];
+		optimizeOverdraw(optimized, indices, 3, &vertices[0].pos, 3, sizeof(Vertex));
+		REQUIRE(optimized[0] == 0);
+		REQUIRE(optimized[1] == 1);
+		REQUIRE(optimized[2] == 2);
+	}
+}
+
+TEST_CASE("optimizeVertexFetch", "[sfz::MeshOptimization]")
+{
+	uint32_t indices[] = { 5, 2, 3, 3, 2, 0 };
+	uint32_t remap[7];
+	REQUIRE(optimizeVertexFetch(remap, indices, 6, 7) == 4);
+	REQUIRE(remap[5] == 0);
+	REQUIRE(remap[2] == 1);
+	REQUIRE(remap[3] == 2);
+	REQUIRE(remap[0] == 3);
+	REQUIRE(remap[1] == ~0u);
+	REQUIRE(remap[4] == ~0u);
+	REQUIRE(remap[6] == ~0u);
+	const uint32_t expected[] = { 0, 1, 2, 2, 1, 3 };
+	REQUIRE(std::equal(indices, indices + 6, expected));
+}
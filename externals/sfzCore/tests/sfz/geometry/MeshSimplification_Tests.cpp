@@ -0,0 +1,271 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "sfz/geometry/MeshSimplification.hpp"
+
+using namespace sfz;
+
+/// Flat grid in the xz-plane with size x size vertices, facing +y. If seamColumn > 0 the vertices
+/// of that column are duplicated, the triangles to the right of it use the duplicates.
+static void createGrid(uint32_t size, uint32_t seamColumn, std::vector<vec3>& positions,
+                       std::vector<uint32_t>& indices) noexcept
+{
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			positions.emplace_back(float(x), 0.0f, float(y));
+		}
+	}
+	const uint32_t numGridVertices = uint32_t(positions.size());
+	if (seamColumn > 0) {
+		for (uint32_t y = 0; y < size; y++) positions.push_back(positions[y * size + seamColumn]);
+	}
+	auto index = [&](uint32_t x, uint32_t y, bool rightSide) {
+		if (rightSide && x == seamColumn && seamColumn > 0) return numGridVertices + y;
+		return y * size + x;
+	};
+	for (uint32_t y = 0; y < size - 1; y++) {
+		for (uint32_t x = 0; x < size - 1; x++) {
+			const bool right = seamColumn > 0 && x >= seamColumn;
+			const uint32_t i00 = index(x, y, right), i10 = index(x + 1, y, right);
+			const uint32_t i01 = index(x, y + 1, right), i11 = index(x + 1, y + 1, right);
+			indices.insert(indices.end(), { i00, i01, i10, i10, i01, i11 });
+		}
+	}
+}
+
+/// Sphere around the origin with latitude/longitude triangulation, poles are single vertices
+static void createSphere(uint32_t rings, uint32_t segments, std::vector<vec3>& positions,
+                         std::vector<uint32_t>& indices) noexcept
+{
+	const float PI = 3.14159265358979f;
+	positions.emplace_back(0.0f, 1.0f, 0.0f);
+	for (uint32_t r = 1; r < rings; r++) {
+		const float theta = PI * float(r) / float(rings);
+		for (uint32_t s = 0; s < segments; s++) {
+			const float phi = 2.0f * PI * float(s) / float(segments);
+			positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+		}
+	}
+	positions.emplace_back(0.0f, -1.0f, 0.0f);
+	const uint32_t south = uint32_t(positions.size()) - 1;
+	auto ring = [&](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + (s % segments); };
+	for (uint32_t s = 0; s < segments; s++) {
+		indices.insert(indices.end(), { 0, ring(1, s + 1), ring(1, s) });
+		indices.insert(indices.end(), { south, ring(rings - 1, s), ring(rings - 1, s + 1) });
+		for (uint32_t r = 1; r < rings - 1; r++) {
+			indices.insert(indices.end(), { ring(r, s), ring(r, s + 1), ring(r + 1, s) });
+			indices.insert(indices.end(), { ring(r, s + 1), ring(r + 1, s + 1), ring(r + 1, s) });
+		}
+	}
+}
+
+static vec3 triangleNormal(const std::vector<vec3>& positions, const uint32_t* tri) noexcept
+{
+	return cross(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]);
+}
+
+/// Half-edges (by position) without an opposite half-edge
+static std::vector<std::pair<vec3, vec3>> openEdges(const std::vector<vec3>& positions,
+                                                    const std::vector<uint32_t>& indices) noexcept
+{
+	auto key = [](const vec3& p) { return std::make_pair(p.x, p.z); };
+	std::map<std::pair<std::pair<float, float>, std::pair<float, float>>, int> halfEdges;
+	for (size_t i = 0; i < indices.size(); i++) {
+		const vec3& from = positions[indices[i]];
+		const vec3& to = positions[indices[(i % 3 == 2) ? (i - 2) : (i + 1)]];
+		halfEdges[std::make_pair(key(from), key(to))]++;
+	}
+	std::vector<std::pair<vec3, vec3>> result;
+	for (size_t i = 0; i < indices.size(); i++) {
+		const vec3& from = positions[indices[i]];
+		const vec3& to = positions[indices[(i % 3 == 2) ? (i - 2) : (i + 1)]];
+		if (halfEdges.count(std::make_pair(key(to), key(from))) == 0) result.emplace_back(from, to);
+	}
+	return result;
+}
+
+TEST_CASE("simplifyMesh flat grid", "[sfz::MeshSimplification]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createGrid(32, 0, positions, indices);
+	const uint32_t numIndices = uint32_t(indices.size());
+	const uint32_t target = (numIndices / 10) / 3 * 3;
+
+	std::vector<uint32_t> simplified(numIndices);
+	float error = -1.0f;
+	uint32_t numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+	    positions.data(), uint32_t(positions.size()), sizeof(vec3), target, 0.01f, &error);
+	simplified.resize(numSimplified);
+	REQUIRE(numSimplified <= target);
+	REQUIRE(numSimplified >= 6);
+	REQUIRE(error >= 0.0f);
+	REQUIRE(error < 0.01f);
+
+	// No flipped triangles, the area and the border are unchanged
+	float area = 0.0f;
+	bool allFacingUp = true;
+	for (uint32_t i = 0; i < numSimplified; i += 3) {
+		const vec3 normal = triangleNormal(positions, &simplified[i]);
+		allFacingUp = allFacingUp && normal.y > 0.0f;
+		area += 0.5f * length(normal);
+	}
+	REQUIRE(allFacingUp);
+	REQUIRE(std::abs(area - 31.0f * 31.0f) < 0.01f);
+	for (const auto& edge : openEdges(positions, simplified)) {
+		const bool alongX = edge.first.z == edge.second.z && (edge.first.z == 0.0f || edge.first.z == 31.0f);
+		const bool alongZ = edge.first.x == edge.second.x && (edge.first.x == 0.0f || edge.first.x == 31.0f);
+		REQUIRE((alongX || alongZ));
+	}
+
+	// In place gives the same result
+	std::vector<uint32_t> inPlace = indices;
+	REQUIRE(simplifyMesh(inPlace.data(), inPlace.data(), numIndices, positions.data(),
+	    uint32_t(positions.size()), sizeof(vec3), target, 0.01f) == numSimplified);
+	inPlace.resize(numSimplified);
+	REQUIRE(inPlace == simplified);
+}
+
+TEST_CASE("simplifyMesh sphere", "[sfz::MeshSimplification]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createSphere(32, 64, positions, indices);
+	const uint32_t numIndices = uint32_t(indices.size());
+	const uint32_t numVertices = uint32_t(positions.size());
+
+	float prevError = 0.0f;
+	for (uint32_t percent : { 50u, 25u, 10u }) {
+		const uint32_t target = (numIndices * percent / 100) / 3 * 3;
+		std::vector<uint32_t> simplified(numIndices);
+		float error = 0.0f;
+		uint32_t numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+		    positions.data(), numVertices, sizeof(vec3), target, 1e30f, &error);
+		simplified.resize(numSimplified);
+		REQUIRE(numSimplified <= target);
+		REQUIRE(numSimplified > target / 2);
+		REQUIRE(error > prevError);
+		REQUIRE(error < 0.1f);
+		prevError = error;
+
+		// Closed and outward facing
+		REQUIRE(openEdges(positions, simplified).empty());
+		bool allOutwards = true;
+		for (uint32_t i = 0; i < numSimplified; i += 3) {
+			const vec3 center = (positions[simplified[i]] + positions[simplified[i + 1]] + positions[simplified[i + 2]]) / 3.0f;
+			allOutwards = allOutwards && dot(triangleNormal(positions, &simplified[i]), center) > 0.0f;
+		}
+		REQUIRE(allOutwards);
+	}
+
+	// The error limit stops the simplification, errors are in the units of the positions
+	std::vector<vec3> scaledPositions;
+	for (const vec3& p : positions) scaledPositions.push_back(p * 100.0f);
+	std::vector<uint32_t> simplified(numIndices);
+	float error = 0.0f;
+	uint32_t numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+	    scaledPositions.data(), numVertices, sizeof(vec3), 0, 0.5f, &error);
+	REQUIRE(numSimplified < numIndices);
+	REQUIRE(numSimplified > 0);
+	REQUIRE(error <= 0.5f);
+}
+
+TEST_CASE("simplifyMesh seams", "[sfz::MeshSimplification]")
+{
+	// Strided vertices with uv coordinates, the duplicated column is a uv seam
+	struct Vertex { vec3 pos; vec2 uv; };
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createGrid(32, 15, positions, indices);
+	std::vector<Vertex> vertices;
+	for (uint32_t i = 0; i < positions.size(); i++) {
+		vertices.push_back({ positions[i], vec2(i < 32 * 32 ? 0.0f : 1.0f) });
+	}
+	const uint32_t numIndices = uint32_t(indices.size());
+	const uint32_t target = (numIndices / 10) / 3 * 3;
+
+	std::vector<uint32_t> simplified(numIndices);
+	uint32_t numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+	    &vertices[0].pos, uint32_t(vertices.size()), sizeof(Vertex), target, 0.01f);
+	simplified.resize(numSimplified);
+	REQUIRE(numSimplified <= target);
+
+	// The seam is still closed (only the outer border is open), and each side only uses its own
+	// vertices along the seam
+	for (const auto& edge : openEdges(positions, simplified)) {
+		const bool alongX = edge.first.z == edge.second.z && (edge.first.z == 0.0f || edge.first.z == 31.0f);
+		const bool alongZ = edge.first.x == edge.second.x && (edge.first.x == 0.0f || edge.first.x == 31.0f);
+		REQUIRE((alongX || alongZ));
+	}
+	bool sidesSeparate = true;
+	for (uint32_t i = 0; i < numSimplified; i += 3) {
+		const float centerX = (positions[simplified[i]].x + positions[simplified[i + 1]].x + positions[simplified[i + 2]].x) / 3.0f;
+		for (uint32_t j = 0; j < 3; j++) {
+			const uint32_t v = simplified[i + j];
+			if (positions[v].x != 15.0f) continue;
+			sidesSeparate = sidesSeparate && ((centerX > 15.0f) == (v >= 32 * 32));
+		}
+	}
+	REQUIRE(sidesSeparate);
+}
+
+TEST_CASE("simplifyMesh locked vertices", "[sfz::MeshSimplification]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createGrid(16, 0, positions, indices);
+	const uint32_t numIndices = uint32_t(indices.size());
+	std::vector<uint32_t> simplified(numIndices);
+
+	bool locked[16 * 16];
+	for (bool& l : locked) l = true;
+	REQUIRE(simplifyMesh(simplified.data(), indices.data(), numIndices, positions.data(),
+	    16 * 16, sizeof(vec3), 0, 1e30f, nullptr, locked) == numIndices);
+
+	// Only the locked vertex at the center remains among the interior vertices
+	for (bool& l : locked) l = false;
+	locked[8 * 16 + 8] = true;
+	uint32_t numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+	    positions.data(), 16 * 16, sizeof(vec3), 0, 0.01f);
+	simplified.resize(numSimplified);
+	bool centerUsed = false;
+	for (uint32_t index : simplified) centerUsed = centerUsed || index == 8 * 16 + 8;
+	REQUIRE(!centerUsed);
+	simplified.resize(numIndices);
+	numSimplified = simplifyMesh(simplified.data(), indices.data(), numIndices,
+	    positions.data(), 16 * 16, sizeof(vec3), 0, 0.01f, nullptr, locked);
+	simplified.resize(numSimplified);
+	centerUsed = false;
+	for (uint32_t index : simplified) centerUsed = centerUsed || index == 8 * 16 + 8;
+	REQUIRE(centerUsed);
+
+	// Degenerate triangles are removed, nothing else when the target is already reached
+	const uint32_t degenerate[] = { 0, 1, 16, 1, 1, 17 };
+	REQUIRE(simplifyMesh(simplified.data(), degenerate, 6, positions.data(), 16 * 16,
+	    sizeof(vec3), 3) == 3);
+}
@@ -0,0 +1,160 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/OcclusionBuffer.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+using namespace sfz;
+
+static mat4 testViewProj() noexcept
+{
+	const mat4 view = lookAt(vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+	const mat4 proj = perspectiveProjectionMatrix(60.0f, 2.0f, 0.5f, 100.0f);
+	return proj * view;
+}
+
+/// A two triangle quad in the plane z = depth facing the camera
+static void addWall(OcclusionBuffer& buffer, const mat4& viewProj, vec2 min, vec2 max, float z) noexcept
+{
+	const vec3 positions[4] = { vec3(min.x, min.y, z), vec3(max.x, min.y, z),
+	                            vec3(max.x, max.y, z), vec3(min.x, max.y, z) };
+	const uint32_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+	buffer.addOccluder(viewProj, positions, indices, 6);
+}
+
+TEST_CASE("OcclusionBuffer resolution and clear", "[sfz::OcclusionBuffer]")
+{
+	OcclusionBuffer buffer(100, 50);
+	REQUIRE(buffer.width() == 128);
+	REQUIRE(buffer.height() == 56);
+
+	// Nothing occludes an empty buffer, but objects outside the screen are not visible
+	const mat4 viewProj = testViewProj();
+	REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -50.0f), vec3(1.0f, 1.0f, -49.0f))));
+	REQUIRE(!buffer.testAABB(viewProj, AABB(vec3(100.0f, -1.0f, -11.0f), vec3(101.0f, 1.0f, -10.0f))));
+
+	addWall(buffer, viewProj, vec2(-100.0f), vec2(100.0f), -10.0f);
+	REQUIRE(buffer.numBinnedTriangles() == 2);
+	buffer.rasterize();
+	REQUIRE(buffer.numBinnedTriangles() == 0);
+	REQUIRE(!buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -50.0f), vec3(1.0f, 1.0f, -49.0f))));
+
+	buffer.clear();
+	REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -50.0f), vec3(1.0f, 1.0f, -49.0f))));
+}
+
+TEST_CASE("OcclusionBuffer wall occlusion", "[sfz::OcclusionBuffer]")
+{
+	const mat4 viewProj = testViewProj();
+	OcclusionBuffer buffer(256, 128);
+	addWall(buffer, viewProj, vec2(-5.0f, -3.0f), vec2(5.0f, 3.0f), -10.0f);
+	buffer.rasterize();
+
+	SECTION("Depth matches the projected wall") {
+		const vec4 clip = viewProj * vec4(0.0f, 0.0f, -10.0f, 1.0f);
+		REQUIRE(approxEqual(buffer.depth(128, 64), clip.z / clip.w, 1e-4f));
+		REQUIRE(buffer.depth(0, 0) == std::numeric_limits<float>::max());
+	}
+	SECTION("Objects behind the wall are occluded") {
+		REQUIRE(!buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -21.0f), vec3(1.0f, 1.0f, -20.0f))));
+		REQUIRE(!buffer.testAABB(viewProj, AABB(vec3(-8.0f, -5.0f, -31.0f), vec3(8.0f, 5.0f, -20.0f))));
+	}
+	SECTION("Objects in front of the wall are visible") {
+		REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -6.0f), vec3(1.0f, 1.0f, -5.0f))));
+		// Straddles the wall
+		REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -12.0f), vec3(1.0f, 1.0f, -8.0f))));
+	}
+	SECTION("Objects behind the wall but peeking out are visible") {
+		REQUIRE(buffer.testAABB(viewProj, AABB(vec3(8.0f, -1.0f, -21.0f), vec3(10.0f, 1.0f, -20.0f))));
+		REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, 4.0f, -21.0f), vec3(1.0f, 8.0f, -20.0f))));
+	}
+	SECTION("Objects crossing the near plane are visible") {
+		REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -20.0f), vec3(1.0f, 1.0f, 1.0f))));
+	}
+}
+
+TEST_CASE("OcclusionBuffer skips occluders crossing the near plane", "[sfz::OcclusionBuffer]")
+{
+	const mat4 viewProj = testViewProj();
+	OcclusionBuffer buffer(256, 128);
+	const vec3 positions[3] = { vec3(-50.0f, -50.0f, 5.0f), vec3(50.0f, -50.0f, -20.0f), vec3(0.0f, 50.0f, -20.0f) };
+	const uint32_t indices[3] = { 0, 1, 2 };
+	buffer.addOccluder(viewProj, positions, indices, 3);
+	REQUIRE(buffer.numBinnedTriangles() == 0);
+	buffer.rasterize();
+	REQUIRE(buffer.testAABB(viewProj, AABB(vec3(-1.0f, -1.0f, -50.0f), vec3(1.0f, 1.0f, -49.0f))));
+}
+
+TEST_CASE("OcclusionBuffer multithreaded rasterization and batched tests", "[sfz::OcclusionBuffer]")
+{
+	const mat4 viewProj = testViewProj();
+	std::mt19937 gen(17);
+	std::uniform_real_distribution<float> xyDist(-30.0f, 30.0f);
+	std::uniform_real_distribution<float> zDist(-60.0f, -5.0f);
+	std::uniform_real_distribution<float> sizeDist(0.5f, 6.0f);
+
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < 200; i++) {
+		const vec3 base(xyDist(gen), xyDist(gen), zDist(gen));
+		for (uint32_t j = 0; j < 3; j++) {
+			indices.push_back(uint32_t(positions.size()));
+			positions.push_back(base + vec3(sizeDist(gen), sizeDist(gen), sizeDist(gen) * 0.2f));
+		}
+	}
+
+	OcclusionBuffer single(200, 100), multi(200, 100);
+	single.addOccluder(viewProj, positions.data(), indices.data(), uint32_t(indices.size()));
+	multi.addOccluder(viewProj, positions.data(), indices.data(), uint32_t(indices.size()));
+	single.rasterize(1);
+	multi.rasterize(4);
+	bool allEqual = true;
+	for (uint32_t y = 0; y < single.height(); y++) {
+		for (uint32_t x = 0; x < single.width(); x++) {
+			allEqual = allEqual && single.depth(x, y) == multi.depth(x, y);
+		}
+	}
+	REQUIRE(allEqual);
+
+	std::vector<AABB> aabbs;
+	for (uint32_t i = 0; i < 77; i++) {
+		const vec3 min(xyDist(gen), xyDist(gen), zDist(gen) - 10.0f);
+		aabbs.push_back(AABB(min, min + vec3(sizeDist(gen) * 0.3f)));
+	}
+	uint32_t mask[3];
+	single.testAABBs(viewProj, aabbs.data(), aabbs.size(), mask);
+	uint32_t numOccluded = 0;
+	for (uint32_t i = 0; i < aabbs.size(); i++) {
+		const bool visible = single.testAABB(viewProj, aabbs[i]);
+		const bool maskVisible = ((mask[i / 32] >> (i % 32)) & 1u) != 0;
+		REQUIRE(visible == maskVisible);
+		if (!visible) numOccluded++;
+	}
+	REQUIRE(numOccluded > 0);
+	REQUIRE(numOccluded < aabbs.size());
+}
@@ -0,0 +1,132 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <array>
+#include <random>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/Plane.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/math/MathHelpers.hpp"
+
+using namespace sfz;
+
+TEST_CASE("Ray vs primitives", "[sfz::Ray]")
+{
+	const Ray ray(vec3(0.0f, 0.0f, -10.0f), vec3(0.0f, 0.0f, 1.0f));
+
+	SECTION("AABB") {
+		REQUIRE(approxEqual<float>(raycast(ray, AABB(vec3(-1.0f), vec3(1.0f))), 9.0f));
+		REQUIRE(raycast(ray, AABB(vec3(2.0f, -1.0f, -1.0f), vec3(3.0f, 1.0f, 1.0f))) == RAY_MISS);
+		REQUIRE(raycast(ray, AABB(vec3(-1.0f, -1.0f, -13.0f), vec3(1.0f, 1.0f, -11.0f))) == RAY_MISS);
+		REQUIRE(raycast(ray, AABB(vec3(-1.0f, -1.0f, -11.0f), vec3(1.0f, 1.0f, -9.0f))) == 0.0f);
+		REQUIRE(raycast(Ray(ray.origin(), ray.dir(), 8.0f), AABB(vec3(-1.0f), vec3(1.0f))) == RAY_MISS);
+	}
+	SECTION("OBB") {
+		const float s = std::sqrt(0.5f);
+		std::array<vec3,3> axes = {{ vec3(s, s, 0.0f), vec3(-s, s, 0.0f), vec3(0.0f, 0.0f, 1.0f) }};
+		OBB obb(vec3(0.0f, 0.0f, 5.0f), axes, vec3(2.0f));
+		REQUIRE(approxEqual<float>(raycast(ray, obb), 14.0f));
+		OBB rotated(vec3(0.0f, 0.0f, 5.0f), {{ vec3(0.0f, s, s), vec3(0.0f, s, -s), vec3(1.0f, 0.0f, 0.0f) }}, vec3(2.0f));
+		REQUIRE(approxEqual<float>(raycast(ray, rotated), 15.0f - std::sqrt(2.0f)));
+		REQUIRE(raycast(Ray(vec3(3.0f, 0.0f, -10.0f), vec3(0.0f, 0.0f, 1.0f)), rotated) == RAY_MISS);
+	}
+	SECTION("Sphere") {
+		REQUIRE(approxEqual<float>(raycast(ray, Sphere(vec3(0.0f), 2.0f)), 8.0f));
+		REQUIRE(raycast(ray, Sphere(vec3(0.0f, 3.0f, 0.0f), 2.0f)) == RAY_MISS);
+		REQUIRE(raycast(ray, Sphere(vec3(0.0f, 0.0f, -20.0f), 2.0f)) == RAY_MISS);
+		REQUIRE(raycast(ray, Sphere(vec3(0.0f, 0.0f, -10.5f), 2.0f)) == 0.0f);
+		// Non-normalized direction gives distances in multiples of its length
+		REQUIRE(approxEqual<float>(raycast(Ray(ray.origin(), vec3(0.0f, 0.0f, 2.0f)), Sphere(vec3(0.0f), 2.0f)), 4.0f));
+	}
+	SECTION("Plane") {
+		REQUIRE(approxEqual<float>(raycast(ray, Plane(vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, 3.0f))), 13.0f));
+		REQUIRE(raycast(ray, Plane(vec3(1.0f, 0.0f, 0.0f), 0.0f)) == RAY_MISS);
+		REQUIRE(raycast(ray, Plane(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -20.0f))) == RAY_MISS);
+	}
+	SECTION("Triangle") {
+		const vec3 v0(-1.0f, -1.0f, 0.0f), v1(1.0f, -1.0f, 0.0f), v2(-1.0f, 1.0f, 0.0f);
+		vec2 uv;
+		REQUIRE(approxEqual<float>(raycast(ray, v0, v1, v2, uv), 10.0f));
+		REQUIRE(approxEqual(uv, vec2(0.5f, 0.5f)));
+		REQUIRE(approxEqual<float>(raycast(ray, v0, v2, v1), 10.0f)); // Double sided
+		REQUIRE(raycast(Ray(vec3(0.5f, 0.5f, -10.0f), ray.dir()), v0, v1, v2) == RAY_MISS);
+		REQUIRE(raycast(Ray(ray.origin(), vec3(1.0f, 0.0f, 0.0f)), v0, v1, v2) == RAY_MISS); // Parallel
+		REQUIRE(raycast(Ray(ray.origin(), -ray.dir()), v0, v1, v2) == RAY_MISS);
+	}
+}
+
+TEST_CASE("Ray packets match scalar versions", "[sfz::Ray]")
+{
+	std::mt19937 gen(3);
+	std::uniform_real_distribution<float> distr(-5.0f, 5.0f);
+	auto randVec = [&]() { return vec3(distr(gen), distr(gen), distr(gen)); };
+
+	for (int iter = 0; iter < 200; iter++) {
+		Ray rays[8];
+		for (Ray& r : rays) {
+			vec3 dir = randVec();
+			if (length(dir) < 0.1f) dir = vec3(1.0f, 0.0f, 0.0f);
+			r = Ray(randVec() * 2.0f, normalize(dir), std::abs(distr(gen)) * 4.0f);
+		}
+		const RayPacket8 packet(rays);
+
+		const vec3 center = randVec();
+		const AABB aabb(center - vec3(1.0f), center + vec3(1.5f));
+		const Sphere sphere(randVec(), 2.0f);
+		const vec3 v0 = randVec(), v1 = randVec(), v2 = randVec();
+
+		const floatx8 aabbDists = raycast(packet, aabb);
+		const floatx8 sphereDists = raycast(packet, sphere);
+		const floatx8 triDists = raycast(packet, v0, v1, v2);
+		for (size_t i = 0; i < 8; i++) {
+			float aabbDist = raycast(rays[i], aabb);
+			float sphereDist = raycast(rays[i], sphere);
+			float triDist = raycast(rays[i], v0, v1, v2);
+			REQUIRE((aabbDists[i] == RAY_MISS) == (aabbDist == RAY_MISS));
+			if (aabbDist != RAY_MISS) REQUIRE(approxEqual(aabbDists[i], aabbDist, 1e-4f));
+			REQUIRE((sphereDists[i] == RAY_MISS) == (sphereDist == RAY_MISS));
+			if (sphereDist != RAY_MISS) REQUIRE(approxEqual(sphereDists[i], sphereDist, 1e-4f));
+			REQUIRE((triDists[i] == RAY_MISS) == (triDist == RAY_MISS));
+			if (triDist != RAY_MISS) REQUIRE(approxEqual(triDists[i], triDist, 1e-4f));
+		}
+
+		// One ray against four triangles
+		vec3x4 p0, p1, p2;
+		vec3 tris[4][3];
+		for (size_t i = 0; i < 4; i++) {
+			for (vec3& v : tris[i]) v = randVec();
+			p0.setLane(i, tris[i][0]);
+			p1.setLane(i, tris[i][1]);
+			p2.setLane(i, tris[i][2]);
+		}
+		const floatx4 dists = raycast(rays[0], p0, p1, p2);
+		for (size_t i = 0; i < 4; i++) {
+			float dist = raycast(rays[0], tris[i][0], tris[i][1], tris[i][2]);
+			REQUIRE((dists[i] == RAY_MISS) == (dist == RAY_MISS));
+			if (dist != RAY_MISS) REQUIRE(approxEqual(dists[i], dist, 1e-4f));
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <random>
+
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+/// Random shape generators shared by the geometry tests
+
+namespace sfz {
+
+/// Returns an OBB with a random orientation, its center is inside [-posRange, posRange] on each
+/// axis and its extents are in [minExtent, maxExtent].
+inline OBB randomOBB(std::mt19937& gen, float posRange, float minExtent, float maxExtent) noexcept
+{
+	std::uniform_real_distribution<float> posDist(-posRange, posRange);
+	std::uniform_real_distribution<float> extentDist(minExtent, maxExtent);
+	std::uniform_real_distribution<float> angleDist(0.0f, 6.28f);
+	const vec3 axis = normalize(vec3(posDist(gen), posDist(gen), posDist(gen)) + vec3(0.01f));
+	const mat3 rot = rotationMatrix3(axis, angleDist(gen));
+	return OBB(vec3(posDist(gen), posDist(gen), posDist(gen)), rot.columnAt(0), rot.columnAt(1),
+	           rot.columnAt(2), vec3(extentDist(gen), extentDist(gen), extentDist(gen)));
+}
+
+} // namespace sfz
@@ -0,0 +1,101 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+
+/// Helpers shared by the tests of the spatial structures (BVH, LooseOctree). Query results are
+/// compared against brute force tests of every AABB.
+
+namespace sfz {
+
+inline std::vector<uint32_t> sorted(const DynArray<uint32_t>& ids) noexcept
+{
+	std::vector<uint32_t> result(ids.begin(), ids.end());
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+/// Returns the sorted ids of all AABBs that fulfill the predicate. ids[i] is the id the spatial
+/// structure returns for aabbs[i], AABBs with id ~0u are not in the structure and are skipped.
+template<typename F>
+std::vector<uint32_t> bruteForce(const std::vector<AABB>& aabbs, const std::vector<uint32_t>& ids,
+                                 F predicate) noexcept
+{
+	std::vector<uint32_t> result;
+	for (uint32_t i = 0; i < aabbs.size(); i++) {
+		if (ids[i] != ~0u && predicate(aabbs[i])) result.push_back(ids[i]);
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+/// Checks queryFrustum(), queryOverlap() (AABB & Sphere) and queryRay() of a spatial structure
+/// at random positions in [-range, range].
+template<typename SpatialStructure>
+void checkSpatialQueries(const SpatialStructure& structure, const std::vector<AABB>& aabbs,
+                         const std::vector<uint32_t>& ids, std::mt19937& gen, float range,
+                         uint32_t numQueries) noexcept
+{
+	DynArray<uint32_t> result;
+
+	const ViewFrustum frustum(vec3(0.0f, 0.0f, -60.0f), vec3(0.1f, 0.05f, 1.0f), vec3(0.0f, 1.0f, 0.0f),
+	                          50.0f, 1.3f, 0.5f, 80.0f);
+	structure.queryFrustum(frustum, result);
+	std::vector<uint32_t> expected = bruteForce(aabbs, ids, [&](const AABB& a) { return frustum.isVisible(a); });
+	REQUIRE(expected.size() > 0);
+	REQUIRE(sorted(result) == expected);
+
+	std::uniform_real_distribution<float> posDistr(-range, range);
+	for (uint32_t i = 0; i < numQueries; i++) {
+		vec3 pos(posDistr(gen), posDistr(gen), posDistr(gen));
+
+		result.clear();
+		AABB query(pos, 15.0f, 10.0f, 20.0f);
+		structure.queryOverlap(query, result);
+		REQUIRE(sorted(result) == bruteForce(aabbs, ids, [&](const AABB& a) { return intersects(query, a); }));
+
+		result.clear();
+		Sphere sphere(pos, 8.0f);
+		structure.queryOverlap(sphere, result);
+		REQUIRE(sorted(result) == bruteForce(aabbs, ids, [&](const AABB& a) { return intersects(a, sphere); }));
+
+		result.clear();
+		Ray ray(pos, normalize(vec3(posDistr(gen), posDistr(gen), posDistr(gen))), 60.0f);
+		structure.queryRay(ray, result);
+		REQUIRE(sorted(result) == bruteForce(aabbs, ids, [&](const AABB& a) {
+			return raycast(ray, a) != RAY_MISS;
+		}));
+	}
+}
+
+} // namespace sfz
@@ -0,0 +1,145 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+
+#include "sfz/geometry/GJK.hpp"
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/Sweep.hpp"
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+using namespace sfz;
+
+static bool approxEqualMatrix(const mat4& lhs, const mat4& rhs) noexcept
+{
+	for (uint32_t i = 0; i < 4; i++) {
+		if (!approxEqual(lhs.rowAt(i), rhs.rowAt(i), 1e-4f)) return false;
+	}
+	return true;
+}
+
+TEST_CASE("SweptShape interpolation", "[sfz::Sweep]")
+{
+	const SphereShape sphere(Sphere(vec3(1.0f, 0.0f, 0.0f), 0.5f));
+	const mat4 from = translationMatrix(vec3(1.0f, 2.0f, 3.0f)) * rotationMatrix4(vec3(0.0f, 1.0f, 0.0f), 0.3f);
+
+	SECTION("Rotation and translation") {
+		const vec3 axis = normalize(vec3(1.0f, 2.0f, -1.0f));
+		const mat4 to = translationMatrix(vec3(-1.0f, 0.0f, 5.0f)) * rotationMatrix4(axis, 1.2f) * from;
+		const SweptShape swept(sphere, from, to);
+		REQUIRE(approxEqualMatrix(swept.transformAt(0.0f), from));
+		REQUIRE(approxEqualMatrix(swept.transformAt(1.0f), to));
+
+		// Constant angular velocity, half way is half the rotation
+		const mat4 half = swept.transformAt(0.5f);
+		mat4 expectedHalf = rotationMatrix4(axis, 0.6f) * from;
+		translation(expectedHalf, lerp(translation(from), translation(to), 0.5f));
+		REQUIRE(approxEqualMatrix(half, expectedHalf));
+	}
+	SECTION("Half turn") {
+		for (float angle : { PI(), PI() - 0.0005f, -(PI() - 0.0005f) }) {
+			const mat4 to = rotationMatrix4(normalize(vec3(0.0f, 1.0f, 1.0f)), angle) * from;
+			const SweptShape swept(sphere, from, to);
+			REQUIRE(approxEqualMatrix(swept.transformAt(1.0f), to));
+		}
+	}
+
+	// Sphere offset 1 from the origin with radius 0.5, the radius is bounded by its local AABB
+	const SweptShape still(sphere, from, from);
+	REQUIRE(approxEqual(still.radius(), length(vec3(1.5f, 0.5f, 0.5f))));
+	REQUIRE(approxEqualMatrix(still.transformAt(0.7f), from));
+	const AABB bounds = still.bounds();
+	REQUIRE(approxEqual(bounds.min(), translation(from) - vec3(still.radius())));
+	REQUIRE(approxEqual(bounds.max(), translation(from) + vec3(still.radius())));
+}
+
+TEST_CASE("Sweep through thin wall", "[sfz::Sweep]")
+{
+	const AABBShape wall(AABB(vec3(-0.01f, -1.0f, -1.0f), vec3(0.01f, 1.0f, 1.0f)));
+	const Sphere localSphere(vec3(0.0f), 0.1f);
+	const SphereShape sphere(localSphere);
+	const mat4 from = translationMatrix(vec3(-1.0f, 0.0f, 0.0f));
+	const mat4 to = translationMatrix(vec3(1.0f, 0.0f, 0.0f));
+
+	// Discrete tests at the start and end of the motion miss the wall
+	GJKSimplex simplex;
+	REQUIRE(!gjkIntersects(TransformedShape(sphere, from), wall, simplex));
+	simplex = GJKSimplex();
+	REQUIRE(!gjkIntersects(TransformedShape(sphere, to), wall, simplex));
+
+	const SweepHit hit = sweep(sphere, from, to, wall);
+	REQUIRE(hit.isHit());
+	REQUIRE(approxEqual(hit.toi, (1.0f - 0.01f - 0.1f) / 2.0f, 1e-3f));
+	REQUIRE(approxEqual(hit.normal, vec3(-1.0f, 0.0f, 0.0f), 1e-3f));
+	REQUIRE(approxEqual(hit.point.x, -0.01f, 1e-3f));
+
+	// Moving away, parallel to the wall and stopping short all miss
+	REQUIRE(!sweep(sphere, to, translationMatrix(vec3(2.0f, 0.0f, 0.0f)), wall).isHit());
+	REQUIRE(!sweep(sphere, from, translationMatrix(vec3(-1.0f, 5.0f, 0.0f)), wall).isHit());
+	REQUIRE(!sweep(sphere, from, translationMatrix(vec3(-0.5f, 0.0f, 0.0f)), wall).isHit());
+
+	// maxToi skips later hits
+	const SweptShape swept(sphere, from, to);
+	REQUIRE(!swept.sweep(wall, 0.4f).isHit());
+	REQUIRE(swept.sweep(wall, 0.5f).isHit());
+
+	// Already intersecting at the start
+	const SweepHit startHit = sweep(sphere, translationMatrix(vec3(0.05f, 0.0f, 0.0f)), to, wall);
+	REQUIRE(startHit.isHit());
+	REQUIRE(startHit.toi == 0.0f);
+	REQUIRE(approxEqual(startHit.normal, vec3(1.0f, 0.0f, 0.0f), 1e-3f));
+}
+
+TEST_CASE("Sweep rotating stick", "[sfz::Sweep]")
+{
+	// A stick along local x from 0 to 1 swung 90 degrees around the y axis, from +x to -z
+	const OBBShape stick(OBB(vec3(0.5f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f),
+	                         vec3(0.0f, 0.0f, 1.0f), vec3(1.0f, 0.05f, 0.05f)));
+	const mat4 from = identityMatrix4<float>();
+	const mat4 to = rotationMatrix4(vec3(0.0f, 1.0f, 0.0f), PI() / 2.0f);
+	REQUIRE(approxEqual(transformPoint(to, vec3(1.0f, 0.0f, 0.0f)), vec3(0.0f, 0.0f, -1.0f)));
+
+	// Small ball on the arc at 45 degrees, the translation of the origin is zero so only the
+	// angular bound moves the stick
+	const float c = std::cos(PI() / 4.0f) * 0.8f;
+	const SphereShape ball(Sphere(vec3(c, 0.0f, -c), 0.05f));
+	const SweptShape swept(stick, from, to);
+	const SweepHit hit = swept.sweep(ball);
+	REQUIRE(hit.isHit());
+	REQUIRE(hit.toi > 0.35f);
+	REQUIRE(hit.toi < 0.5f);
+
+	// The shapes touch at the time of impact and were apart slightly before it
+	GJKSimplex simplex;
+	const GJKResult atHit = gjkDistance(TransformedShape(stick, swept.transformAt(hit.toi)), ball, simplex);
+	REQUIRE(atHit.distance < 0.002f);
+	simplex = GJKSimplex();
+	const GJKResult before = gjkDistance(TransformedShape(stick, swept.transformAt(hit.toi - 0.02f)), ball, simplex);
+	REQUIRE(before.distance > 0.005f);
+
+	// A ball outside the reach of the stick is never hit
+	const SphereShape farBall(Sphere(vec3(c, 0.0f, -c) * 2.0f, 0.05f));
+	REQUIRE(!swept.sweep(farBall).isHit());
+}
@@ -0,0 +1,177 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/Intersection.hpp"
+#include "sfz/geometry/TriangleBVH.hpp"
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+using namespace sfz;
+
+// Bumpy sphere-ish mesh with numSegments^2 * 2 triangles
+static void createMesh(uint32_t numSegments, std::vector<vec3>& positions,
+                       std::vector<uint32_t>& indices) noexcept
+{
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<float> bump(0.9f, 1.1f);
+	for (uint32_t y = 0; y <= numSegments; y++) {
+		for (uint32_t x = 0; x <= numSegments; x++) {
+			float theta = PI<float>() * float(y) / float(numSegments);
+			float phi = 2.0f * PI<float>() * float(x) / float(numSegments);
+			vec3 dir(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			positions.push_back(dir * 4.0f * bump(gen));
+		}
+	}
+	for (uint32_t y = 0; y < numSegments; y++) {
+		for (uint32_t x = 0; x < numSegments; x++) {
+			uint32_t i0 = y * (numSegments + 1) + x;
+			uint32_t i1 = i0 + 1;
+			uint32_t i2 = i0 + numSegments + 1;
+			uint32_t i3 = i2 + 1;
+			indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+		}
+	}
+}
+
+TEST_CASE("TriangleBVH raycast", "[sfz::TriangleBVH]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createMesh(64, positions, indices);
+
+	TriangleBVH empty;
+	REQUIRE(!empty.raycast(Ray(vec3(0.0f), vec3(1.0f, 0.0f, 0.0f))).isHit());
+
+	TriangleBVH bvh(positions.data(), indices.data(), uint32_t(indices.size()));
+	REQUIRE(bvh.numTriangles() == indices.size() / 3);
+
+	std::mt19937 gen(11);
+	std::uniform_real_distribution<float> distr(-8.0f, 8.0f);
+	for (int i = 0; i < 500; i++) {
+		// Rays from outside and inside the mesh, some with limited length
+		vec3 origin = vec3(distr(gen), distr(gen), distr(gen)) * ((i % 4 == 0) ? 0.2f : 1.0f);
+		vec3 target = vec3(distr(gen), distr(gen), distr(gen)) * 0.3f;
+		float maxDist = (i % 3 == 0) ? 6.0f : RAY_MISS;
+		Ray ray(origin, normalize(target - origin), maxDist);
+
+		float closest = RAY_MISS;
+		uint32_t closestTri = ~0u;
+		for (uint32_t t = 0; t < indices.size() / 3; t++) {
+			float dist = raycast(ray, positions[indices[t * 3]], positions[indices[t * 3 + 1]],
+			                     positions[indices[t * 3 + 2]]);
+			if (dist < closest) {
+				closest = dist;
+				closestTri = t;
+			}
+		}
+
+		RayHit hit = bvh.raycast(ray);
+		REQUIRE(hit.isHit() == (closest != RAY_MISS));
+		if (!hit.isHit()) continue;
+		REQUIRE(approxEqual(hit.dist, closest, 1e-4f));
+		if (hit.triangleIndex != closestTri) continue; // Shared edge, either triangle is fine
+
+		const vec3 v0 = positions[indices[closestTri * 3]];
+		const vec3 v1 = positions[indices[closestTri * 3 + 1]];
+		const vec3 v2 = positions[indices[closestTri * 3 + 2]];
+		vec3 baryPoint = (1.0f - hit.uv.x - hit.uv.y) * v0 + hit.uv.x * v1 + hit.uv.y * v2;
+		REQUIRE(approxEqual(baryPoint, ray.point(hit.dist), 1e-3f));
+	}
+}
+
+TEST_CASE("TriangleBVH restore", "[sfz::TriangleBVH]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createMesh(32, positions, indices);
+	const uint32_t numIndices = uint32_t(indices.size());
+
+	TriangleBVH built(positions.data(), indices.data(), numIndices);
+	const BVH& builtBVH = built.bvh();
+	TriangleBVH bvh;
+	REQUIRE(bvh.restore(positions.data(), indices.data(), numIndices, builtBVH.nodes().data(),
+	                    builtBVH.nodes().size(), builtBVH.primitiveIndices().data()));
+	REQUIRE(bvh.numTriangles() == built.numTriangles());
+
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<float> distr(-8.0f, 8.0f);
+	for (int i = 0; i < 200; i++) {
+		vec3 origin(distr(gen), distr(gen), distr(gen));
+		vec3 target = vec3(distr(gen), distr(gen), distr(gen)) * 0.3f;
+		Ray ray(origin, normalize(target - origin));
+		RayHit expected = built.raycast(ray);
+		RayHit hit = bvh.raycast(ray);
+		REQUIRE(hit.dist == expected.dist);
+		REQUIRE(hit.triangleIndex == expected.triangleIndex);
+	}
+
+	// Nodes of another mesh are rejected
+	std::vector<uint32_t> fewerIndices(indices.begin(), indices.end() - 3);
+	REQUIRE(!bvh.restore(positions.data(), fewerIndices.data(), numIndices - 3,
+	                     builtBVH.nodes().data(), builtBVH.nodes().size(),
+	                     builtBVH.primitiveIndices().data()));
+	REQUIRE(bvh.numTriangles() == 0);
+	REQUIRE(!bvh.raycast(Ray(vec3(0.0f, 0.0f, -8.0f), vec3(0.0f, 0.0f, 1.0f))).isHit());
+}
+
+TEST_CASE("TriangleBVH sweep", "[sfz::TriangleBVH]")
+{
+	std::vector<vec3> positions;
+	std::vector<uint32_t> indices;
+	createMesh(16, positions, indices);
+	TriangleBVH bvh(positions.data(), indices.data(), uint32_t(indices.size()));
+
+	const SphereShape sphere(Sphere(vec3(0.0f), 0.2f));
+	std::mt19937 gen(13);
+	std::uniform_real_distribution<float> dirDist(-1.0f, 1.0f);
+	for (uint32_t i = 0; i < 10; i++) {
+		// Sweep from the center through the (closed) mesh, so it always hits
+		const vec3 dir = normalize(vec3(dirDist(gen), dirDist(gen), dirDist(gen)));
+		const SweptShape swept(sphere, identityMatrix4<float>(), translationMatrix(dir * 10.0f));
+		const SweepHit hit = bvh.sweep(swept);
+		REQUIRE(hit.isHit());
+		REQUIRE(hit.toi > (3.6f - 0.2f) / 10.0f - 0.01f);
+		REQUIRE(hit.toi < (4.4f - 0.2f) / 10.0f);
+
+		// Same as sweeping against every triangle
+		float closestToi = SWEEP_MISS;
+		for (uint32_t tri = 0; tri < indices.size() / 3; tri++) {
+			const vec3 triangle[3] = { positions[indices[tri * 3]], positions[indices[tri * 3 + 1]],
+			                           positions[indices[tri * 3 + 2]] };
+			const SweepHit triHit = swept.sweep(ConvexHullShape(triangle, 3));
+			if (triHit.toi < closestToi) closestToi = triHit.toi;
+		}
+		REQUIRE(approxEqual(hit.toi, closestToi, 1e-4f));
+
+		// The contact point is on the surface of the sphere at the time of impact
+		const vec3 center = translation(swept.transformAt(hit.toi));
+		REQUIRE(std::abs(length(hit.point - center) - 0.2f) < 0.01f);
+	}
+
+	// Sweeping inside the mesh without reaching it misses
+	const SweptShape shortSwept(sphere, identityMatrix4<float>(), translationMatrix(vec3(1.0f, 0.0f, 0.0f)));
+	REQUIRE(!bvh.sweep(shortSwept).isHit());
+}
@@ -0,0 +1,185 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <random>
+#include <vector>
+
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/ViewFrustum.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/MatrixSupport.hpp"
+
+using namespace sfz;
+
+static bool maskBit(const std::vector<uint32_t>& mask, size_t i) noexcept
+{
+	return ((mask[i / 32] >> (i % 32)) & 1u) != 0;
+}
+
+TEST_CASE("Batch culling matches isVisible()", "[sfz::ViewFrustum]")
+{
+	const ViewFrustum frustum(vec3(1.0f, 2.0f, -3.0f), vec3(0.2f, -0.1f, 1.0f), vec3(0.0f, 1.0f, 0.0f),
+	                          60.0f, 1.6f, 0.5f, 80.0f);
+
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<float> posDistr(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> sizeDistr(0.1f, 8.0f);
+
+	// Deliberately not a multiple of the packet width or 32 to test the tail
+	const size_t count = 1003;
+	std::vector<float> xs(count), ys(count), zs(count), radii(count);
+	std::vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+	for (size_t i = 0; i < count; i++) {
+		xs[i] = posDistr(gen); ys[i] = posDistr(gen); zs[i] = posDistr(gen);
+		radii[i] = sizeDistr(gen);
+		minX[i] = xs[i] - sizeDistr(gen); maxX[i] = xs[i] + sizeDistr(gen);
+		minY[i] = ys[i] - sizeDistr(gen); maxY[i] = ys[i] + sizeDistr(gen);
+		minZ[i] = zs[i] - sizeDistr(gen); maxZ[i] = zs[i] + sizeDistr(gen);
+	}
+
+	std::vector<uint32_t> mask((count + 31) / 32, 0xFFFFFFFFu);
+
+	SECTION("Spheres") {
+		frustum.cullSpheres(xs.data(), ys.data(), zs.data(), radii.data(), count, mask.data());
+		size_t numVisible = 0;
+		for (size_t i = 0; i < count; i++) {
+			bool expected = frustum.isVisible(Sphere(vec3(xs[i], ys[i], zs[i]), radii[i]));
+			REQUIRE(maskBit(mask, i) == expected);
+			if (expected) numVisible++;
+		}
+		REQUIRE(numVisible > 0);
+		REQUIRE(numVisible < count);
+		REQUIRE((mask.back() >> (count % 32)) == 0u);
+	}
+	SECTION("AABBs") {
+		frustum.cullAABBs(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(),
+		                  count, mask.data());
+		size_t numVisible = 0;
+		for (size_t i = 0; i < count; i++) {
+			AABB aabb(vec3(minX[i], minY[i], minZ[i]), vec3(maxX[i], maxY[i], maxZ[i]));
+			bool expected = frustum.isVisible(aabb);
+			REQUIRE(maskBit(mask, i) == expected);
+			if (expected) numVisible++;
+		}
+		REQUIRE(numVisible > 0);
+		REQUIRE(numVisible < count);
+		REQUIRE((mask.back() >> (count % 32)) == 0u);
+	}
+}
+
+static vec3 fromNdc(const mat4& viewMatrix, const mat4& projMatrix, vec3 ndc) noexcept
+{
+	vec4 p = inverse(projMatrix * viewMatrix) * vec4(ndc, 1.0f);
+	return p.xyz / p[3];
+}
+
+TEST_CASE("ViewFrustum from view and projection matrices", "[sfz::ViewFrustum]")
+{
+	SECTION("Symmetric frustum matches parameter constructor") {
+		const ViewFrustum ref(vec3(1.0f, 2.0f, 3.0f), vec3(1.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f),
+		                      70.0f, 1.0f, 0.5f, 50.0f);
+		const ViewFrustum fromMats(ref.viewMatrix(), ref.projMatrix());
+		REQUIRE(approxEqual(fromMats.pos(), ref.pos(), 1e-4f));
+		REQUIRE(approxEqual(fromMats.dir(), ref.dir(), 1e-4f));
+		REQUIRE(approxEqual(fromMats.up(), ref.up(), 1e-4f));
+		REQUIRE(approxEqual(fromMats.near(), ref.near(), 1e-3f));
+		REQUIRE(approxEqual(fromMats.far(), ref.far(), 0.05f));
+		REQUIRE(approxEqual(fromMats.verticalFov(), ref.verticalFov(), 0.01f));
+		REQUIRE(approxEqual(fromMats.aspectRatio(), ref.aspectRatio(), 1e-3f));
+
+		std::mt19937 gen(3);
+		std::uniform_real_distribution<float> distr(-60.0f, 60.0f);
+		for (int i = 0; i < 1000; i++) {
+			Sphere sphere(vec3(distr(gen), distr(gen), distr(gen)), 1.0f);
+			REQUIRE(fromMats.isVisible(sphere) == ref.isVisible(sphere));
+		}
+	}
+	SECTION("Asymmetric frustum") {
+		const mat4 view = lookAt(vec3(0.0f, 1.5f, 0.0f), vec3(0.0f, 1.5f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+		const mat4 proj = perspectiveProjectionMatrix(-0.15f, -0.1f, 0.1f, 0.05f, 0.12f, 100.0f);
+		const ViewFrustum frustum(view, proj);
+		REQUIRE(approxEqual(frustum.pos(), vec3(0.0f, 1.5f, 0.0f), 1e-4f));
+		REQUIRE(approxEqual(frustum.dir(), vec3(0.0f, 0.0f, -1.0f), 1e-4f));
+		REQUIRE(approxEqual(frustum.near(), 0.1f, 1e-4f));
+		REQUIRE(approxEqual(frustum.far(), 100.0f, 0.05f));
+
+		for (float x : { -0.95f, 0.0f, 0.95f }) {
+			for (float y : { -0.95f, 0.0f, 0.95f }) {
+				for (float z : { -0.95f, 0.0f, 0.95f }) {
+					vec3 inside = fromNdc(view, proj, vec3(x, y, z));
+					REQUIRE(frustum.isVisible(Sphere(inside, 1e-4f)));
+					vec3 outsideX = fromNdc(view, proj, vec3(x < 0.0f ? -1.05f : 1.05f, y, z));
+					REQUIRE(!frustum.isVisible(Sphere(outsideX, 1e-4f)));
+					vec3 outsideY = fromNdc(view, proj, vec3(x, y < 0.0f ? -1.05f : 1.05f, z));
+					REQUIRE(!frustum.isVisible(Sphere(outsideY, 1e-4f)));
+				}
+			}
+		}
+		REQUIRE(!frustum.isVisible(Sphere(vec3(0.0f, 1.5f, 0.05f), 0.01f)));
+		REQUIRE(!frustum.isVisible(Sphere(vec3(0.0f, 1.5f, -101.0f), 0.01f)));
+	}
+}
+
+TEST_CASE("Combined stereo ViewFrustum", "[sfz::ViewFrustum]")
+{
+	// Eyes 64mm apart with mirrored asymmetric projections, slightly canted outwards
+	const vec3 head(0.0f, 1.7f, 0.0f);
+	const mat4 leftView = lookAt(head - vec3(0.032f, 0.0f, 0.0f),
+	                             head + vec3(-0.1f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+	const mat4 rightView = lookAt(head + vec3(0.032f, 0.0f, 0.0f),
+	                              head + vec3(0.1f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+	const mat4 leftProj = perspectiveProjectionMatrix(-0.14f, -0.12f, 0.1f, 0.09f, 0.11f, 50.0f);
+	const mat4 rightProj = perspectiveProjectionMatrix(-0.09f, -0.12f, 0.1f, 0.14f, 0.11f, 50.0f);
+
+	const ViewFrustum leftEye(leftView, leftProj);
+	const ViewFrustum rightEye(rightView, rightProj);
+	const ViewFrustum combined = ViewFrustum::combinedStereo(leftView, leftProj, rightView, rightProj);
+
+	std::mt19937 gen(11);
+	std::uniform_real_distribution<float> distr(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> radiusDistr(0.01f, 2.0f);
+	size_t numVisible = 0, numCulled = 0;
+	for (int i = 0; i < 5000; i++) {
+		Sphere sphere(head + vec3(distr(gen), distr(gen), distr(gen)), radiusDistr(gen));
+		bool visibleInEye = leftEye.isVisible(sphere) || rightEye.isVisible(sphere);
+		if (visibleInEye) {
+			REQUIRE(combined.isVisible(sphere));
+			numVisible++;
+		}
+		if (!combined.isVisible(sphere)) numCulled++;
+	}
+	REQUIRE(numVisible > 0);
+	REQUIRE(numCulled > 0);
+
+	// Corners of both eye frustums are inside the combined frustum
+	for (float x : { -1.0f, 1.0f }) {
+		for (float y : { -1.0f, 1.0f }) {
+			for (float z : { -1.0f, 1.0f }) {
+				REQUIRE(combined.isVisible(Sphere(fromNdc(leftView, leftProj, vec3(x, y, z)), 1e-3f)));
+				REQUIRE(combined.isVisible(Sphere(fromNdc(rightView, rightProj, vec3(x, y, z)), 1e-3f)));
+			}
+		}
+	}
+	REQUIRE(!combined.isVisible(Sphere(head + vec3(0.0f, 0.0f, 1.0f), 0.1f)));
+}
@@ -0,0 +1,148 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+
+#include "sfz/math/FastMath.hpp"
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MathHelpers.hpp"
+
+using namespace sfz;
+
+// Packet and scalar versions may be compiled differently (e.g. contracted to fma with
+// -ffast-math), so they are only required to agree up to rounding
+static bool nearlyEqual(float lhs, float rhs) noexcept
+{
+	return std::abs(lhs - rhs) <= 1e-6f * std::max(1.0f, std::abs(rhs));
+}
+
+TEST_CASE("fastRsqrt(), fastSqrt() & fastNormalize()", "[sfz::FastMath]")
+{
+	SECTION("Error bounds") {
+		float maxRelError = 0.0f;
+		for (float x = 1e-6f; x < 1e6f; x *= 1.01f) {
+			float relError = std::abs(fastRsqrt(x) * std::sqrt(x) - 1.0f);
+			maxRelError = std::max(maxRelError, relError);
+			REQUIRE(std::abs(fastSqrt(x) / std::sqrt(x) - 1.0f) <= 1.8e-3f);
+		}
+		REQUIRE(maxRelError <= 1.8e-3f);
+		REQUIRE(fastSqrt(0.0f) == 0.0f);
+	}
+	SECTION("fastNormalize()") {
+		vec3 vectors[] = {vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 2.0f, 3.0f), vec3(-100.0f, 0.1f, 5.0f)};
+		for (const vec3& v : vectors) {
+			vec3 n = fastNormalize(v);
+			REQUIRE(std::abs(length(n) - 1.0f) <= 1.8e-3f);
+			REQUIRE(length(n - normalize(v)) <= 1.8e-3f);
+		}
+	}
+	SECTION("Packets match scalar versions") {
+		float arr[] = {0.5f, 1.0f, 2.0f, 100.0f, 0.001f, 3.0f, 7.0f, 1e5f};
+		floatx8 p{arr};
+		floatx8 rsqrt = fastRsqrt(p);
+		floatx8 sqrt = fastSqrt(p);
+		for (size_t i = 0; i < 8; i++) {
+			REQUIRE(nearlyEqual(rsqrt[i], fastRsqrt(arr[i])));
+			REQUIRE(nearlyEqual(sqrt[i], fastSqrt(arr[i])));
+		}
+		vec3 vecs[] = {vec3(1.0f, 2.0f, 3.0f), vec3(0.0f, 0.0f, 2.0f), vec3(-1.0f), vec3(4.0f, 0.0f, 3.0f)};
+		vec3x4 normalized = fastNormalize(loadAoS<4>(vecs));
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(approxEqual(normalized.lane(i), fastNormalize(vecs[i])));
+		}
+	}
+}
+
+TEST_CASE("fastSin() & fastCos()", "[sfz::FastMath]")
+{
+	SECTION("Error bounds") {
+		float maxError = 0.0f;
+		for (float x = -2.0f * PI<float>(); x <= 2.0f * PI<float>(); x += 0.0001f) {
+			maxError = std::max(maxError, std::abs(fastSin(x) - std::sin(x)));
+			maxError = std::max(maxError, std::abs(fastCos(x) - std::cos(x)));
+		}
+		REQUIRE(maxError <= 5e-7f);
+
+		float maxErrorLarge = 0.0f;
+		for (float x = -1e4f; x <= 1e4f; x += 0.37f) {
+			maxErrorLarge = std::max(maxErrorLarge, std::abs(fastSin(x) - std::sin(x)));
+			maxErrorLarge = std::max(maxErrorLarge, std::abs(fastCos(x) - std::cos(x)));
+		}
+		REQUIRE(maxErrorLarge <= 5e-7f);
+	}
+	SECTION("Packets match scalar versions") {
+		float arr[] = {-10.0f, -3.0f, -1.0f, 0.0f, 0.5f, 1.5f, 3.14f, 100.0f};
+		floatx8 p{arr};
+		floatx8 sin = fastSin(p);
+		floatx8 cos = fastCos(p);
+		for (size_t i = 0; i < 8; i++) {
+			REQUIRE(nearlyEqual(sin[i], fastSin(arr[i])));
+			REQUIRE(nearlyEqual(cos[i], fastCos(arr[i])));
+		}
+	}
+}
+
+TEST_CASE("fastAtan2()", "[sfz::FastMath]")
+{
+	SECTION("Error bounds") {
+		float maxError = 0.0f;
+		for (float angle = -PI<float>(); angle <= PI<float>(); angle += 0.0001f) {
+			for (float radius : {0.001f, 1.0f, 1000.0f}) {
+				float x = radius * std::cos(angle);
+				float y = radius * std::sin(angle);
+				maxError = std::max(maxError, std::abs(fastAtan2(y, x) - std::atan2(y, x)));
+			}
+		}
+		REQUIRE(maxError <= 1.5e-5f);
+		REQUIRE(fastAtan2(0.0f, 0.0f) == 0.0f);
+	}
+	SECTION("Packets match scalar versions") {
+		float ys[] = {1.0f, -1.0f, 0.0f, 5.0f};
+		float xs[] = {1.0f, 1.0f, -1.0f, -0.1f};
+		floatx4 result = fastAtan2(floatx4{ys}, floatx4{xs});
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(nearlyEqual(result[i], fastAtan2(ys[i], xs[i])));
+		}
+	}
+}
+
+TEST_CASE("fastExp()", "[sfz::FastMath]")
+{
+	SECTION("Error bounds") {
+		float maxRelError = 0.0f;
+		for (float x = -87.0f; x <= 88.0f; x += 0.001f) {
+			float reference = std::exp(x);
+			maxRelError = std::max(maxRelError, std::abs(fastExp(x) - reference) / reference);
+		}
+		REQUIRE(maxRelError <= 5e-7f);
+		REQUIRE(fastExp(0.0f) == 1.0f);
+		REQUIRE(fastExp(-1000.0f) > 0.0f);
+	}
+	SECTION("Packets match scalar versions") {
+		float arr[] = {-50.0f, -1.0f, 0.0f, 1.0f};
+		floatx4 result = fastExp(floatx4{arr});
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(nearlyEqual(result[i], fastExp(arr[i])));
+		}
+	}
+}
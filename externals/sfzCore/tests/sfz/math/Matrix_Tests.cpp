@@ -477,6 +477,38 @@ bool approxEqual(const sfz::Matrix<float,4,4>& lhs, const sfz::Matrix<float,4,4>
 	return sfz::approxEqual<float,4,4>(lhs, rhs);
 }
 
+TEST_CASE("Matrix constexpr", "[sfz::Matrix]")
+{
+	using namespace sfz;
+
+	constexpr mat3 a{{1.0f, 2.0f, 3.0f},
+	                 {4.0f, 5.0f, 6.0f},
+	                 {7.0f, 8.0f, 9.0f}};
+	constexpr float arr[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f};
+	constexpr mat3 b{arr, true};
+	constexpr mat3 c{arr, false};
+
+	static_assert(a == b, "constexpr constructors");
+	static_assert(transpose(a) == c, "constexpr transpose()");
+	static_assert(a.at(0, 2) == 3.0f, "constexpr at()");
+	static_assert(a.rowAt(1) == vec3(4.0f, 5.0f, 6.0f), "constexpr rowAt()");
+	static_assert(a.columnAt(1) == vec3(2.0f, 5.0f, 8.0f), "constexpr columnAt()");
+
+	static_assert(a + a == a * 2.0f, "constexpr operator+ and operator*");
+	static_assert(a - a == mat3{}, "constexpr operator-");
+	static_assert(-a == a * -1.0f, "constexpr unary operator-");
+	static_assert(elemMult(a, identityMatrix3<float>()) == scalingMatrix3(1.0f, 5.0f, 9.0f), "constexpr elemMult()");
+	static_assert(a * identityMatrix3<float>() == a, "constexpr operator*");
+	static_assert(a * vec3(1.0f, 0.0f, 0.0f) == vec3(1.0f, 4.0f, 7.0f), "constexpr operator*");
+
+	constexpr mat4 transform = translationMatrix(vec3(1.0f, 2.0f, 3.0f)) * scalingMatrix4(2.0f);
+	static_assert(transform * vec4(1.0f, 1.0f, 1.0f, 1.0f) == vec4(3.0f, 4.0f, 5.0f, 1.0f), "constexpr transformation matrices");
+	static_assert(identityMatrix4<float>() * transform == transform, "constexpr identityMatrix4()");
+	static_assert(scalingMatrix4(2.0f, 3.0f, 4.0f).at(1, 1) == 3.0f, "constexpr scalingMatrix4()");
+
+	REQUIRE(a * identityMatrix3<float>() == a);
+}
+
 TEST_CASE("Resizing Matrices", "[sfz::MatrixSupport]")
 {
 	sfz::Matrix<int, 4, 4> m1{{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}, {13, 14, 15, 16}};
@@ -0,0 +1,210 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "sfz/math/MathConstants.hpp"
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/PackedVector.hpp"
+
+using namespace sfz;
+
+// std::isnan() may be folded to false with -ffast-math, so NaN is checked through the bits
+static bool isNaNBits(float value) noexcept
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(uint32_t));
+	return (bits & 0x7F800000u) == 0x7F800000u && (bits & 0x007FFFFFu) != 0;
+}
+
+TEST_CASE("Half-precision conversion", "[sfz::PackedVector]")
+{
+	SECTION("Exact values") {
+		REQUIRE(floatToHalf(0.0f) == 0x0000);
+		REQUIRE(floatToHalf(-0.0f) == 0x8000);
+		REQUIRE(floatToHalf(1.0f) == 0x3C00);
+		REQUIRE(floatToHalf(-2.0f) == 0xC000);
+		REQUIRE(floatToHalf(65504.0f) == 0x7BFF);
+		REQUIRE(floatToHalf(0.5f) == 0x3800);
+
+		REQUIRE(halfToFloat(0x3C00) == 1.0f);
+		REQUIRE(halfToFloat(0xC000) == -2.0f);
+		REQUIRE(halfToFloat(0x7BFF) == 65504.0f);
+		REQUIRE(halfToFloat(0x0001) == std::ldexp(1.0f, -24)); // Smallest denormal
+	}
+	SECTION("Special values") {
+		float inf = std::numeric_limits<float>::infinity();
+		REQUIRE(floatToHalf(inf) == 0x7C00);
+		REQUIRE(floatToHalf(-inf) == 0xFC00);
+		REQUIRE(floatToHalf(100000.0f) == 0x7C00);
+		REQUIRE(halfToFloat(0x7C00) == inf);
+		uint16_t nanHalf = floatToHalf(std::numeric_limits<float>::quiet_NaN());
+		REQUIRE((nanHalf & 0x7C00) == 0x7C00);
+		REQUIRE((nanHalf & 0x03FF) != 0);
+		REQUIRE(isNaNBits(halfToFloat(nanHalf)));
+	}
+	SECTION("All halfs survive roundtrip") {
+		for (uint32_t i = 0; i < 0x10000u; i++) {
+			uint16_t h = uint16_t(i);
+			bool isNaN = (h & 0x7C00) == 0x7C00 && (h & 0x03FF) != 0;
+			if (isNaN) continue;
+			REQUIRE(floatToHalf(halfToFloat(h)) == h);
+		}
+	}
+	SECTION("Batch kernels and relative error") {
+		const size_t COUNT = 1000;
+		float original[COUNT], reconstructed[COUNT];
+		uint16_t packed[COUNT];
+		for (size_t i = 0; i < COUNT; i++) {
+			original[i] = (float(i) - 500.0f) * 0.37f;
+		}
+		packHalf(original, packed, COUNT);
+		unpackHalf(packed, reconstructed, COUNT);
+		for (size_t i = 0; i < COUNT; i++) {
+			REQUIRE(packed[i] == floatToHalf(original[i]));
+			REQUIRE(std::abs(original[i] - reconstructed[i]) <= std::abs(original[i]) * (1.0f / 2048.0f));
+		}
+		REQUIRE(maxAbsoluteError(original, reconstructed, COUNT) <= 0.0625f);
+	}
+	SECTION("Vectors") {
+		half3 h = packHalf(vec3(1.0f, -0.5f, 2.0f));
+		REQUIRE(h.elements[0] == 0x3C00);
+		REQUIRE(unpackHalf(h) == vec3(1.0f, -0.5f, 2.0f));
+	}
+}
+
+TEST_CASE("Normalized 16-bit conversion", "[sfz::PackedVector]")
+{
+	SECTION("unorm16") {
+		REQUIRE(floatToUnorm16(0.0f) == 0);
+		REQUIRE(floatToUnorm16(1.0f) == 65535);
+		REQUIRE(floatToUnorm16(2.0f) == 65535);
+		REQUIRE(floatToUnorm16(-1.0f) == 0);
+		REQUIRE(unorm16ToFloat(65535) == 1.0f);
+		for (float f = 0.0f; f <= 1.0f; f += 0.01f) {
+			REQUIRE(std::abs(unorm16ToFloat(floatToUnorm16(f)) - f) <= 0.5f / 65535.0f + 1e-7f);
+		}
+		unorm16x2 uv = packUnorm16(vec2(0.25f, 0.75f));
+		vec2 uvUnpacked = unpackUnorm16(uv);
+		REQUIRE(std::abs(uvUnpacked.x - 0.25f) < 1e-4f);
+		REQUIRE(std::abs(uvUnpacked.y - 0.75f) < 1e-4f);
+	}
+	SECTION("snorm16") {
+		REQUIRE(floatToSnorm16(0.0f) == 0);
+		REQUIRE(floatToSnorm16(1.0f) == 32767);
+		REQUIRE(floatToSnorm16(-1.0f) == -32767);
+		REQUIRE(floatToSnorm16(-3.0f) == -32767);
+		REQUIRE(snorm16ToFloat(-32768) == -1.0f);
+		REQUIRE(snorm16ToFloat(32767) == 1.0f);
+		for (float f = -1.0f; f <= 1.0f; f += 0.01f) {
+			REQUIRE(std::abs(snorm16ToFloat(floatToSnorm16(f)) - f) <= 0.5f / 32767.0f + 1e-7f);
+		}
+		vec2 v = unpackSnorm16(packSnorm16(vec2(-0.5f, 0.5f)));
+		REQUIRE(std::abs(v.x + 0.5f) < 1e-4f);
+		REQUIRE(std::abs(v.y - 0.5f) < 1e-4f);
+	}
+}
+
+TEST_CASE("Octahedral normals", "[sfz::PackedVector]")
+{
+	SECTION("Axes survive roundtrip") {
+		vec3 axes[] = {
+			vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+			vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+			vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f)
+		};
+		for (const vec3& axis : axes) {
+			REQUIRE(approxEqual(unpackOctNormal(packOctNormal(axis)), axis));
+		}
+	}
+	SECTION("Sphere error bound") {
+		const size_t NUM_THETA = 65, NUM_PHI = 31, COUNT = NUM_THETA * NUM_PHI;
+		vec3 original[COUNT], reconstructed[COUNT];
+		snorm16x2 packed[COUNT];
+		for (size_t i = 0; i < NUM_THETA; i++) {
+			for (size_t j = 0; j < NUM_PHI; j++) {
+				float theta = 2.0f * PI<float>() * float(i) / float(NUM_THETA);
+				float phi = PI<float>() * (float(j) + 0.5f) / float(NUM_PHI);
+				original[i * NUM_PHI + j] = vec3(std::cos(theta) * std::sin(phi),
+				                                 std::sin(theta) * std::sin(phi), std::cos(phi));
+			}
+		}
+		packOctNormals(original, packed, COUNT);
+		unpackOctNormals(packed, reconstructed, COUNT);
+		for (size_t i = 0; i < COUNT; i++) {
+			// The compiler may vectorize the inlined batch loop differently, allow one step of difference
+			snorm16x2 scalar = packOctNormal(original[i]);
+			REQUIRE(std::abs(int(packed[i].elements[0]) - int(scalar.elements[0])) <= 1);
+			REQUIRE(std::abs(int(packed[i].elements[1]) - int(scalar.elements[1])) <= 1);
+			REQUIRE(std::abs(length(reconstructed[i]) - 1.0f) < 1e-5f);
+		}
+
+		// 16 bits per component gives an error well below 0.01 degrees
+		REQUIRE(maxAngularError(original, reconstructed, COUNT) < 0.0002f);
+	}
+}
+
+TEST_CASE("Quantized positions", "[sfz::PackedVector]")
+{
+	const vec3 boundsMin(-2.0f, 0.0f, -10.0f);
+	const vec3 boundsMax(2.0f, 1.0f, 10.0f);
+
+	SECTION("Corners are exact") {
+		REQUIRE(dequantizePosition(quantizePosition(boundsMin, boundsMin, boundsMax), boundsMin, boundsMax) == boundsMin);
+		REQUIRE(dequantizePosition(quantizePosition(boundsMax, boundsMin, boundsMax), boundsMin, boundsMax) == boundsMax);
+	}
+	SECTION("Outside positions are clamped") {
+		unorm16x3 q = quantizePosition(vec3(5.0f, -1.0f, 0.0f), boundsMin, boundsMax);
+		REQUIRE(q.elements[0] == 65535);
+		REQUIRE(q.elements[1] == 0);
+	}
+	SECTION("Flat bounds") {
+		unorm16x3 q = quantizePosition(vec3(1.0f, 2.0f, 3.0f), vec3(1.0f, 2.0f, 3.0f), vec3(1.0f, 2.0f, 3.0f));
+		REQUIRE(dequantizePosition(q, vec3(1.0f, 2.0f, 3.0f), vec3(1.0f, 2.0f, 3.0f)) == vec3(1.0f, 2.0f, 3.0f));
+	}
+	SECTION("Batch kernels and error bound") {
+		const size_t COUNT = 1003;
+		vec3 original[COUNT], reconstructed[COUNT];
+		unorm16x3 packed[COUNT];
+		for (size_t i = 0; i < COUNT; i++) {
+			float t = float(i) / float(COUNT - 1);
+			original[i] = boundsMin + (boundsMax - boundsMin) * vec3(t, t * t, 1.0f - t);
+		}
+		quantizePositions(original, packed, COUNT, boundsMin, boundsMax);
+		dequantizePositions(packed, reconstructed, COUNT, boundsMin, boundsMax);
+		for (size_t i = 0; i < COUNT; i++) {
+			unorm16x3 scalar = quantizePosition(original[i], boundsMin, boundsMax);
+			for (size_t j = 0; j < 3; j++) {
+				REQUIRE(std::abs(int(packed[i].elements[j]) - int(scalar.elements[j])) <= 1);
+			}
+			REQUIRE(approxEqual(reconstructed[i], dequantizePosition(packed[i], boundsMin, boundsMax)));
+		}
+
+		// Max error is half a quantization step per axis
+		vec3 halfStep = (boundsMax - boundsMin) * (0.5f / 65535.0f);
+		REQUIRE(maxPositionError(original, reconstructed, COUNT) <= length(halfStep) * 1.01f);
+	}
+}
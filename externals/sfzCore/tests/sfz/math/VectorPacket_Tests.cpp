@@ -0,0 +1,233 @@
+// Copyright (c) Peter Hillerström (skipifzero.com, peter@hstroem.se)
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "sfz/PushWarnings.hpp"
+#include "catch.hpp"
+#include "sfz/PopWarnings.hpp"
+
+#include "sfz/math/MathHelpers.hpp"
+#include "sfz/math/VectorPacket.hpp"
+
+using namespace sfz;
+
+TEST_CASE("FloatPacket basics", "[sfz::VectorPacket]")
+{
+	SECTION("Data and alignment") {
+		REQUIRE(sizeof(floatx4) == sizeof(float) * 4);
+		REQUIRE(sizeof(floatx8) == sizeof(float) * 8);
+		REQUIRE(alignof(floatx4) == 16);
+		REQUIRE(alignof(floatx8) == 32);
+		REQUIRE(sizeof(vec3x4) == sizeof(float) * 12);
+		REQUIRE(sizeof(vec3x8) == sizeof(float) * 24);
+	}
+	SECTION("Constructors") {
+		floatx4 p1{2.0f};
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(p1[i] == 2.0f);
+		}
+		float arr[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+		floatx8 p2{arr};
+		for (size_t i = 0; i < 8; i++) {
+			REQUIRE(p2[i] == arr[i]);
+		}
+	}
+	SECTION("Arithmetic") {
+		float arr1[] = {1.0f, 2.0f, 3.0f, 4.0f};
+		float arr2[] = {4.0f, 2.0f, -1.0f, 8.0f};
+		floatx4 a{arr1}, b{arr2};
+
+		floatx4 sum = a + b;
+		floatx4 diff = a - b;
+		floatx4 prod = a * b;
+		floatx4 quot = a / b;
+		floatx4 neg = -a;
+		floatx4 scaled = 2.0f * a;
+		floatx4 fma = multiplyAdd(a, b, floatx4{1.0f});
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(sum[i] == arr1[i] + arr2[i]);
+			REQUIRE(diff[i] == arr1[i] - arr2[i]);
+			REQUIRE(prod[i] == arr1[i] * arr2[i]);
+			REQUIRE(quot[i] == arr1[i] / arr2[i]);
+			REQUIRE(neg[i] == -arr1[i]);
+			REQUIRE(scaled[i] == 2.0f * arr1[i]);
+			REQUIRE(fma[i] == arr1[i] * arr2[i] + 1.0f);
+		}
+	}
+	SECTION("Functions") {
+		float arr1[] = {1.0f, -2.0f, 9.0f, 4.0f};
+		float arr2[] = {4.0f, 2.0f, -1.0f, 16.0f};
+		floatx4 a{arr1}, b{arr2};
+
+		floatx4 mi = min(a, b);
+		floatx4 ma = max(a, b);
+		floatx4 ab = abs(a);
+		floatx4 sq = sqrt(abs(b));
+		REQUIRE(mi[0] == 1.0f);
+		REQUIRE(mi[1] == -2.0f);
+		REQUIRE(mi[2] == -1.0f);
+		REQUIRE(mi[3] == 4.0f);
+		REQUIRE(ma[0] == 4.0f);
+		REQUIRE(ma[1] == 2.0f);
+		REQUIRE(ma[2] == 9.0f);
+		REQUIRE(ma[3] == 16.0f);
+		REQUIRE(ab[1] == 2.0f);
+		REQUIRE(approxEqual(sq[0], 2.0f));
+		REQUIRE(approxEqual(sq[3], 4.0f));
+		REQUIRE(horizontalMin(a) == -2.0f);
+		REQUIRE(horizontalMax(a) == 9.0f);
+	}
+}
+
+TEST_CASE("LaneMask comparisons", "[sfz::VectorPacket]")
+{
+	float arr1[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+	float arr2[] = {8.0f, 2.0f, 6.0f, 4.0f, 4.0f, 3.0f, 2.0f, 1.0f};
+	floatx8 a{arr1}, b{arr2};
+
+	SECTION("ALL_LANES") {
+		REQUIRE(ALL_LANES<4>() == 0x0Fu);
+		REQUIRE(ALL_LANES<8>() == 0xFFu);
+	}
+	SECTION("Comparisons") {
+		REQUIRE(lessThan(a, b) == 0x05u);
+		REQUIRE(lessThanEqual(a, b) == 0x0Fu);
+		REQUIRE(greaterThan(a, b) == 0xF0u);
+		REQUIRE(greaterThanEqual(a, b) == 0xFAu);
+		REQUIRE(equal(a, b) == 0x0Au);
+	}
+	SECTION("anyLane() & allLanes()") {
+		REQUIRE(anyLane(lessThan(a, b)));
+		REQUIRE(!anyLane(lessThan(a, floatx8{0.0f})));
+		REQUIRE(allLanes<8>(lessThan(a, floatx8{10.0f})));
+		REQUIRE(!allLanes<8>(lessThan(a, b)));
+		REQUIRE(allLanes<4>(lessThanEqual(a, b)));
+	}
+	SECTION("select()") {
+		floatx8 s = select(lessThan(a, b), a, b);
+		floatx8 m = min(a, b);
+		for (size_t i = 0; i < 8; i++) {
+			REQUIRE(s[i] == m[i]);
+		}
+	}
+}
+
+TEST_CASE("Vec3Packet", "[sfz::VectorPacket]")
+{
+	vec3 arr[] = {
+		vec3{1.0f, 2.0f, 3.0f},
+		vec3{-1.0f, 0.0f, 4.0f},
+		vec3{0.0f, 5.0f, -2.0f},
+		vec3{2.0f, 2.0f, 1.0f}
+	};
+	vec3 arr2[] = {
+		vec3{3.0f, 1.0f, 0.0f},
+		vec3{1.0f, 1.0f, 1.0f},
+		vec3{-4.0f, 2.0f, 2.0f},
+		vec3{0.0f, 0.0f, 2.0f}
+	};
+
+	SECTION("Loading & storing") {
+		vec3x4 p = loadAoS<4>(arr);
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(p.lane(i) == arr[i]);
+		}
+
+		vec3 out[4];
+		storeAoS(p, out);
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(out[i] == arr[i]);
+		}
+
+		float xs[4], ys[4], zs[4];
+		storeSoA(p, xs, ys, zs);
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(xs[i] == arr[i].x);
+			REQUIRE(ys[i] == arr[i].y);
+			REQUIRE(zs[i] == arr[i].z);
+		}
+		vec3x4 p2 = loadSoA<4>(xs, ys, zs);
+		REQUIRE(allLanes<4>(equal(p, p2)));
+
+		p2.setLane(2, vec3{9.0f, 9.0f, 9.0f});
+		REQUIRE(p2.lane(2) == vec3(9.0f, 9.0f, 9.0f));
+		REQUIRE(equal(p, p2) == 0x0Bu);
+
+		vec3x4 broadcast{vec3{1.0f, 2.0f, 3.0f}};
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(broadcast.lane(i) == vec3(1.0f, 2.0f, 3.0f));
+		}
+	}
+	SECTION("Functions match scalar versions") {
+		vec3x4 a = loadAoS<4>(arr);
+		vec3x4 b = loadAoS<4>(arr2);
+
+		floatx4 d = dot(a, b);
+		floatx4 dv = dot(a, arr2[0]);
+		vec3x4 c = cross(a, b);
+		floatx4 len = length(a);
+		floatx4 sqLen = squaredLength(a);
+		vec3x4 mi = min(a, b);
+		vec3x4 ma = max(a, b);
+		vec3x4 ab = abs(a);
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(d[i] == dot(arr[i], arr2[i]));
+			REQUIRE(dv[i] == dot(arr[i], arr2[0]));
+			REQUIRE(c.lane(i) == cross(arr[i], arr2[i]));
+			REQUIRE(approxEqual(len[i], length(arr[i])));
+			REQUIRE(sqLen[i] == squaredLength(arr[i]));
+			REQUIRE(mi.lane(i) == sfz::min(arr[i], arr2[i]));
+			REQUIRE(ma.lane(i) == sfz::max(arr[i], arr2[i]));
+			REQUIRE(ab.lane(i) == sfz::abs(arr[i]));
+		}
+		REQUIRE(horizontalMin(a) == vec3(-1.0f, 0.0f, -2.0f));
+		REQUIRE(horizontalMax(a) == vec3(2.0f, 5.0f, 4.0f));
+	}
+	SECTION("Operators match scalar versions") {
+		vec3x4 a = loadAoS<4>(arr);
+		vec3x4 b = loadAoS<4>(arr2);
+		float sArr[] = {1.0f, 2.0f, 4.0f, 8.0f};
+		floatx4 s{sArr};
+
+		vec3x4 sum = a + b;
+		vec3x4 diff = a - b;
+		vec3x4 neg = -a;
+		vec3x4 prod = a * b;
+		vec3x4 scaled = a * s;
+		vec3x4 scaled2 = 3.0f * a;
+		vec3x4 quot = a / s;
+		for (size_t i = 0; i < 4; i++) {
+			REQUIRE(sum.lane(i) == arr[i] + arr2[i]);
+			REQUIRE(diff.lane(i) == arr[i] - arr2[i]);
+			REQUIRE(neg.lane(i) == -arr[i]);
+			REQUIRE(prod.lane(i) == arr[i] * arr2[i]);
+			REQUIRE(scaled.lane(i) == arr[i] * sArr[i]);
+			REQUIRE(scaled2.lane(i) == 3.0f * arr[i]);
+			REQUIRE(approxEqual(quot.lane(i), arr[i] / sArr[i]));
+		}
+	}
+	SECTION("select()") {
+		vec3x4 a = loadAoS<4>(arr);
+		vec3x4 b = loadAoS<4>(arr2);
+		vec3x4 s = select(0x06u, a, b);
+		REQUIRE(s.lane(0) == arr2[0]);
+		REQUIRE(s.lane(1) == arr[1]);
+		REQUIRE(s.lane(2) == arr[2]);
+		REQUIRE(s.lane(3) == arr2[3]);
+	}
+}
@@ -738,4 +738,42 @@ TEST_CASE("Is proper POD", "[sfz::Vector]")
 	REQUIRE(std::is_literal_type<sfz::vec2i>::value);
 	REQUIRE(std::is_literal_type<sfz::vec3>::value);
 	REQUIRE(std::is_literal_type<sfz::vec3i>::value);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Vector constexpr", "[sfz::Vector]")
+{
+	using namespace sfz;
+
+	constexpr vec3 a{1.0f, 2.0f, 3.0f};
+	constexpr vec3 b{vec2{4.0f, 5.0f}, 6.0f};
+	constexpr vec4 c{a, 1.0f};
+	constexpr vec3i d{vec3{1.5f, 2.5f, -3.5f}};
+	constexpr float arr[] = {1.0f, 2.0f, 3.0f};
+	constexpr vec3 e{arr};
+
+	static_assert(a[0] == 1.0f && a[1] == 2.0f && a[2] == 3.0f, "constexpr constructor");
+	static_assert(b[0] == 4.0f && b[2] == 6.0f, "constexpr constructor");
+	static_assert(c[3] == 1.0f, "constexpr constructor");
+	static_assert(d == vec3i(1, 2, -3), "constexpr conversion");
+	static_assert(e == a, "constexpr array constructor");
+	static_assert(vec3(2.0f) == vec3(2.0f, 2.0f, 2.0f), "constexpr fill constructor");
+
+	static_assert(a + b == vec3(5.0f, 7.0f, 9.0f), "constexpr operator+");
+	static_assert(b - a == vec3(3.0f), "constexpr operator-");
+	static_assert(-a == vec3(-1.0f, -2.0f, -3.0f), "constexpr unary operator-");
+	static_assert(a * 2.0f == vec3(2.0f, 4.0f, 6.0f), "constexpr operator*");
+	static_assert(2.0f * a == a * b / b * 2.0f, "constexpr operator*");
+	static_assert(a * b == vec3(4.0f, 10.0f, 18.0f), "constexpr element-wise operator*");
+	static_assert(b / 2.0f == vec3(2.0f, 2.5f, 3.0f), "constexpr operator/");
+	static_assert(a != b, "constexpr operator!=");
+
+	static_assert(dot(a, b) == 32.0f, "constexpr dot()");
+	static_assert(squaredLength(a) == 14.0f, "constexpr squaredLength()");
+	static_assert(sum(c) == 7.0f, "constexpr sum()");
+	static_assert(cross(UNIT_X(), UNIT_Y()) == UNIT_Z(), "constexpr cross()");
+
+	constexpr Vector<int,5> f{Vector<int,5>{} + Vector<int,5>{}};
+	static_assert(f == Vector<int,5>{}, "constexpr generic Vector");
+
+	REQUIRE(a + b == vec3(5.0f, 7.0f, 9.0f));
+}
@@ -131,3 +131,51 @@ TEST_CASE("readTextFile()", "[sfz::IO]")
 	REQUIRE(emptyStr == "");
 	REQUIRE(sfz::deleteFile(fpath));
 }
+
+TEST_CASE("fileModificationTime()", "[sfz::IO]")
+{
+	auto filePath = appendBasePath(stupidFileName);
+	const char* fpath = filePath.str();
+	if (sfz::fileExists(fpath)) REQUIRE(sfz::deleteFile(fpath));
+
+	REQUIRE(sfz::fileModificationTime(fpath) < 0);
+	REQUIRE(sfz::createFile(fpath));
+	REQUIRE(sfz::fileModificationTime(fpath) > 0);
+	REQUIRE(sfz::deleteFile(fpath));
+}
+
+TEST_CASE("MappedFile", "[sfz::IO]")
+{
+	auto filePath = appendBasePath(stupidFileName);
+	const char* fpath = filePath.str();
+	const uint8_t data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xA, 0xB, 0xC, 0xD, 0xE};
+	if (sfz::fileExists(fpath)) REQUIRE(sfz::deleteFile(fpath));
+
+	// Missing file
+	sfz::MappedFile missing(fpath);
+	REQUIRE(!missing.isMapped());
+	REQUIRE(missing.data() == nullptr);
+	REQUIRE(missing.size() == 0);
+
+	// Empty file
+	REQUIRE(sfz::writeBinaryFile(fpath, data, 0));
+	sfz::MappedFile empty(fpath);
+	REQUIRE(!empty.isMapped());
+
+	REQUIRE(sfz::writeBinaryFile(fpath, data, sizeof(data)));
+	sfz::MappedFile mapped(fpath);
+	REQUIRE(mapped.isMapped());
+	REQUIRE(mapped.size() == sizeof(data));
+	REQUIRE(std::memcmp(mapped.data(), data, sizeof(data)) == 0);
+
+	sfz::MappedFile moved = std::move(mapped);
+	REQUIRE(!mapped.isMapped());
+	REQUIRE(moved.isMapped());
+	REQUIRE(moved.size() == sizeof(data));
+	REQUIRE(moved.data()[13] == 0xE);
+
+	moved.destroy();
+	REQUIRE(!moved.isMapped());
+	REQUIRE(moved.size() == 0);
+	REQUIRE(sfz::deleteFile(fpath));
+}
@@ -0,0 +1,134 @@
+//
+// Load time benchmark for LoadObj(). Generates a multi-million triangle OBJ
+// (a grid with positions, texcoords and normals, split into groups) and
+// reports the time to parse it from a std::istream, from an in-memory buffer
+// and from a (memory-mapped) file written to the temp directory, serially and
+// with LoadObjParallel().
+//
+// Usage: tinyobjloaderBenchmark [grid size (default 1024)] [reps (default 5)]
+//                               [groups (default 64)] [temp file path]
+//                               [threads (default 0 = hardware threads)]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tiny_obj_loader.h"
+
+static std::string generateObj(int gridSize, int numGroups) {
+  std::ostringstream ss;
+  const int n = gridSize + 1;
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      ss << "v " << x * 0.01f << " " << ((x * 7 + y * 13) % 17) * 0.001f << " "
+         << y * 0.01f << "\n";
+    }
+  }
+  for (int y = 0; y < n; y++) {
+    for (int x = 0; x < n; x++) {
+      ss << "vt " << float(x) / gridSize << " " << float(y) / gridSize << "\n";
+    }
+  }
+  ss << "vn 0 1 0\n";
+
+  // Quads, in numGroups groups of rows
+  const int rowsPerGroup = std::max(1, gridSize / numGroups);
+  for (int y = 0; y < gridSize; y++) {
+    if (y % rowsPerGroup == 0) {
+      ss << "g group" << y / rowsPerGroup << "\n";
+    }
+    for (int x = 0; x < gridSize; x++) {
+      const int i0 = y * n + x + 1;
+      const int i1 = i0 + 1;
+      const int i2 = i0 + n + 1;
+      const int i3 = i0 + n;
+      ss << "f " << i0 << "/" << i0 << "/1 " << i1 << "/" << i1 << "/1 " << i2
+         << "/" << i2 << "/1 " << i3 << "/" << i3 << "/1\n";
+    }
+  }
+  return ss.str();
+}
+
+enum Source { FROM_STREAM, FROM_BUFFER, FROM_FILE, FROM_FILE_PARALLEL };
+
+// Returns false on failure
+static bool benchmark(const char *label, Source source, const std::string &obj,
+                      const char *path, int gridSize, int reps,
+                      unsigned int numThreads) {
+  std::vector<double> times;
+  for (int i = 0; i < reps; i++) {
+    tinyobj::MaterialFileReader matReader("");
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+
+    auto before = std::chrono::high_resolution_clock::now();
+    std::string err;
+    if (source == FROM_STREAM) {
+      std::istringstream stream(obj);
+      err = tinyobj::LoadObj(shapes, materials, stream, matReader);
+    } else if (source == FROM_BUFFER) {
+      err = tinyobj::LoadObj(shapes, materials, obj.data(), obj.size(), matReader);
+    } else if (source == FROM_FILE) {
+      err = tinyobj::LoadObj(shapes, materials, path);
+    } else {
+      err = tinyobj::LoadObjParallel(shapes, materials, path, NULL, numThreads);
+    }
+    auto after = std::chrono::high_resolution_clock::now();
+
+    if (!err.empty()) {
+      std::fprintf(stderr, "LoadObj failed: %s\n", err.c_str());
+      return false;
+    }
+    size_t numIndices = 0;
+    for (size_t s = 0; s < shapes.size(); s++) {
+      numIndices += shapes[s].mesh.indices.size();
+    }
+    if (numIndices != size_t(6) * gridSize * gridSize) {
+      std::fprintf(stderr, "Unexpected number of indices: %zu\n", numIndices);
+      return false;
+    }
+    times.push_back(std::chrono::duration<double, std::milli>(after - before).count());
+  }
+
+  std::sort(times.begin(), times.end());
+  std::printf("LoadObj (%s): min %.1f ms, median %.1f ms (%d reps)\n", label,
+              times.front(), times[times.size() / 2], reps);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  const int gridSize = (argc > 1) ? std::atoi(argv[1]) : 1024;
+  const int reps = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 5;
+  const int numGroups = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 64;
+  const char *path = (argc > 4) ? argv[4] : "tinyobjloader_benchmark.obj";
+  const unsigned int numThreads =
+      (argc > 5) ? static_cast<unsigned int>(std::atoi(argv[5])) : 0;
+
+  const std::string obj = generateObj(gridSize, numGroups);
+  std::printf("OBJ: %.1f MB, %d triangles, %d groups\n",
+              obj.size() / (1024.0 * 1024.0), 2 * gridSize * gridSize, numGroups);
+
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(obj.data(), obj.size());
+    if (!file) {
+      std::fprintf(stderr, "Could not write %s\n", path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  bool success =
+      benchmark("istream", FROM_STREAM, obj, path, gridSize, reps, 1) &&
+      benchmark("buffer", FROM_BUFFER, obj, path, gridSize, reps, 1) &&
+      benchmark("file", FROM_FILE, obj, path, gridSize, reps, 1) &&
+      benchmark("file, parallel", FROM_FILE_PARALLEL, obj, path, gridSize, reps,
+                numThreads);
+  std::remove(path);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -88,6 +88,31 @@ std::string LoadObj(std::vector<shape_t> &shapes,       // [output]
                     std::vector<material_t> &materials, // [output]
                     std::istream &inStream, MaterialReader &readMatFn);
 
+/// Loads object from an in-memory .obj file of 'size' bytes, which does not
+/// need to be null terminated. The buffer is parsed in place, the filename
+/// version above memory-maps the file and calls this.
+/// Returns empty string when loading .obj success.
+std::string LoadObj(std::vector<shape_t> &shapes,       // [output]
+                    std::vector<material_t> &materials, // [output]
+                    const char *buffer, size_t size, MaterialReader &readMatFn);
+
+/// Same as LoadObj() with a filename, but splits the file at line boundaries
+/// into chunks which are parsed concurrently on up to 'numThreads' threads
+/// (0 = one per hardware thread). The shapes are also exported in parallel,
+/// one thread per group. The output is identical to LoadObj().
+std::string LoadObjParallel(std::vector<shape_t> &shapes,       // [output]
+                            std::vector<material_t> &materials, // [output]
+                            const char *filename,
+                            const char *mtl_basepath = NULL,
+                            unsigned int numThreads = 0);
+
+/// Same as LoadObj() with a buffer, but parsed on up to 'numThreads' threads.
+std::string LoadObjParallel(std::vector<shape_t> &shapes,       // [output]
+                            std::vector<material_t> &materials, // [output]
+                            const char *buffer, size_t size,
+                            MaterialReader &readMatFn,
+                            unsigned int numThreads = 0);
+
 /// Loads materials into std::map
 /// Returns an empty string if successful
 std::string LoadMtl(std::map<std::string, int> &material_map,
@@ -37,6 +37,24 @@
 #include <map>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "tiny_obj_loader.h"
 
@@ -51,17 +69,93 @@ struct vertex_index {
   vertex_index(int vidx, int vtidx, int vnidx)
       : v_idx(vidx), vt_idx(vtidx), vn_idx(vnidx){};
 };
-// for std::map
-static inline bool operator<(const vertex_index &a, const vertex_index &b) {
-  if (a.v_idx != b.v_idx)
-    return (a.v_idx < b.v_idx);
-  if (a.vn_idx != b.vn_idx)
-    return (a.vn_idx < b.vn_idx);
-  if (a.vt_idx != b.vt_idx)
-    return (a.vt_idx < b.vt_idx);
-
-  return false;
-}
+
+// Open addressing (linear probing) hash table mapping vertex_index triples to
+// output vertex indices. Reused for every face group, clear() only bumps a
+// generation counter so clearing a large table between groups is free.
+class vertex_index_cache {
+public:
+  vertex_index_cache() : m_numEntries(0), m_generation(1) {}
+
+  // Returns true and sets *idx to the cached index if vi is in the table,
+  // otherwise inserts vi with new_idx and returns false.
+  bool find_or_insert(const vertex_index &vi, unsigned int new_idx,
+                      unsigned int *idx) {
+    // Keep the load factor at most 1/2
+    if (2 * (m_numEntries + 1) > m_entries.size()) {
+      grow();
+    }
+
+    const size_t mask = m_entries.size() - 1;
+    size_t slot = hash(vi) & mask;
+    while (m_entries[slot].generation == m_generation) {
+      const entry &e = m_entries[slot];
+      if (e.key.v_idx == vi.v_idx && e.key.vt_idx == vi.vt_idx &&
+          e.key.vn_idx == vi.vn_idx) {
+        *idx = e.value;
+        return true;
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    m_entries[slot].key = vi;
+    m_entries[slot].value = new_idx;
+    m_entries[slot].generation = m_generation;
+    m_numEntries++;
+    return false;
+  }
+
+  void clear() {
+    m_numEntries = 0;
+    m_generation++;
+    if (m_generation == 0) {
+      // Wrapped around, stale entries could look valid again
+      for (size_t i = 0; i < m_entries.size(); i++) {
+        m_entries[i].generation = 0;
+      }
+      m_generation = 1;
+    }
+  }
+
+private:
+  struct entry {
+    vertex_index key;
+    unsigned int value;
+    unsigned int generation; // Slot is empty unless equal to m_generation
+    entry() : value(0), generation(0) {}
+  };
+
+  static size_t hash(const vertex_index &vi) {
+    unsigned int h = static_cast<unsigned int>(vi.v_idx) * 73856093u;
+    h ^= static_cast<unsigned int>(vi.vt_idx) * 19349663u;
+    h ^= static_cast<unsigned int>(vi.vn_idx) * 83492791u;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+  }
+
+  void grow() {
+    std::vector<entry> old;
+    old.swap(m_entries);
+    m_entries.resize(old.empty() ? 1024 : 2 * old.size());
+
+    const size_t mask = m_entries.size() - 1;
+    for (size_t i = 0; i < old.size(); i++) {
+      if (old[i].generation != m_generation)
+        continue;
+      size_t slot = hash(old[i].key) & mask;
+      while (m_entries[slot].generation == m_generation) {
+        slot = (slot + 1) & mask;
+      }
+      m_entries[slot] = old[i];
+    }
+  }
+
+  std::vector<entry> m_entries;
+  size_t m_numEntries;
+  unsigned int m_generation;
+};
 
 struct obj_shape {
   std::vector<float> v;
@@ -85,7 +179,7 @@ static inline int fixIndex(int idx, int n) {
 static inline std::string parseString(const char *&token) {
   std::string s;
   token += strspn(token, " \t");
-  size_t e = strcspn(token, " \t\r");
+  size_t e = strcspn(token, " \t\r\n");
   s = std::string(token, &token[e]);
   token += e;
   return s;
@@ -94,7 +188,7 @@ static inline std::string parseString(const char *&token) {
 static inline int parseInt(const char *&token) {
   token += strspn(token, " \t");
   int i = atoi(token);
-  token += strcspn(token, " \t\r");
+  token += strcspn(token, " \t\r\n");
   return i;
 }
 
@@ -126,6 +220,15 @@ static inline int parseInt(const char *&token) {
 //  - s >= s_end.
 //  - parse failure.
 // 
+// Powers of ten exactly representable as doubles
+static const double kExactPow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// The significant digits are accumulated in an integer, which is then scaled
+// by a single multiplication or division with an exact power of ten. This is
+// both faster and more accurate than scaling each digit separately.
 static bool tryParseDouble(const char *s, const char *s_end, double *result)
 {
 	if (s >= s_end)
@@ -133,121 +236,108 @@ static bool tryParseDouble(const char *s, const char *s_end, double *result)
 		return false;
 	}
 
-	double mantissa = 0.0;
-	// This exponent is base 2 rather than 10.
-	// However the exponent we parse is supposed to be one of ten,
-	// thus we must take care to convert the exponent/and or the 
-	// mantissa to a * 2^E, where a is the mantissa and E is the
-	// exponent.
-	// To get the final double we will use ldexp, it requires the
-	// exponent to be in base 2.
-	int exponent = 0;
-
-	// NOTE: THESE MUST BE DECLARED HERE SINCE WE ARE NOT ALLOWED
-	// TO JUMP OVER DEFINITIONS.
-	char sign = '+';
-	char exp_sign = '+';
+	const int kMaxDigits = 19; // Fits in an unsigned 64 bit integer
+	unsigned long long mantissa = 0;
+	int numDigits = 0;
+	int exponent = 0; // Base 10, applied to mantissa
+	bool negative = false;
 	char const *curr = s;
 
-	// How many characters were read in a loop. 
-	int read = 0;
-	// Tells whether a loop terminated due to reaching s_end.
-	bool end_not_reached = false;
-
-	/*
-		BEGIN PARSING.
-	*/
-
 	// Find out what sign we've got.
 	if (*curr == '+' || *curr == '-')
 	{
-		sign = *curr;
+		negative = (*curr == '-');
 		curr++;
 	}
-	else if (isdigit(*curr)) { /* Pass through. */ }
-	else
+	if (curr == s_end || !isdigit(*curr))
 	{
-		goto fail;
+		return false;
 	}
 
-	// Read the integer part.
-	while ((end_not_reached = (curr != s_end)) && isdigit(*curr))
+	// Read the integer part, digits beyond what fits only scale the result.
+	while (curr != s_end && isdigit(*curr))
 	{
-		mantissa *= 10;
-		mantissa += static_cast<int>(*curr - 0x30);
-		curr++;	read++;
+		if (numDigits < kMaxDigits)
+		{
+			mantissa = mantissa * 10 + static_cast<unsigned>(*curr - '0');
+			if (mantissa != 0) numDigits++;
+		}
+		else
+		{
+			exponent++;
+		}
+		curr++;
 	}
 
-	// We must make sure we actually got something.
-	if (read == 0)
-		goto fail;
-	// We allow numbers of form "#", "###" etc.
-	if (!end_not_reached)
-		goto assemble;
-
 	// Read the decimal part.
-	if (*curr == '.')
+	if (curr != s_end && *curr == '.')
 	{
 		curr++;
-		read = 1;
-		while ((end_not_reached = (curr != s_end)) && isdigit(*curr))
+		while (curr != s_end && isdigit(*curr))
 		{
-			// NOTE: Don't use powf here, it will absolutely murder precision.
-			mantissa += static_cast<int>(*curr - 0x30) * pow(10.0, -read);
-			read++; curr++;
+			if (numDigits < kMaxDigits)
+			{
+				mantissa = mantissa * 10 + static_cast<unsigned>(*curr - '0');
+				if (mantissa != 0) numDigits++;
+				exponent--;
+			}
+			curr++;
 		}
 	}
-	else if (*curr == 'e' || *curr == 'E') {}
-	else
-	{
-		goto assemble;
-	}
-
-	if (!end_not_reached)
-		goto assemble;
 
 	// Read the exponent part.
-	if (*curr == 'e' || *curr == 'E')
+	if (curr != s_end && (*curr == 'e' || *curr == 'E'))
 	{
 		curr++;
-		// Figure out if a sign is present and if it is.
-		if ((end_not_reached = (curr != s_end)) && (*curr == '+' || *curr == '-'))
+		bool expNegative = false;
+		if (curr != s_end && (*curr == '+' || *curr == '-'))
 		{
-			exp_sign = *curr;
+			expNegative = (*curr == '-');
 			curr++;
 		}
-		else if (isdigit(*curr)) { /* Pass through. */ }
-		else
+		if (curr == s_end || !isdigit(*curr))
 		{
 			// Empty E is not allowed.
-			goto fail;
+			return false;
 		}
 
-		read = 0;
-		while ((end_not_reached = (curr != s_end)) && isdigit(*curr))
+		int exp = 0;
+		while (curr != s_end && isdigit(*curr))
 		{
-			exponent *= 10;
-			exponent += static_cast<int>(*curr - 0x30);
-			curr++;	read++;
+			if (exp < 100000) exp = exp * 10 + (*curr - '0');
+			curr++;
 		}
-		exponent *= (exp_sign == '+'? 1 : -1);
-		if (read == 0)
-			goto fail;
+		exponent += expNegative ? -exp : exp;
 	}
 
-assemble:
-	*result = (sign == '+'? 1 : -1) * ldexp(mantissa * pow(5.0, exponent), exponent);
+	double value = static_cast<double>(mantissa);
+	if (mantissa == 0)
+	{
+		// Zero regardless of exponent
+	}
+	else if (exponent >= 0 && exponent <= 22)
+	{
+		value *= kExactPow10[exponent];
+	}
+	else if (exponent < 0 && exponent >= -22)
+	{
+		value /= kExactPow10[-exponent];
+	}
+	else
+	{
+		value *= pow(10.0, exponent);
+	}
+	*result = negative ? -value : value;
 	return true;
-fail:
-	return false;
 }
+
 static inline float parseFloat(const char *&token) {
   token += strspn(token, " \t");
 #ifdef TINY_OBJ_LOADER_OLD_FLOAT_PARSER
   float f = (float)atof(token);
-  token += strcspn(token, " \t\r");
+  token += strcspn(token, " \t\r\n");
 #else
-  const char *end = token + strcspn(token, " \t\r");
+  const char *end = token + strcspn(token, " \t\r\n");
   double val = 0.0;
   tryParseDouble(token, end, &val);
   float f = static_cast<float>(val);
@@ -269,13 +359,30 @@ static inline void parseFloat3(float &x, float &y, float &z,
   z = parseFloat(token);
 }
 
+// Bits telling which indices of a parsed triple were relative (negative)
+enum {
+  RELATIVE_V_IDX = 1,
+  RELATIVE_VT_IDX = 2,
+  RELATIVE_VN_IDX = 4
+};
+
+// Parses an index of a triple, relative indices are flagged in 'relative'
+static inline int parseIndex(const char *&token, int n, unsigned char &relative,
+                             unsigned char relativeBit) {
+  int idx = atoi(token);
+  if (idx < 0)
+    relative |= relativeBit;
+  token += strcspn(token, "/ \t\r\n");
+  return fixIndex(idx, n);
+}
+
 // Parse triples: i, i/j/k, i//k, i/j
 static vertex_index parseTriple(const char *&token, int vsize, int vnsize,
-                                int vtsize) {
+                                int vtsize, unsigned char &relative) {
   vertex_index vi(-1);
+  relative = 0;
 
-  vi.v_idx = fixIndex(atoi(token), vsize);
-  token += strcspn(token, "/ \t\r");
+  vi.v_idx = parseIndex(token, vsize, relative, RELATIVE_V_IDX);
   if (token[0] != '/') {
     return vi;
   }
@@ -284,37 +391,34 @@ static vertex_index parseTriple(const char *&token, int vsize, int vnsize,
   // i//k
   if (token[0] == '/') {
     token++;
-    vi.vn_idx = fixIndex(atoi(token), vnsize);
-    token += strcspn(token, "/ \t\r");
+    vi.vn_idx = parseIndex(token, vnsize, relative, RELATIVE_VN_IDX);
     return vi;
   }
 
   // i/j/k or i/j
-  vi.vt_idx = fixIndex(atoi(token), vtsize);
-  token += strcspn(token, "/ \t\r");
+  vi.vt_idx = parseIndex(token, vtsize, relative, RELATIVE_VT_IDX);
   if (token[0] != '/') {
     return vi;
   }
 
   // i/j/k
   token++; // skip '/'
-  vi.vn_idx = fixIndex(atoi(token), vnsize);
-  token += strcspn(token, "/ \t\r");
+  vi.vn_idx = parseIndex(token, vnsize, relative, RELATIVE_VN_IDX);
   return vi;
 }
 
 static unsigned int
-updateVertex(std::map<vertex_index, unsigned int> &vertexCache,
+updateVertex(vertex_index_cache &vertexCache,
              std::vector<float> &positions, std::vector<float> &normals,
              std::vector<float> &texcoords,
              const std::vector<float> &in_positions,
              const std::vector<float> &in_normals,
              const std::vector<float> &in_texcoords, const vertex_index &i) {
-  const std::map<vertex_index, unsigned int>::iterator it = vertexCache.find(i);
-
-  if (it != vertexCache.end()) {
+  const unsigned int new_idx = static_cast<unsigned int>(positions.size() / 3);
+  unsigned int cached_idx;
+  if (vertexCache.find_or_insert(i, new_idx, &cached_idx)) {
     // found cache
-    return it->second;
+    return cached_idx;
   }
 
   assert(in_positions.size() > (unsigned int)(3 * i.v_idx + 2));
@@ -334,10 +438,7 @@ updateVertex(std::map<vertex_index, unsigned int> &vertexCache,
     texcoords.push_back(in_texcoords[2 * i.vt_idx + 1]);
   }
 
-  unsigned int idx = static_cast<unsigned int>(positions.size() / 3 - 1);
-  vertexCache[i] = idx;
-
-  return idx;
+  return new_idx;
 }
 
 void InitMaterial(material_t &material) {
@@ -363,56 +464,84 @@ void InitMaterial(material_t &material) {
   material.unknown_parameter.clear();
 }
 
-static bool exportFaceGroupToShape(
-    shape_t &shape, std::map<vertex_index, unsigned int> vertexCache,
-    const std::vector<float> &in_positions,
-    const std::vector<float> &in_normals,
-    const std::vector<float> &in_texcoords,
-    const std::vector<std::vector<vertex_index> > &faceGroup,
-    const int material_id, const std::string &name, bool clearCache) {
-  if (faceGroup.empty()) {
-    return false;
-  }
+// Command in an .obj file which affects how faces are grouped into shapes
+struct obj_command {
+  enum type_t { NEW_GROUP, USEMTL, MTLLIB };
 
-  // Flatten vertices and indices
-  for (size_t i = 0; i < faceGroup.size(); i++) {
-    const std::vector<vertex_index> &face = faceGroup[i];
-
-    vertex_index i0 = face[0];
-    vertex_index i1(-1);
-    vertex_index i2 = face[1];
-
-    size_t npolys = face.size();
+  type_t type;
+  size_t numFaces;        // Faces in the chunk before this command
+  size_t numFaceVertices; // Face vertices in the chunk before this command
+  std::string name;
+};
 
-    // Polygon -> triangle fan conversion
-    for (size_t k = 2; k < npolys; k++) {
-      i1 = i2;
-      i2 = face[k];
+// The parsed contents of a range of lines of an .obj file. Indices of faces
+// are relative to the chunk's own vertices until fixChunkIndices() is called.
+struct obj_chunk {
+  std::vector<float> v;
+  std::vector<float> vn;
+  std::vector<float> vt;
+  std::vector<vertex_index> faceVertices;
+  std::vector<unsigned char> relative; // RELATIVE_* bits per face vertex
+  std::vector<unsigned int> faceSizes;
+  std::vector<obj_command> commands;
+};
 
-      unsigned int v0 = updateVertex(
-          vertexCache, shape.mesh.positions, shape.mesh.normals,
-          shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i0);
-      unsigned int v1 = updateVertex(
-          vertexCache, shape.mesh.positions, shape.mesh.normals,
-          shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i1);
-      unsigned int v2 = updateVertex(
-          vertexCache, shape.mesh.positions, shape.mesh.normals,
-          shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i2);
+// Faces [faceBegin, faceEnd) of a chunk
+struct face_range {
+  const obj_chunk *chunk;
+  size_t faceBegin, faceEnd;
+  size_t vertexBegin;
+};
 
-      shape.mesh.indices.push_back(v0);
-      shape.mesh.indices.push_back(v1);
-      shape.mesh.indices.push_back(v2);
+// The faces which end up in one shape_t
+struct face_group {
+  std::vector<face_range> ranges;
+  int material;
+  std::string name;
+};
 
-      shape.mesh.material_ids.push_back(material_id);
+static void exportFaceGroupToShape(shape_t &shape,
+                                   vertex_index_cache &vertexCache,
+                                   const std::vector<float> &in_positions,
+                                   const std::vector<float> &in_normals,
+                                   const std::vector<float> &in_texcoords,
+                                   const face_group &faceGroup) {
+  // Flatten vertices and indices
+  for (size_t r = 0; r < faceGroup.ranges.size(); r++) {
+    const face_range &range = faceGroup.ranges[r];
+    const vertex_index *face = &range.chunk->faceVertices[range.vertexBegin];
+
+    for (size_t i = range.faceBegin; i < range.faceEnd; i++) {
+      size_t npolys = range.chunk->faceSizes[i];
+
+      // Polygon -> triangle fan conversion
+      for (size_t k = 2; k < npolys; k++) {
+        vertex_index i0 = face[0];
+        vertex_index i1 = face[k - 1];
+        vertex_index i2 = face[k];
+
+        unsigned int v0 = updateVertex(
+            vertexCache, shape.mesh.positions, shape.mesh.normals,
+            shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i0);
+        unsigned int v1 = updateVertex(
+            vertexCache, shape.mesh.positions, shape.mesh.normals,
+            shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i1);
+        unsigned int v2 = updateVertex(
+            vertexCache, shape.mesh.positions, shape.mesh.normals,
+            shape.mesh.texcoords, in_positions, in_normals, in_texcoords, i2);
+
+        shape.mesh.indices.push_back(v0);
+        shape.mesh.indices.push_back(v1);
+        shape.mesh.indices.push_back(v2);
+
+        shape.mesh.material_ids.push_back(faceGroup.material);
+      }
+      face += npolys;
     }
   }
 
-  shape.name = name;
-
-  if (clearCache)
-    vertexCache.clear();
-
-  return true;
+  shape.name = faceGroup.name;
+  vertexCache.clear();
 }
 
 std::string LoadMtl(std::map<std::string, int> &material_map,
@@ -668,251 +797,483 @@ std::string MaterialFileReader::operator()(const std::string &matId,
   return err;
 }
 
-std::string LoadObj(std::vector<shape_t> &shapes,
-                    std::vector<material_t> &materials, // [output]
-                    const char *filename, const char *mtl_basepath) {
+// Read-only memory mapping of a whole file
+class mapped_file {
+public:
+  mapped_file() : m_data(NULL), m_size(0) {}
+  ~mapped_file() { close(); }
+
+  // Returns false if the file could not be opened or mapped. Empty files are
+  // not mapped, data() is NULL and size() is 0 for them.
+  bool open(const char *filename) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      return false;
+    }
+    if (size.QuadPart > 0) {
+      // The view keeps the file and the mapping alive until it is unmapped
+      HANDLE mapping =
+          CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (mapping != NULL) {
+        m_data = static_cast<const char *>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+      }
+      if (m_data == NULL) {
+        CloseHandle(file);
+        return false;
+      }
+      m_size = static_cast<size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    if (st.st_size > 0) {
+      void *ptr = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ,
+                       MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) {
+        ::close(fd);
+        return false;
+      }
+      posix_madvise(ptr, static_cast<size_t>(st.st_size),
+                    POSIX_MADV_SEQUENTIAL);
+      m_data = static_cast<const char *>(ptr);
+      m_size = static_cast<size_t>(st.st_size);
+    }
+    ::close(fd);
+#endif
+    return true;
+  }
 
-  shapes.clear();
+  void close() {
+    if (m_data != NULL) {
+#ifdef _WIN32
+      UnmapViewOfFile(m_data);
+#else
+      munmap(const_cast<char *>(m_data), m_size);
+#endif
+    }
+    m_data = NULL;
+    m_size = 0;
+  }
 
-  std::stringstream err;
+  const char *data() const { return m_data; }
+  size_t size() const { return m_size; }
 
-  std::ifstream ifs(filename);
-  if (!ifs) {
-    err << "Cannot open file [" << filename << "]" << std::endl;
-    return err.str();
-  }
+private:
+  mapped_file(const mapped_file &);
+  mapped_file &operator=(const mapped_file &);
 
-  std::string basePath;
-  if (mtl_basepath) {
-    basePath = mtl_basepath;
+  const char *m_data;
+  size_t m_size;
+};
+
+// Chunks smaller than this are not worth parsing on a separate thread. The
+// tests define it to a few bytes to split small files into many chunks.
+#ifndef TINYOBJLOADER_MIN_CHUNK_SIZE
+#define TINYOBJLOADER_MIN_CHUNK_SIZE (1 << 20)
+#endif
+static const size_t kMinChunkSize = TINYOBJLOADER_MIN_CHUNK_SIZE;
+
+// Calls func(i, thread) for every i in [0, count) on up to numThreads threads,
+// 'thread' is the index (< numThreads) of the thread doing the call.
+template <typename Func>
+static void parallelFor(size_t count, unsigned int numThreads, Func func) {
+  if (numThreads > count)
+    numThreads = static_cast<unsigned int>(count);
+  if (numThreads <= 1) {
+    for (size_t i = 0; i < count; i++) {
+      func(i, 0u);
+    }
+    return;
   }
-  MaterialFileReader matFileReader(basePath);
 
-  return LoadObj(shapes, materials, ifs, matFileReader);
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < numThreads; t++) {
+    threads.push_back(std::thread([&next, &func, count, t]() {
+      for (size_t i = next++; i < count; i = next++) {
+        func(i, t);
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); t++) {
+    threads[t].join();
+  }
 }
 
-std::string LoadObj(std::vector<shape_t> &shapes,
-                    std::vector<material_t> &materials, // [output]
-                    std::istream &inStream, MaterialReader &readMatFn) {
-  std::stringstream err;
-
-  std::vector<float> v;
-  std::vector<float> vn;
-  std::vector<float> vt;
-  std::vector<std::vector<vertex_index> > faceGroup;
-  std::string name;
+static void addCommand(obj_chunk &chunk, obj_command::type_t type,
+                       const std::string &name) {
+  obj_command command;
+  command.type = type;
+  command.numFaces = chunk.faceSizes.size();
+  command.numFaceVertices = chunk.faceVertices.size();
+  command.name = name;
+  chunk.commands.push_back(command);
+}
 
-  // material
-  std::map<std::string, int> material_map;
-  std::map<vertex_index, unsigned int> vertexCache;
-  int material = -1;
+// Parses a single line. token points to the start of the line, which ends at
+// '\n', '\r' or '\0', so lines can be parsed directly from a larger buffer.
+static void parseObjLine(const char *token, obj_chunk &chunk) {
+  // Skip leading space.
+  token += strspn(token, " \t");
 
-  shape_t shape;
+  assert(token);
+  if (isNewLine(token[0]))
+    return; // empty line
+
+  if (token[0] == '#')
+    return; // comment line
+
+  // vertex
+  if (token[0] == 'v' && isSpace((token[1]))) {
+    token += 2;
+    float x, y, z;
+    parseFloat3(x, y, z, token);
+    chunk.v.push_back(x);
+    chunk.v.push_back(y);
+    chunk.v.push_back(z);
+    return;
+  }
 
-  int maxchars = 8192;             // Alloc enough size.
-  std::vector<char> buf(maxchars); // Alloc enough size.
-  while (inStream.peek() != -1) {
-    inStream.getline(&buf[0], maxchars);
+  // normal
+  if (token[0] == 'v' && token[1] == 'n' && isSpace((token[2]))) {
+    token += 3;
+    float x, y, z;
+    parseFloat3(x, y, z, token);
+    chunk.vn.push_back(x);
+    chunk.vn.push_back(y);
+    chunk.vn.push_back(z);
+    return;
+  }
 
-    std::string linebuf(&buf[0]);
+  // texcoord
+  if (token[0] == 'v' && token[1] == 't' && isSpace((token[2]))) {
+    token += 3;
+    float x, y;
+    parseFloat2(x, y, token);
+    chunk.vt.push_back(x);
+    chunk.vt.push_back(y);
+    return;
+  }
 
-    // Trim newline '\r\n' or '\n'
-    if (linebuf.size() > 0) {
-      if (linebuf[linebuf.size() - 1] == '\n')
-        linebuf.erase(linebuf.size() - 1);
-    }
-    if (linebuf.size() > 0) {
-      if (linebuf[linebuf.size() - 1] == '\r')
-        linebuf.erase(linebuf.size() - 1);
-    }
+  // face
+  if (token[0] == 'f' && isSpace((token[1]))) {
+    token += 2;
+    token += strspn(token, " \t");
 
-    // Skip if empty line.
-    if (linebuf.empty()) {
-      continue;
+    unsigned int npolys = 0;
+    while (!isNewLine(token[0])) {
+      unsigned char relative;
+      vertex_index vi = parseTriple(token, static_cast<int>(chunk.v.size() / 3),
+                                    static_cast<int>(chunk.vn.size() / 3),
+                                    static_cast<int>(chunk.vt.size() / 2),
+                                    relative);
+      chunk.faceVertices.push_back(vi);
+      chunk.relative.push_back(relative);
+      npolys++;
+      size_t n = strspn(token, " \t\r");
+      token += n;
     }
 
-    // Skip leading space.
-    const char *token = linebuf.c_str();
-    token += strspn(token, " \t");
+    chunk.faceSizes.push_back(npolys);
+    return;
+  }
 
-    assert(token);
-    if (token[0] == '\0')
-      continue; // empty line
+  // use mtl
+  if ((0 == strncmp(token, "usemtl", 6)) && isSpace((token[6]))) {
+    token += 7;
+    addCommand(chunk, obj_command::USEMTL, parseString(token));
+    return;
+  }
 
-    if (token[0] == '#')
-      continue; // comment line
+  // load mtl
+  if ((0 == strncmp(token, "mtllib", 6)) && isSpace((token[6]))) {
+    token += 7;
+    addCommand(chunk, obj_command::MTLLIB, parseString(token));
+    return;
+  }
 
-    // vertex
-    if (token[0] == 'v' && isSpace((token[1]))) {
-      token += 2;
-      float x, y, z;
-      parseFloat3(x, y, z, token);
-      v.push_back(x);
-      v.push_back(y);
-      v.push_back(z);
-      continue;
+  // group name
+  if (token[0] == 'g' && isSpace((token[1]))) {
+    std::vector<std::string> names;
+    while (!isNewLine(token[0])) {
+      std::string str = parseString(token);
+      names.push_back(str);
+      token += strspn(token, " \t\r"); // skip tag
     }
 
-    // normal
-    if (token[0] == 'v' && token[1] == 'n' && isSpace((token[2]))) {
-      token += 3;
-      float x, y, z;
-      parseFloat3(x, y, z, token);
-      vn.push_back(x);
-      vn.push_back(y);
-      vn.push_back(z);
-      continue;
-    }
+    assert(names.size() > 0);
 
-    // texcoord
-    if (token[0] == 'v' && token[1] == 't' && isSpace((token[2]))) {
-      token += 3;
-      float x, y;
-      parseFloat2(x, y, token);
-      vt.push_back(x);
-      vt.push_back(y);
-      continue;
-    }
+    // names[0] must be 'g', so skip the 0th element.
+    addCommand(chunk, obj_command::NEW_GROUP,
+               names.size() > 1 ? names[1] : std::string());
+    return;
+  }
 
-    // face
-    if (token[0] == 'f' && isSpace((token[1]))) {
-      token += 2;
-      token += strspn(token, " \t");
-
-      std::vector<vertex_index> face;
-      while (!isNewLine(token[0])) {
-        vertex_index vi =
-            parseTriple(token, static_cast<int>(v.size() / 3), static_cast<int>(vn.size() / 3), static_cast<int>(vt.size() / 2));
-        face.push_back(vi);
-        size_t n = strspn(token, " \t\r");
-        token += n;
-      }
+  // object name
+  if (token[0] == 'o' && isSpace((token[1]))) {
+    // @todo { multiple object name? }
+    token += 2;
+    addCommand(chunk, obj_command::NEW_GROUP, parseString(token));
+    return;
+  }
 
-      faceGroup.push_back(face);
+  // Ignore unknown command.
+}
 
-      continue;
+// Parses the lines in [begin, end), end must be at a line boundary
+static void parseObjLines(const char *begin, const char *end,
+                          obj_chunk &chunk) {
+  const char *curr = begin;
+  while (curr < end) {
+    const char *lineEnd = static_cast<const char *>(
+        memchr(curr, '\n', static_cast<size_t>(end - curr)));
+
+    if (lineEnd != NULL) {
+      // Parsed in place, all scanners stop at the '\n'
+      parseObjLine(curr, chunk);
+      curr = lineEnd + 1;
+    } else {
+      // The last line is not terminated, copy it so that it is
+      std::string lastLine(curr, end);
+      parseObjLine(lastLine.c_str(), chunk);
+      curr = end;
     }
+  }
+}
 
-    // use mtl
-    if ((0 == strncmp(token, "usemtl", 6)) && isSpace((token[6]))) {
+// Offsets the relative indices of a chunk's faces by the number of vertices
+// in the chunks before it.
+static void fixChunkIndices(obj_chunk &chunk, int vBase, int vnBase,
+                            int vtBase) {
+  for (size_t i = 0; i < chunk.faceVertices.size(); i++) {
+    const unsigned char relative = chunk.relative[i];
+    vertex_index &vi = chunk.faceVertices[i];
+    if (relative & RELATIVE_V_IDX)
+      vi.v_idx += vBase;
+    if (relative & RELATIVE_VT_IDX)
+      vi.vt_idx += vtBase;
+    if (relative & RELATIVE_VN_IDX)
+      vi.vn_idx += vnBase;
+  }
+  std::vector<unsigned char>().swap(chunk.relative);
+}
 
-      char namebuf[TINYOBJ_SSCANF_BUFFER_SIZE];
-      token += 7;
-#ifdef _MSC_VER
-      sscanf_s(token, "%s", namebuf, (unsigned)_countof(namebuf));
-#else
-      sscanf(token, "%s", namebuf);
-#endif
+static void flushFaceGroup(std::vector<face_group> &faceGroups,
+                           face_group &current, int material,
+                           const std::string &name) {
+  if (current.ranges.empty()) {
+    return;
+  }
+  current.material = material;
+  current.name = name;
+  faceGroups.push_back(current);
+  current.ranges.clear();
+}
 
-      // Create face group per material.
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt,
-                                        faceGroup, material, name, true);
-      if (ret) {
-          shapes.push_back(shape);
-      }
-      shape = shape_t();
-      faceGroup.clear();
+// Merges the parsed chunks (in file order) and appends one shape per face
+// group to shapes, the face groups are exported on up to numThreads threads.
+static std::string buildShapes(std::vector<obj_chunk> &chunks,
+                               std::vector<shape_t> &shapes,
+                               std::vector<material_t> &materials,
+                               MaterialReader &readMatFn,
+                               unsigned int numThreads) {
+  // Concatenate vertex data and make relative indices global
+  std::vector<size_t> vBase(chunks.size() + 1, 0);
+  std::vector<size_t> vnBase(chunks.size() + 1, 0);
+  std::vector<size_t> vtBase(chunks.size() + 1, 0);
+  for (size_t i = 0; i < chunks.size(); i++) {
+    vBase[i + 1] = vBase[i] + chunks[i].v.size();
+    vnBase[i + 1] = vnBase[i] + chunks[i].vn.size();
+    vtBase[i + 1] = vtBase[i] + chunks[i].vt.size();
+  }
 
-      if (material_map.find(namebuf) != material_map.end()) {
-        material = material_map[namebuf];
-      } else {
-        // { error!! material not found }
-        material = -1;
-      }
+  std::vector<float> v, vn, vt;
+  if (chunks.size() == 1) {
+    v.swap(chunks[0].v);
+    vn.swap(chunks[0].vn);
+    vt.swap(chunks[0].vt);
+  } else {
+    v.resize(vBase.back());
+    vn.resize(vnBase.back());
+    vt.resize(vtBase.back());
+  }
 
-      continue;
+  parallelFor(chunks.size(), numThreads, [&](size_t i, unsigned int) {
+    obj_chunk &chunk = chunks[i];
+    if (chunks.size() > 1) {
+      std::copy(chunk.v.begin(), chunk.v.end(), v.begin() + vBase[i]);
+      std::copy(chunk.vn.begin(), chunk.vn.end(), vn.begin() + vnBase[i]);
+      std::copy(chunk.vt.begin(), chunk.vt.end(), vt.begin() + vtBase[i]);
+      std::vector<float>().swap(chunk.v);
+      std::vector<float>().swap(chunk.vn);
+      std::vector<float>().swap(chunk.vt);
     }
+    fixChunkIndices(chunk, static_cast<int>(vBase[i] / 3),
+                    static_cast<int>(vnBase[i] / 3),
+                    static_cast<int>(vtBase[i] / 2));
+  });
+
+  // Split faces into groups, one per shape
+  std::vector<face_group> faceGroups;
+  face_group current;
+  int material = -1;
+  std::string name;
+  std::map<std::string, int> material_map;
+  std::string err;
+
+  for (size_t i = 0; i < chunks.size() && err.empty(); i++) {
+    const obj_chunk &chunk = chunks[i];
+    size_t faceBegin = 0;
+    size_t vertexBegin = 0;
+
+    for (size_t c = 0; c <= chunk.commands.size(); c++) {
+      const bool isLast = (c == chunk.commands.size());
+      const size_t faceEnd =
+          isLast ? chunk.faceSizes.size() : chunk.commands[c].numFaces;
+      if (faceEnd > faceBegin) {
+        face_range range = {&chunk, faceBegin, faceEnd, vertexBegin};
+        current.ranges.push_back(range);
+      }
+      if (isLast)
+        break;
+
+      const obj_command &command = chunk.commands[c];
+      faceBegin = command.numFaces;
+      vertexBegin = command.numFaceVertices;
+
+      if (command.type == obj_command::MTLLIB) {
+        err = readMatFn(command.name, materials, material_map);
+        if (!err.empty()) {
+          current.ranges.clear(); // for safety
+          break;
+        }
+        continue;
+      }
 
-    // load mtl
-    if ((0 == strncmp(token, "mtllib", 6)) && isSpace((token[6]))) {
-      char namebuf[TINYOBJ_SSCANF_BUFFER_SIZE];
-      token += 7;
-#ifdef _MSC_VER
-      sscanf_s(token, "%s", namebuf, (unsigned)_countof(namebuf));
-#else
-      sscanf(token, "%s", namebuf);
-#endif
+      // Both 'g'/'o' and 'usemtl' create a new face group
+      flushFaceGroup(faceGroups, current, material, name);
 
-      std::string err_mtl = readMatFn(namebuf, materials, material_map);
-      if (!err_mtl.empty()) {
-        faceGroup.clear(); // for safety
-        return err_mtl;
+      if (command.type == obj_command::NEW_GROUP) {
+        name = command.name;
+      } else if (material_map.find(command.name) != material_map.end()) {
+        material = material_map[command.name];
+      } else {
+        // { error!! material not found }
+        material = -1;
       }
-
-      continue;
     }
+  }
+  flushFaceGroup(faceGroups, current, material, name);
+
+  // Export the face groups, each thread has its own vertex cache
+  const size_t firstShape = shapes.size();
+  shapes.resize(firstShape + faceGroups.size());
+  std::vector<vertex_index_cache> vertexCaches(numThreads);
+  parallelFor(faceGroups.size(), numThreads,
+              [&](size_t i, unsigned int thread) {
+                exportFaceGroupToShape(shapes[firstShape + i],
+                                       vertexCaches[thread], v, vn, vt,
+                                       faceGroups[i]);
+              });
 
-    // group name
-    if (token[0] == 'g' && isSpace((token[1]))) {
-
-      // flush previous face group.
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt,
-                                        faceGroup, material, name, true);
-      if (ret) {
-        shapes.push_back(shape);
-      }
+  return err;
+}
 
-      shape = shape_t();
+std::string LoadObj(std::vector<shape_t> &shapes,
+                    std::vector<material_t> &materials, // [output]
+                    const char *filename, const char *mtl_basepath) {
+  return LoadObjParallel(shapes, materials, filename, mtl_basepath, 1);
+}
 
-      // material = -1;
-      faceGroup.clear();
+std::string LoadObj(std::vector<shape_t> &shapes,
+                    std::vector<material_t> &materials, // [output]
+                    std::istream &inStream, MaterialReader &readMatFn) {
+  std::vector<obj_chunk> chunks(1);
 
-      std::vector<std::string> names;
-      while (!isNewLine(token[0])) {
-        std::string str = parseString(token);
-        names.push_back(str);
-        token += strspn(token, " \t\r"); // skip tag
-      }
+  int maxchars = 8192;             // Alloc enough size.
+  std::vector<char> buf(maxchars); // Alloc enough size.
+  while (inStream.peek() != -1) {
+    inStream.getline(&buf[0], maxchars);
+    parseObjLine(&buf[0], chunks[0]);
+  }
 
-      assert(names.size() > 0);
+  return buildShapes(chunks, shapes, materials, readMatFn, 1);
+}
 
-      // names[0] must be 'g', so skip the 0th element.
-      if (names.size() > 1) {
-        name = names[1];
-      } else {
-        name = "";
-      }
+std::string LoadObj(std::vector<shape_t> &shapes,
+                    std::vector<material_t> &materials, // [output]
+                    const char *buffer, size_t size, MaterialReader &readMatFn) {
+  return LoadObjParallel(shapes, materials, buffer, size, readMatFn, 1);
+}
 
-      continue;
-    }
+std::string LoadObjParallel(std::vector<shape_t> &shapes,
+                            std::vector<material_t> &materials, // [output]
+                            const char *filename, const char *mtl_basepath,
+                            unsigned int numThreads) {
 
-    // object name
-    if (token[0] == 'o' && isSpace((token[1]))) {
+  shapes.clear();
 
-      // flush previous face group.
-      bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt,
-                                        faceGroup, material, name, true);
-      if (ret) {
-        shapes.push_back(shape);
-      }
+  std::stringstream err;
 
-      // material = -1;
-      faceGroup.clear();
-      shape = shape_t();
+  mapped_file file;
+  if (!file.open(filename)) {
+    err << "Cannot open file [" << filename << "]" << std::endl;
+    return err.str();
+  }
 
-      // @todo { multiple object name? }
-      char namebuf[TINYOBJ_SSCANF_BUFFER_SIZE];
-      token += 2;
-#ifdef _MSC_VER
-      sscanf_s(token, "%s", namebuf, (unsigned)_countof(namebuf));
-#else
-      sscanf(token, "%s", namebuf);
-#endif
-      name = std::string(namebuf);
+  std::string basePath;
+  if (mtl_basepath) {
+    basePath = mtl_basepath;
+  }
+  MaterialFileReader matFileReader(basePath);
 
-      continue;
-    }
+  return LoadObjParallel(shapes, materials, file.data(), file.size(),
+                         matFileReader, numThreads);
+}
 
-    // Ignore unknown command.
+std::string LoadObjParallel(std::vector<shape_t> &shapes,
+                            std::vector<material_t> &materials, // [output]
+                            const char *buffer, size_t size,
+                            MaterialReader &readMatFn,
+                            unsigned int numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
   }
 
-  bool ret = exportFaceGroupToShape(shape, vertexCache, v, vn, vt, faceGroup,
-                                    material, name, true);
-  if (ret) {
-    shapes.push_back(shape);
+  // Split into chunks at line boundaries
+  size_t numChunks = std::min(size_t(numThreads), size / kMinChunkSize);
+  numChunks = std::max(size_t(1), numChunks);
+  std::vector<const char *> bounds(numChunks + 1);
+  bounds[0] = buffer;
+  bounds[numChunks] = buffer + size;
+  for (size_t i = 1; i < numChunks; i++) {
+    const char *split = std::max(buffer + (size / numChunks) * i, bounds[i - 1]);
+    const char *newline = static_cast<const char *>(
+        memchr(split, '\n', static_cast<size_t>(bounds[numChunks] - split)));
+    bounds[i] = (newline != NULL) ? newline + 1 : bounds[numChunks];
   }
-  faceGroup.clear(); // for safety
 
-  return err.str();
+  std::vector<obj_chunk> chunks(numChunks);
+  parallelFor(numChunks, numThreads, [&](size_t i, unsigned int) {
+    parseObjLines(bounds[i], bounds[i + 1], chunks[i]);
+  });
+
+  return buildShapes(chunks, shapes, materials, readMatFn, numThreads);
 }
 }
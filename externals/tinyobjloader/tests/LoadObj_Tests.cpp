@@ -0,0 +1,284 @@
+//
+// Regression tests for the OBJ loaders. LoadObjParallel() and the memory-mapped
+// file loaders are compared against the std::istream loader for small inline
+// OBJ files, which are written to the working directory for the file loaders.
+// The test executable is
+// built with TINYOBJLOADER_MIN_CHUNK_SIZE set to a few bytes, so even these
+// files are split into many chunks and relative indices, groups and usemtl
+// cross chunk boundaries.
+//
+// Usage: tinyobjloaderTests (returns non-zero if any check fails)
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tiny_obj_loader.h"
+
+static int numFailures = 0;
+
+#define CHECK(cond, label)                                                     \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed for %s\n", __FILE__,       \
+                   __LINE__, #cond, (label).c_str());                          \
+      numFailures++;                                                           \
+    }                                                                          \
+  } while (false)
+
+static const char *kMtl = "newmtl red\n"
+                          "Kd 1 0 0\n"
+                          "Ns 10\n"
+                          "map_Kd red.png\n"
+                          "newmtl blue\n"
+                          "Kd 0 0 1\n"
+                          "d 0.5\n"
+                          "illum 2\n";
+
+static const char *kMtlName = "tinyobjloader_test.mtl";
+static const char *kObjName = "tinyobjloader_test.obj";
+
+// Absolute and relative indices, v/vt/vn, v//vn and v/vt faces, groups and
+// materials (one of them missing)
+static const char *kMixedObj = "mtllib tinyobjloader_test.mtl\n"
+                               "o quads\n"
+                               "v 0 0 0\n"
+                               "v 1 0 0\n"
+                               "v 1 1 0\n"
+                               "v 0 1 0\n"
+                               "vt 0 0\n"
+                               "vt 1 0\n"
+                               "vt 1 1\n"
+                               "vt 0 1\n"
+                               "vn 0 0 1\n"
+                               "usemtl red\n"
+                               "f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\n"
+                               "g second\n"
+                               "v 0 0 1.5\n"
+                               "v 1 0 1.5\n"
+                               "v 1 1 1.5\n"
+                               "usemtl blue\n"
+                               "f -3//-1 -2//-1 -1//1\n"
+                               "f 1/1 -2/-4 3/3\n"
+                               "g third\n"
+                               "usemtl missing\n"
+                               "v 2 2 2\n"
+                               "f -1 -2 -3 1\n";
+
+// A strip of quads where every face only uses relative indices, with the
+// vertices declared between the faces
+static std::string generateRelativeObj() {
+  std::ostringstream ss;
+  ss << "mtllib " << kMtlName << "\n";
+  ss << "v 0 0 0\nv 0 1 0\nvt 0 0\nvt 0 1\n";
+  for (int i = 1; i <= 40; i++) {
+    if (i % 7 == 0) {
+      ss << "g strip" << i / 7 << "\n";
+      ss << "usemtl " << ((i / 7) % 2 == 0 ? "red" : "blue") << "\n";
+    }
+    ss << "v " << i << " 0 " << i * 0.25f << "\n";
+    ss << "v " << i << " 1 " << i * 0.25f << "\n";
+    ss << "vt " << i / 40.0f << " 0\nvt " << i / 40.0f << " 1\n";
+    ss << "vn 0 0." << i % 10 << " 1\n";
+    ss << "f -4/-4/-1 -2/-2/-1 -1/-1/-1 -3/-3/-1\n";
+  }
+  return ss.str();
+}
+
+static std::string toCRLF(const std::string &obj) {
+  std::string result;
+  for (size_t i = 0; i < obj.size(); i++) {
+    if (obj[i] == '\n')
+      result += '\r';
+    result += obj[i];
+  }
+  return result;
+}
+
+static std::string withoutTrailingNewline(const std::string &obj) {
+  std::string result = obj;
+  while (!result.empty() &&
+         (result[result.size() - 1] == '\n' || result[result.size() - 1] == '\r')) {
+    result.erase(result.size() - 1);
+  }
+  return result;
+}
+
+// Serves the .mtl files from memory
+class InlineMaterialReader : public tinyobj::MaterialReader {
+public:
+  virtual std::string operator()(const std::string &matId,
+                                 std::vector<tinyobj::material_t> &materials,
+                                 std::map<std::string, int> &matMap) {
+    std::istringstream stream(matId == kMtlName ? kMtl : "");
+    return tinyobj::LoadMtl(matMap, materials, stream);
+  }
+};
+
+struct LoadResult {
+  std::string err;
+  std::vector<tinyobj::shape_t> shapes;
+  std::vector<tinyobj::material_t> materials;
+};
+
+static LoadResult loadFromStream(const std::string &obj) {
+  LoadResult result;
+  InlineMaterialReader matReader;
+  std::istringstream stream(obj);
+  result.err = tinyobj::LoadObj(result.shapes, result.materials, stream, matReader);
+  return result;
+}
+
+static LoadResult loadParallel(const std::string &obj, unsigned int numThreads) {
+  LoadResult result;
+  InlineMaterialReader matReader;
+  result.err = tinyobj::LoadObjParallel(result.shapes, result.materials,
+                                        obj.data(), obj.size(), matReader,
+                                        numThreads);
+  return result;
+}
+
+// Writes the OBJ to kObjName and loads it with LoadObj(filename), or with
+// LoadObjParallel() if numThreads is not 1
+static LoadResult loadFromFile(const std::string &obj, unsigned int numThreads) {
+  LoadResult result;
+  {
+    std::ofstream file(kObjName, std::ios::binary);
+    file.write(obj.data(), obj.size());
+    if (!file) {
+      result.err = "Could not write test file";
+      return result;
+    }
+  }
+  if (numThreads == 1) {
+    result.err = tinyobj::LoadObj(result.shapes, result.materials, kObjName);
+  } else {
+    result.err = tinyobj::LoadObjParallel(result.shapes, result.materials,
+                                          kObjName, NULL, numThreads);
+  }
+  std::remove(kObjName);
+  return result;
+}
+
+static bool equalArrays(const float *a, const float *b, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    if (a[i] != b[i])
+      return false;
+  }
+  return true;
+}
+
+static bool equalMaterials(const tinyobj::material_t &a,
+                           const tinyobj::material_t &b) {
+  return a.name == b.name && equalArrays(a.ambient, b.ambient, 3) &&
+         equalArrays(a.diffuse, b.diffuse, 3) &&
+         equalArrays(a.specular, b.specular, 3) &&
+         equalArrays(a.transmittance, b.transmittance, 3) &&
+         equalArrays(a.emission, b.emission, 3) && a.shininess == b.shininess &&
+         a.ior == b.ior && a.dissolve == b.dissolve && a.illum == b.illum &&
+         a.ambient_texname == b.ambient_texname &&
+         a.diffuse_texname == b.diffuse_texname &&
+         a.specular_texname == b.specular_texname &&
+         a.specular_highlight_texname == b.specular_highlight_texname &&
+         a.bump_texname == b.bump_texname &&
+         a.displacement_texname == b.displacement_texname &&
+         a.alpha_texname == b.alpha_texname &&
+         a.unknown_parameter == b.unknown_parameter;
+}
+
+static bool equalShapes(const tinyobj::shape_t &a, const tinyobj::shape_t &b) {
+  return a.name == b.name && a.mesh.positions == b.mesh.positions &&
+         a.mesh.normals == b.mesh.normals &&
+         a.mesh.texcoords == b.mesh.texcoords &&
+         a.mesh.indices == b.mesh.indices &&
+         a.mesh.material_ids == b.mesh.material_ids;
+}
+
+static void checkEqual(const LoadResult &expected, const LoadResult &actual,
+                       const std::string &label) {
+  CHECK(actual.err == expected.err, label);
+  CHECK(actual.shapes.size() == expected.shapes.size(), label);
+  for (size_t i = 0; i < expected.shapes.size() && i < actual.shapes.size(); i++) {
+    CHECK(equalShapes(actual.shapes[i], expected.shapes[i]), label);
+  }
+  CHECK(actual.materials.size() == expected.materials.size(), label);
+  for (size_t i = 0; i < expected.materials.size() && i < actual.materials.size(); i++) {
+    CHECK(equalMaterials(actual.materials[i], expected.materials[i]), label);
+  }
+}
+
+static const unsigned int kThreadCounts[] = {1, 2, 3, 4, 7, 16, 0};
+
+// Compares LoadObjParallel() and the file loaders with every thread count
+// against the stream loader
+static void testParallel(const std::string &obj, const std::string &name) {
+  const LoadResult expected = loadFromStream(obj);
+  for (size_t i = 0; i < sizeof(kThreadCounts) / sizeof(kThreadCounts[0]); i++) {
+    std::ostringstream label;
+    label << name << ", " << kThreadCounts[i] << " threads";
+    checkEqual(expected, loadParallel(obj, kThreadCounts[i]), label.str());
+    checkEqual(expected, loadFromFile(obj, kThreadCounts[i]),
+               label.str() + ", file");
+  }
+}
+
+int main() {
+  // The file loaders read the materials through MaterialFileReader
+  {
+    std::ofstream mtlFile(kMtlName, std::ios::binary);
+    mtlFile << kMtl;
+  }
+
+  const std::string mixed = kMixedObj;
+  const std::string relative = generateRelativeObj();
+
+  // Sanity check the reference itself, the variants below must not change it
+  const LoadResult mixedResult = loadFromStream(mixed);
+  CHECK(mixedResult.shapes.size() == 3, std::string("mixed"));
+  if (mixedResult.shapes.size() == 3) {
+    CHECK(mixedResult.shapes[0].name == "quads", std::string("mixed"));
+    CHECK(mixedResult.shapes[0].mesh.indices.size() == 6, std::string("mixed"));
+    CHECK(mixedResult.shapes[1].mesh.indices.size() == 6, std::string("mixed"));
+    CHECK(mixedResult.shapes[2].mesh.positions.size() == 4 * 3, std::string("mixed"));
+  }
+  CHECK(mixedResult.materials.size() == 2, std::string("mixed"));
+  const LoadResult relativeResult = loadFromStream(relative);
+  size_t numIndices = 0;
+  for (size_t i = 0; i < relativeResult.shapes.size(); i++) {
+    numIndices += relativeResult.shapes[i].mesh.indices.size();
+  }
+  CHECK(numIndices == 40 * 6, std::string("relative"));
+
+  checkEqual(mixedResult, loadFromStream(toCRLF(mixed)), "mixed, CRLF");
+  checkEqual(mixedResult, loadFromStream(withoutTrailingNewline(mixed)),
+             "mixed, no trailing newline");
+
+  testParallel(mixed, "mixed");
+  testParallel(toCRLF(mixed), "mixed, CRLF");
+  testParallel(withoutTrailingNewline(mixed), "mixed, no trailing newline");
+  testParallel(relative, "relative");
+  testParallel(toCRLF(relative), "relative, CRLF");
+  testParallel(withoutTrailingNewline(toCRLF(relative)),
+               "relative, CRLF, no trailing newline");
+  testParallel(std::string(), "empty");
+
+  {
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    const std::string err = tinyobj::LoadObj(shapes, materials, kObjName);
+    CHECK(!err.empty(), std::string("missing file"));
+  }
+  std::remove(kMtlName);
+
+  if (numFailures != 0) {
+    std::fprintf(stderr, "%d checks failed\n", numFailures);
+    return EXIT_FAILURE;
+  }
+  std::printf("All checks passed\n");
+  return EXIT_SUCCESS;
+}
@@ -1,12 +1,20 @@
 #include "GameScreen.hpp"
 
 #include "sfz/containers/StackString.hpp"
+#include "sfz/geometry/Intersection.hpp"
 #include "sfz/gl/IncludeOpenGL.hpp"
+#include "sfz/gl/SfzMesh.hpp"
 
 #include "sfz/util/IO.hpp"
 
 namespace vre {
 
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+// Conservative bounding radius (meters) around the origin of a tracked device model
+static const float DEVICE_CULL_RADIUS = 0.3f;
+
 // GameScreen: Constructors & destructors
 // ------------------------------------------------------------------------------------------------
 
@@ -19,7 +27,7 @@ GameScreen::GameScreen() noexcept
 	sfz::StackString128 shadersPath;
 	shadersPath.printf("%sassets/shaders/", sfz::basePath());
 
-	mSnakeModel = sfz::gl::tinyObjLoadModel(modelsPath.str, "head_d2u_f2.obj");
+	mSnakeModel = sfz::gl::loadModelCached(modelsPath.str, "head_d2u_f2.obj");
 
 	mSimpleShader = Program::fromFile(shadersPath.str, "SimpleShader.vert", "SimpleShader.frag",
 	[](uint32_t shaderProgram) {
@@ -160,8 +168,51 @@ UpdateOp GameScreen::update(UpdateState& state)
 		printf("Touchpad: %s\n", toString(rHand.touchpad).str);
 	}
 
+	mControllerRayHit = RayHit();
 	if (rHand.trigger > 0.01f) {
 		printf("Trigger pressed: %f.2\n", rHand.trigger);
+
+		// Pick the snake model (drawn with identity model matrix) along the controller's -z axis,
+		// the snake is tinted while it is picked
+		const TrackedDevice* controller = vr.rightController();
+		if (controller != nullptr) {
+			vec3 dir = -normalize(sfz::transformDir(controller->transform, vec3(0.0f, 0.0f, 1.0f)));
+			mControllerRayHit = mSnakeModel.bvh.raycast(Ray(controller->pos(), dir));
+		}
+	}
+
+	// Collide the convex hulls of the right controller model and the snake model, the simplex is
+	// kept between frames to warm start GJK
+	mControllerPenetration = Penetration();
+	const TrackedDevice* rController = vr.rightController();
+	if (rController != nullptr && rController->model.convexHull.vertices.size() > 0 &&
+	    mSnakeModel.convexHull.vertices.size() > 0) {
+		const Model& controllerModel = rController->model;
+		if (sfz::intersects(controllerModel.aabb.transformAABB(rController->transform), mSnakeModel.aabb)) {
+			const sfz::ConvexHull& controllerHull = controllerModel.convexHull;
+			const sfz::ConvexHull& snakeHull = mSnakeModel.convexHull;
+			const ConvexHullShape controllerShape(controllerHull.vertices.data(),
+			    controllerHull.vertices.size(), sizeof(vec3), rController->transform);
+			const ConvexHullShape snakeShape(snakeHull.vertices.data(), snakeHull.vertices.size());
+			if (sfz::gjkIntersects(controllerShape, snakeShape, mControllerSnakeSimplex)) {
+				mControllerPenetration = sfz::epaPenetration(controllerShape, snakeShape,
+				                                             mControllerSnakeSimplex);
+			}
+		}
+	}
+
+	// Sweep the hulls of both controllers from their previous to their current transform against
+	// the snake mesh, fast swings can pass through it between two frames. The earliest hit is kept.
+	mControllerSweepHit = SweepHit();
+	for (const TrackedDevice* controller : { vr.leftController(), vr.rightController() }) {
+		if (controller == nullptr || controller->model.convexHull.vertices.size() == 0) continue;
+		const sfz::ConvexHull& hull = controller->model.convexHull;
+		const ConvexHullShape localShape(hull.vertices.data(), hull.vertices.size());
+		const SweepHit hit = mSnakeModel.bvh.sweep(SweptShape(localShape, controller->prevTransform,
+		                                                       controller->transform));
+		if (hit.isHit() && hit.toi > 0.0f && hit.toi < mControllerSweepHit.toi) {
+			mControllerSweepHit = hit;
+		}
 	}
 
 	return sfz::SCREEN_NO_OP;
@@ -201,9 +252,31 @@ void GameScreen::render(UpdateState& state)
 		glEnable(GL_DEPTH_TEST);
 		glDepthFunc(GL_LESS);
 
+		// Cull tracked devices once for both eyes using a frustum enclosing both eye frustums
+		const mat4 headMatrix = vr.headMatrix();
+		const ViewFrustum stereoFrustum = ViewFrustum::combinedStereo(
+		    vr.eyeMatrix(LEFT_EYE) * headMatrix, vr.projMatrix(LEFT_EYE),
+		    vr.eyeMatrix(RIGHT_EYE) * headMatrix, vr.projMatrix(RIGHT_EYE));
+		mDeviceVisible.clear();
+		for (const auto& device : vr.trackedDevices()) {
+			Sphere bounds(translation(device.transform), DEVICE_CULL_RADIUS);
+			mDeviceVisible.add(device.type != TrackedDeviceType::HMD && stereoFrustum.isVisible(bounds));
+		}
+
+		const mat4 snakeModelMatrix = identityMatrix4<float>();
+		const bool snakeVisible = stereoFrustum.isVisible(mSnakeModel.aabb.transformAABB(snakeModelMatrix));
+
+		// Show the controller queries against the snake by tinting it
+		vec3 snakeTint = vec3(1.0f);
+		if (mControllerRayHit.isHit()) snakeTint = vec3(0.5f, 1.0f, 0.5f);
+		if (mControllerSweepHit.isHit()) snakeTint = vec3(1.0f, 0.7f, 0.3f);
+		if (mControllerPenetration.valid) snakeTint = vec3(1.0f, 0.4f, 0.4f);
+
 		for (uint32_t eye : VR_EYES) {
-			const mat4 viewMatrix = vr.eyeMatrix(eye) * vr.headMatrix();
-			const mat4 modelMatrix = identityMatrix4<float>();
+			const mat4 viewMatrix = vr.eyeMatrix(eye) * headMatrix;
+			const mat4 modelMatrix = snakeModelMatrix;
+			const uint32_t snakeLOD = mSnakeModel.selectLOD(viewMatrix * modelMatrix, vr.projMatrix(eye),
+			                                                float(fbRes.y));
 
 			gl::setUniform(mSimpleShader, "uProjMatrix", vr.projMatrix(eye));
 			gl::setUniform(mSimpleShader, "uViewMatrix", viewMatrix);
@@ -211,18 +284,21 @@ void GameScreen::render(UpdateState& state)
 			gl::setUniform(mSimpleShader, "uNormalMatrix", inverse(transpose(viewMatrix * modelMatrix))); // inverse(tranpose(modelViewMatrix))*/
 			
 			gl::setUniform(mSimpleShader, "uHasTexture", 0);
+			gl::setUniform(mSimpleShader, "uTint", snakeTint);
 
 			mFinalFB[eye].bindViewportClearColorDepth();
 			
-			mSnakeModel.draw();
+			if (snakeVisible) mSnakeModel.draw(snakeLOD);
 			
 			// Draw tracked devices
 			gl::setUniform(mSimpleShader, "uHasTexture", 1);
+			gl::setUniform(mSimpleShader, "uTint", vec3(1.0f));
 			glActiveTexture(GL_TEXTURE0);
 			gl::setUniform(mSimpleShader, "uTexture", 0);
-			for (const auto& device : vr.trackedDevices()) {
+			for (uint32_t i = 0; i < vr.trackedDevices().size(); i++) {
 				
-				if (device.type == TrackedDeviceType::HMD) continue;
+				if (!mDeviceVisible[i]) continue;
+				const TrackedDevice& device = vr.trackedDevices()[i];
 
 				glBindTexture(GL_TEXTURE_2D, device.model.glColorTexture);
 				gl::setUniform(mSimpleShader, "uModelMatrix", device.transform);
@@ -3,6 +3,11 @@
 #include "sfz/Math.hpp"
 #include "sfz/Screens.hpp"
 #include "sfz/SDL.hpp"
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/geometry/GJK.hpp"
+#include "sfz/geometry/Ray.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/Sweep.hpp"
 #include "sfz/geometry/ViewFrustum.hpp"
 #include "sfz/gl/Program.hpp"
 #include "sfz/gl/Framebuffer.hpp"
@@ -25,6 +30,15 @@ using sfz::gl::Program;
 using sfz::sdl::Window;
 using sfz::UpdateOp;
 using sfz::UpdateState;
+using sfz::Ray;
+using sfz::RayHit;
+using sfz::Sphere;
+using sfz::GJKSimplex;
+using sfz::Penetration;
+using sfz::ConvexHullShape;
+using sfz::SweepHit;
+using sfz::SweptShape;
+using sfz::ViewFrustum;
 using sfz::vec2;
 using sfz::vec3;
 using sfz::mat4;
@@ -55,6 +69,11 @@ private:
 	FullscreenQuad mQuad;
 	Model mSnakeModel;
 	sfz::ViewFrustum mCam;
+	sfz::DynArray<bool> mDeviceVisible;
+	GJKSimplex mControllerSnakeSimplex;
+	RayHit mControllerRayHit;
+	Penetration mControllerPenetration;
+	SweepHit mControllerSweepHit;
 };
 
 } // namespace vre
@@ -97,27 +97,18 @@ static Model loadVRModel(const char* deviceName) noexcept
 		tmp.indices[i] = modelPtr->rIndexData[i];
 	}
 
-	// Create Vertex Array object
-	glGenVertexArrays(1, &tmp.glVAO);
-	glBindVertexArray(tmp.glVAO);
-
-	// Create and fill vertex buffer
-	glGenBuffers(1, &tmp.glVertexBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, tmp.glVertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, tmp.vertices.size() * sizeof(Vertex), tmp.vertices.data(), GL_STATIC_DRAW);
-
-	// Locate components in vertex buffer
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-
-	// Create and fill index buffer
-	glGenBuffers(1, &tmp.glIndexBuffer);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tmp.glIndexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * tmp.indices.size(), tmp.indices.data(), GL_STATIC_DRAW);
+	// Compute bounds and build BVH for ray casts
+	tmp.computeBounds();
+	tmp.buildBVH();
+	tmp.buildConvexHull();
+
+	// A single submesh using the model's texture
+	sfz::gl::Submesh submesh;
+	submesh.numIndices = tmp.indices.size();
+	submesh.aabb = tmp.aabb;
+	tmp.submeshes.add(submesh);
+
+	tmp.createGLBuffers(tmp.vertices.data(), tmp.indices.data());
 
 	// Create OpenGL texture
 	glGenTextures(1, &tmp.glColorTexture);
@@ -138,9 +129,6 @@ static Model loadVRModel(const char* deviceName) noexcept
 	glGenerateMipmap(GL_TEXTURE_2D);
 
 	// Cleanup
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 	vr::VRRenderModels()->FreeRenderModel(modelPtr);
 	vr::VRRenderModels()->FreeTexture(texturePtr);
@@ -173,6 +161,7 @@ static TrackedDevice initTrackedDevice(vr::IVRSystem* system, uint32_t deviceInd
 
 	// Transform
 	tmp.transform = convertSteamVRMatrix(pose.mDeviceToAbsoluteTracking);
+	tmp.prevTransform = tmp.transform;
 
 	// Retrieve name of device
 	uint32_t nameLen = system->GetStringTrackedDeviceProperty(deviceIndex,
@@ -355,7 +344,9 @@ void VR::update() noexcept
 		}
 
 		// Update device location
-		mTrackedDevices[arrayIndex].transform = convertSteamVRMatrix(devicePoses[i].mDeviceToAbsoluteTracking);
+		TrackedDevice& device = mTrackedDevices[arrayIndex];
+		device.prevTransform = device.transform;
+		device.transform = convertSteamVRMatrix(devicePoses[i].mDeviceToAbsoluteTracking);
 	}
 
 
@@ -36,6 +36,8 @@ struct TrackedDevice final {
 
 	// Position and rotation relative to room origin
 	mat4 transform = identityMatrix4<float>();
+	// Transform before the latest update, for swept (continuous) collision tests
+	mat4 prevTransform = identityMatrix4<float>();
 	// TODO: Predicted transform
 
 	// Model and texture
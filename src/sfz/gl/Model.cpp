@@ -10,6 +10,8 @@
 #include "tiny_obj_loader.h"
 
 #include "sfz/Assert.hpp"
+#include "sfz/geometry/BoundingVolumes.hpp"
+#include "sfz/geometry/MeshSimplification.hpp"
 #include "sfz/gl/IncludeOpenGL.hpp"
 
 namespace sfz {
@@ -22,6 +24,54 @@ using std::vector;
 using tinyobj::shape_t;
 using tinyobj::material_t;
 
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const float IMPORT_LOD_RATIOS[] = { 0.5f, 0.25f, 0.1f };
+
+// A LOD is skipped if it has more than this ratio of the triangles of the previous LOD
+static const float MIN_LOD_REDUCTION = 0.9f;
+
+// Vertex struct
+// ------------------------------------------------------------------------------------------------
+
+DynArray<CompactVertex> compactVertices(const DynArray<Vertex>& vertices, vec3& boundsMinOut,
+                                        vec3& boundsMaxOut) noexcept
+{
+	boundsMinOut = vec3(0.0f);
+	boundsMaxOut = vec3(0.0f);
+	if (vertices.size() == 0) return DynArray<CompactVertex>();
+
+	// Calculate bounds
+	boundsMinOut = vertices[0].pos;
+	boundsMaxOut = vertices[0].pos;
+	for (const Vertex& vertex : vertices) {
+		boundsMinOut = sfz::min(boundsMinOut, vertex.pos);
+		boundsMaxOut = sfz::max(boundsMaxOut, vertex.pos);
+	}
+
+	// Pack vertices
+	DynArray<CompactVertex> tmp(vertices.size(), vertices.size());
+	for (uint32_t i = 0; i < vertices.size(); i++) {
+		const Vertex& vertex = vertices[i];
+		CompactVertex& compact = tmp[i];
+		compact.normal = (vertex.normal == vec3(0.0f)) ? snorm16x2{{0, 0}} : packOctNormal(vertex.normal);
+		compact.uv = packHalf(vertex.uv);
+		compact.pos = quantizePosition(vertex.pos, boundsMinOut, boundsMaxOut);
+		compact.padding = 0;
+	}
+	return std::move(tmp);
+}
+
+Vertex expandVertex(const CompactVertex& vertex, const vec3& boundsMin, const vec3& boundsMax) noexcept
+{
+	Vertex tmp;
+	tmp.pos = dequantizePosition(vertex.pos, boundsMin, boundsMax);
+	tmp.normal = unpackOctNormal(vertex.normal);
+	tmp.uv = unpackHalf(vertex.uv);
+	return tmp;
+}
+
 // Model class
 // ------------------------------------------------------------------------------------------------
 
@@ -48,6 +98,14 @@ void Model::swap(Model& other) noexcept
 {
 	this->vertices.swap(other.vertices);
 	this->indices.swap(other.indices);
+	this->submeshes.swap(other.submeshes);
+	this->materials.swap(other.materials);
+	this->lods.swap(other.lods);
+	std::swap(this->bvh, other.bvh);
+	std::swap(this->aabb, other.aabb);
+	std::swap(this->boundingSphere, other.boundingSphere);
+	std::swap(this->obb, other.obb);
+	std::swap(this->convexHull, other.convexHull);
 
 	std::swap(this->glVertexBuffer, other.glVertexBuffer);
 	std::swap(this->glIndexBuffer, other.glIndexBuffer);
@@ -60,94 +118,388 @@ void Model::destroy() noexcept
 {
 	this->vertices.destroy();
 	this->indices.destroy();
+	this->submeshes.destroy();
+	this->materials.destroy();
+	this->lods.destroy();
+	this->bvh.clear();
+	this->convexHull.vertices.destroy();
+	this->convexHull.indices.destroy();
+
+	// Models without OpenGL objects (e.g. imported by tools) may not have a GL context to call
+	if (glVertexBuffer != 0) glDeleteBuffers(1, &glVertexBuffer);
+	if (glIndexBuffer != 0) glDeleteBuffers(1, &glIndexBuffer);
+	if (glVAO != 0) glDeleteVertexArrays(1, &glVAO);
+	if (glColorTexture != 0) glDeleteTextures(1, &glColorTexture);
+	glVertexBuffer = 0;
+	glIndexBuffer = 0;
+	glVAO = 0;
+	glColorTexture = 0;
+}
+
+RenderingOptimizationStats Model::optimizeForRendering() noexcept
+{
+	RenderingOptimizationStats stats;
+	stats.before = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	if (indices.size() == 0) return stats;
+
+	// Triangles are only reordered within each submesh, so that the submeshes stay valid
+	DynArray<uint32_t> tmpIndices(indices.size(), 0u, 0u);
+	for (const Submesh& submesh : submeshes) {
+		uint32_t* submeshIndices = indices.data() + submesh.firstIndex;
+		optimizeVertexCache(submeshIndices, submeshIndices, submesh.numIndices, vertices.size());
+		optimizeOverdraw(tmpIndices.data(), submeshIndices, submesh.numIndices, &vertices[0].pos,
+		                 vertices.size(), sizeof(Vertex));
+		std::copy(tmpIndices.data(), tmpIndices.data() + submesh.numIndices, submeshIndices);
+	}
+
+	// Vertices in the order they are first used by the indices
+	DynArray<uint32_t> remap(vertices.size(), 0u, 0u);
+	const uint32_t numUsedVertices = optimizeVertexFetch(remap.data(), indices.data(),
+	                                                     indices.size(), vertices.size());
+	DynArray<Vertex> remappedVertices(numUsedVertices, numUsedVertices);
+	for (uint32_t i = 0; i < vertices.size(); i++) {
+		if (remap[i] != ~0u) remappedVertices[remap[i]] = vertices[i];
+	}
+	vertices = std::move(remappedVertices);
+
+	stats.after = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	return stats;
+}
+
+void Model::generateLODs(const float* triangleRatios, uint32_t numRatios) noexcept
+{
+	LOD base = lod(0);
+	base.error = 0.0f;
+	indices.setSize(base.numIndices);
+	submeshes.remove(base.numSubmeshes, submeshes.size() - base.numSubmeshes);
+	lods.clear();
+	lods.add(base);
+	if (base.numIndices == 0) return;
+
+	// Vertices at positions used by several submeshes are locked, so that the submeshes stay
+	// connected. Vertices with the same position are grouped by sorting.
+	DynArray<uint32_t> vertexSubmesh(vertices.size(), ~0u, 0u);
+	DynArray<bool> lockedVertices(vertices.size(), false, 0u);
+	for (uint32_t i = 0; i < base.numSubmeshes; i++) {
+		const Submesh& submesh = submeshes[i];
+		for (uint32_t j = submesh.firstIndex; j < submesh.firstIndex + submesh.numIndices; j++) {
+			uint32_t& owner = vertexSubmesh[indices[j]];
+			if (owner == ~0u) owner = i;
+			else if (owner != i) lockedVertices[indices[j]] = true;
+		}
+	}
+	if (base.numSubmeshes > 1) {
+		DynArray<uint32_t> order(0u, 0u, vertices.size());
+		for (uint32_t i = 0; i < vertices.size(); i++) order.add(i);
+		std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+			const vec3& a = vertices[lhs].pos;
+			const vec3& b = vertices[rhs].pos;
+			if (a.x != b.x) return a.x < b.x;
+			if (a.y != b.y) return a.y < b.y;
+			return a.z < b.z;
+		});
+		uint32_t first = 0;
+		for (uint32_t i = 1; i <= order.size(); i++) {
+			if (i < order.size() && vertices[order[i]].pos == vertices[order[first]].pos) continue;
+			uint32_t groupOwner = ~0u;
+			bool shared = false;
+			for (uint32_t j = first; j < i; j++) {
+				const uint32_t owner = vertexSubmesh[order[j]];
+				if (owner == ~0u) continue;
+				if (groupOwner == ~0u) groupOwner = owner;
+				shared = shared || owner != groupOwner;
+			}
+			for (uint32_t j = first; j < i && shared; j++) lockedVertices[order[j]] = true;
+			first = i;
+		}
+	}
+
+	// Each LOD is simplified from LOD 0, so that its error is relative to the full detail model
+	DynArray<uint32_t> tmpIndices(base.numIndices, 0u, 0u);
+	for (uint32_t i = 0; i < numRatios; i++) {
+		LOD newLOD;
+		newLOD.firstIndex = indices.size();
+		newLOD.firstSubmesh = submeshes.size();
+		newLOD.numSubmeshes = base.numSubmeshes;
+		for (uint32_t j = 0; j < base.numSubmeshes; j++) {
+			Submesh submesh = submeshes[j];
+			const uint32_t target = uint32_t(float(submesh.numIndices / 3) * triangleRatios[i]) * 3;
+			float error = 0.0f;
+			const uint32_t numSimplified = simplifyMesh(tmpIndices.data(),
+			    indices.data() + submesh.firstIndex, submesh.numIndices, &vertices[0].pos,
+			    vertices.size(), sizeof(Vertex), std::max(target, 3u), 1e30f, &error,
+			    lockedVertices.data());
+			optimizeVertexCache(tmpIndices.data(), tmpIndices.data(), numSimplified, vertices.size());
+
+			submesh.firstIndex = indices.size();
+			submesh.numIndices = numSimplified;
+			indices.add(tmpIndices.data(), numSimplified);
+			submeshes.add(submesh);
+			newLOD.error = std::max(newLOD.error, error);
+		}
+		newLOD.numIndices = indices.size() - newLOD.firstIndex;
+
+		if (float(newLOD.numIndices) > MIN_LOD_REDUCTION * float(lods.last().numIndices)) {
+			indices.setSize(newLOD.firstIndex);
+			submeshes.remove(newLOD.firstSubmesh, newLOD.numSubmeshes);
+			break;
+		}
+		lods.add(newLOD);
+	}
+}
+
+LOD Model::lod(uint32_t index) const noexcept
+{
+	if (lods.size() > 0) {
+		sfz_assert_debug(index < lods.size());
+		return lods[index];
+	}
+	sfz_assert_debug(index == 0);
+	LOD tmp;
+	tmp.numIndices = indices.size();
+	tmp.numSubmeshes = submeshes.size();
+	return tmp;
+}
 
+uint32_t Model::selectLOD(const mat4& modelViewMatrix, const mat4& projMatrix, float viewportHeight,
+                          float maxPixelError) const noexcept
+{
+	if (lods.size() <= 1 || boundingSphere.radius() <= 0.0f) return 0;
+
+	// View space depth (along -z) of the nearest point of the bounding sphere. The depth rather
+	// than the distance is used since the projection scales by 1 / depth, so objects off center
+	// are not underestimated.
+	const Sphere viewSphere = boundingSphere.transformSphere(modelViewMatrix);
+	const float depth = -viewSphere.position().z - viewSphere.radius();
+	if (depth <= 0.0f) return 0;
+
+	// projMatrix(1,1) is the scale from view space y / -z to normalized device coordinates, which
+	// span 2 units of the viewport height. The off-axis terms of asymmetric (per eye) projections
+	// only shift the image, they don't change this scale.
+	const float pixelsPerUnit = projMatrix.at(1, 1) * 0.5f * viewportHeight / depth;
+	const float scale = viewSphere.radius() / boundingSphere.radius();
+
+	uint32_t selected = 0;
+	for (uint32_t i = 1; i < lods.size(); i++) {
+		if (lods[i].error * scale * pixelsPerUnit > maxPixelError) break;
+		selected = i;
+	}
+	return selected;
+}
+
+void Model::buildBVH() noexcept
+{
+	DynArray<vec3> positions(0, vertices.size());
+	for (const Vertex& vertex : vertices) positions.add(vertex.pos);
+	bvh.build(positions.data(), indices.data(), lod(0).numIndices);
+}
+
+bool Model::restoreBVH(const BVHNode* nodes, uint32_t numNodes, const uint32_t* primitiveIndices) noexcept
+{
+	DynArray<vec3> positions(0, vertices.size());
+	for (const Vertex& vertex : vertices) positions.add(vertex.pos);
+	return bvh.restore(positions.data(), indices.data(), lod(0).numIndices, nodes, numNodes,
+	                   primitiveIndices);
+}
+
+void Model::computeBounds() noexcept
+{
+	if (vertices.size() == 0) return;
+	const uint32_t stride = sizeof(Vertex);
+	aabb = computeAABB(&vertices[0].pos, vertices.size(), stride);
+	boundingSphere = computeBoundingSphere(&vertices[0].pos, vertices.size(), stride);
+	obb = computePCAOBB(&vertices[0].pos, vertices.size(), stride);
+}
+
+void Model::buildConvexHull(uint32_t maxVertices) noexcept
+{
+	if (vertices.size() == 0) return;
+	convexHull = computeConvexHull(&vertices[0].pos, vertices.size(), sizeof(Vertex), maxVertices);
+}
+
+void Model::createGLBuffers(const Vertex* vertexData, const uint32_t* indexData) noexcept
+{
 	// Silently ignores values == 0
 	glDeleteBuffers(1, &glVertexBuffer);
 	glDeleteBuffers(1, &glIndexBuffer);
 	glDeleteVertexArrays(1, &glVAO);
 
-	glDeleteTextures(1, &glColorTexture);
+	// Create Vertex Array object
+	glGenVertexArrays(1, &glVAO);
+	glBindVertexArray(glVAO);
+
+	// Create and fill vertex buffer
+	glGenBuffers(1, &glVertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, glVertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertexData, GL_STATIC_DRAW);
+
+	// Locate components in vertex buffer
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+
+	// Create and fill index buffer
+	glGenBuffers(1, &glIndexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * indices.size(), indexData, GL_STATIC_DRAW);
+
+	// Cleanup
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
-void Model::draw() const noexcept
+void Model::draw(uint32_t lod) const noexcept
 {
+	const LOD range = this->lod(lod);
 	glBindVertexArray(glVAO);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBuffer);
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLES, range.numIndices, GL_UNSIGNED_INT,
+	               (void*)(sizeof(uint32_t) * range.firstIndex));
+}
+
+void Model::bindVAO() const noexcept
+{
+	glBindVertexArray(glVAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glIndexBuffer);
+}
+
+void Model::drawSubmesh(uint32_t index) const noexcept
+{
+	sfz_assert_debug(index < submeshes.size());
+	const Submesh& submesh = submeshes[index];
+	glDrawElements(GL_TRIANGLES, submesh.numIndices, GL_UNSIGNED_INT,
+	               (void*)(sizeof(uint32_t) * submesh.firstIndex));
 }
 
 // Model loading functions
 // ------------------------------------------------------------------------------------------------
 
-Model tinyObjLoadModel(const char* basePath, const char* fileName) noexcept
+static size_t numShapeVertices(const shape_t& shape) noexcept
+{
+	return std::max(shape.mesh.positions.size() / 3,
+	       std::max(shape.mesh.normals.size() / 3, shape.mesh.texcoords.size() / 2));
+}
+
+Model tinyObjImportModel(const char* basePath, const char* fileName,
+                         RenderingOptimizationStats* optimizationStatsOut) noexcept
 {
 	vector<shape_t> shapes;
 	vector<material_t> materials;
 
-	string error = tinyobj::LoadObj(shapes, materials, (string(basePath) + fileName).c_str(), basePath);
+	string error = tinyobj::LoadObjParallel(shapes, materials, (string(basePath) + fileName).c_str(), basePath);
 	if (!error.empty()) {
 		printErrorMessage("Failed loading model %s, error: %s", fileName, error.c_str());
 		return Model();
 	}
 
-	// TODO: Only cares about first shape
 	if (shapes.size() == 0) {
 		printErrorMessage("Model %s has no shapes", fileName);
 		return Model();
 	}
-	shape_t& shape = shapes[0];
 
-	// Calculate number of vertices and create default vertices (all 0)
-	size_t numVertices = std::max(shape.mesh.positions.size() / 3,
-	                     std::max(shape.mesh.normals.size() / 3, shape.mesh.texcoords.size() / 2));
+	// Calculate total number of vertices and indices
+	size_t numVertices = 0, numIndices = 0;
+	for (const shape_t& shape : shapes) {
+		numVertices += numShapeVertices(shape);
+		numIndices += shape.mesh.indices.size();
+	}
+
+	// Create default vertices (all 0)
 	Model tmp;
 	tmp.vertices = DynArray<Vertex>(numVertices, numVertices);
-	
-	// Fill vertices with positions
-	for (size_t i = 0; i < shape.mesh.positions.size() / 3; i++) {
-		tmp.vertices[i].pos = vec3(&shape.mesh.positions[i * 3]);
+	tmp.indices = DynArray<uint32_t>(0, 0, uint32_t(numIndices));
+
+	uint32_t baseVertex = 0;
+	for (const shape_t& shape : shapes) {
+		// Fill vertices with positions
+		for (size_t i = 0; i < shape.mesh.positions.size() / 3; i++) {
+			tmp.vertices[baseVertex + i].pos = vec3(&shape.mesh.positions[i * 3]);
+		}
+
+		// Fill vertices with normals
+		for (size_t i = 0; i < shape.mesh.normals.size() / 3; i++) {
+			tmp.vertices[baseVertex + i].normal = vec3(&shape.mesh.normals[i * 3]);
+		}
+
+		// Fill vertices with uv coordinates
+		for (size_t i = 0; i < shape.mesh.texcoords.size() / 2; i++) {
+			tmp.vertices[baseVertex + i].uv = vec2(&shape.mesh.texcoords[i * 2]);
+		}
+
+		// Create indices, with a new submesh whenever the material changes
+		const vector<unsigned int>& shapeIndices = shape.mesh.indices;
+		for (size_t i = 0; i + 2 < shapeIndices.size(); i += 3) {
+			int32_t materialIndex = shape.mesh.material_ids[i / 3];
+			if (materialIndex < 0 || size_t(materialIndex) >= materials.size()) materialIndex = -1;
+
+			if (i == 0 || tmp.submeshes.last().materialIndex != materialIndex) {
+				Submesh submesh;
+				submesh.firstIndex = tmp.indices.size();
+				submesh.materialIndex = materialIndex;
+				tmp.submeshes.add(submesh);
+			}
+			tmp.indices.add(baseVertex + shapeIndices[i]);
+			tmp.indices.add(baseVertex + shapeIndices[i + 1]);
+			tmp.indices.add(baseVertex + shapeIndices[i + 2]);
+			tmp.submeshes.last().numIndices += 3;
+		}
+
+		baseVertex += uint32_t(numShapeVertices(shape));
 	}
 
-	// Fill vertices with normals
-	for (size_t i = 0; i < shape.mesh.normals.size() / 3; i++) {
-		tmp.vertices[i].normal = vec3(&shape.mesh.normals[i * 3]);
+	if (tmp.indices.size() == 0) {
+		printErrorMessage("Model %s has no triangles", fileName);
+		return Model();
 	}
 
-	// Fill vertices with uv coordinates
-	for (size_t i = 0; i < shape.mesh.texcoords.size() / 2; i++) {
-		tmp.vertices[i].uv = vec2(&shape.mesh.texcoords[i * 2]);
+	// Calculate bounds of submeshes
+	for (Submesh& submesh : tmp.submeshes) {
+		vec3 min = tmp.vertices[tmp.indices[submesh.firstIndex]].pos;
+		vec3 max = min;
+		for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.numIndices; i++) {
+			min = sfz::min(min, tmp.vertices[tmp.indices[i]].pos);
+			max = sfz::max(max, tmp.vertices[tmp.indices[i]].pos);
+		}
+		submesh.aabb = AABB(min, max);
 	}
 
-	// Create indices
-	tmp.indices.add(&shape.mesh.indices[0], shape.mesh.indices.size());
+	// Copy materials
+	tmp.materials = DynArray<Material>(uint32_t(materials.size()), uint32_t(materials.size()));
+	for (size_t i = 0; i < materials.size(); i++) {
+		const material_t& src = materials[i];
+		Material& dst = tmp.materials[i];
+		dst.name = DynString(src.name.c_str());
+		dst.ambient = vec3(src.ambient);
+		dst.diffuse = vec3(src.diffuse);
+		dst.specular = vec3(src.specular);
+		dst.emission = vec3(src.emission);
+		dst.shininess = src.shininess;
+		dst.dissolve = src.dissolve;
+		dst.diffuseTexture = DynString(src.diffuse_texname.c_str());
+	}
 
-	// Create Vertex Array object
-	glGenVertexArrays(1, &tmp.glVAO);
-	glBindVertexArray(tmp.glVAO);
+	// Reorder triangles and vertices for the GPU, before the BVH is built as it changes the indices
+	RenderingOptimizationStats optimizationStats = tmp.optimizeForRendering();
+	if (optimizationStatsOut != nullptr) *optimizationStatsOut = optimizationStats;
 
-	// Create and fill vertex buffer
-	glGenBuffers(1, &tmp.glVertexBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, tmp.glVertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, tmp.vertices.size() * sizeof(Vertex), tmp.vertices.data(), GL_STATIC_DRAW);
+	// Compute bounds and build BVH for ray casts
+	tmp.computeBounds();
+	tmp.buildBVH();
+	tmp.buildConvexHull();
+	tmp.generateLODs(IMPORT_LOD_RATIOS, sizeof(IMPORT_LOD_RATIOS) / sizeof(float));
 
-	// Locate components in vertex buffer
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-
-	// Create and fill index buffer
-	glGenBuffers(1, &tmp.glIndexBuffer);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tmp.glIndexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * tmp.indices.size(), tmp.indices.data(), GL_STATIC_DRAW);
-
-	// Cleanup
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	return std::move(tmp);
+}
 
+Model tinyObjLoadModel(const char* basePath, const char* fileName) noexcept
+{
+	Model tmp = tinyObjImportModel(basePath, fileName);
+	if (tmp.vertices.size() == 0) return Model();
+	tmp.createGLBuffers(tmp.vertices.data(), tmp.indices.data());
 	return std::move(tmp);
 }
 
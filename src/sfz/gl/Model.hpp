@@ -5,7 +5,15 @@
 #include <cstdint>
 
 #include "sfz/containers/DynArray.hpp"
+#include "sfz/containers/DynString.hpp"
+#include "sfz/geometry/AABB.hpp"
+#include "sfz/geometry/ConvexHull.hpp"
+#include "sfz/geometry/MeshOptimization.hpp"
+#include "sfz/geometry/OBB.hpp"
+#include "sfz/geometry/Sphere.hpp"
+#include "sfz/geometry/TriangleBVH.hpp"
 #include "sfz/math/Matrix.hpp"
+#include "sfz/math/PackedVector.hpp"
 #include "sfz/math/Vector.hpp"
 
 namespace sfz {
@@ -25,6 +33,68 @@ struct Vertex {
 
 static_assert(sizeof(Vertex) == sizeof(float) * 8, "Vertex is padded");
 
+/// Compact alternative to Vertex, half the size. The normal is octahedral encoded and the uv
+/// coordinates are stored as half-precision floats since they may lie outside [0, 1]. The
+/// position is quantized relative to a bounding box, which is needed to reconstruct it.
+struct CompactVertex {
+	snorm16x2 normal;
+	half2 uv;
+	unorm16x3 pos;
+	uint16_t padding;
+};
+
+static_assert(sizeof(CompactVertex) == sizeof(Vertex) / 2, "CompactVertex is padded");
+
+/// Converts vertices to CompactVertex. The bounds used for quantizing the positions are
+/// calculated from the vertices and returned through boundsMinOut and boundsMaxOut.
+DynArray<CompactVertex> compactVertices(const DynArray<Vertex>& vertices, vec3& boundsMinOut,
+                                        vec3& boundsMaxOut) noexcept;
+
+/// Reconstructs a Vertex from a CompactVertex and the bounds returned by compactVertices()
+Vertex expandVertex(const CompactVertex& vertex, const vec3& boundsMin, const vec3& boundsMax) noexcept;
+
+// Material & Submesh structs
+// ------------------------------------------------------------------------------------------------
+
+/// A material loaded from the .mtl file(s) of a model. Textures are not loaded, only their paths
+/// (relative to the model's base path) are stored.
+struct Material {
+	DynString name;
+	vec3 ambient = vec3(0.0f);
+	vec3 diffuse = vec3(0.0f);
+	vec3 specular = vec3(0.0f);
+	vec3 emission = vec3(0.0f);
+	float shininess = 1.0f;
+	float dissolve = 1.0f; // 1 == opaque, 0 == fully transparent
+	DynString diffuseTexture;
+};
+
+/// A part of a Model using a single material. All submeshes share the vertex and index buffers
+/// of the Model, a submesh is the range [firstIndex, firstIndex + numIndices) of the indices.
+struct Submesh {
+	uint32_t firstIndex = 0;
+	uint32_t numIndices = 0;
+	int32_t materialIndex = -1; // Index into Model::materials, -1 if no material
+	AABB aabb; // Bounds in model space
+};
+
+/// A level of detail of a Model, see Model::generateLODs(). The indices of all LODs are stored
+/// after each other in Model::indices and use the same vertices. Each LOD has its own submeshes
+/// (a range of Model::submeshes) with the same materials as the submeshes of LOD 0.
+struct LOD {
+	uint32_t firstIndex = 0;
+	uint32_t numIndices = 0;
+	uint32_t firstSubmesh = 0;
+	uint32_t numSubmeshes = 0;
+	float error = 0.0f; // Estimated max distance to the surface of LOD 0, in model space
+};
+
+/// Vertex cache statistics of a Model before and after Model::optimizeForRendering()
+struct RenderingOptimizationStats {
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
 // Model class
 // ------------------------------------------------------------------------------------------------
 
@@ -41,6 +111,26 @@ public:
 	DynArray<Vertex> vertices;
 	DynArray<uint32_t> indices;
 
+	// Parts of the model and their materials, the submeshes of each LOD cover its indices in order
+	DynArray<Submesh> submeshes;
+	DynArray<Material> materials;
+
+	// Levels of detail, LOD 0 is the full detail model, see generateLODs(). May be empty, the
+	// model then only has its full detail version covering all indices and submeshes.
+	DynArray<LOD> lods;
+
+	// Triangle BVH in model space for ray casts, see buildBVH()
+	TriangleBVH bvh;
+
+	// Bounding volumes in model space, see computeBounds(). Use transformAABB(),
+	// transformSphere() and transformOBB() with the model matrix to get world space bounds.
+	AABB aabb;
+	Sphere boundingSphere;
+	OBB obb;
+
+	// Simplified convex hull in model space used as collision proxy, see buildConvexHull()
+	ConvexHull convexHull;
+
 	// OpenGL geometric information
 	uint32_t glVertexBuffer = 0;
 	uint32_t glIndexBuffer = 0;
@@ -69,15 +159,76 @@ public:
 	/// Destroys this model, the result will be an empty Model.
 	void destroy() noexcept;
 
-	/// Draws the geometry of this model through OpenGL, material information (including binding
-	/// textures) needs to be done manually before the call.
-	void draw() const noexcept;
+	/// Reorders the triangles of each submesh for the post-transform vertex cache and to reduce
+	/// overdraw, then reorders the vertices in the order they are used (removing unreferenced
+	/// vertices). The triangles and submeshes themselves are unchanged. Must be called before
+	/// buildBVH(), as the BVH refers to triangles by index.
+	RenderingOptimizationStats optimizeForRendering() noexcept;
+
+	/// Generates levels of detail by simplifying each submesh of LOD 0 to the given ratios of its
+	/// triangles, e.g. { 0.5f, 0.25f, 0.1f }, see simplifyMesh(). Previous LODs are replaced. LODs
+	/// that can't be simplified much further than the previous LOD are skipped.
+	void generateLODs(const float* triangleRatios, uint32_t numRatios) noexcept;
+
+	/// Returns the number of LODs, at least 1
+	uint32_t numLODs() const noexcept { return lods.size() > 0 ? lods.size() : 1; }
+
+	/// Returns a LOD, LOD 0 covers all indices and submeshes if the model has no LODs
+	LOD lod(uint32_t index) const noexcept;
+
+	/// Selects the coarsest LOD whose error, projected at the nearest point of the bounding
+	/// sphere, is at most maxPixelError pixels on screen. In VR it should be selected per eye
+	/// using the eye's view and projection matrices and the height of its render target.
+	uint32_t selectLOD(const mat4& modelViewMatrix, const mat4& projMatrix, float viewportHeight,
+	                   float maxPixelError = 1.0f) const noexcept;
+
+	/// (Re)builds the triangle BVH from the current vertices and the indices of LOD 0
+	void buildBVH() noexcept;
+
+	/// Restores the triangle BVH from the nodes and primitive indices of a BVH previously built
+	/// from the same vertices and indices of LOD 0, see TriangleBVH::restore(). Returns false (and leaves
+	/// the BVH empty) if they are invalid.
+	bool restoreBVH(const BVHNode* nodes, uint32_t numNodes, const uint32_t* primitiveIndices) noexcept;
+
+	/// (Re)computes the bounding volumes from the current vertices
+	void computeBounds() noexcept;
+
+	/// (Re)builds the convex hull of the current vertices, reduced to at most maxVertices vertices
+	void buildConvexHull(uint32_t maxVertices = 32) noexcept;
+
+	/// (Re)creates the OpenGL vertex array object and buffers of this model. The buffers are filled
+	/// from vertexData and indexData, which must hold vertices.size() and indices.size() elements.
+	/// Normally these are vertices.data() and indices.data(), but they may also point into e.g. a
+	/// memory mapped file.
+	void createGLBuffers(const Vertex* vertexData, const uint32_t* indexData) noexcept;
+
+	/// Draws the geometry of a LOD of this model (all its submeshes) through OpenGL with a single
+	/// draw call, material information (including binding textures) needs to be done manually before
+	/// the call.
+	void draw(uint32_t lod = 0) const noexcept;
+
+	/// Binds the vertex array object of this model, which needs to be done before drawSubmesh().
+	void bindVAO() const noexcept;
+
+	/// Draws a single submesh, assumes bindVAO() has been called. Material information needs to be
+	/// set manually before the call.
+	void drawSubmesh(uint32_t index) const noexcept;
 };
 
 // Model loading functions
 // ------------------------------------------------------------------------------------------------
 
-/// Loads a 3D model through tinyObjLoader, returns an empty Model on failure.
+/// Imports a 3D model through tinyObjLoader, returns an empty Model on failure. All shapes in the
+/// file are packed into the same vertices and indices, with one submesh per shape and material.
+/// The model is optimized for rendering (see Model::optimizeForRendering()) and gets LODs with
+/// 50%, 25% and 10% of the triangles (see Model::generateLODs()). The optimization statistics are
+/// returned through optimizationStatsOut if it is not nullptr. No OpenGL objects are created, so
+/// no OpenGL context is needed.
+Model tinyObjImportModel(const char* basePath, const char* fileName,
+                         RenderingOptimizationStats* optimizationStatsOut = nullptr) noexcept;
+
+/// Imports a 3D model using tinyObjImportModel() and creates its OpenGL buffers, returns an empty
+/// Model on failure.
 Model tinyObjLoadModel(const char* basePath, const char* fileName) noexcept;
 
 } // namespace gl
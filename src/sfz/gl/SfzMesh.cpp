@@ -0,0 +1,411 @@
+// Copyright (c) Peter Hillerstrm (skipifzero.com, peter@hstroem.se)
+
+#include "sfz/gl/SfzMesh.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "sfz/Assert.hpp"
+#include "sfz/util/IO.hpp"
+
+namespace sfz {
+
+namespace gl {
+
+using std::size_t;
+using std::uint8_t;
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const uint8_t SFZMESH_MAGIC[8] = {'S', 'F', 'Z', 'M', 'E', 'S', 'H', '\0'};
+static const uint32_t SFZMESH_VERSION = 3; // Also bumped when the import processing changes
+static const uint64_t SFZMESH_SECTION_ALIGNMENT = 16;
+
+// All sections are stored at 16 byte aligned offsets from the beginning of the file
+struct SfzMeshHeader final {
+	uint8_t magic[8];
+	uint32_t version;
+	uint32_t headerSize; // sizeof(SfzMeshHeader), detects layout changes
+	uint32_t vertexSize; // sizeof(Vertex), detects layout changes
+	uint32_t numVertices;
+	uint32_t numIndices;
+	uint32_t numSubmeshes;
+	uint32_t numMaterials;
+	uint32_t numStringBytes;
+	uint32_t numHullVertices;
+	uint32_t numHullIndices;
+	uint32_t numBVHNodes;
+	uint32_t numBVHPrimitives;
+	uint32_t numLODs;
+	SfzMeshSource source;
+
+	uint64_t verticesOffset;
+	uint64_t indicesOffset;
+	uint64_t submeshesOffset;
+	uint64_t materialsOffset;
+	uint64_t stringsOffset;
+	uint64_t hullVerticesOffset;
+	uint64_t hullIndicesOffset;
+	uint64_t bvhNodesOffset;
+	uint64_t bvhPrimitivesOffset;
+	uint64_t lodsOffset;
+
+	AABB aabb;
+	Sphere boundingSphere;
+	OBB obb;
+};
+
+// Material with its strings stored as (null-terminated) ranges of the strings section
+struct SfzMeshMaterial final {
+	vec3 ambient, diffuse, specular, emission;
+	float shininess, dissolve;
+	uint32_t nameOffset, nameLength;
+	uint32_t diffuseTextureOffset, diffuseTextureLength;
+};
+
+static_assert(std::is_trivially_copyable<SfzMeshHeader>::value, "SfzMeshHeader must be POD");
+static_assert(std::is_trivially_copyable<Submesh>::value, "Submesh must be POD");
+static_assert(std::is_trivially_copyable<BVHNode>::value, "BVHNode must be POD");
+static_assert(std::is_trivially_copyable<LOD>::value, "LOD must be POD");
+
+static uint64_t fnv1aHash(const uint8_t* data, size_t numBytes) noexcept
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < numBytes; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static uint64_t alignOffset(uint64_t offset) noexcept
+{
+	return (offset + SFZMESH_SECTION_ALIGNMENT - 1) & ~(SFZMESH_SECTION_ALIGNMENT - 1);
+}
+
+// Appends a section at the next aligned offset, returns the offset
+static uint64_t appendSection(DynArray<uint8_t>& file, const void* data, size_t numBytes) noexcept
+{
+	uint64_t offset = alignOffset(file.size());
+	while (file.size() < offset) file.add(uint8_t(0));
+	if (numBytes > 0) file.add(static_cast<const uint8_t*>(data), uint32_t(numBytes));
+	return offset;
+}
+
+static uint32_t appendString(DynArray<char>& strings, const DynString& str) noexcept
+{
+	uint32_t offset = strings.size();
+	if (str.size() > 0) strings.add(str.str(), str.size());
+	strings.add('\0');
+	return offset;
+}
+
+// Whether the header is from the current version of the format
+static bool headerIsCurrent(const SfzMeshHeader& header) noexcept
+{
+	return std::memcmp(header.magic, SFZMESH_MAGIC, sizeof(SFZMESH_MAGIC)) == 0 &&
+	       header.version == SFZMESH_VERSION && header.headerSize == sizeof(SfzMeshHeader) &&
+	       header.vertexSize == sizeof(Vertex);
+}
+
+// Whether numElements elements of elementSize bytes at offset fit in a file of fileSize bytes
+static bool sectionInFile(uint64_t offset, uint32_t numElements, size_t elementSize,
+                          size_t fileSize) noexcept
+{
+	if ((offset % SFZMESH_SECTION_ALIGNMENT) != 0) return false;
+	if (offset > fileSize) return false;
+	return uint64_t(numElements) * elementSize <= fileSize - offset;
+}
+
+// SfzMeshSource struct
+// ------------------------------------------------------------------------------------------------
+
+SfzMeshSource sfzMeshSource(const char* path, bool computeHash) noexcept
+{
+	SfzMeshSource tmp;
+	tmp.modificationTime = fileModificationTime(path);
+	tmp.size = sizeofFile(path);
+	if (computeHash && tmp.size > 0) {
+		MappedFile file(path);
+		if (file.isMapped()) tmp.hash = fnv1aHash(file.data(), file.size());
+	}
+	return tmp;
+}
+
+// .sfzmesh functions
+// ------------------------------------------------------------------------------------------------
+
+bool writeSfzMesh(const Model& model, const SfzMeshSource& source, const char* path) noexcept
+{
+	// The header is written as is, zero it including the padding so the files are deterministic.
+	// AABB, Sphere and OBB have default constructors, hence the cast to silence -Wclass-memaccess.
+	SfzMeshHeader header;
+	std::memset(static_cast<void*>(&header), 0, sizeof(SfzMeshHeader));
+	std::memcpy(header.magic, SFZMESH_MAGIC, sizeof(SFZMESH_MAGIC));
+	header.version = SFZMESH_VERSION;
+	header.headerSize = sizeof(SfzMeshHeader);
+	header.vertexSize = sizeof(Vertex);
+	header.numVertices = model.vertices.size();
+	header.numIndices = model.indices.size();
+	header.numSubmeshes = model.submeshes.size();
+	header.numMaterials = model.materials.size();
+	header.numHullVertices = model.convexHull.vertices.size();
+	header.numHullIndices = model.convexHull.indices.size();
+	const BVH& bvh = model.bvh.bvh();
+	header.numBVHNodes = bvh.nodes().size();
+	header.numBVHPrimitives = bvh.primitiveIndices().size();
+	header.numLODs = model.lods.size();
+	header.source = source;
+	header.aabb = model.aabb;
+	header.boundingSphere = model.boundingSphere;
+	header.obb = model.obb;
+
+	// Materials and their strings
+	DynArray<SfzMeshMaterial> materials(0, model.materials.size());
+	DynArray<char> strings;
+	for (const Material& material : model.materials) {
+		SfzMeshMaterial tmp;
+		tmp.ambient = material.ambient;
+		tmp.diffuse = material.diffuse;
+		tmp.specular = material.specular;
+		tmp.emission = material.emission;
+		tmp.shininess = material.shininess;
+		tmp.dissolve = material.dissolve;
+		tmp.nameLength = material.name.size();
+		tmp.nameOffset = appendString(strings, material.name);
+		tmp.diffuseTextureLength = material.diffuseTexture.size();
+		tmp.diffuseTextureOffset = appendString(strings, material.diffuseTexture);
+		materials.add(tmp);
+	}
+	header.numStringBytes = strings.size();
+
+	// Header is written last when all offsets are known
+	DynArray<uint8_t> file(sizeof(SfzMeshHeader), uint8_t(0));
+	header.verticesOffset = appendSection(file, model.vertices.data(),
+	                                      model.vertices.size() * sizeof(Vertex));
+	header.indicesOffset = appendSection(file, model.indices.data(),
+	                                     model.indices.size() * sizeof(uint32_t));
+	header.submeshesOffset = appendSection(file, model.submeshes.data(),
+	                                       model.submeshes.size() * sizeof(Submesh));
+	header.materialsOffset = appendSection(file, materials.data(),
+	                                       materials.size() * sizeof(SfzMeshMaterial));
+	header.stringsOffset = appendSection(file, strings.data(), strings.size());
+	header.hullVerticesOffset = appendSection(file, model.convexHull.vertices.data(),
+	                                          model.convexHull.vertices.size() * sizeof(vec3));
+	header.hullIndicesOffset = appendSection(file, model.convexHull.indices.data(),
+	                                         model.convexHull.indices.size() * sizeof(uint32_t));
+	header.bvhNodesOffset = appendSection(file, bvh.nodes().data(),
+	                                      bvh.nodes().size() * sizeof(BVHNode));
+	header.bvhPrimitivesOffset = appendSection(file, bvh.primitiveIndices().data(),
+	                                           bvh.primitiveIndices().size() * sizeof(uint32_t));
+	header.lodsOffset = appendSection(file, model.lods.data(), model.lods.size() * sizeof(LOD));
+	std::memcpy(file.data(), &header, sizeof(SfzMeshHeader));
+
+	return writeBinaryFile(path, file.data(), file.size());
+}
+
+bool readSfzMeshInfo(const char* path, SfzMeshInfo& infoOut) noexcept
+{
+	// Only the pages touched are read, so mapping the whole file is cheap
+	MappedFile file(path);
+	if (!file.isMapped() || file.size() < sizeof(SfzMeshHeader)) return false;
+	SfzMeshHeader header;
+	std::memcpy(&header, file.data(), sizeof(SfzMeshHeader));
+	if (!headerIsCurrent(header)) return false;
+	infoOut.source = header.source;
+	infoOut.numVertices = header.numVertices;
+	infoOut.numIndices = header.numIndices;
+	infoOut.numSubmeshes = header.numSubmeshes;
+	infoOut.numMaterials = header.numMaterials;
+	infoOut.numLODs = header.numLODs;
+	return true;
+}
+
+bool updateSfzMeshSource(const char* path, const SfzMeshSource& source) noexcept
+{
+	std::FILE* file = std::fopen(path, "r+b");
+	if (file == NULL) return false;
+	SfzMeshHeader header;
+	bool success = std::fread(&header, sizeof(SfzMeshHeader), 1, file) == 1 && headerIsCurrent(header);
+	if (success) {
+		header.source = source;
+		success = std::fseek(file, 0, SEEK_SET) == 0 &&
+		          std::fwrite(&header, sizeof(SfzMeshHeader), 1, file) == 1;
+	}
+	success = std::fclose(file) == 0 && success;
+	return success;
+}
+
+Model readSfzMesh(const char* path, const SfzMeshSource* expectedSource) noexcept
+{
+	MappedFile file(path);
+	if (!file.isMapped()) return Model();
+
+	// Check header
+	SfzMeshHeader header;
+	if (file.size() < sizeof(SfzMeshHeader)) {
+		printErrorMessage("Invalid .sfzmesh file %s, too small", path);
+		return Model();
+	}
+	std::memcpy(&header, file.data(), sizeof(SfzMeshHeader));
+	if (!headerIsCurrent(header)) {
+		// Not an error, the file is just from another version
+		return Model();
+	}
+	if (expectedSource != nullptr &&
+	    (header.source.modificationTime != expectedSource->modificationTime ||
+	     header.source.size != expectedSource->size)) {
+		// Stale, the source has been modified since the file was written
+		return Model();
+	}
+
+	// Check that all sections are inside the file
+	const size_t size = file.size();
+	if (header.numVertices == 0 || header.numIndices == 0 ||
+	    !sectionInFile(header.verticesOffset, header.numVertices, sizeof(Vertex), size) ||
+	    !sectionInFile(header.indicesOffset, header.numIndices, sizeof(uint32_t), size) ||
+	    !sectionInFile(header.submeshesOffset, header.numSubmeshes, sizeof(Submesh), size) ||
+	    !sectionInFile(header.materialsOffset, header.numMaterials, sizeof(SfzMeshMaterial), size) ||
+	    !sectionInFile(header.stringsOffset, header.numStringBytes, sizeof(char), size) ||
+	    !sectionInFile(header.hullVerticesOffset, header.numHullVertices, sizeof(vec3), size) ||
+	    !sectionInFile(header.hullIndicesOffset, header.numHullIndices, sizeof(uint32_t), size) ||
+	    !sectionInFile(header.bvhNodesOffset, header.numBVHNodes, sizeof(BVHNode), size) ||
+	    !sectionInFile(header.bvhPrimitivesOffset, header.numBVHPrimitives, sizeof(uint32_t), size) ||
+	    !sectionInFile(header.lodsOffset, header.numLODs, sizeof(LOD), size)) {
+		printErrorMessage("Invalid .sfzmesh file %s, sections out of bounds", path);
+		return Model();
+	}
+
+	const Vertex* vertices = reinterpret_cast<const Vertex*>(file.data() + header.verticesOffset);
+	const uint32_t* indices = reinterpret_cast<const uint32_t*>(file.data() + header.indicesOffset);
+	const Submesh* submeshes =
+	    reinterpret_cast<const Submesh*>(file.data() + header.submeshesOffset);
+	const SfzMeshMaterial* materials =
+	    reinterpret_cast<const SfzMeshMaterial*>(file.data() + header.materialsOffset);
+	const char* strings = reinterpret_cast<const char*>(file.data() + header.stringsOffset);
+	const vec3* hullVertices = reinterpret_cast<const vec3*>(file.data() + header.hullVerticesOffset);
+	const uint32_t* hullIndices =
+	    reinterpret_cast<const uint32_t*>(file.data() + header.hullIndicesOffset);
+	const BVHNode* bvhNodes = reinterpret_cast<const BVHNode*>(file.data() + header.bvhNodesOffset);
+	const uint32_t* bvhPrimitives =
+	    reinterpret_cast<const uint32_t*>(file.data() + header.bvhPrimitivesOffset);
+	const LOD* lods = reinterpret_cast<const LOD*>(file.data() + header.lodsOffset);
+
+	// Check that all indices are in range, so a corrupt file can't make OpenGL read out of bounds
+	bool valid = true;
+	for (uint32_t i = 0; i < header.numIndices; i++) {
+		valid &= indices[i] < header.numVertices;
+	}
+	for (uint32_t i = 0; i < header.numSubmeshes; i++) {
+		const Submesh& submesh = submeshes[i];
+		valid &= uint64_t(submesh.firstIndex) + submesh.numIndices <= header.numIndices;
+		valid &= submesh.materialIndex >= -1 && submesh.materialIndex < int32_t(header.numMaterials);
+	}
+	for (uint32_t i = 0; i < header.numMaterials; i++) {
+		const SfzMeshMaterial& material = materials[i];
+		valid &= uint64_t(material.nameOffset) + material.nameLength < header.numStringBytes;
+		valid &= uint64_t(material.diffuseTextureOffset) + material.diffuseTextureLength < header.numStringBytes;
+		if (!valid) break;
+		valid &= strings[material.nameOffset + material.nameLength] == '\0';
+		valid &= strings[material.diffuseTextureOffset + material.diffuseTextureLength] == '\0';
+	}
+	for (uint32_t i = 0; i < header.numHullIndices; i++) {
+		valid &= hullIndices[i] < header.numHullVertices;
+	}
+	for (uint32_t i = 0; i < header.numLODs; i++) {
+		const LOD& lod = lods[i];
+		valid &= uint64_t(lod.firstIndex) + lod.numIndices <= header.numIndices;
+		valid &= uint64_t(lod.firstSubmesh) + lod.numSubmeshes <= header.numSubmeshes;
+		valid &= lod.error >= 0.0f;
+	}
+	if (!valid) {
+		printErrorMessage("Invalid .sfzmesh file %s, indices out of range", path);
+		return Model();
+	}
+
+	// Copy into Model
+	Model tmp;
+	tmp.vertices.setCapacity(header.numVertices);
+	tmp.vertices.add(vertices, header.numVertices);
+	tmp.indices.setCapacity(header.numIndices);
+	tmp.indices.add(indices, header.numIndices);
+	if (header.numSubmeshes > 0) tmp.submeshes.add(submeshes, header.numSubmeshes);
+	tmp.materials = DynArray<Material>(header.numMaterials, header.numMaterials);
+	for (uint32_t i = 0; i < header.numMaterials; i++) {
+		const SfzMeshMaterial& src = materials[i];
+		Material& dst = tmp.materials[i];
+		dst.name = DynString(strings + src.nameOffset);
+		dst.ambient = src.ambient;
+		dst.diffuse = src.diffuse;
+		dst.specular = src.specular;
+		dst.emission = src.emission;
+		dst.shininess = src.shininess;
+		dst.dissolve = src.dissolve;
+		dst.diffuseTexture = DynString(strings + src.diffuseTextureOffset);
+	}
+	if (header.numHullVertices > 0) tmp.convexHull.vertices.add(hullVertices, header.numHullVertices);
+	if (header.numHullIndices > 0) tmp.convexHull.indices.add(hullIndices, header.numHullIndices);
+	if (header.numLODs > 0) tmp.lods.add(lods, header.numLODs);
+	tmp.aabb = header.aabb;
+	tmp.boundingSphere = header.boundingSphere;
+	tmp.obb = header.obb;
+
+	// Restoring the BVH validates the stored nodes, it is rebuilt if they don't match the mesh
+	if (header.numBVHPrimitives != tmp.lod(0).numIndices / 3 ||
+	    !tmp.restoreBVH(bvhNodes, header.numBVHNodes, bvhPrimitives)) {
+		tmp.buildBVH();
+	}
+
+	tmp.createGLBuffers(vertices, indices);
+	return std::move(tmp);
+}
+
+Model loadModelCached(const char* basePath, const char* fileName) noexcept
+{
+	const uint32_t pathCapacity = uint32_t(std::strlen(basePath) + std::strlen(fileName) + 16);
+	DynString sourcePath("", pathCapacity);
+	sourcePath.printf("%s%s", basePath, fileName);
+	DynString cachePath("", pathCapacity);
+	cachePath.printf("%s%s.sfzmesh", basePath, fileName);
+
+	// Attempt to load from cache
+	SfzMeshSource source = sfzMeshSource(sourcePath.str(), false);
+	const bool sourceExists = source.size >= 0;
+	SfzMeshInfo cached;
+	if (readSfzMeshInfo(cachePath.str(), cached)) {
+		const SfzMeshSource& cachedSource = cached.source;
+		bool upToDate = !sourceExists || (cachedSource.modificationTime == source.modificationTime &&
+		                                  cachedSource.size == source.size);
+
+		// Modification time differs, hashing the source is still much cheaper than parsing it. If
+		// the contents are unchanged the new modification time is stored so that the next startup
+		// doesn't need to hash again.
+		if (!upToDate && cachedSource.size == source.size && cachedSource.hash != 0) {
+			SfzMeshSource hashedSource = sfzMeshSource(sourcePath.str(), true);
+			upToDate = hashedSource.hash == cachedSource.hash;
+			if (upToDate && !updateSfzMeshSource(cachePath.str(), hashedSource)) {
+				printErrorMessage("Failed to update model cache %s", cachePath.str());
+			}
+		}
+
+		if (upToDate) {
+			Model tmp = readSfzMesh(cachePath.str());
+			if (tmp.vertices.size() > 0) return std::move(tmp);
+		}
+	}
+	if (!sourceExists) return Model();
+
+	// Load source and (re)write cache
+	Model tmp = tinyObjLoadModel(basePath, fileName);
+	if (tmp.vertices.size() == 0) return Model();
+	source = sfzMeshSource(sourcePath.str(), true);
+	if (!writeSfzMesh(tmp, source, cachePath.str())) {
+		printErrorMessage("Failed to write model cache %s", cachePath.str());
+	}
+	return std::move(tmp);
+}
+
+} // namespace gl
+} // namespace sfz
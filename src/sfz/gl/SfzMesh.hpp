@@ -0,0 +1,76 @@
+// Copyright (c) Peter Hillerstrm (skipifzero.com, peter@hstroem.se)
+
+#pragma once
+
+#include <cstdint>
+
+#include "sfz/gl/Model.hpp"
+
+namespace sfz {
+
+namespace gl {
+
+using std::int64_t;
+using std::uint64_t;
+
+// SfzMeshSource struct
+// ------------------------------------------------------------------------------------------------
+
+/// Identifies the source file (e.g. an .obj file) a .sfzmesh file was created from
+struct SfzMeshSource final {
+	int64_t modificationTime = -1; // Seconds since the Unix epoch, see fileModificationTime()
+	int64_t size = -1; // Size in bytes
+	uint64_t hash = 0; // 64-bit FNV-1a hash of the contents, 0 if not computed
+};
+
+/// Returns the SfzMeshSource of a file, modificationTime and size are negative if the file does
+/// not exist. Computing the hash requires reading the whole file, so it is optional.
+SfzMeshSource sfzMeshSource(const char* path, bool computeHash) noexcept;
+
+// SfzMeshInfo struct
+// ------------------------------------------------------------------------------------------------
+
+/// The information in the header of a .sfzmesh file, see readSfzMeshInfo()
+struct SfzMeshInfo final {
+	SfzMeshSource source;
+	uint32_t numVertices = 0;
+	uint32_t numIndices = 0;
+	uint32_t numSubmeshes = 0;
+	uint32_t numMaterials = 0;
+	uint32_t numLODs = 0;
+};
+
+// .sfzmesh functions
+// ------------------------------------------------------------------------------------------------
+
+/// Writes a Model to a binary .sfzmesh file, returns whether successful or not. The file contains
+/// a header (with the bounding volumes and the source), the vertex and index streams, the
+/// submeshes, the materials, the convex hull, the nodes of the triangle BVH and the LODs.
+bool writeSfzMesh(const Model& model, const SfzMeshSource& source, const char* path) noexcept;
+
+/// Reads the source and element counts stored in the header of a .sfzmesh file without loading
+/// the rest of it. Returns false if the file is missing or was written by another version of the
+/// format.
+bool readSfzMeshInfo(const char* path, SfzMeshInfo& infoOut) noexcept;
+
+/// Replaces the source stored in the header of an existing .sfzmesh file without rewriting the
+/// rest of it. Used when the source was found to be unchanged by its hash, so that the next check
+/// can use the modification time again. Returns whether successful or not.
+bool updateSfzMeshSource(const char* path, const SfzMeshSource& source) noexcept;
+
+/// Reads a .sfzmesh file through a memory mapping, the OpenGL buffers are filled straight from
+/// the mapped file. If expectedSource is not null the file is only loaded if it was created from a
+/// source with the same modification time and size. Returns an empty Model if the file is
+/// missing, stale or invalid.
+Model readSfzMesh(const char* path, const SfzMeshSource* expectedSource = nullptr) noexcept;
+
+/// Loads a model using the .sfzmesh cache (basePath + fileName + ".sfzmesh") if it is up to date,
+/// otherwise the model is loaded with tinyObjLoadModel() and the cache is (re)written. The cache
+/// is up to date if the source has the same modification time and size, or the same size and
+/// contents (e.g. after a checkout or copy, or if written by sfzAssetConverter). If only the
+/// .sfzmesh file exists it is loaded without checking it against the source. Returns an empty
+/// Model on failure.
+Model loadModelCached(const char* basePath, const char* fileName) noexcept;
+
+} // namespace gl
+} // namespace sfz
@@ -0,0 +1,352 @@
+// Copyright (c) Peter Hillerstrm (skipifzero.com, peter@hstroem.se)
+
+// sfzAssetConverter: converts .obj models into .sfzmesh files offline, see printUsage()
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "sfz/containers/DynArray.hpp"
+#include "sfz/containers/DynString.hpp"
+#include "sfz/gl/SfzMesh.hpp"
+#include "sfz/util/IO.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace sfz;
+using namespace sfz::gl;
+
+// Statics
+// ------------------------------------------------------------------------------------------------
+
+static const char* MANIFEST_FILE_NAME = "sfzmesh_manifest.txt";
+
+struct Job final {
+	DynString sourceBasePath; // Directory of the source, ends with a separator
+	DynString sourceFileName;
+	DynString outputDir; // Directory of the output, ends with a separator
+
+	// Results
+	bool success = false;
+	bool skipped = false;
+	SfzMeshInfo info;
+};
+
+static void printUsage() noexcept
+{
+	std::printf(
+	    "Usage: sfzAssetConverter [options] <file or directory>...\n"
+	    "Converts .obj models into .sfzmesh files, directories are searched recursively. Models\n"
+	    "whose .sfzmesh file was created from a source with the same contents are skipped.\n"
+	    "\n"
+	    "Options:\n"
+	    "  -o <dir>   Write the outputs to dir (mirroring the input directories) instead of next\n"
+	    "             to the sources, which is where the game looks for them\n"
+	    "  -m <file>  Path of the manifest, default is %s in the output directory\n"
+	    "             (or the current directory)\n"
+	    "  -j <n>     Number of models converted in parallel, default is the number of cores\n"
+	    "  -f         Convert all models, even the ones that are up to date\n",
+	    MANIFEST_FILE_NAME);
+}
+
+static DynString concat(const char* a, const char* b, const char* c = "") noexcept
+{
+	DynString tmp("", uint32_t(std::strlen(a) + std::strlen(b) + std::strlen(c) + 1));
+	tmp.printf("%s%s%s", a, b, c);
+	return tmp;
+}
+
+static bool endsWith(const char* str, const char* suffix) noexcept
+{
+	const size_t strLen = std::strlen(str);
+	const size_t suffixLen = std::strlen(suffix);
+	if (suffixLen > strLen) return false;
+	for (size_t i = 0; i < suffixLen; i++) {
+		char c = str[strLen - suffixLen + i];
+		if (c >= 'A' && c <= 'Z') c = char(c - 'A' + 'a');
+		if (c != suffix[i]) return false;
+	}
+	return true;
+}
+
+/// Both '/' and '\\' separate directories, the latter on Windows
+static bool isSeparator(char c) noexcept
+{
+	return c == '/' || c == '\\';
+}
+
+static bool endsWithSeparator(const char* path) noexcept
+{
+	const size_t length = std::strlen(path);
+	return length > 0 && isSeparator(path[length - 1]);
+}
+
+/// Returns the last separator in the path, or nullptr if there is none
+static const char* lastSeparator(const char* path) noexcept
+{
+	const char* last = nullptr;
+	for (const char* c = path; *c != '\0'; c++) {
+		if (isSeparator(*c)) last = c;
+	}
+	return last;
+}
+
+static bool isDirectory(const char* path) noexcept
+{
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path);
+	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	struct stat st;
+	return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+}
+
+/// Appends the names of the entries of a directory (except "." and "..") to the lists
+static void listDirectory(const char* path, DynArray<DynString>& filesOut,
+                          DynArray<DynString>& directoriesOut) noexcept
+{
+#ifdef _WIN32
+	DynString pattern = concat(path, "*");
+	WIN32_FIND_DATAA data;
+	HANDLE handle = FindFirstFileA(pattern.str(), &data);
+	if (handle == INVALID_HANDLE_VALUE) return;
+	do {
+		if (std::strcmp(data.cFileName, ".") == 0 || std::strcmp(data.cFileName, "..") == 0) continue;
+		if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+			directoriesOut.add(DynString(data.cFileName));
+		}
+		else {
+			filesOut.add(DynString(data.cFileName));
+		}
+	} while (FindNextFileA(handle, &data));
+	FindClose(handle);
+#else
+	DIR* dir = opendir(path);
+	if (dir == nullptr) return;
+	while (struct dirent* entry = readdir(dir)) {
+		if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) continue;
+		DynString entryPath = concat(path, entry->d_name);
+		if (isDirectory(entryPath.str())) directoriesOut.add(DynString(entry->d_name));
+		else filesOut.add(DynString(entry->d_name));
+	}
+	closedir(dir);
+#endif
+}
+
+/// Adds a job for each .obj file in a directory and its subdirectories. Paths end with '/'.
+static void findJobs(const char* sourceDir, const char* outputDir, DynArray<Job>& jobsOut) noexcept
+{
+	DynArray<DynString> files, directories;
+	listDirectory(sourceDir, files, directories);
+
+	// Sorted so that the manifest doesn't depend on the order of the directory entries
+	std::sort(files.begin(), files.end());
+	std::sort(directories.begin(), directories.end());
+
+	for (const DynString& file : files) {
+		if (!endsWith(file.str(), ".obj")) continue;
+		Job job;
+		job.sourceBasePath = DynString(sourceDir);
+		job.sourceFileName = file;
+		job.outputDir = DynString(outputDir);
+		jobsOut.add(std::move(job));
+	}
+	for (const DynString& directory : directories) {
+		DynString subSourceDir = concat(sourceDir, directory.str(), "/");
+		DynString subOutputDir = concat(outputDir, directory.str(), "/");
+		findJobs(subSourceDir.str(), subOutputDir.str(), jobsOut);
+	}
+}
+
+/// Creates a directory and all its missing parents
+static bool createDirectories(const char* path) noexcept
+{
+	DynString tmp(path);
+	for (uint32_t i = 1; i < tmp.size(); i++) {
+		if (!isSeparator(tmp.str()[i])) continue;
+		const char separator = tmp.str()[i];
+		tmp.str()[i] = '\0';
+		if (!isDirectory(tmp.str())) createDirectory(tmp.str());
+		tmp.str()[i] = separator;
+	}
+	if (!isDirectory(tmp.str())) createDirectory(tmp.str());
+	return isDirectory(tmp.str());
+}
+
+static void runJob(Job& job, bool force, std::mutex& printMutex) noexcept
+{
+	DynString sourcePath = concat(job.sourceBasePath.str(), job.sourceFileName.str());
+	DynString outputPath = concat(job.outputDir.str(), job.sourceFileName.str(), ".sfzmesh");
+
+	// Skip if the output was created from a source with the same contents
+	const SfzMeshSource source = sfzMeshSource(sourcePath.str(), true);
+	if (!force && readSfzMeshInfo(outputPath.str(), job.info) &&
+	    job.info.source.size == source.size && job.info.source.hash == source.hash) {
+		job.success = true;
+		job.skipped = true;
+		std::lock_guard<std::mutex> lock(printMutex);
+		std::printf("Up to date: %s\n", sourcePath.str());
+		return;
+	}
+
+	// Import, optimizes the mesh and computes bounds, BVH and convex hull but creates no OpenGL
+	// objects
+	RenderingOptimizationStats optimizationStats;
+	Model model = tinyObjImportModel(job.sourceBasePath.str(), job.sourceFileName.str(),
+	                                 &optimizationStats);
+	if (model.vertices.size() == 0) {
+		std::lock_guard<std::mutex> lock(printMutex);
+		std::printf("Failed to import: %s\n", sourcePath.str());
+		return;
+	}
+	job.info.source = source;
+	job.info.numVertices = model.vertices.size();
+	job.info.numIndices = model.indices.size();
+	job.info.numSubmeshes = model.submeshes.size();
+	job.info.numMaterials = model.materials.size();
+	job.info.numLODs = model.lods.size();
+
+	if (!createDirectories(job.outputDir.str()) ||
+	    !writeSfzMesh(model, source, outputPath.str())) {
+		std::lock_guard<std::mutex> lock(printMutex);
+		std::printf("Failed to write: %s\n", outputPath.str());
+		return;
+	}
+	job.success = true;
+	std::lock_guard<std::mutex> lock(printMutex);
+	std::printf("Converted: %s (%u vertices, %u triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f)\n",
+	            sourcePath.str(), job.info.numVertices, model.lod(0).numIndices / 3,
+	            optimizationStats.before.acmr, optimizationStats.after.acmr,
+	            optimizationStats.before.atvr, optimizationStats.after.atvr);
+	for (uint32_t i = 1; i < model.numLODs(); i++) {
+		const LOD lod = model.lod(i);
+		std::printf("    LOD %u: %u triangles, error %g\n", i, lod.numIndices / 3, lod.error);
+	}
+}
+
+/// Writes one tab separated line per successfully converted model
+static bool writeManifest(const char* path, const DynArray<Job>& jobs) noexcept
+{
+	std::FILE* file = std::fopen(path, "w");
+	if (file == nullptr) return false;
+	std::fprintf(file, "# output\tsource\tsourceSize\tsourceHash\tvertices\tindices\tsubmeshes\tmaterials\tlods\n");
+	for (const Job& job : jobs) {
+		if (!job.success) continue;
+		const SfzMeshInfo& info = job.info;
+		std::fprintf(file, "%s%s.sfzmesh\t%s%s\t%" PRId64 "\t%016" PRIx64 "\t%u\t%u\t%u\t%u\t%u\n",
+		             job.outputDir.str(), job.sourceFileName.str(), job.sourceBasePath.str(),
+		             job.sourceFileName.str(), info.source.size, info.source.hash,
+		             info.numVertices, info.numIndices, info.numSubmeshes, info.numMaterials,
+		             info.numLODs);
+	}
+	std::fclose(file);
+	return true;
+}
+
+// Main
+// ------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	// Parse arguments
+	DynArray<DynString> inputs;
+	const char* outputDirArg = nullptr;
+	const char* manifestArg = nullptr;
+	uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+	bool force = false;
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const bool hasValue = (i + 1) < argc;
+		if (std::strcmp(arg, "-o") == 0 && hasValue) outputDirArg = argv[++i];
+		else if (std::strcmp(arg, "-m") == 0 && hasValue) manifestArg = argv[++i];
+		else if (std::strcmp(arg, "-j") == 0 && hasValue) numThreads = uint32_t(std::max(1, std::atoi(argv[++i])));
+		else if (std::strcmp(arg, "-f") == 0) force = true;
+		else if (arg[0] == '-') {
+			printUsage();
+			return 1;
+		}
+		else inputs.add(DynString(arg));
+	}
+	if (inputs.size() == 0) {
+		printUsage();
+		return 1;
+	}
+	DynString outputDir;
+	if (outputDirArg != nullptr) {
+		outputDir = endsWithSeparator(outputDirArg) ? DynString(outputDirArg) : concat(outputDirArg, "/");
+	}
+
+	// Find models
+	DynArray<Job> jobs;
+	for (const DynString& input : inputs) {
+		if (isDirectory(input.str())) {
+			DynString sourceDir = endsWithSeparator(input.str()) ? input : concat(input.str(), "/");
+			findJobs(sourceDir.str(), outputDirArg != nullptr ? outputDir.str() : sourceDir.str(), jobs);
+			continue;
+		}
+		if (!fileExists(input.str())) {
+			std::printf("No such file or directory: %s\n", input.str());
+			return 1;
+		}
+
+		// Single file, split into directory and file name
+		const char* separator = lastSeparator(input.str());
+		Job job;
+		if (separator != nullptr) {
+			const uint32_t dirLength = uint32_t(separator - input.str()) + 1;
+			job.sourceBasePath = DynString("", dirLength + 1);
+			job.sourceBasePath.printf("%.*s", int(dirLength), input.str());
+			job.sourceFileName = DynString(separator + 1);
+		}
+		else {
+			job.sourceBasePath = DynString("./");
+			job.sourceFileName = input;
+		}
+		job.outputDir = outputDirArg != nullptr ? outputDir : job.sourceBasePath;
+		jobs.add(std::move(job));
+	}
+
+	// Convert models in parallel, each thread takes the next model not yet started
+	std::atomic<uint32_t> nextJob(0);
+	std::mutex printMutex;
+	auto worker = [&]() {
+		for (uint32_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+			runJob(jobs[i], force, printMutex);
+		}
+	};
+	numThreads = std::min(numThreads, std::max(1u, jobs.size()));
+	DynArray<std::thread> threads(0, numThreads);
+	for (uint32_t i = 1; i < numThreads; i++) threads.add(std::thread(worker));
+	worker();
+	for (std::thread& thread : threads) thread.join();
+
+	// Summary and manifest
+	uint32_t numConverted = 0, numSkipped = 0, numFailed = 0;
+	for (const Job& job : jobs) {
+		if (!job.success) numFailed++;
+		else if (job.skipped) numSkipped++;
+		else numConverted++;
+	}
+	DynString manifestPath = manifestArg != nullptr ? DynString(manifestArg) :
+	                         concat(outputDirArg != nullptr ? outputDir.str() : "", MANIFEST_FILE_NAME);
+	if (outputDirArg != nullptr) createDirectories(outputDir.str());
+	if (!writeManifest(manifestPath.str(), jobs)) {
+		std::printf("Failed to write manifest: %s\n", manifestPath.str());
+		numFailed++;
+	}
+	std::printf("%u converted, %u up to date, %u failed\n", numConverted, numSkipped, numFailed);
+	return numFailed == 0 ? 0 : 1;
+}